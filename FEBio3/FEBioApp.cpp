@@ -159,6 +159,7 @@ int FEBioApp::RunModel()
 	fem.SetLogFilename(m_ops.szlog);
 	fem.SetPlotFilename(m_ops.szplt);
 	fem.SetDumpFilename(m_ops.szdmp);
+	fem.SetTelemetryFilename(m_ops.sztlm);
 
 	// read the input file if specified
 	int nret = 0;
@@ -243,6 +244,7 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 	ops.sztask[0] = 0;
 	ops.szctrl[0] = 0;
 	ops.szimp[0] = 0;
+	ops.sztlm[0] = 0;
 
 	// set initial configuration file name
 	if (ops.szcnf[0] == 0)
@@ -352,6 +354,9 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 			if (sz[5] != '=') { fprintf(stderr, "command line error when parsing task\n"); return false; }
 			strcpy(ops.sztask, sz+6);
 
+			// the benchmark tasks do not need a model file
+			if ((strcmp(ops.sztask, "benchmark") == 0) || (strcmp(ops.sztask, "tensor benchmark") == 0)) ops.binteractive = false;
+
 			if (i<nargs-1)
 			{
 				char* szi = argv[i+1];
@@ -394,6 +399,10 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 		{
 			strcpy(ops.szimp, argv[++i]);
 		}
+		else if (strcmp(sz, "-telemetry") == 0)
+		{
+			strcpy(ops.sztlm, argv[++i]);
+		}
 		else if (sz[0] == '-')
 		{
 			fprintf(stderr, "FATAL ERROR: Invalid command line option.\n");
@@ -39,6 +39,7 @@ SOFTWARE.*/
 #include "cmdoptions.h"
 #include <FEBioLib/febio.h>
 #include <FEBioLib/plugin.h>
+#include <FEBioXML/FEBinaryMesh.h>
 #include "FEBioApp.h"
 #include "breakpoint.h"
 #include <iostream>
@@ -67,6 +68,7 @@ REGISTER_COMMAND(FEBioCmd_Cont         , "cont"   , "continues the current model
 REGISTER_COMMAND(FEBioCmd_Conv         , "conv"   , "force conversion of iteration");
 REGISTER_COMMAND(FEBioCmd_Debug        , "debug"  , "toggle debug mode");
 REGISTER_COMMAND(FEBioCmd_Events       , "events" , "print list of events");
+REGISTER_COMMAND(FEBioCmd_export       , "export" , "write mesh to binary mesh file");
 REGISTER_COMMAND(FEBioCmd_Fail         , "fail"   , "force iteratoin failer");
 REGISTER_COMMAND(FEBioCmd_Help         , "help"   , "print available commands");
 REGISTER_COMMAND(FEBioCmd_hist         , "hist"   , "lists history of commands");
@@ -549,6 +551,32 @@ int FEBioCmd_out::run(int nargs, char **argv)
 	return 0;
 }
 
+//-----------------------------------------------------------------------------
+int FEBioCmd_export::run(int nargs, char **argv)
+{
+	FEBioModel* fem = GetFEM();
+	if (fem == nullptr) return need_active_model();
+
+	char szfile[1024] = { 0 };
+	if (nargs == 2) strcpy(szfile, argv[1]);
+	else if ((nargs == 1) && (fem->GetFileTitle().empty() == false))
+	{
+		strcpy(szfile, fem->GetFileTitle().c_str());
+		char* ch = strrchr(szfile, '.');
+		if (ch) *ch = 0;
+		strcat(szfile, ".febm");
+	}
+	else return invalid_nr_args();
+
+	FEBinaryMeshWriter writer;
+	if (writer.Write(*fem, szfile))
+		cout << "\nFile written " << szfile << endl;
+	else
+		cout << "ERROR: " << writer.GetErrorString() << endl;
+
+	return 0;
+}
+
 //-----------------------------------------------------------------------------
 int FEBioCmd_where::run(int nargs, char **argv)
 {
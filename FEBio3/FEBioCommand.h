@@ -215,6 +215,14 @@ public:
 	DECLARE_COMMAND(FEBioCmd_out);
 };
 
+//-----------------------------------------------------------------------------
+class FEBioCmd_export : public FEBioCommand
+{
+public:
+	int run(int nargs, char** argv);
+	DECLARE_COMMAND(FEBioCmd_export);
+};
+
 //-----------------------------------------------------------------------------
 class FEBioCmd_where : public FEBioCommand
 {
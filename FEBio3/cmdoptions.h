@@ -49,6 +49,7 @@ struct CMDOPTIONS
 	char	sztask[MAXFILE];	//!< task name
 	char	szctrl[MAXFILE];	//!< control file for tasks
 	char	szimp[MAXFILE];		//!< import file
+	char	sztlm[MAXFILE];		//!< convergence telemetry file
 
 	CMDOPTIONS()
 	{
@@ -71,5 +72,6 @@ struct CMDOPTIONS
 		sztask[0] = 0;
 		szctrl[0] = 0;
 		szimp[0] = 0;
+		sztlm[0] = 0;
 	}
 };
@@ -33,3 +33,19 @@ SOFTWARE.*/
 FEBiphasicFSIDomain::FEBiphasicFSIDomain(FEModel* pfem)
 {
 }
+
+//-----------------------------------------------------------------------------
+void FEBiphasicFSIDomain::FusedStiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool bmass)
+{
+    StiffnessMatrix(LS, tp);
+    for (size_t i=0; i<bf.size(); ++i) BodyForceStiffness(LS, tp, *bf[i]);
+    if (bmass) MassMatrix(LS, tp);
+}
+
+//-----------------------------------------------------------------------------
+void FEBiphasicFSIDomain::FusedResidual(FEGlobalVector& R, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool binertial)
+{
+    InternalForces(R, tp);
+    for (size_t i=0; i<bf.size(); ++i) BodyForce(R, tp, *bf[i]);
+    if (binertial) InertialForces(R, tp);
+}
@@ -91,6 +91,12 @@ public: // overrides from FEElasticDomain
     //! body force stiffness
     void BodyForceStiffness(FELinearSystem& LS, const FETimeInfo& tp, FEBodyForce& bf) override;
     
+    //! stiffness, body force stiffness and mass matrix in a single pass
+    void FusedStiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool bmass) override;
+    
+    //! internal, body and inertial forces in a single pass
+    void FusedResidual(FEGlobalVector& R, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool binertial) override;
+    
 public:
     // --- S T I F F N E S S ---
     
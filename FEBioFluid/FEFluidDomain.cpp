@@ -30,8 +30,42 @@ SOFTWARE.*/
 #include "FEFluidDomain.h"
 #include "FECore/FESolidDomain.h"
 #include "FECore/FEModel.h"
+#include <FEBioMech/FEBodyForce.h>
 
 //-----------------------------------------------------------------------------
 FEFluidDomain::FEFluidDomain(FEModel* pfem)
 {
 }
+
+//-----------------------------------------------------------------------------
+void FEFluidDomain::FusedStiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool bmass)
+{
+    StiffnessMatrix(LS, tp);
+    for (size_t i=0; i<bf.size(); ++i) BodyForceStiffness(LS, tp, *bf[i]);
+    if (bmass) MassMatrix(LS, tp);
+}
+
+//-----------------------------------------------------------------------------
+void FEFluidDomain::FusedResidual(FEGlobalVector& R, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool binertial)
+{
+    InternalForces(R, tp);
+    for (size_t i=0; i<bf.size(); ++i) BodyForce(R, tp, *bf[i]);
+    if (binertial) InertialForces(R, tp);
+}
+
+//-----------------------------------------------------------------------------
+void FindBodyForces(FEModel& fem, FEDomain& dom, vector<FEBodyForce*>& bf)
+{
+    bf.clear();
+    for (int j=0; j<fem.BodyLoads(); ++j)
+    {
+        FEBodyForce* pbf = dynamic_cast<FEBodyForce*>(fem.GetBodyLoad(j));
+        if (pbf && pbf->IsActive())
+        {
+            for (int i=0; i<pbf->Domains(); ++i)
+            {
+                if (pbf->Domain(i) == &dom) { bf.push_back(pbf); break; }
+            }
+        }
+    }
+}
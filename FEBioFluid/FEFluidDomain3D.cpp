@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioFluid.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementWorkspace.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -153,19 +154,20 @@ void FEFluidDomain3D::UnpackLM(FEElement& el, vector<int>& lm)
 void FEFluidDomain3D::InternalForces(FEGlobalVector& R, const FETimeInfo& tp)
 {
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 4*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = ws.ElementVector(ndof);
+        vector<int>& lm = ws.LM();
         
         // calculate internal force vector
         ElementInternalForce(el, fe, tp);
@@ -253,17 +255,18 @@ void FEFluidDomain3D::ElementInternalForce(FESolidElement& el, vector<double>& f
 void FEFluidDomain3D::BodyForce(FEGlobalVector& R, const FETimeInfo& tp, FEBodyForce& BF)
 {
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 4*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = ws.ElementVector(ndof);
+        vector<int>& lm = ws.LM();
         
         // apply body forces
         ElementBodyForce(BF, el, fe, tp);
@@ -464,25 +467,25 @@ void FEFluidDomain3D::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
 		FESolidElement& el = m_Elem[iel];
 
-        // element stiffness matrix
-        FEElementMatrix ke(el);
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
         
         // calculate material stiffness
         ElementStiffness(el, ke, tp);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -496,24 +499,24 @@ void FEFluidDomain3D::MassMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     
     for (int iel=0; iel<NE; ++iel)
     {
 		FESolidElement& el = m_Elem[iel];
 
-        // element stiffness matrix
-		FEElementMatrix ke(el);
+        // scratch space of this thread
+		FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
         
         // calculate inertial stiffness
         ElementMassMatrix(el, ke, tp);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -527,24 +530,24 @@ void FEFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, const FETimeInfo& t
 {
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     
     for (int iel=0; iel<NE; ++iel)
     {
 		FESolidElement& el = m_Elem[iel];
 
-        // element stiffness matrix
-        FEElementMatrix ke(el);
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke, tp);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -553,6 +556,90 @@ void FEFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, const FETimeInfo& t
     }
 }
 
+//-----------------------------------------------------------------------------
+//! The element stiffness, body force stiffness and mass matrices are evaluated
+//! one element at a time and the combined matrix is assembled once. This way
+//! the element and material point data are still in cache for each contribution.
+void FEFluidDomain3D::FusedStiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool bmass)
+{
+    int NE = (int)m_Elem.size();
+    m_ws.Prepare();
+    int NBF = (int)bf.size();
+#pragma omp parallel shared(NE, NBF)
+    {
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
+        vector<int>& lm = ws.LM();
+        
+#pragma omp for
+        for (int iel=0; iel<NE; ++iel)
+        {
+            FESolidElement& el = m_Elem[iel];
+            
+            // create the element's stiffness matrix
+            int ndof = 4*el.Nodes();
+            FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
+            
+            // calculate material stiffness
+            ElementStiffness(el, ke, tp);
+            
+            // add body force stiffness
+            for (int j=0; j<NBF; ++j) ElementBodyForceStiffness(*bf[j], el, ke, tp);
+            
+            // add inertial stiffness
+            if (bmass) ElementMassMatrix(el, ke, tp);
+            
+            // get the element's LM vector
+            UnpackLM(el, lm);
+            ke.SetIndices(lm);
+            
+            // assemble element matrix in global stiffness matrix
+            LS.Assemble(ke);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//! The element internal, body and inertial forces are evaluated one element at
+//! a time and the combined vector is assembled once.
+void FEFluidDomain3D::FusedResidual(FEGlobalVector& R, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool binertial)
+{
+    int NE = (int)m_Elem.size();
+    m_ws.Prepare();
+    int NBF = (int)bf.size();
+#pragma omp parallel shared(NE, NBF)
+    {
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
+        
+#pragma omp for
+        for (int i=0; i<NE; ++i)
+        {
+            FESolidElement& el = m_Elem[i];
+            
+            // get the element force vector and initialize it to zero
+            int ndof = 4*el.Nodes();
+            vector<double>& fe = ws.ElementVector(ndof);
+            vector<int>& lm = ws.LM();
+            
+            // calculate internal force vector
+            ElementInternalForce(el, fe, tp);
+            
+            // apply body forces
+            for (int j=0; j<NBF; ++j) ElementBodyForce(*bf[j], el, fe, tp);
+            
+            // add inertial forces
+            if (binertial) ElementInertialForce(el, fe, tp);
+            
+            // get the element's LM vector
+            UnpackLM(el, lm);
+            
+            // assemble element 'fe'-vector into global R vector
+            R.Assemble(el.m_node, lm, fe);
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 //! calculates element inertial stiffness matrix
 void FEFluidDomain3D::ElementMassMatrix(FESolidElement& el, matrix& ke, const FETimeInfo& tp)
@@ -727,18 +814,19 @@ void FEFluidDomain3D::UpdateElementStress(int iel, const FETimeInfo& tp)
 void FEFluidDomain3D::InertialForces(FEGlobalVector& R, const FETimeInfo& tp)
 {
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 4*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = ws.ElementVector(ndof);
+        vector<int>& lm = ws.LM();
         
         // calculate internal force vector
         ElementInertialForce(el, fe, tp);
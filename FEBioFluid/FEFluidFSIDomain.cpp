@@ -35,3 +35,19 @@ SOFTWARE.*/
 FEFluidFSIDomain::FEFluidFSIDomain(FEModel* pfem)
 {
 }
+
+//-----------------------------------------------------------------------------
+void FEFluidFSIDomain::FusedStiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool bmass)
+{
+    StiffnessMatrix(LS, tp);
+    for (size_t i=0; i<bf.size(); ++i) BodyForceStiffness(LS, tp, *bf[i]);
+    if (bmass) MassMatrix(LS, tp);
+}
+
+//-----------------------------------------------------------------------------
+void FEFluidFSIDomain::FusedResidual(FEGlobalVector& R, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool binertial)
+{
+    InternalForces(R, tp);
+    for (size_t i=0; i<bf.size(); ++i) BodyForce(R, tp, *bf[i]);
+    if (binertial) InertialForces(R, tp);
+}
@@ -74,6 +74,16 @@ public:
     //! calculate the mass matrix (for dynamic problems)
     virtual void MassMatrix(FELinearSystem& LS, const FETimeInfo& tp) = 0;
     
+    // --- F U S E D   E L E M E N T   L O O P S ---
+    
+    //! Calculate the stiffness matrix, the stiffness of the body forces bf and (when bmass is true)
+    //! the mass matrix. Domains can override this to do this in a single pass over the elements.
+    virtual void FusedStiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool bmass);
+    
+    //! Calculate the internal forces, the body forces bf and (when binertial is true) the inertial forces.
+    //! Domains can override this to do this in a single pass over the elements.
+    virtual void FusedResidual(FEGlobalVector& R, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool binertial);
+    
     //! transient analysis
     void SetTransientAnalysis() { m_btrans = true; }
     void SetSteadyStateAnalysis() { m_btrans = false; }
@@ -58,6 +58,7 @@ SOFTWARE.*/
 #include <FECore/FEAnalysis.h>
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/DumpStream.h>
+#include <FECore/FETelemetry.h>
 #include <FEBioMech/FESolidLinearSystem.h>
 #include "FEBioFSI.h"
 
@@ -1051,6 +1052,17 @@ bool FEFluidFSISolver::Quasin()
             feLogWarning("No force acting on the system.");
             bconv = true;
         }
+
+        // write the convergence telemetry
+        if (GetFEModel()->GetTelemetry().IsOpen())
+        {
+            AddTelemetryNorm("residual", normRi, normR1, m_Rtol*normRi);
+            AddTelemetryNorm("energy", normEi, normE1, m_Etol*normEi);
+            AddTelemetryNorm("displacement", normDi, normd, (m_Dtol*m_Dtol)*normD);
+            AddTelemetryNorm("velocity", normVi, normv, (m_Vtol*m_Vtol)*normV);
+            AddTelemetryNorm("dilatation", normFi, normf, (m_Ftol*m_Ftol)*normF);
+            WriteIterationTelemetry(s, bconv);
+        }
         
 		// see if we have exceeded the max residual
 		if ((bconv == false) && (m_Rmax > 0) && (normR1 >= m_Rmax))
@@ -1126,6 +1138,11 @@ bool FEFluidFSISolver::StiffnessMatrix()
 
 	FESolidLinearSystem LS(this, &m_rigidSolver, *m_pK, m_Fd, m_ui, (m_msymm == REAL_SYMMETRIC), m_alpha, m_nreq);
     
+    // fluid domains add their body force stiffness and mass matrix
+    // in the same pass over the elements as the stiffness matrix
+    bool bmass = (fem.GetCurrentStep()->m_nanalysis == FE_DYNAMIC);
+    vector<FEBodyForce*> bf;
+    
     // calculate the stiffness matrix for each domain
     for (int i=0; i<mesh.Domains(); ++i)
     {
@@ -1134,8 +1151,9 @@ bool FEFluidFSISolver::StiffnessMatrix()
             FEFluidDomain* fdom = dynamic_cast<FEFluidDomain*>(&dom);
             FEFluidFSIDomain* fsidom = dynamic_cast<FEFluidFSIDomain*>(&dom);
             FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(&dom);
-            if (fdom) fdom->StiffnessMatrix(LS, tp);
-            else if (fsidom) fsidom->StiffnessMatrix(LS, tp);
+            if (fdom || fsidom) FindBodyForces(fem, dom, bf);
+            if (fdom) fdom->FusedStiffnessMatrix(LS, tp, bf, bmass);
+            else if (fsidom) fsidom->FusedStiffnessMatrix(LS, tp, bf, bmass);
             else if (edom) edom->StiffnessMatrix(LS);
         }
     }
@@ -1156,9 +1174,8 @@ bool FEFluidFSISolver::StiffnessMatrix()
 					FEFluidDomain* fdom = dynamic_cast<FEFluidDomain*>(dom);
 					FEFluidFSIDomain* fsidom = dynamic_cast<FEFluidFSIDomain*>(dom);
 					FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(dom);
-					if (fdom) fdom->BodyForceStiffness(LS, tp, *pbf);
-					else if (fsidom) fsidom->BodyForceStiffness(LS, tp, *pbf);
-					else if (edom)
+					// fluid domains were evaluated in the fused element loop
+					if ((fdom == nullptr) && (fsidom == nullptr) && edom)
 					{
 						FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom->GetMaterial());
 						if (mat && (mat->IsRigid()==false)) edom->BodyForceStiffness(LS, *pbf);
@@ -1186,9 +1203,8 @@ bool FEFluidFSISolver::StiffnessMatrix()
 				FEFluidDomain* fdom = dynamic_cast<FEFluidDomain*>(&dom);
 				FEFluidFSIDomain* fsidom = dynamic_cast<FEFluidFSIDomain*>(&dom);
 				FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(&dom);
-				if (fdom) fdom->MassMatrix(LS, tp);
-				else if (fsidom) fsidom->MassMatrix(LS, tp);
-				else if (edom)
+				// fluid domains were evaluated in the fused element loop
+				if ((fdom == nullptr) && (fsidom == nullptr) && edom)
 				{
 					FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
 					if (mat && (mat->IsRigid() == false)) edom->MassMatrix(LS, a);
@@ -1319,6 +1335,10 @@ bool FEFluidFSISolver::Residual(vector<double>& R)
         }
     }
     
+    // fluid domains add their body and inertial forces
+    // in the same pass over the elements as the internal forces
+    vector<FEBodyForce*> bf;
+    
     // calculate the internal (stress) forces
     for (int i=0; i<mesh.Domains(); ++i)
     {
@@ -1328,8 +1348,9 @@ bool FEFluidFSISolver::Residual(vector<double>& R)
 			FEFluidDomain* fdom = dynamic_cast<FEFluidDomain*>(&dom);
 			FEFluidFSIDomain* fsidom = dynamic_cast<FEFluidFSIDomain*>(&dom);
 			FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(&dom);
-			if (fdom) fdom->InternalForces(RHS, tp);
-			else if (fsidom) fsidom->InternalForces(RHS, tp);
+			if (fdom || fsidom) FindBodyForces(fem, dom, bf);
+			if (fdom) fdom->FusedResidual(RHS, tp, bf, true);
+			else if (fsidom) fsidom->FusedResidual(RHS, tp, bf, true);
 			else if (edom)
 			{
 				FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
@@ -1352,9 +1373,8 @@ bool FEFluidFSISolver::Residual(vector<double>& R)
 					FEFluidDomain* fdom = dynamic_cast<FEFluidDomain*>(dom);
 					FEFluidFSIDomain* fsidom = dynamic_cast<FEFluidFSIDomain*>(dom);
 					FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(dom);
-					if (fdom) fdom->BodyForce(RHS, tp, *pbf);
-					else if (fsidom) fsidom->BodyForce(RHS, tp, *pbf);
-					else if (edom)
+					// fluid domains were evaluated in the fused element loop
+					if ((fdom == nullptr) && (fsidom == nullptr) && edom)
 					{
 						FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom->GetMaterial());
 						if (mat && (mat->IsRigid()==false)) edom->BodyForce(RHS, *pbf);
@@ -1384,9 +1404,8 @@ bool FEFluidFSISolver::Residual(vector<double>& R)
 			FEFluidDomain* fdom = dynamic_cast<FEFluidDomain*>(&dom);
 			FEFluidFSIDomain* fsidom = dynamic_cast<FEFluidFSIDomain*>(&dom);
 			FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(&dom);
-			if (fdom) fdom->InertialForces(RHS, tp);
-			else if (fsidom) fsidom->InertialForces(RHS, tp);
-			else if (edom && (pstep->m_nanalysis == FE_DYNAMIC))
+			// fluid domains were evaluated in the fused element loop
+			if ((fdom == nullptr) && (fsidom == nullptr) && edom && (pstep->m_nanalysis == FE_DYNAMIC))
 			{
 				FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
 				if (mat && (mat->IsRigid()==false)) edom->InertialForces(RHS, F);
@@ -693,6 +693,91 @@ void FEFluidSolutesDomain3D::BodyForceStiffness(FELinearSystem& LS, const FETime
     }
 }
 
+//-----------------------------------------------------------------------------
+//! The element stiffness, body force stiffness and mass matrices are evaluated
+//! one element at a time and the combined matrix is assembled once. This way
+//! the element and material point data are still in cache for each contribution.
+void FEFluidSolutesDomain3D::FusedStiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool bmass)
+{
+    int nsol = m_pMat->Solutes();
+    int NE = (int)m_Elem.size();
+    int NBF = (int)bf.size();
+#pragma omp parallel shared(NE, NBF)
+    {
+        vector<int> lm;
+        
+#pragma omp for
+        for (int iel=0; iel<NE; ++iel)
+        {
+            FESolidElement& el = m_Elem[iel];
+            
+            // element stiffness matrix
+            FEElementMatrix ke(el);
+            
+            // create the element's stiffness matrix
+            int ndof = (4+nsol)*el.Nodes();
+            ke.resize(ndof, ndof);
+            ke.zero();
+            
+            // calculate material stiffness
+            ElementStiffness(el, ke, tp);
+            
+            // add body force stiffness
+            for (int j=0; j<NBF; ++j) ElementBodyForceStiffness(*bf[j], el, ke, tp);
+            
+            // add inertial stiffness
+            if (bmass) ElementMassMatrix(el, ke, tp);
+            
+            // get the element's LM vector
+            UnpackLM(el, lm);
+            ke.SetIndices(lm);
+            
+            // assemble element matrix in global stiffness matrix
+            LS.Assemble(ke);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//! The element internal, body and inertial forces are evaluated one element at
+//! a time and the combined vector is assembled once.
+void FEFluidSolutesDomain3D::FusedResidual(FEGlobalVector& R, const FETimeInfo& tp, const vector<FEBodyForce*>& bf, bool binertial)
+{
+    int nsol = m_pMat->Solutes();
+    int NE = (int)m_Elem.size();
+    int NBF = (int)bf.size();
+#pragma omp parallel shared(NE, NBF)
+    {
+        vector<double> fe;
+        vector<int> lm;
+        
+#pragma omp for
+        for (int i=0; i<NE; ++i)
+        {
+            FESolidElement& el = m_Elem[i];
+            
+            // get the element force vector and initialize it to zero
+            int ndof = (4+nsol)*el.Nodes();
+            fe.assign(ndof, 0);
+            
+            // calculate internal force vector
+            ElementInternalForce(el, fe, tp);
+            
+            // apply body forces
+            for (int j=0; j<NBF; ++j) ElementBodyForce(*bf[j], el, fe, tp);
+            
+            // add inertial forces
+            if (binertial) ElementInertialForce(el, fe, tp);
+            
+            // get the element's LM vector
+            UnpackLM(el, lm);
+            
+            // assemble element 'fe'-vector into global R vector
+            R.Assemble(el.m_node, lm, fe);
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 //! calculates element inertial stiffness matrix
 void FEFluidSolutesDomain3D::ElementMassMatrix(FESolidElement& el, matrix& ke, const FETimeInfo& tp)
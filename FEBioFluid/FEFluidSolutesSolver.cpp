@@ -51,6 +51,7 @@ SOFTWARE.*/
 #include <FECore/FEAnalysis.h>
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FETelemetry.h>
 #include "FEBioFluidSolutes.h"
 
 //-----------------------------------------------------------------------------
@@ -882,6 +883,16 @@ bool FEFluidSolutesSolver::Quasin()
             feLogWarning("No force acting on the system.");
             bconv = true;
         }
+
+        // write the convergence telemetry
+        if (GetFEModel()->GetTelemetry().IsOpen())
+        {
+            AddTelemetryNorm("residual", normRi, normR1, m_Rtol*normRi);
+            AddTelemetryNorm("energy", normEi, normE1, m_Etol*normEi);
+            AddTelemetryNorm("velocity", normVi, normv, (m_Vtol*m_Vtol)*normV);
+            AddTelemetryNorm("dilatation", normDi, normd, (m_Ftol*m_Ftol)*normD);
+            WriteIterationTelemetry(s, bconv);
+        }
         
         // see if we have exceeded the max residual
         if ((bconv == false) && (m_Rmax > 0) && (normR1 >= m_Rmax))
@@ -969,26 +980,14 @@ bool FEFluidSolutesSolver::StiffnessMatrix(FELinearSystem& LS)
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
     
-    // calculate the stiffness matrix for each domain
+    // calculate the stiffness, body force stiffness and mass matrix
+    // for each domain in a single pass over its elements
+    vector<FEBodyForce*> bf;
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.StiffnessMatrix(LS, tp);
-    }
-    
-    // calculate the body force stiffness matrix for each domain
-    int NBL = fem.BodyLoads();
-    for (int j = 0; j<NBL; ++j)
-    {
-        FEBodyForce* pbf = dynamic_cast<FEBodyForce*>(fem.GetBodyLoad(j));
-        if (pbf && pbf->IsActive())
-        {
-            for (int i = 0; i<pbf->Domains(); ++i)
-            {
-                FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(*pbf->Domain(i));
-                dom.BodyForceStiffness(LS, tp, *pbf);
-            }
-        }
+        FindBodyForces(fem, mesh.Domain(i), bf);
+        dom.FusedStiffnessMatrix(LS, tp, bf, true);
     }
     
     // calculate contact stiffness
@@ -1002,14 +1001,6 @@ bool FEFluidSolutesSolver::StiffnessMatrix(FELinearSystem& LS)
         if (psl->IsActive()) psl->StiffnessMatrix(LS, tp);
     }
     
-    // Add mass matrix
-    // loop over all domains
-    for (int i=0; i<mesh.Domains(); ++i)
-    {
-        FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.MassMatrix(LS, tp);
-    }
-    
     // calculate nonlinear constraint stiffness
     // note that this is the contribution of the
     // constrainst enforced with augmented lagrangian
@@ -1086,32 +1077,14 @@ bool FEFluidSolutesSolver::Residual(vector<double>& R)
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
     
-    // calculate the internal (stress) forces
-    for (int i=0; i<mesh.Domains(); ++i)
-    {
-        FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.InternalForces(RHS, tp);
-    }
-    
-    // calculate the body forces
-    for (int j = 0; j<fem.BodyLoads(); ++j)
-    {
-        FEBodyForce* pbf = dynamic_cast<FEBodyForce*>(fem.GetBodyLoad(j));
-        if (pbf && pbf->IsActive())
-        {
-            for (int i = 0; i<pbf->Domains(); ++i)
-            {
-                FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(*pbf->Domain(i));
-                dom.BodyForce(RHS, tp, *pbf);
-            }
-        }
-    }
-    
-    // calculate inertial forces
+    // calculate the internal (stress), body and inertial forces
+    // for each domain in a single pass over its elements
+    vector<FEBodyForce*> bf;
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.InertialForces(RHS, tp);
+        FindBodyForces(fem, mesh.Domain(i), bf);
+        dom.FusedResidual(RHS, tp, bf, true);
     }
     
     // calculate forces due to surface loads
@@ -52,6 +52,7 @@ SOFTWARE.*/
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/FELinearSystem.h>
 #include "FEBioFluid.h"
+#include <FECore/FETelemetry.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -657,6 +658,8 @@ bool FEFluidSolver::Quasin()
 		feLog("\tstiffness updates             = %d\n", m_qnstrategy->m_nups);
         feLog("\tright hand side evaluations   = %d\n", m_nrhs);
         feLog("\tstiffness matrix reformations = %d\n", m_nref);
+        LogLinearSolverIterations();
+        LogElementWorkspaceAllocations();
 		if (m_lineSearch->m_LStol > 0) feLog("\tstep from line search         = %lf\n", s);
         feLog("\tconvergence norms :     INITIAL         CURRENT         REQUIRED\n");
         feLog("\t   residual         %15le %15le %15le \n", normRi, normR1, m_Rtol*normRi);
@@ -672,6 +675,16 @@ bool FEFluidSolver::Quasin()
             feLogWarning("No force acting on the system.");
             bconv = true;
         }
+
+        // write the convergence telemetry
+        if (GetFEModel()->GetTelemetry().IsOpen())
+        {
+            AddTelemetryNorm("residual", normRi, normR1, m_Rtol*normRi);
+            AddTelemetryNorm("energy", normEi, normE1, m_Etol*normEi);
+            AddTelemetryNorm("velocity", normVi, normv, (m_Vtol*m_Vtol)*normV);
+            AddTelemetryNorm("dilatation", normDi, normd, (m_Ftol*m_Ftol)*normD);
+            WriteIterationTelemetry(s, bconv);
+        }
         
 		// see if we have exceeded the max residual
 		if ((bconv == false) && (m_Rmax > 0) && (normR1 >= m_Rmax))
@@ -744,26 +757,14 @@ bool FEFluidSolver::StiffnessMatrix(FELinearSystem& LS)
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
     
-    // calculate the stiffness matrix for each domain
+    // calculate the stiffness, body force stiffness and mass matrix
+    // for each domain in a single pass over its elements
+    vector<FEBodyForce*> bf;
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.StiffnessMatrix(LS, tp);
-    }
-    
-    // calculate the body force stiffness matrix for each domain
-	int NBL = fem.BodyLoads();
-	for (int j = 0; j<NBL; ++j)
-	{
-		FEBodyForce* pbf = dynamic_cast<FEBodyForce*>(fem.GetBodyLoad(j));
-		if (pbf && pbf->IsActive())
-		{
-			for (int i = 0; i<pbf->Domains(); ++i)
-			{
-				FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(*pbf->Domain(i));
-				dom.BodyForceStiffness(LS, tp, *pbf);
-			}
-        }
+        FindBodyForces(fem, mesh.Domain(i), bf);
+        dom.FusedStiffnessMatrix(LS, tp, bf, true);
     }
     
     // calculate contact stiffness
@@ -777,14 +778,6 @@ bool FEFluidSolver::StiffnessMatrix(FELinearSystem& LS)
         if (psl->IsActive() && HasActiveDofs(psl->GetDofList())) psl->StiffnessMatrix(LS, tp);
     }
     
-    // Add mass matrix
-    // loop over all domains
-    for (int i=0; i<mesh.Domains(); ++i)
-    {
-        FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.MassMatrix(LS, tp);
-    }
-    
     // calculate nonlinear constraint stiffness
     // note that this is the contribution of the
     // constrainst enforced with augmented lagrangian
@@ -861,32 +854,14 @@ bool FEFluidSolver::Residual(vector<double>& R)
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
     
-    // calculate the internal (stress) forces
-    for (int i=0; i<mesh.Domains(); ++i)
-    {
-        FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.InternalForces(RHS, tp);
-    }
-    
-    // calculate the body forces
-	for (int j = 0; j<fem.BodyLoads(); ++j)
-	{
-		FEBodyForce* pbf = dynamic_cast<FEBodyForce*>(fem.GetBodyLoad(j));
-		if (pbf && pbf->IsActive())
-		{
-			for (int i = 0; i<pbf->Domains(); ++i)
-			{
-				FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(*pbf->Domain(i));
-				dom.BodyForce(RHS, tp, *pbf);
-			}
-        }
-    }
-    
-    // calculate inertial forces
+    // calculate the internal (stress), body and inertial forces
+    // for each domain in a single pass over its elements
+    vector<FEBodyForce*> bf;
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.InertialForces(RHS, tp);
+        FindBodyForces(fem, mesh.Domain(i), bf);
+        dom.FusedResidual(RHS, tp, bf, true);
     }
 
     // calculate forces due to surface loads
@@ -39,6 +39,7 @@ SOFTWARE.*/
 #include <FECore/FEAnalysis.h>
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FETelemetry.h>
 #include "FEBioFluidSolutes.h"
 #include <assert.h>
 
@@ -639,6 +640,14 @@ bool FESolutesSolver::Quasin()
             feLogWarning("No force acting on the system.");
             bconv = true;
         }
+
+        // write the convergence telemetry
+        if (GetFEModel()->GetTelemetry().IsOpen())
+        {
+            AddTelemetryNorm("residual", normRi, normR1, m_Rtol*normRi);
+            AddTelemetryNorm("energy", normEi, normE1, m_Etol*normEi);
+            WriteIterationTelemetry(s, bconv);
+        }
         
         // see if we have exceeded the max residual
         if ((bconv == false) && (m_Rmax > 0) && (normR1 >= m_Rmax))
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FEThermoFluidSolver.h"
 #include "FEThermoFluidDomain.h"
+#include "FEFluidDomain.h"
 #include "FEFluidResidualVector.h"
 #include <FECore/FEModel.h>
 #include <FECore/log.h>
@@ -52,6 +53,7 @@ SOFTWARE.*/
 #include <FECore/FEAnalysis.h>
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FETelemetry.h>
 #include "FEBioThermoFluid.h"
 
 //-----------------------------------------------------------------------------
@@ -739,6 +741,17 @@ bool FEThermoFluidSolver::Quasin()
             feLogWarning("No force acting on the system.");
             bconv = true;
         }
+
+        // write the convergence telemetry
+        if (GetFEModel()->GetTelemetry().IsOpen())
+        {
+            AddTelemetryNorm("residual", normRi, normR1, m_Rtol*normRi);
+            AddTelemetryNorm("energy", normEi, normE1, m_Etol*normEi);
+            AddTelemetryNorm("velocity", normVi, normv, (m_Vtol*m_Vtol)*normV);
+            AddTelemetryNorm("dilatation", normDi, normd, (m_Ftol*m_Ftol)*normD);
+            AddTelemetryNorm("temperature", normTi, normt, (m_Ttol*m_Ttol)*normT);
+            WriteIterationTelemetry(s, bconv);
+        }
         
         // see if we have exceeded the max residual
         if ((bconv == false) && (m_Rmax > 0) && (normR1 >= m_Rmax))
@@ -812,28 +825,22 @@ bool FEThermoFluidSolver::StiffnessMatrix(FELinearSystem& LS)
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
     
-    // calculate the stiffness matrix for each domain
+    // calculate the stiffness, body force stiffness and mass matrix
+    // for each domain in a single pass over its elements
+    vector<FEBodyForce*> bf;
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEThermoFluidDomain& dom = dynamic_cast<FEThermoFluidDomain&>(mesh.Domain(i));
-        dom.StiffnessMatrix(LS, tp);
+        FindBodyForces(fem, mesh.Domain(i), bf);
+        dom.FusedStiffnessMatrix(LS, tp, bf, true);
     }
     
-    // calculate the body force stiffness matrix for each domain
+    // calculate the heat supply stiffness matrix for each domain
     int NBL = fem.BodyLoads();
     for (int j = 0; j<NBL; ++j)
     {
-        FEBodyForce* pbf = dynamic_cast<FEBodyForce*>(fem.GetBodyLoad(j));
         FEFluidHeatSupply* phs = dynamic_cast<FEFluidHeatSupply*>(fem.GetBodyLoad(j));
-        if (pbf && pbf->IsActive())
-        {
-            for (int i = 0; i<pbf->Domains(); ++i)
-            {
-                FEThermoFluidDomain& dom = dynamic_cast<FEThermoFluidDomain&>(*pbf->Domain(i));
-                dom.BodyForceStiffness(LS, tp, *pbf);
-            }
-        }
-        else if (phs && phs->IsActive())
+        if (phs && phs->IsActive())
         {
             for (int i = 0; i<phs->Domains(); ++i)
             {
@@ -854,14 +861,6 @@ bool FEThermoFluidSolver::StiffnessMatrix(FELinearSystem& LS)
         if (psl->IsActive() && HasActiveDofs(psl->GetDofList())) psl->StiffnessMatrix(LS, tp);
     }
     
-    // Add mass matrix
-    // loop over all domains
-    for (int i=0; i<mesh.Domains(); ++i)
-    {
-        FEThermoFluidDomain& dom = dynamic_cast<FEThermoFluidDomain&>(mesh.Domain(i));
-        dom.MassMatrix(LS, tp);
-    }
-    
     // calculate nonlinear constraint stiffness
     // note that this is the contribution of the
     // constrainst enforced with augmented lagrangian
@@ -938,27 +937,21 @@ bool FEThermoFluidSolver::Residual(vector<double>& R)
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
     
-    // calculate the internal (stress) forces
+    // calculate the internal (stress), body and inertial forces
+    // for each domain in a single pass over its elements
+    vector<FEBodyForce*> bf;
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEThermoFluidDomain& dom = dynamic_cast<FEThermoFluidDomain&>(mesh.Domain(i));
-        dom.InternalForces(RHS, tp);
+        FindBodyForces(fem, mesh.Domain(i), bf);
+        dom.FusedResidual(RHS, tp, bf, true);
     }
     
-    // calculate the body forces
+    // calculate the heat supplies
     for (int j = 0; j<fem.BodyLoads(); ++j)
     {
-        FEBodyForce* pbf = dynamic_cast<FEBodyForce*>(fem.GetBodyLoad(j));
         FEFluidHeatSupply* phs = dynamic_cast<FEFluidHeatSupply*>(fem.GetBodyLoad(j));
-        if (pbf && pbf->IsActive())
-        {
-            for (int i = 0; i<pbf->Domains(); ++i)
-            {
-                FEThermoFluidDomain& dom = dynamic_cast<FEThermoFluidDomain&>(*pbf->Domain(i));
-                dom.BodyForce(RHS, tp, *pbf);
-            }
-        }
-        else if (phs && phs->IsActive())
+        if (phs && phs->IsActive())
         {
             for (int i = 0; i<phs->Domains(); ++i)
             {
@@ -968,13 +961,6 @@ bool FEThermoFluidSolver::Residual(vector<double>& R)
         }
     }
     
-    // calculate inertial forces
-    for (int i=0; i<mesh.Domains(); ++i)
-    {
-        FEThermoFluidDomain& dom = dynamic_cast<FEThermoFluidDomain&>(mesh.Domain(i));
-        dom.InertialForces(RHS, tp);
-    }
-
     // calculate forces due to surface loads
     int nsl = fem.SurfaceLoads();
     for (int i=0; i<nsl; ++i)
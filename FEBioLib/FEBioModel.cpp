@@ -44,6 +44,7 @@ SOFTWARE.*/
 #include <FECore/LinearSolver.h>
 #include <FECore/FEDomain.h>
 #include <FECore/FEMaterial.h>
+#include <FECore/FETelemetry.h>
 #include "febio.h"
 #include "version.h"
 #include <iostream>
@@ -253,6 +254,13 @@ void FEBioModel::SetDumpFilename(const std::string& sfile)
 	m_sdump = sfile;
 }
 
+//-----------------------------------------------------------------------------
+//! Set the name of the convergence telemetry file
+void FEBioModel::SetTelemetryFilename(const std::string& sfile)
+{
+	m_stelemetry = sfile;
+}
+
 //-----------------------------------------------------------------------------
 //! Return the name of the input file
 const std::string& FEBioModel::GetInputFileName()
@@ -281,6 +289,13 @@ const std::string& FEBioModel::GetDumpFileName()
 	return	m_sdump;
 }
 
+//-----------------------------------------------------------------------------
+//! Return the convergence telemetry file name.
+const std::string& FEBioModel::GetTelemetryFileName()
+{
+	return m_stelemetry;
+}
+
 //-----------------------------------------------------------------------------
 //! get the file title (i.e. name of input file without the path)
 const std::string& FEBioModel::GetFileTitle()
@@ -872,6 +887,17 @@ bool FEBioModel::Init()
 		if (InitLogFile() == false) return false;
 	}
 
+	// open the convergence telemetry file
+	FETelemetry& tlm = GetTelemetry();
+	if ((m_stelemetry.empty() == false) && (tlm.IsOpen() == false))
+	{
+		if (tlm.Open(m_stelemetry.c_str()) == false)
+		{
+			feLogError("Failed creating telemetry file");
+			return false;
+		}
+	}
+
 	// open plot database file
 	FEAnalysis* step = GetCurrentStep();
 	if (step->GetPlotLevel() != FE_PLOT_NEVER)
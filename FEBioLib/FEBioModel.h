@@ -141,12 +141,14 @@ public: // --- I/O functions ---
 	void SetLogFilename  (const std::string& sfile);
 	void SetPlotFilename (const std::string& sfile);
 	void SetDumpFilename (const std::string& sfile);
+	void SetTelemetryFilename(const std::string& sfile);
 
 	//! Get the I/O file names
 	const std::string& GetInputFileName();
 	const std::string& GetLogfileName  ();
 	const std::string& GetPlotFileName ();
 	const std::string& GetDumpFileName ();
+	const std::string& GetTelemetryFileName();
 
 	//! get the file title
 	const std::string& GetFileTitle();
@@ -216,6 +218,7 @@ protected: // file names
 	std::string		m_splot;			//!< plot output file name
 	std::string		m_slog ;			//!< log output file name
 	std::string		m_sdump;			//!< dump file name
+	std::string		m_stelemetry;		//!< convergence telemetry file name (empty = no telemetry)
 
 	std::string	m_title;	//!< model title
 
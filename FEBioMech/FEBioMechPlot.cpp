@@ -2800,40 +2800,39 @@ bool FEPlotSPRPreStrainCorrection::Save(FEDomain& dom, FEDataStream& a)
 	int NE = sd.Elements();
 
 	// build the element data array
-	vector< vector<double> > ED;
-	ED.resize(NE);
-	for (int i = 0; i<NE; ++i)
+	vector< vector< vector<double> > > ED(9);
+	for (int n = 0; n<9; ++n)
 	{
-		FESolidElement& e = sd.Element(i);
-		int nint = e.GaussPoints();
-		ED[i].assign(nint, 0.0);
+		ED[n].resize(NE);
+		for (int i = 0; i<NE; ++i)
+		{
+			FESolidElement& e = sd.Element(i);
+			int nint = e.GaussPoints();
+			ED[n][i].assign(nint, 0.0);
+		}
 	}
 
 	// this array will store the results
 	FESPRProjection map;
-	vector<double> val[9];
+	vector< vector<double> > val;
 
-	// loop over stress components
-	for (int n = 0; n<9; ++n)
+	// fill the ED array
+	for (int i = 0; i<NE; ++i)
 	{
-		// fill the ED array
-		for (int i = 0; i<NE; ++i)
+		FESolidElement& el = sd.Element(i);
+		int nint = el.GaussPoints();
+		for (int j = 0; j<nint; ++j)
 		{
-			FESolidElement& el = sd.Element(i);
-			int nint = el.GaussPoints();
-			for (int j = 0; j<nint; ++j)
-			{
-				FEMaterialPoint& mp = *el.GetMaterialPoint(j)->GetPointData(0);
-				FEPrestrainMaterialPoint& pt = *mp.ExtractData<FEPrestrainMaterialPoint>();
-				const mat3d& F = pt.PrestrainCorrection();
-				ED[i][j] = F(LUT[n][0], LUT[n][1]);
-			}
+			FEMaterialPoint& mp = *el.GetMaterialPoint(j)->GetPointData(0);
+			FEPrestrainMaterialPoint& pt = *mp.ExtractData<FEPrestrainMaterialPoint>();
+			const mat3d& F = pt.PrestrainCorrection();
+			for (int n = 0; n<9; ++n) ED[n][i][j] = F(LUT[n][0], LUT[n][1]);
 		}
-
-		// project to nodes
-		map.Project(sd, ED, val[n]);
 	}
 
+	// project all stress components to nodes
+	map.Project(sd, ED, val);
+
 	// copy results to archive
 	for (int i = 0; i<NN; ++i)
 	{
@@ -2871,18 +2870,21 @@ bool FEPlotPreStrainCompatibility::Save(FEDomain& dom, FEDataStream& a)
 	// STEP 1 - first we do an SPR recovery of the pre-strain gradient
 
 	// build the element data array
-	vector< vector<double> > ED;
-	ED.resize(NE);
-	for (int i = 0; i<NE; ++i)
+	vector< vector< vector<double> > > ED(9);
+	for (int n = 0; n<9; ++n)
 	{
-		FESolidElement& e = sd.Element(i);
-		int nint = e.GaussPoints();
-		ED[i].assign(nint, 0.0);
+		ED[n].resize(NE);
+		for (int i = 0; i<NE; ++i)
+		{
+			FESolidElement& e = sd.Element(i);
+			int nint = e.GaussPoints();
+			ED[n][i].assign(nint, 0.0);
+		}
 	}
 
 	// this array will store the results
 	FESPRProjection map;
-	vector<double> val[9];
+	vector< vector<double> > val;
 
 	// create a global-to-local node list
 	FEMesh& mesh = *dom.GetMesh();
@@ -2898,27 +2900,23 @@ bool FEPlotPreStrainCompatibility::Save(FEDomain& dom, FEDataStream& a)
 		}
 	}
 
-	// loop over tensor components
-	for (int n = 0; n<9; ++n)
+	// fill the ED array
+	for (int i = 0; i<NE; ++i)
 	{
-		// fill the ED array
-		for (int i = 0; i<NE; ++i)
+		FESolidElement& el = sd.Element(i);
+		int nint = el.GaussPoints();
+		for (int j = 0; j<nint; ++j)
 		{
-			FESolidElement& el = sd.Element(i);
-			int nint = el.GaussPoints();
-			for (int j = 0; j<nint; ++j)
-			{
-				FEMaterialPoint& mp = *el.GetMaterialPoint(j)->GetPointData(0);
-				FEPrestrainMaterialPoint& pt = *mp.ExtractData<FEPrestrainMaterialPoint>();
-				mat3d Fp = pt.prestrain();
-				ED[i][j] = Fp(LUT[n][0], LUT[n][1]);
-			}
+			FEMaterialPoint& mp = *el.GetMaterialPoint(j)->GetPointData(0);
+			FEPrestrainMaterialPoint& pt = *mp.ExtractData<FEPrestrainMaterialPoint>();
+			mat3d Fp = pt.prestrain();
+			for (int n = 0; n<9; ++n) ED[n][i][j] = Fp(LUT[n][0], LUT[n][1]);
 		}
-
-		// project to nodes
-		map.Project(sd, ED, val[n]);
 	}
 
+	// project all tensor components to nodes
+	map.Project(sd, ED, val);
+
 	// STEP 2 - now we calculate the gradient of the nodal values at the integration points
 	vector<double> vn(FEElement::MAX_NODES);
 	for (int i = 0; i<NE; ++i)
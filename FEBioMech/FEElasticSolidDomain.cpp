@@ -36,6 +36,13 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioMech.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementWorkspace.h>
+#include <FECore/tens4ds_batch.h>
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(FEElasticSolidDomain, FESolidDomain)
+	ADD_PARAMETER(m_bcacheTangent, "cache_tangent");
+END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -47,6 +54,7 @@ FEElasticSolidDomain::FEElasticSolidDomain(FEModel* pfem) : FESolidDomain(pfem),
     m_alphaf = m_beta = 1;
     m_alpham = 2;
 	m_update_dynamic = true; // default for backward compatibility
+	m_bcacheTangent = false;
 
 	// TODO: Move this elsewhere since there is no error checking
 	m_dofU.AddVariable(FEBioMech::GetVariableName(FEBioMech::DISPLACEMENT));
@@ -80,6 +88,28 @@ void FEElasticSolidDomain::SetDynamicUpdateFlag(bool b)
 	m_update_dynamic = b;
 }
 
+//-----------------------------------------------------------------------------
+//! Set flag for caching the material tangent at the integration points
+void FEElasticSolidDomain::SetTangentCaching(bool b)
+{
+	m_bcacheTangent = b;
+	if (b == false)
+	{
+		m_Ct.clear();
+		m_Ctoff.clear();
+		m_Ctvalid.clear();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! The cache is only used once it has been allocated (in PreSolveUpdate). It is not
+//! used with the secant tangent, or when the stress is adjusted for energy conservation
+//! after it is evaluated (alpha_f = 0.5), since then the tangent depends on the adjusted stress.
+bool FEElasticSolidDomain::UseTangentCache() const
+{
+	return (m_bcacheTangent && (m_Ctvalid.size() == m_Elem.size()) && (m_pMat->m_secant == false) && (m_alphaf != 0.5));
+}
+
 //-----------------------------------------------------------------------------
 //! Assign material
 void FEElasticSolidDomain::SetMaterial(FEMaterial* pmat)
@@ -134,6 +164,25 @@ void FEElasticSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
     m_alpham = timeInfo.alpham;
     m_beta = timeInfo.beta;
 
+	// allocate the tangent cache and invalidate it, since the material points are reset below
+	if (m_bcacheTangent)
+	{
+		if (m_Ctvalid.size() != m_Elem.size())
+		{
+			int NE = Elements();
+			m_Ctoff.resize(NE);
+			int nsize = 0;
+			for (int i = 0; i < NE; ++i)
+			{
+				m_Ctoff[i] = nsize;
+				nsize += m_Elem[i].GaussPoints();
+			}
+			m_Ct.resize(nsize);
+			m_Ctvalid.resize(NE);
+		}
+		m_Ctvalid.assign(m_Ctvalid.size(), 0);
+	}
+
 	vec3d r0, rt;
 	for (size_t i=0; i<Elements(); ++i)
 	{
@@ -157,6 +206,7 @@ void FEElasticSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 {
 	int NE = Elements();
+	m_ws.Prepare();
 	#pragma omp parallel for shared (NE)
 	for (int i=0; i<NE; ++i)
 	{
@@ -164,13 +214,12 @@ void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 		FESolidElement& el = m_Elem[i];
 
 		if (el.isActive()) {
-			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+			FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
 
 			// get the element force vector and initialize it to zero
 			int ndof = 3 * el.Nodes();
-			fe.assign(ndof, 0);
+			vector<double>& fe = ws.ElementVector(ndof);
+			vector<int>& lm = ws.LM();
 
 			// calculate internal force vector
 			ElementInternalForce(el, fe);
@@ -340,6 +389,38 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	// weights at gauss points
 	const double *gw = el.GaussWeights();
 
+	// see if we can use the cached tangents
+	int iel = el.GetLocalID();
+	bool bcache = UseTangentCache() && m_Ctvalid[iel];
+
+	// otherwise, evaluate the tangents at all integration points at once
+	const int NINT = FEElement::MAX_INTPOINTS;
+	tens4ds Cn[NINT];
+	if ((bcache == false) && (m_pMat->m_secant == false))
+	{
+		FEMaterialPoint* mpp[NINT];
+		for (int n = 0; n<nint; ++n) mpp[n] = el.GetMaterialPoint(n);
+		m_pMat->EvaluateBatch(mpp, nint, nullptr, Cn);
+	}
+
+	// With spatial tangents, the contraction with the shape function gradients is 
+	// done for all integration points at once by the batch kernel.
+	if (m_pMat->m_secant == false)
+	{
+		const int L = tens4ds_batch::LANES;
+		double cbuf[tens4ds_batch::NNZ*((NINT + L - 1)/L)*L];
+		tens4ds_batch Cb(nint, cbuf);
+		vec3d Gn[NINT*FEElement::MAX_NODES];
+		double wn[NINT];
+		for (int n = 0; n<nint; ++n)
+		{
+			wn[n] = ShapeGradient(el, n, &Gn[n*neln], m_alphaf)*gw[n]*m_alphaf;
+			Cb.set(n, (bcache ? m_Ct[m_Ctoff[iel] + n] : Cn[n]));
+		}
+		add_material_stiffness(Cb, Gn, wn, neln, ke);
+		return;
+	}
+
 	// calculate element stiffness matrix
 	for (int n=0; n<nint; ++n)
 	{
@@ -352,8 +433,13 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 
 		// get the 'D' matrix
 //		tens4ds C = m_pMat->Tangent(mp);
-        tens4dmm C = m_pMat->m_secant ? m_pMat->SecantTangent(mp) : m_pMat->Tangent(mp);
-		C.extract(D);
+		if (bcache) m_Ct[m_Ctoff[iel] + n].extract(D);
+		else if (m_pMat->m_secant)
+		{
+			tens4dmm C = m_pMat->SecantTangent(mp);
+			C.extract(D);
+		}
+		else Cn[n].extract(D);
 
 		// we only calculate the upper triangular part
 		// since ke is symmetric. The other part is
@@ -416,6 +502,7 @@ void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 {
 	// repeat over all solid elements
 	int NE = Elements();
+	m_ws.Prepare();
 	
 	#pragma omp parallel for shared (NE)
 	for (int iel=0; iel<NE; ++iel)
@@ -423,18 +510,16 @@ void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
 		if (el.isActive()) {
+			FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
 
 			// get the element's LM vector
-			vector<int> lm;
+			vector<int>& lm = ws.LM();
 			UnpackLM(el, lm);
 
 			// element stiffness matrix
-			FEElementMatrix ke(el, lm);
-
-			// create the element's stiffness matrix
 			int ndof = 3 * el.Nodes();
-			ke.resize(ndof, ndof);
-			ke.zero();
+			FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
+			ke.SetIndices(lm);
 
 			// calculate geometrical stiffness
 			ElementGeometricalStiffness(el, ke);
@@ -606,12 +691,20 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
 		}
 	}
 
-	// loop over the integration points and calculate
-	// the stress at the integration point
+	// see if we need to update the tangent cache
+	bool bcache = UseTangentCache();
+	if (bcache) m_Ctvalid[iel] = 0;
+
+	// loop over the integration points and update the kinematics
+	const int NINT = FEElement::MAX_INTPOINTS;
+	FEMaterialPoint* mpp[NINT];
+	mat3d Ftn[NINT];
+	double Jtn[NINT];
 	for (int n=0; n<nint; ++n)
 	{
 		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
 		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		mpp[n] = &mp;
 
 		// material point coordinates
 		pt.m_rt = el.Evaluate(r, n);
@@ -621,6 +714,8 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
         mat3d Ft, Fp;
         Jt = defgrad(el, Ft, n);
         defgradp(el, Fp, n);
+		Ftn[n] = Ft;
+		Jtn[n] = Jt;
 
 		if (m_alphaf == 1.0)
 		{
@@ -643,17 +738,25 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
 
         // update specialized material points
         m_pMat->UpdateSpecializedMaterialPoints(mp, tp);
-        
-		// calculate the stress at this material point
-        pt.m_s = m_pMat->Stress(mp);
-        
+	}
+
+	// calculate the stresses (and tangents) at all integration points
+	mat3ds s[NINT];
+	m_pMat->EvaluateBatch(mpp, nint, s, (bcache ? &m_Ct[m_Ctoff[iel]] : nullptr));
+
+	for (int n=0; n<nint; ++n)
+	{
+		FEMaterialPoint& mp = *mpp[n];
+		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		pt.m_s = s[n];
+
         // adjust stress for strain energy conservation
         if (m_alphaf == 0.5) 
 		{
 			// evaluate strain energy at current time
 			FEElasticMaterialPoint et = pt;
-			et.m_F = Ft;
-			et.m_J = Jt;
+			et.m_F = Ftn[n];
+			et.m_J = Jtn[n];
 
 			// evaluate strain-energy density
 			FEElasticMaterial* pme = dynamic_cast<FEElasticMaterial*>(m_pMat);
@@ -665,6 +768,9 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
                 pt.m_s += D*(((pt.m_Wt-pt.m_Wp)/(dt*pt.m_J) - pt.m_s.dotdot(D))/D2);
         }
     }
+
+	// the cached tangents are now consistent with the stresses
+	if (bcache) m_Ctvalid[iel] = 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -710,19 +816,18 @@ void FEElasticSolidDomain::UnpackLM(FEElement& el, vector<int>& lm)
 void FEElasticSolidDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 {
     int NE = Elements();
+	m_ws.Prepare();
+	FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
     for (int i=0; i<NE; ++i)
     {
 		// get the element
 		FESolidElement& el = m_Elem[i];
 
 		if (el.isActive()) {
-			// element force vector
-			vector<double> fe;
-			vector<int> lm;
-
 			// get the element force vector and initialize it to zero
 			int ndof = 3 * el.Nodes();
-			fe.assign(ndof, 0);
+			vector<double>& fe = ws.ElementVector(ndof);
+			vector<int>& lm = ws.LM();
 
 			// calculate internal force vector
 			ElementInertialForce(el, fe);
@@ -56,6 +56,9 @@ public:
 	//! Set flag for update for dynamic quantities
 	void SetDynamicUpdateFlag(bool b);
 
+	//! Set flag for caching the material tangent at the integration points
+	void SetTangentCaching(bool b);
+
 	//! serialization
 	void Serialize(DumpStream& ar) override;
 
@@ -111,7 +114,7 @@ public:
 	// --- R E S I D U A L ---
 
 	//! Calculates the internal stress vector for solid elements
-	void ElementInternalForce(FESolidElement& el, vector<double>& fe);
+	virtual void ElementInternalForce(FESolidElement& el, vector<double>& fe);
 
     //! Calculates the inertial force vector for solid elements
     void ElementInertialForce(FESolidElement& el, vector<double>& fe);
@@ -122,6 +125,16 @@ protected:
     double              m_beta;
 	bool				m_update_dynamic;	//!< flag for updating quantities only used in dynamic analysis
 
+protected:
+	// Tangent cache. When enabled, the tangent is evaluated together with the stress
+	// in UpdateElementStress and reused in ElementMaterialStiffness.
+	bool UseTangentCache() const;
+
+	bool				m_bcacheTangent;	//!< cache the material tangent (opt-in, costs one tens4ds per integration point)
+	vector<tens4ds>		m_Ct;				//!< cached tangents
+	vector<int>			m_Ctoff;			//!< offset of the element's first integration point into m_Ct
+	vector<char>		m_Ctvalid;			//!< flag whether the element's cached tangents are up to date
+
 protected:
 	FEDofList	m_dofU;		// displacement dofs
 	FEDofList	m_dofR;		// rigid rotation rofs
@@ -132,4 +145,6 @@ protected:
 	FEDofList	m_dof;		// total dof list
 
 	FESolidMaterial*	m_pMat;
+
+	DECLARE_FECORE_CLASS();
 };
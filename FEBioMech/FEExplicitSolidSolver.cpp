@@ -43,19 +43,26 @@ SOFTWARE.*/
 #include <FECore/FELinearConstraintManager.h>
 #include "FEResidualVector.h"
 #include "FEBioMech.h"
+#include <FECore/sys.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
 BEGIN_FECORE_CLASS(FEExplicitSolidSolver, FESolver)
 	ADD_PARAMETER(m_dyn_damping, "dyn_damping");
+	ADD_PARAMETER(m_bauto_dt   , "auto_dt");
+	ADD_PARAMETER(m_dt_scale   , FE_RANGE_LEFT_OPEN(0.0, 1.0), "dt_scale");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
 FEExplicitSolidSolver::FEExplicitSolidSolver(FEModel* pfem) : FESolver(pfem), m_dofU(pfem), m_dofV(pfem), m_dofSQ(pfem), m_dofRQ(pfem)
 {
 	m_dyn_damping = 0.99;
+	m_bauto_dt = false;
+	m_dt_scale = 0.9;
 	m_niter = 0;
 	m_nreq = 0;
+	m_RHS = nullptr;
+	domain_mass = nullptr;
 
 	// Allocate degrees of freedom
 	DOFS& dofs = pfem->GetDOFS();
@@ -83,6 +90,12 @@ FEExplicitSolidSolver::FEExplicitSolidSolver(FEModel* pfem) : FESolver(pfem), m_
 	m_dofRQ.AddVariable(FEBioMech::GetVariableName(FEBioMech::RIGID_ROTATION));
 }
 
+//-----------------------------------------------------------------------------
+FEExplicitSolidSolver::~FEExplicitSolidSolver()
+{
+	delete m_RHS;
+}
+
 //-----------------------------------------------------------------------------
 void FEExplicitSolidSolver::Clean()
 {
@@ -116,14 +129,37 @@ bool FEExplicitSolidSolver::Init()
 	gather(m_Ut, mesh, m_dofSQ[2]);
 
 	// calculate the inverse mass vector for the explicit analysis
-	vector<double> dummy(m_inv_mass);
-	FEGlobalVector Mi(fem, m_inv_mass, dummy);
-	matrix ke;
-	int j, iel;
-	int nint, neln;
-	double *H, kab;
-	vector <int> lm;
-	vector <double> el_lumped_mass;
+	LumpedMass();
+
+	// setup the element loops that are done by the solver
+	InitExplicitDomains();
+	if (m_bauto_dt)
+	{
+		double dtc = CriticalTimeStep();
+		feLog("\tcritical time step estimate ...... : %lg\n", dtc);
+		SetCriticalTimeStep(dtc);
+	}
+
+	// Calculate initial residual to be used on the first time step
+	if (Residual() == false) return false;
+	m_R1 += m_Fd;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Calculates the lumped mass of the elastic solid domains. The element masses
+//! are stored for the dynamic damping and the inverse of the nodal masses is
+//! stored in m_inv_mass.
+void FEExplicitSolidSolver::LumpedMass()
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+
+	// the nodal masses are assembled first and inverted afterwards
+	vector<double> M(m_neq, 0.0), dummy(m_neq, 0.0);
+	FEGlobalVector Mi(fem, M, dummy);
+
 	// Data structure to store element mass data for dynamic damping:-
 	// Define an overall dynamic array of pointers to the array that points to the element data
 	// domain_mass is a list of pointers to the data for each domain
@@ -136,82 +172,223 @@ bool FEExplicitSolidSolver::Init()
 		if (pbd)  // it is an elastic solid domain
 		{
 			// for each domain define an array of pointers to the individual element_mass records
-			double ** elmasses; 
-			elmasses = new double * [pbd->Elements()];
+			int NE = pbd->Elements();
+			double ** elmasses = new double * [NE];
 			// and set a pointer in domain_mass to the new element array
 			domain_mass[nd] = elmasses;
 
 			FESolidMaterial* pme = dynamic_cast<FESolidMaterial*>(pbd->GetMaterial());
 
-			for (iel=0; iel<pbd->Elements(); ++iel)
+#pragma omp parallel
 			{
-				FESolidElement& el = pbd->Element(iel);
-				pbd->UnpackLM(el, lm);
-
-				nint = el.GaussPoints();
-				neln = el.Nodes();
-
-				ke.resize(3*neln, 3*neln);
-				ke.zero();
-				el_lumped_mass.resize(3*neln);
-				for (int i=0; i<3*neln; ++i) el_lumped_mass[i]=0.0;
+				vector<int> lm;
+				vector<double> el_lumped_mass;
 
-				// create the element mass matrix
-				for (int n=0; n<nint; ++n)
+#pragma omp for schedule(static)
+				for (int iel=0; iel<NE; ++iel)
 				{
-					FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-					double d = pme->Density(mp);
-					double detJ0 = pbd->detJ0(el, n)*el.GaussWeights()[n];
-
-					H = el.H(n);
-					for (int i=0; i<neln; ++i)
-						for (j=0; j<neln; ++j)
+					FESolidElement& el = pbd->Element(iel);
+					pbd->UnpackLM(el, lm);
+
+					int nint = el.GaussPoints();
+					int neln = el.Nodes();
+
+					// The lumped mass is the row sum of the consistent mass matrix,
+					// so we integrate rho*H_i*sum(H_j) directly.
+					el_lumped_mass.assign(3*neln, 0.0);
+					for (int n=0; n<nint; ++n)
+					{
+						FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+						double d = pme->Density(mp);
+						double detJ0 = pbd->detJ0(el, n)*el.GaussWeights()[n];
+
+						double* H = el.H(n);
+						double sH = 0.0;
+						for (int j=0; j<neln; ++j) sH += H[j];
+
+						for (int i=0; i<neln; ++i)
 						{
-							kab = H[i]*H[j]*detJ0*d;
-							ke[3*i  ][3*j  ] += kab;
-							ke[3*i+1][3*j+1] += kab;
-							ke[3*i+2][3*j+2] += kab;
-						}	
-				}
-				// reduce to a lumped mass vector and add up the total
-				double total_mass = 0.0;
-				for (int i=0; i<3*neln; ++i)
-				{
-						for (j=0; j<neln; ++j)
-						{
-							el_lumped_mass[i]+=ke[i][j];
+							double mi = H[i]*sH*detJ0*d;
+							el_lumped_mass[3*i  ] += mi;
+							el_lumped_mass[3*i+1] += mi;
+							el_lumped_mass[3*i+2] += mi;
 						}
-						total_mass += el_lumped_mass[i];
-				}	
-				total_mass /= 3.0; // because each mass is represented three times for each direction
-				// define an element mass record
-				double * thiselement;
-				thiselement = new double [neln+1];
-				// and set a pointer to the element data
-				elmasses[iel] = thiselement;
-				thiselement[0] = total_mass; // total mass of the element first, followed by the fraction at each node
-				// for each node, store the fraction of the element mass associated with it
-				for (int i=0; i<neln; ++i)
-				{
-					thiselement[i+1] = (el_lumped_mass[3*i]+el_lumped_mass[3*i+1]+el_lumped_mass[3*i+2])/(3*total_mass);
-				} // loop over nodes within element
-				// invert and assemble element matrix into inv_mass vector 
-				for (int i=0; i<3*neln; ++i)
-				{
-					el_lumped_mass[i] = 1.0/el_lumped_mass[i];
-				}
-				Mi.Assemble(el.m_node, lm, el_lumped_mass);
-				// formerly AssembleResidual(el.m_node, lm, el_lumped_mass, m_inv_mass);
-			} // loop over elements
+					}
+
+					// add up the total
+					double total_mass = 0.0;
+					for (int i=0; i<3*neln; ++i) total_mass += el_lumped_mass[i];
+					total_mass /= 3.0; // because each mass is represented three times for each direction
+
+					// define an element mass record
+					double * thiselement = new double [neln+1];
+					// and set a pointer to the element data
+					elmasses[iel] = thiselement;
+					thiselement[0] = total_mass; // total mass of the element first, followed by the fraction at each node
+					// for each node, store the fraction of the element mass associated with it
+					for (int i=0; i<neln; ++i)
+					{
+						thiselement[i+1] = (el_lumped_mass[3*i]+el_lumped_mass[3*i+1]+el_lumped_mass[3*i+2])/(3*total_mass);
+					} // loop over nodes within element
+
+					// assemble the element masses into the nodal masses
+					Mi.Assemble(el.m_node, lm, el_lumped_mass);
+				} // loop over elements
+			}
 		} // was an elastic solid domain
 		else domain_mass[nd] = 0;  // no masses stored for other types of domain
 	}
 
-	// Calculate initial residual to be used on the first time step
-	if (Residual(m_R1) == false) return false;
-	m_R1 += m_Fd;
+	// invert the nodal masses
+	for (int i=0; i<m_neq; ++i) m_inv_mass[i] = (M[i] > 0.0 ? 1.0 / M[i] : 1.0);
+}
 
-	return true;
+//-----------------------------------------------------------------------------
+//! The solver evaluates the internal forces of the standard elastic solid and
+//! UDG hex domains itself. This avoids the atomic assembly of the domain loops.
+//! Derived domains may customize these loops, so they are left alone.
+void FEExplicitSolidSolver::InitExplicitDomains()
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+
+	m_exdom.clear();
+	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	{
+		FEDomain& dom = mesh.Domain(nd);
+		const char* sztype = dom.GetTypeStr();
+		if ((sztype == 0) || (dom.IsActive() == false)) continue;
+		if ((strcmp(sztype, "elastic-solid") != 0) && (strcmp(sztype, "udg-hex") != 0)) continue;
+
+		FEElasticSolidDomain* pdom = dynamic_cast<FEElasticSolidDomain*>(&dom);
+		FESolidMaterial* pme = dynamic_cast<FESolidMaterial*>(pdom->GetMaterial());
+		if (pme == 0) continue;
+
+		ExplicitDomain ed;
+		ed.pdom = pdom;
+
+		int NE = pdom->Elements();
+		ed.c.assign(NE, 0.0);
+		ed.dtc.assign(NE, 0.0);
+
+		// The dilatational wave speed is evaluated from the initial tangent. 
+		if (m_bauto_dt)
+		{
+#pragma omp parallel for schedule(static)
+			for (int i=0; i<NE; ++i)
+			{
+				FESolidElement& el = pdom->Element(i);
+				FEMaterialPoint& mp = *el.GetMaterialPoint(0);
+				double rho = pme->Density(mp);
+				tens4ds C = pme->Tangent(mp);
+				double Cmax = C(0,0,0,0);
+				if (C(1,1,1,1) > Cmax) Cmax = C(1,1,1,1);
+				if (C(2,2,2,2) > Cmax) Cmax = C(2,2,2,2);
+				ed.c[i] = ((rho > 0.0) && (Cmax > 0.0) ? sqrt(Cmax / rho) : 0.0);
+			}
+		}
+
+		m_exdom.push_back(ed);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Estimates the critical time step of the explicit domains. The critical time step
+//! of an element is the time it takes a dilatational wave to cross the element's
+//! smallest node-to-node distance, scaled by the safety factor m_dt_scale.
+//! Returns zero if no estimate could be made.
+double FEExplicitSolidSolver::CriticalTimeStep()
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+
+	double dtmin = 0.0;
+	for (size_t nd = 0; nd < m_exdom.size(); ++nd)
+	{
+		ExplicitDomain& ed = m_exdom[nd];
+		FEElasticSolidDomain& dom = *ed.pdom;
+		int NE = dom.Elements();
+
+#pragma omp parallel for schedule(static)
+		for (int i=0; i<NE; ++i)
+		{
+			FESolidElement& el = dom.Element(i);
+			ed.dtc[i] = 0.0;
+			if (el.isActive() && (ed.c[i] > 0.0))
+			{
+				// find the smallest distance between two nodes
+				int neln = el.Nodes();
+				double L2 = -1.0;
+				for (int a=0; a<neln; ++a)
+				{
+					vec3d ra = mesh.Node(el.m_node[a]).m_rt;
+					for (int b=a+1; b<neln; ++b)
+					{
+						double l2 = (mesh.Node(el.m_node[b]).m_rt - ra).norm2();
+						if ((L2 < 0.0) || (l2 < L2)) L2 = l2;
+					}
+				}
+				if (L2 > 0.0) ed.dtc[i] = m_dt_scale*sqrt(L2) / ed.c[i];
+			}
+		}
+
+		for (int i=0; i<NE; ++i)
+		{
+			double dti = ed.dtc[i];
+			if ((dti > 0.0) && ((dtmin == 0.0) || (dti < dtmin))) dtmin = dti;
+		}
+	}
+
+	return dtmin;
+}
+
+//-----------------------------------------------------------------------------
+//! Sets the time step size of the current analysis step to the critical time step.
+//! The analysis picks this up when it advances the time, so the time step that is 
+//! in progress is not changed. The time step is cut back so that the analysis
+//! does not step past the end of the analysis step.
+void FEExplicitSolidSolver::SetCriticalTimeStep(double dtc)
+{
+	if (dtc <= 0.0) return;
+
+	FEModel& fem = *GetFEModel();
+	FEAnalysis* step = fem.GetCurrentStep();
+	if (step == nullptr) return;
+
+	double dt = dtc;
+	double t = fem.GetCurrentTime();
+	if ((t < step->m_tend) && (t + dt > step->m_tend)) dt = step->m_tend - t;
+	step->m_dt = dt;
+}
+
+//-----------------------------------------------------------------------------
+//! Calculates the internal forces of the explicit domains.
+void FEExplicitSolidSolver::ExplicitInternalForces(FEGlobalVector& R)
+{
+	for (size_t nd = 0; nd < m_exdom.size(); ++nd)
+	{
+		ExplicitDomain& ed = m_exdom[nd];
+		FEElasticSolidDomain& dom = *ed.pdom;
+		int NE = dom.Elements();
+
+#pragma omp parallel
+		{
+			vector<double> fe;
+			vector<int> lm;
+
+#pragma omp for schedule(static)
+			for (int i=0; i<NE; ++i)
+			{
+				FESolidElement& el = dom.Element(i);
+				if (el.isActive() == false) continue;
+
+				fe.assign(3*el.Nodes(), 0.0);
+				dom.ElementInternalForce(el, fe);
+
+				dom.UnpackLM(el, lm);
+				R.Assemble(el.m_node, lm, fe);
+			}
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -241,18 +418,28 @@ void FEExplicitSolidSolver::UpdateKinematics(vector<double>& ui)
 	UpdateRigidBodies(ui);
 
 	// total displacements
-	vector<double> U(m_Ut.size());
-	for (size_t i=0; i<m_Ut.size(); ++i) U[i] = ui[i] + m_Ui[i] + m_Ut[i];
+	int neq = (int)m_Ut.size();
+	vector<double> U(neq);
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<neq; ++i) U[i] = ui[i] + m_Ui[i] + m_Ut[i];
 
 	// update flexible nodes
-	// translational dofs
-	scatter(U, mesh, m_dofU[0]);
-	scatter(U, mesh, m_dofU[1]);
-	scatter(U, mesh, m_dofU[2]);
-	// rotational dofs
-	scatter(U, mesh, m_dofSQ[0]);
-	scatter(U, mesh, m_dofSQ[1]);
-	scatter(U, mesh, m_dofSQ[2]);
+	int NN = mesh.Nodes();
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		for (int j=0; j<3; ++j)
+		{
+			// translational dofs
+			int n = node.m_ID[m_dofU[j]];
+			if (n >= 0) node.set(m_dofU[j], U[n]);
+
+			// rotational dofs
+			n = node.m_ID[m_dofSQ[j]];
+			if (n >= 0) node.set(m_dofSQ[j], U[n]);
+		}
+	}
 
 	// make sure the prescribed displacements are fullfilled
 	int ndis = fem.BoundaryConditions();
@@ -273,7 +460,8 @@ void FEExplicitSolidSolver::UpdateKinematics(vector<double>& ui)
 
 	// Update the spatial nodal positions
 	// Don't update rigid nodes since they are already updated
-	for (int i=0; i<mesh.Nodes(); ++i)
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
 		if (node.m_rid == -1)
@@ -456,7 +644,9 @@ void FEExplicitSolidSolver::PrepStep()
 	// we need them for velocity and acceleration calculations
 	FEMechModel& fem = static_cast<FEMechModel&>(*GetFEModel());
 	FEMesh& mesh = fem.GetMesh();
-	for (i=0; i<mesh.Nodes(); ++i)
+	int NN = mesh.Nodes();
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NN; ++i)
 	{
 		FENode& ni = mesh.Node(i);
 		ni.m_rp = ni.m_rt;
@@ -593,11 +783,6 @@ void FEExplicitSolidSolver::PrepStep()
 //-----------------------------------------------------------------------------
 bool FEExplicitSolidSolver::DoSolve()
 {
-	int i, n;
-
-	vector<double> u0(m_neq);
-	vector<double> Rold(m_neq);
-
 	// Get the current step
 	FEModel& fem = *GetFEModel();
 	FEAnalysis* pstep = fem.GetCurrentStep();
@@ -610,14 +795,10 @@ bool FEExplicitSolidSolver::DoSolve()
 	// get the mesh
 	FEMesh& mesh = fem.GetMesh();
 	int N = mesh.Nodes(); // this is the total number of nodes in the mesh
-	int j,iel;
-    double dt = fem.GetTime().timeIncrement;
-	double avx = 0.0;  // average element velocity in each direction
-	double avy = 0.0;
-	double avz = 0.0;
-	double mass_at_node;
+	double dt = fem.GetTime().timeIncrement;
 
-	for (i=0; i<N; ++i) // zero the new acceleration vector ready to add in the damping components
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<N; ++i) // zero the new acceleration vector ready to add in the damping components
 	{
 		FENode& node = mesh.Node(i);
 		node.m_at.x = 0.0;
@@ -625,67 +806,82 @@ bool FEExplicitSolidSolver::DoSolve()
 		node.m_at.z = 0.0;
 	}
 
-	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	if (m_dyn_damping != 0.0)
 	{
-		FEElasticSolidDomain* pbd = dynamic_cast<FEElasticSolidDomain*>(&mesh.Domain(nd));
-		if (pbd)  // it is an elastic solid domain
+		for (int nd = 0; nd < mesh.Domains(); ++nd)
 		{
-			double ** emass = domain_mass[nd]; // array of pointers to the element mass records for this domain
-			for (iel=0; iel<pbd->Elements(); ++iel)
+			FEElasticSolidDomain* pbd = dynamic_cast<FEElasticSolidDomain*>(&mesh.Domain(nd));
+			if (pbd)  // it is an elastic solid domain
 			{
-				FESolidElement& el = pbd->Element(iel);
-
-				// zero the three average velocity components
-				avx = 0.0;
-				avy = 0.0;
-				avz = 0.0;
-
-				// will use previously calculated element mass data for weighted averaging of velocities
-
-				// loop over each element to find the average velocity
-				// then calculate the weighted velocity change for each node
-				// add each velocity change into node.m_vt
-				double * this_element = emass[iel]; // pointer to the array of fractional nodal masses for this element
-				for (j=0; j<el.Nodes(); j++) // loop over each node in the element
+				double ** emass = domain_mass[nd]; // array of pointers to the element mass records for this domain
+				int NE = pbd->Elements();
+#pragma omp parallel for schedule(static)
+				for (int iel=0; iel<NE; ++iel)
 				{
-					FENode& node = mesh.Node(el.m_node[j]);  // get the node 
-					avx += node.m_vp.x*this_element[j+1];  // add each of the three components to the averages
-					avy += node.m_vp.y*this_element[j+1];  // weighted by the fractional mass of the node
-					avz += node.m_vp.z*this_element[j+1];  // remembering that this_element[0] is the total mass
-				}
-				for (j=0; j<el.Nodes(); j++) // loop over each node in the element again
-				// and calculate and add in the velocity change contribution to each dof
-				{
-					FENode& node = mesh.Node(el.m_node[j]);  // get the node 
-					//	need to find node.m_vt.x += (avx-node.m_vp.x)*dt*m_dyn_damping*element_mass_at_node/total_mass at node;
-					// should be t* = dt/(h/c) not dt
-					// put this into the accelerations as (avx-node.m_vp.x)*m_dyn_damping*element_mass_at_node
-					// then it will be multiplied by dt and divided by m_inv_mass later 
-					mass_at_node = this_element[j+1]*this_element[0];
-					node.m_at.x += (avx-node.m_vp.x)*mass_at_node*m_dyn_damping;
-					node.m_at.y += (avy-node.m_vp.y)*mass_at_node*m_dyn_damping;
-					node.m_at.z += (avz-node.m_vp.z)*mass_at_node*m_dyn_damping;
-				}
-			}  // loop over elements
-		}  // if (pbd)
-	}  // loop over domains
+					FESolidElement& el = pbd->Element(iel);
+
+					// will use previously calculated element mass data for weighted averaging of velocities
+
+					// loop over each element to find the average velocity
+					// then calculate the weighted velocity change for each node
+					// add each velocity change into node.m_vt
+					double avx = 0.0;  // average element velocity in each direction
+					double avy = 0.0;
+					double avz = 0.0;
+					double * this_element = emass[iel]; // pointer to the array of fractional nodal masses for this element
+					int neln = el.Nodes();
+					for (int j=0; j<neln; j++) // loop over each node in the element
+					{
+						FENode& node = mesh.Node(el.m_node[j]);  // get the node 
+						avx += node.m_vp.x*this_element[j+1];  // add each of the three components to the averages
+						avy += node.m_vp.y*this_element[j+1];  // weighted by the fractional mass of the node
+						avz += node.m_vp.z*this_element[j+1];  // remembering that this_element[0] is the total mass
+					}
+					for (int j=0; j<neln; j++) // loop over each node in the element again
+					// and calculate and add in the velocity change contribution to each dof
+					{
+						FENode& node = mesh.Node(el.m_node[j]);  // get the node 
+						//	need to find node.m_vt.x += (avx-node.m_vp.x)*dt*m_dyn_damping*element_mass_at_node/total_mass at node;
+						// should be t* = dt/(h/c) not dt
+						// put this into the accelerations as (avx-node.m_vp.x)*m_dyn_damping*element_mass_at_node
+						// then it will be multiplied by dt and divided by m_inv_mass later 
+						double mass_at_node = this_element[j+1]*this_element[0];
+						double ax = (avx-node.m_vp.x)*mass_at_node*m_dyn_damping;
+						double ay = (avy-node.m_vp.y)*mass_at_node*m_dyn_damping;
+						double az = (avz-node.m_vp.z)*mass_at_node*m_dyn_damping;
+#pragma omp atomic
+						node.m_at.x += ax;
+#pragma omp atomic
+						node.m_at.y += ay;
+#pragma omp atomic
+						node.m_at.z += az;
+					}
+				}  // loop over elements
+			}  // if (pbd)
+		}  // loop over domains
+	}
 
-	for (i=0; i<N; ++i)
+	// central difference update of the nodal velocities and displacements
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<N; ++i)
 	{
 		FENode& node = mesh.Node(i);
+		int nx = node.m_ID[m_dofU[0]];
+		int ny = node.m_ID[m_dofU[1]];
+		int nz = node.m_ID[m_dofU[2]];
+
 		//  calculate acceleration using F=ma and update - note m_inv_mass is 1/m so multiply not divide
-		n=(int)m_R1[0];
-		if ((n = node.m_ID[m_dofU[0]]) >= 0) node.m_at.x = (node.m_at.x+m_R1[n])*m_inv_mass[n];
-		if ((n = node.m_ID[m_dofU[1]]) >= 0) node.m_at.y = (node.m_at.y+m_R1[n])*m_inv_mass[n];
-		if ((n = node.m_ID[m_dofU[2]]) >= 0) node.m_at.z = (node.m_at.z+m_R1[n])*m_inv_mass[n];
+		if (nx >= 0) node.m_at.x = (node.m_at.x+m_R1[nx])*m_inv_mass[nx];
+		if (ny >= 0) node.m_at.y = (node.m_at.y+m_R1[ny])*m_inv_mass[ny];
+		if (nz >= 0) node.m_at.z = (node.m_at.z+m_R1[nz])*m_inv_mass[nz];
 		// and update the velocities using the accelerations
 		// which are added to the previously calculated velocity changes from damping
 		vec3d vt = node.m_vp + node.m_at*dt;
 		node.set_vec3d(m_dofV[0], m_dofV[1], m_dofV[2], vt);	//  update velocity using acceleration m_at
 		//	calculate incremental displacement using the velocity
-		if ((n = node.m_ID[m_dofU[0]]) >= 0) m_ui[n] = vt.x*dt;
-		if ((n = node.m_ID[m_dofU[1]]) >= 0) m_ui[n] = vt.y*dt;
-		if ((n = node.m_ID[m_dofU[2]]) >= 0) m_ui[n] = vt.z*dt;
+		if (nx >= 0) m_ui[nx] = vt.x*dt;
+		if (ny >= 0) m_ui[ny] = vt.y*dt;
+		if (nz >= 0) m_ui[nz] = vt.z*dt;
 	}
 
 	// need to update everything for the explicit solver
@@ -693,11 +889,12 @@ bool FEExplicitSolidSolver::DoSolve()
 	Update(m_ui);
 
 	// calculate new residual at this point - which will be used on the next step to find the acceleration
-	Residual(m_R1);
+	Residual();
 
 	// update total displacements
 	int neq = (int)m_Ui.size();
-	for (i=0; i<neq; ++i) m_Ui[i] += m_ui[i];
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<neq; ++i) m_Ui[i] += m_ui[i];
 
 	// increase iteration number
 	m_niter++;
@@ -708,6 +905,9 @@ bool FEExplicitSolidSolver::DoSolve()
 	// if converged we update the total displacements
 	m_Ut += m_Ui;
 
+	// set the size of the next time step
+	if (m_bauto_dt) SetCriticalTimeStep(CriticalTimeStep());
+
 	return true;
 }
 
@@ -717,7 +917,7 @@ bool FEExplicitSolidSolver::DoSolve()
 //! This is because they do not depend on the geometry 
 //! so we only calculate them once (in Quasin) and then add them here.
 
-bool FEExplicitSolidSolver::Residual(vector<double>& R)
+bool FEExplicitSolidSolver::Residual()
 {
 	int i;
 
@@ -726,13 +926,16 @@ bool FEExplicitSolidSolver::Residual(vector<double>& R)
 	const FETimeInfo& tp = fem.GetTime();
 
 	// initialize residual with concentrated nodal loads
-	R = m_Fn;
+	m_R1 = m_Fn;
 
 	// zero nodal reaction forces
 	zero(m_Fr);
 
 	// setup the global vector
-	FEGlobalVector RHS(fem, R, m_Fr);
+	// Each thread assembles into its own copy, which are added to m_R1 and m_Fr at the end.
+	if (m_RHS == nullptr) m_RHS = new FEThreadLocalVector(fem, m_R1, m_Fr);
+	FEThreadLocalVector& RHS = *m_RHS;
+	RHS.Zero();
 
 	// zero rigid body reaction forces
 	int NRB = fem.RigidBodies();
@@ -748,9 +951,17 @@ bool FEExplicitSolidSolver::Residual(vector<double>& R)
 	// calculate the internal (stress) forces
 	for (i=0; i<mesh.Domains(); ++i)
 	{
-		FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
-		dom.InternalForces(RHS);
+		FEDomain& dom = mesh.Domain(i);
+
+		// the explicit domains are done below
+		bool bexplicit = false;
+		for (size_t n = 0; n < m_exdom.size(); ++n) if (m_exdom[n].pdom == &dom) bexplicit = true;
+		if (bexplicit) continue;
+
+		FEElasticDomain& edom = dynamic_cast<FEElasticDomain&>(dom);
+		edom.InternalForces(RHS);
 	}
+	ExplicitInternalForces(RHS);
 
 	// calculate the body forces
 	for (int j = 0; j<fem.BodyLoads(); ++j)
@@ -791,9 +1002,14 @@ bool FEExplicitSolidSolver::Residual(vector<double>& R)
 	// forces due to point constraints
 //	for (i=0; i<(int) fem.m_PC.size(); ++i) fem.m_PC[i]->LoadVector(this, R);
 
+	// add the thread contributions
+	RHS.Reduce();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
-	for (i=0; i<mesh.Nodes(); ++i)
+	int NN = mesh.Nodes();
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
 		node.set_load(m_dofU[0], 0);
@@ -856,7 +1072,9 @@ void FEExplicitSolidSolver::InertialForces(FEGlobalVector& R)
     double dt = fem.GetTime().timeIncrement;
 	double a = 4.0 / dt;
 	double b = a / dt;
-	for (int i=0; i<mesh.Nodes(); ++i)
+	int NN = mesh.Nodes();
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
 		vec3d& rt = node.m_rt;
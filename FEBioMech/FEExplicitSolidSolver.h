@@ -29,9 +29,12 @@ SOFTWARE.*/
 #pragma once
 #include "FECore/FESolver.h"
 #include "FECore/FEGlobalVector.h"
+#include "FECore/FEThreadLocalVector.h"
 #include <FECore/FETimeInfo.h>
 #include <FECore/FEDofList.h>
 
+class FEElasticSolidDomain;
+
 //-----------------------------------------------------------------------------
 //! This class implements a nonlinear explicit solver for solid mechanics
 //! problems.
@@ -42,7 +45,7 @@ public:
 	FEExplicitSolidSolver(FEModel* pfem);
 
 	//! destructor
-	virtual ~FEExplicitSolidSolver() {}
+	virtual ~FEExplicitSolidSolver();
 
 public:
 	//! Data initialization
@@ -77,7 +80,7 @@ public:
 
 	void PrepStep();
 
-	bool Residual(vector<double>& R);
+	bool Residual();
 
 	void NonLinearConstraintForces(FEGlobalVector& R, const FETimeInfo& tp);
 
@@ -85,8 +88,26 @@ public:
 	
 	void ContactForces(FEGlobalVector& R);
 
+	//! estimate the critical time step of the mesh
+	double CriticalTimeStep();
+
+	//! set the time step size to the critical time step
+	void SetCriticalTimeStep(double dtc);
+
+protected:
+	//! calculate the lumped mass and the inverse mass vector
+	void LumpedMass();
+
+	//! collect the domains whose element loops are managed by the solver
+	void InitExplicitDomains();
+
+	//! internal forces of the explicit domains
+	void ExplicitInternalForces(FEGlobalVector& R);
+
 public:
 	double		m_dyn_damping;	//!< velocity damping for the explicit solver
+	bool		m_bauto_dt;		//!< set the time step to the critical time step
+	double		m_dt_scale;		//!< safety factor applied to the critical time step
 
 public:
 	// equation numbers
@@ -105,6 +126,17 @@ public:
 	vector<double> m_R1;	//!< residual at iteration i
 	double *** domain_mass;	//! Pointer to data structure for nodal masses, dynamically allocated during initiation
 
+protected:
+	// Domains whose internal forces are evaluated by the solver.
+	struct ExplicitDomain
+	{
+		FEElasticSolidDomain*		pdom;
+		vector<double>				c;		//!< dilatational wave speed of each element
+		vector<double>				dtc;	//!< critical time step of each element
+	};
+	vector<ExplicitDomain>	m_exdom;
+	FEThreadLocalVector*	m_RHS;		//!< residual with thread-local assembly
+
 protected:
 	FEDofList	m_dofU, m_dofV, m_dofSQ, m_dofRQ;
 
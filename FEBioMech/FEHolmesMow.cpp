@@ -108,6 +108,54 @@ tens4ds FEHolmesMow::Tangent(FEMaterialPoint& mp)
 	return c;
 }
 
+//-----------------------------------------------------------------------------
+//! Evaluates the stress and tangent as a batch of one point, so that the two
+//! share the same implementation.
+mat3ds FEHolmesMow::StressAndTangent(FEMaterialPoint& mp, tens4ds& C)
+{
+	FEMaterialPoint* pmp = &mp;
+	mat3ds s;
+	EvaluateBatch(&pmp, 1, &s, &C);
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+//! Batch version of Stress and Tangent. The invariants, the exponential term and
+//! the stress are shared between the stress and the tangent.
+void FEHolmesMow::EvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* C)
+{
+	mat3ds identity(1.,1.,1.,0.,0.,0.);
+	tens4ds I4 = dyad4s(identity);
+
+	for (int n = 0; n < npts; ++n)
+	{
+		FEElasticMaterialPoint& pt = *mp[n]->ExtractData<FEElasticMaterialPoint>();
+
+		double detF = pt.m_J;
+		double detFi = 1.0/detF;
+
+		// calculate left Cauchy-Green tensor
+		mat3ds b = pt.LeftCauchyGreen();
+		mat3ds b2 = b.sqr();
+
+		// calculate invariants of B
+		double I1 = b.tr();
+		double I2 = (I1*I1 - b2.tr())*0.5;
+		double I3 = b.det();
+
+		// Exponential term
+		double eQ = exp(m_b*((2*mu-lam)*(I1-3) + lam*(I2-3))/Ha)/pow(I3,m_b);
+
+		// calculate stress
+		mat3ds sn = 0.5*detFi*eQ*((2*mu+lam*(I1-1))*b - lam*b2 - Ha*identity);
+		if (s) s[n] = sn;
+
+		// calculate elasticity tensor
+		if (C) C[n] = 4.*m_b/Ha*detF/eQ*dyad1s(sn) 
+			+ detFi*eQ*(lam*(dyad1s(b) - dyad4s(b)) + Ha*I4);
+	}
+}
+
 //-----------------------------------------------------------------------------
 double FEHolmesMow::StrainEnergyDensity(FEMaterialPoint& mp)
 {
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEIsotropicElastic.h"
+#include <FECore/tens4ds_batch.h>
 
 //-----------------------------------------------------------------------------
 // define the material parameters
@@ -85,6 +86,67 @@ tens4ds FEIsotropicElastic::Tangent(FEMaterialPoint& mp)
 	return dyad1s(b)*lam + dyad4s(b)*(2.0*mu);
 }
 
+//-----------------------------------------------------------------------------
+//! Evaluates the stress and tangent as a batch of one point, so that the two
+//! share the same implementation.
+mat3ds FEIsotropicElastic::StressAndTangent(FEMaterialPoint& mp, tens4ds& C)
+{
+	FEMaterialPoint* pmp = &mp;
+	mat3ds s;
+	EvaluateBatch(&pmp, 1, &s, &C);
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+//! The points are processed in blocks of tens4ds_batch::LANES. The stress is
+//! evaluated point by point, and the tangents of a block with the batch kernels.
+void FEIsotropicElastic::EvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* C)
+{
+	const int L = tens4ds_batch::LANES;
+
+	// lame parameters (in reference configuration)
+	const double lam0 = m_v*m_E/((1+m_v)*(1-2*m_v));
+	const double mu0  = 0.5*m_E/(1+m_v);
+
+	double lam[L], mu2[L];
+	double bbuf[mat3ds_batch::NNZ*L];
+	double cbuf[tens4ds_batch::NNZ*L], tbuf[tens4ds_batch::NNZ*L];
+	for (int n0 = 0; n0 < npts; n0 += L)
+	{
+		const int nl = (npts - n0 < L ? npts - n0 : L);
+		mat3ds_batch B(nl, bbuf);
+		for (int l = 0; l < nl; ++l)
+		{
+			FEElasticMaterialPoint& pt = *mp[n0 + l]->ExtractData<FEElasticMaterialPoint>();
+
+			double Ji = 1.0 / pt.m_J;
+			lam[l] = Ji*lam0;
+			mu2[l] = 2.0*(Ji*mu0);
+
+			// left Cauchy-Green tensor
+			mat3ds b = pt.LeftCauchyGreen();
+			B.set(l, b);
+
+			if (s)
+			{
+				double trE = 0.5*(b.tr()-3);
+				s[n0 + l] = b*(lam[l]*trE - 0.5*mu2[l]) + b.sqr()*(0.5*mu2[l]);
+			}
+		}
+
+		// C = lam*(b dyad1s b) + 2*mu*(b dyad4s b)
+		if (C)
+		{
+			tens4ds_batch c(nl, cbuf), t(nl, tbuf);
+			dyad1s(B, c);
+			scale(lam, c);
+			dyad4s(B, t);
+			axpy(t, mu2, c);
+			for (int l = 0; l < nl; ++l) C[n0 + l] = c.get(l);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 double FEIsotropicElastic::StrainEnergyDensity(FEMaterialPoint& mp)
 {
@@ -46,6 +46,12 @@ public:
 	//! calculate tangent stiffness at material point
 	virtual tens4ds Tangent(FEMaterialPoint& pt) override;
 
+	//! calculate stress and tangent in one pass
+	mat3ds StressAndTangent(FEMaterialPoint& pt, tens4ds& C) override;
+
+	//! calculate stress and/or tangent at a batch of points
+	void EvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* C) override;
+
 	//! calculate strain energy density at material point
 	virtual double StrainEnergyDensity(FEMaterialPoint& pt) override;
     
@@ -137,6 +137,76 @@ tens4ds FEMooneyRivlin::DevTangent(FEMaterialPoint& mp)
 	return c;
 }
 
+//-----------------------------------------------------------------------------
+//! Calculate the deviatoric stress and tangent as a batch of one point, so that
+//! the two share the same implementation.
+mat3ds FEMooneyRivlin::DevStressAndTangent(FEMaterialPoint& mp, tens4ds& Cdev)
+{
+	FEMaterialPoint* pmp = &mp;
+	mat3ds s;
+	DevEvaluateBatch(&pmp, 1, &s, &Cdev);
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+//! Batch version of DevStress and DevTangent. When only the tangent is requested
+//! the stress stored in the material point is used, as in DevTangent.
+void FEMooneyRivlin::DevEvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* Cdev)
+{
+	// the material parameters only need to be evaluated once if they are constant
+	const bool bconst = (m_c1.isConst() && m_c2.isConst());
+	double c1 = 0.0, c2 = 0.0;
+	if (bconst) { c1 = m_c1(*mp[0]); c2 = m_c2(*mp[0]); }
+
+	// Identity tensor
+	mat3ds I(1,1,1,0,0,0);
+	tens4ds IxI = dyad1s(I);
+	tens4ds I4  = dyad4s(I);
+
+	for (int n = 0; n < npts; ++n)
+	{
+		FEElasticMaterialPoint& pt = *mp[n]->ExtractData<FEElasticMaterialPoint>();
+		if (bconst == false) { c1 = m_c1(*mp[n]); c2 = m_c2(*mp[n]); }
+
+		double Ji = 1.0/pt.m_J;
+
+		// deviatoric left Cauchy-Green tensor, its square and invariants
+		mat3ds B = pt.DevLeftCauchyGreen();
+		mat3ds B2 = B.sqr();
+		double I1 = B.tr();
+		double I2 = 0.5*(I1*I1 - B2.tr());
+
+		// Wi = dW/dIi
+		double W1 = c1;
+		double W2 = c2;
+
+		// deviatoric Cauchy stress
+		mat3ds devs;
+		if (s)
+		{
+			mat3ds T = B*(W1 + W2*I1) - B2*W2;
+			devs = s[n] = T.dev()*(2.0*Ji);
+		}
+		else devs = pt.m_s.dev();
+
+		if (Cdev)
+		{
+			// calculate dWdC:C
+			double WC = W1*I1 + 2*W2*I2;
+
+			// calculate C:d2WdCdC:C
+			double CWWC = 2*I2*W2;
+
+			// d2W/dCdC:C
+			mat3ds WCCxC = B*(W2*I1) - B2*W2;
+
+			tens4ds cw = (dyad1s(B) - dyad4s(B))*(W2*4.0*Ji) - dyad1s(WCCxC, I)*(4.0/3.0*Ji) + IxI*(4.0/9.0*Ji*CWWC);
+
+			Cdev[n] = dyad1s(devs, I)*(-2.0/3.0) + (I4 - IxI/3.0)*(4.0/3.0*Ji*WC) + cw;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! calculate deviatoric strain energy density
 double FEMooneyRivlin::DevStrainEnergyDensity(FEMaterialPoint& mp)
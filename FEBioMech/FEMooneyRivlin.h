@@ -49,6 +49,12 @@ public:
 	//! calculate deviatoric tangent stiffness at material point
 	tens4ds DevTangent(FEMaterialPoint& pt) override;
 
+	//! calculate deviatoric stress and tangent in one pass
+	mat3ds DevStressAndTangent(FEMaterialPoint& pt, tens4ds& Cdev) override;
+
+	//! calculate deviatoric stress and/or tangent at a batch of points
+	void DevEvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* Cdev) override;
+
 	//! calculate deviatoric strain energy density
 	double DevStrainEnergyDensity(FEMaterialPoint& mp) override;
     
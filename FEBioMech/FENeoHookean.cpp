@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FENeoHookean.h"
+#include <FECore/tens4ds_batch.h>
 
 //-----------------------------------------------------------------------------
 // define the material parameters
@@ -95,6 +96,71 @@ tens4ds FENeoHookean::Tangent(FEMaterialPoint& mp)
 	return tens4ds(D);
 }
 
+//-----------------------------------------------------------------------------
+//! Evaluates the stress and tangent as a batch of one point, so that the two
+//! share the same implementation.
+mat3ds FENeoHookean::StressAndTangent(FEMaterialPoint& mp, tens4ds& C)
+{
+	FEMaterialPoint* pmp = &mp;
+	mat3ds s;
+	EvaluateBatch(&pmp, 1, &s, &C);
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+//! The points are processed in blocks of tens4ds_batch::LANES. The stress is
+//! evaluated point by point, and the (isotropic) tangents of a block with the
+//! batch kernels.
+void FENeoHookean::EvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* C)
+{
+	const int L = tens4ds_batch::LANES;
+
+	// the material parameters only need to be evaluated once if they are constant
+	const bool bconst = (m_E.isConst() && m_v.isConst());
+	double E = 0.0, v = 0.0;
+	if (bconst) { E = m_E(*mp[0]); v = m_v(*mp[0]); }
+
+	mat3dd I(1);
+	double lam1[L], mu1[L];
+	double cbuf[tens4ds_batch::NNZ*L];
+	for (int n0 = 0; n0 < npts; n0 += L)
+	{
+		const int nl = (npts - n0 < L ? npts - n0 : L);
+		for (int l = 0; l < nl; ++l)
+		{
+			FEMaterialPoint& mpl = *mp[n0 + l];
+			FEElasticMaterialPoint& pt = *mpl.ExtractData<FEElasticMaterialPoint>();
+			if (bconst == false) { E = m_E(mpl); v = m_v(mpl); }
+
+			// lame parameters
+			double lam = v*E/((1+v)*(1-2*v));
+			double mu  = 0.5*E/(1+v);
+
+			double detFi = 1.0/pt.m_J;
+			double lndetF = log(pt.m_J);
+
+			// stress
+			if (s)
+			{
+				mat3ds b = pt.LeftCauchyGreen();
+				s[n0 + l] = (b - I)*(mu*detFi) + I*(lam*lndetF*detFi);
+			}
+
+			// tangent parameters
+			lam1[l] = lam*detFi;
+			mu1[l]  = (mu - lam*lndetF)*detFi;
+		}
+
+		// tangent
+		if (C)
+		{
+			tens4ds_batch c(nl, cbuf);
+			add_isotropic(lam1, mu1, c);
+			for (int l = 0; l < nl; ++l) C[n0 + l] = c.get(l);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 double FENeoHookean::StrainEnergyDensity(FEMaterialPoint& mp)
 {
@@ -40,6 +40,7 @@ SOFTWARE.*/
 #include <FECore/Archive.h>
 #include "FEMechModel.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/sys.h>
 
 FERigidSolver::FERigidSolver(FEModel* fem)
 {
@@ -289,6 +290,85 @@ void FERigidSolver::PrepStep(const FETimeInfo& timeInfo, vector<double>& ui)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void FERigidSolver::RigidStiffnessBuffer::Clear()
+{
+	m_block.clear();
+	m_Krr.clear();
+	m_I.clear();
+	m_J.clear();
+	m_K.clear();
+}
+
+//-----------------------------------------------------------------------------
+//! Returns the 6x6 block that couples rigid body rbi to rigid body rbj
+double* FERigidSolver::RigidStiffnessBuffer::Block(int rbi, int rbj)
+{
+	std::pair<int, int> key(rbi, rbj);
+	std::map<std::pair<int, int>, int>::iterator it = m_block.find(key);
+	if (it != m_block.end()) return &m_Krr[it->second];
+
+	int n = (int)m_Krr.size();
+	m_Krr.resize(n + 36, 0.0);
+	m_block[key] = n;
+	return &m_Krr[n];
+}
+
+//-----------------------------------------------------------------------------
+//! Add a rigid-flexible coupling term
+void FERigidSolver::RigidStiffnessBuffer::Add(int I, int J, double v)
+{
+	m_I.push_back(I);
+	m_J.push_back(J);
+	m_K.push_back(v);
+}
+
+//-----------------------------------------------------------------------------
+//! Clear the per-thread rigid stiffness buffers. This must be called before 
+//! the stiffness matrix is assembled.
+void FERigidSolver::ZeroRigidStiffness()
+{
+	int nt = omp_get_max_threads();
+	if ((int)m_Kbuf.size() < nt) m_Kbuf.resize(nt);
+	for (int i = 0; i < (int)m_Kbuf.size(); ++i) m_Kbuf[i].Clear();
+}
+
+//-----------------------------------------------------------------------------
+//! Add the rigid body contributions that were collected during the assembly
+//! to the global stiffness matrix.
+void FERigidSolver::AssembleRigidStiffness(SparseMatrix& K)
+{
+	if (m_fem == nullptr) return;
+	FEMechModel& fem = *m_fem;
+
+	for (int n = 0; n < (int)m_Kbuf.size(); ++n)
+	{
+		RigidStiffnessBuffer& buf = m_Kbuf[n];
+
+		// rigid-rigid blocks
+		std::map<std::pair<int, int>, int>::iterator it;
+		for (it = buf.m_block.begin(); it != buf.m_block.end(); ++it)
+		{
+			int* lmi = fem.GetRigidBody(it->first.first)->m_LM;
+			int* lmj = fem.GetRigidBody(it->first.second)->m_LM;
+			const double* Krr = &buf.m_Krr[it->second];
+			for (int l = 0; l < 6; ++l)
+				for (int k = 0; k < 6; ++k)
+				{
+					int I = lmi[l];
+					int J = lmj[k];
+					if ((I >= 0) && (J >= 0)) K.add(I, J, Krr[6*l + k]);
+				}
+		}
+
+		// rigid-flexible coupling terms
+		int nk = (int)buf.m_K.size();
+		for (int i = 0; i < nk; ++i) K.add(buf.m_I[i], buf.m_J[i], buf.m_K[i]);
+
+		buf.Clear();
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! This function calculates the rigid stiffness matrices
 void FERigidSolver::RigidStiffness(SparseMatrix& K, vector<double>& ui, vector<double>& F, const FEElementMatrix& ke, double alpha)
@@ -329,6 +409,10 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 	if (en.empty()) return;
     
     int i, j, k, l, n = (int)en.size();
+
+    // the rigid body contributions are collected in a per-thread buffer
+    // and added to the global stiffness matrix in StiffnessMatrix
+    RigidStiffnessBuffer& buf = m_Kbuf[omp_get_thread_num()];
     
     // get nodal DOFS
     DOFS& fedofs = m_fem->GetDOFS();
@@ -423,6 +507,7 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
                     KR[5][3] = M[2][0]; KR[5][4] = M[2][1]; KR[5][5] = M[2][2];
                     
                     // add the stiffness components to the Krr matrix
+                    double* Krr = buf.Block(nodei.m_rid, nodej.m_rid);
                     for (k = 0; k<6; ++k)
                         for (l = 0; l<6; ++l)
                         {
@@ -432,8 +517,12 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
                             if (I >= 0)
                             {
                                 // multiply KR by alpha for alpha rule
-                                if (J < -1) F[I] -= KR[l][k]*ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KR[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KR[l][k]*ui[-J - 2];
+                                }
+                                else if (J >= 0) Krr[6*l + k] += KR[l][k];
                             }
                         }
                     
@@ -456,8 +545,12 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
                             if (I >= 0)
                             {
                                 // multiply KF by alpha for alpha rule
-                                if (J < -1) F[I] -= KF[l][k] * ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KF[l][k] * ui[-J - 2];
+                                }
+                                else if (J >= 0) buf.Add(I, J, KF[l][k]);
                             }
                         }
                     
@@ -477,8 +570,12 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
                             
                             if (I >= 0)
                             {
-                                if (J < -1) F[I] -= KF[l][k] * ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KF[l][k] * ui[-J - 2];
+                                }
+                                else if (J >= 0) buf.Add(I, J, KF[l][k]);
                             }
                         }
                     
@@ -506,8 +603,12 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
                             if (I >= 0)
                             {
                                 // multiply KF by alpha for alpha rule
-                                if (J < -1) F[I] -= KF[l][k] * ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KF[l][k] * ui[-J - 2];
+                                }
+                                else if (J >= 0) buf.Add(I, J, KF[l][k]);
                             }
                         }
                 }
@@ -555,8 +656,12 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
                             
                             if (I >= 0)
                             {
-                                if (J < -1) F[I] -= KF[l][k] * ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KF[l][k] * ui[-J - 2];
+                                }
+                                else if (J >= 0) buf.Add(I, J, KF[l][k]);
                             }
                         }
                 }
@@ -576,6 +681,10 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
 	if (fem.RigidBodies() == 0) return;
     
     int i, j, k, l, n = (int)en.size();
+
+    // the rigid body contributions are collected in a per-thread buffer
+    // and added to the global stiffness matrix in StiffnessMatrix
+    RigidStiffnessBuffer& buf = m_Kbuf[omp_get_thread_num()];
     
     // get nodal DOFS
     DOFS& fedofs = m_fem->GetDOFS();
@@ -689,6 +798,7 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                     KR[5][3] = M[2][0]; KR[5][4] = M[2][1]; KR[5][5] = M[2][2];
                     
                     // add the stiffness components to the Krr matrix
+                    double* Krr = buf.Block(nodei.m_rid, nodej.m_rid);
                     for (k = 0; k<6; ++k)
                         for (l = 0; l<6; ++l)
                         {
@@ -698,8 +808,12 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                             if (I >= 0)
                             {
                                 // multiply KR by alpha for alpha rule
-                                if (J < -1) F[I] -= KR[l][k]*ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KR[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KR[l][k]*ui[-J - 2];
+                                }
+                                else if (J >= 0) Krr[6*l + k] += KR[l][k];
                             }
                         }
                     
@@ -723,8 +837,12 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                             if (I >= 0)
                             {
                                 // multiply KF by alpha for alpha rule
-                                if (J < -1) F[I] -= KF[l][k] * ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KF[l][k] * ui[-J - 2];
+                                }
+                                else if (J >= 0) buf.Add(I, J, KF[l][k]);
                             }
                         }
                     
@@ -746,8 +864,12 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                             
                             if (I >= 0)
                             {
-                                if (J < -1) F[I] -= KF[l][k] * ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KF[l][k] * ui[-J - 2];
+                                }
+                                else if (J >= 0) buf.Add(I, J, KF[l][k]);
                             }
                         }
                     
@@ -776,8 +898,12 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                             if (I >= 0)
                             {
                                 // multiply KF by alpha for alpha rule
-                                if (J < -1) F[I] -= KF[l][k] * ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KF[l][k] * ui[-J - 2];
+                                }
+                                else if (J >= 0) buf.Add(I, J, KF[l][k]);
                             }
                         }
                 }
@@ -831,8 +957,12 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                             
                             if (I >= 0)
                             {
-                                if (J < -1) F[I] -= KF[l][k] * ui[-J - 2];
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
+                                if (J < -1)
+                                {
+                                    #pragma omp atomic
+                                    F[I] -= KF[l][k] * ui[-J - 2];
+                                }
+                                else if (J >= 0) buf.Add(I, J, KF[l][k]);
                             }
                         }
                 }
@@ -928,6 +1058,9 @@ void FERigidSolver::StiffnessMatrix(SparseMatrix& K, const FETimeInfo& tp)
 	if (m_fem == nullptr) return;
 	FEMechModel& fem = *m_fem;
 
+	// add the contributions from the rigid-deformable interfaces
+	AssembleRigidStiffness(K);
+
 	// we still need to set the diagonal elements to 1
 	// for the prescribed rigid body dofs.
 	int NRB = fem.RigidBodies();
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include <FECore/FETimeInfo.h>
 #include <FECore/FESolver.h>
 #include <vector>
+#include <map>
 
 //-----------------------------------------------------------------------------
 class matrix;
@@ -81,6 +82,12 @@ public:
 	// contribution from rigid bodies to stiffness matrix
 	void StiffnessMatrix(SparseMatrix& K, const FETimeInfo& tp);
 
+	// clear the buffers that collect the rigid stiffness during assembly
+	void ZeroRigidStiffness();
+
+	// add the buffered rigid stiffness contributions to the stiffness matrix
+	void AssembleRigidStiffness(SparseMatrix& K);
+
 	// calculate contribution to mass matrix from a rigid body
 	void RigidMassMatrix(FELinearSystem& LS, const FETimeInfo& timeInfo);
 
@@ -101,6 +108,24 @@ protected:
     int         m_dofSX, m_dofSY, m_dofSZ;
     int         m_dofSVX, m_dofSVY, m_dofSVZ;
 	bool		m_bAllowMixedBCs;
+
+protected:
+	// Collects the rigid body stiffness contributions of one thread. 
+	// The Krr blocks are accumulated per rigid body pair, the Kfr and Krf 
+	// terms are stored as a list of entries.
+	struct RigidStiffnessBuffer
+	{
+		std::map<std::pair<int, int>, int>	m_block;	//!< offset of 6x6 Krr block for rigid body pair
+		std::vector<double>	m_Krr;	//!< Krr blocks
+		std::vector<int>	m_I, m_J;	//!< row and column of coupling terms
+		std::vector<double>	m_K;	//!< coupling terms
+
+		void Clear();
+		double* Block(int rbi, int rbj);
+		void Add(int I, int J, double v);
+	};
+
+	std::vector<RigidStiffnessBuffer>	m_Kbuf;	//!< per-thread rigid stiffness buffers
 };
 
 //-----------------------------------------------------------------------------
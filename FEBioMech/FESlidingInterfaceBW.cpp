@@ -285,6 +285,9 @@ FESlidingInterfaceBW::FESlidingInterfaceBW(FEModel* pfem) : FEContactInterface(p
     
     m_naugmin = 0;
     m_naugmax = 10;
+    m_naug = 0;
+    m_biter = 0;
+    m_bfirst = true;
     
     m_bfreeze = false;
     m_bflipm = m_bflips = false;
@@ -302,8 +305,11 @@ FESlidingInterfaceBW::~FESlidingInterfaceBW()
 //-----------------------------------------------------------------------------
 bool FESlidingInterfaceBW::Init()
 {
-    
-    
+    // reset the segment update counters
+    m_naug = 0;
+    m_biter = 0;
+    m_bfirst = true;
+
     // check friction and tension parameters
     // since they cannot be used simultaneously
 	if ((m_mu != 0) && m_btension) {
@@ -612,9 +618,6 @@ void FESlidingInterfaceBW::ProjectSurface(FESlidingSurfaceBW& ss, FESlidingSurfa
 
 void FESlidingInterfaceBW::Update()
 {
-    static int naug = 0;
-    static int biter = 0;
-    
     FEModel& fem = *GetFEModel();
     
     // get the iteration number
@@ -623,13 +626,13 @@ void FESlidingInterfaceBW::Update()
     FEAnalysis* pstep = fem.GetCurrentStep();
     FESolver* psolver = pstep->GetFESolver();
     if (psolver->m_niter == 0) {
-        biter = 0;
-        naug = psolver->m_naug;
-    } else if (psolver->m_naug > naug) {
-        biter = psolver->m_niter;
-        naug = psolver->m_naug;
+        m_biter = 0;
+        m_naug = psolver->m_naug;
+    } else if (psolver->m_naug > m_naug) {
+        m_biter = psolver->m_niter;
+        m_naug = psolver->m_naug;
     }
-    int niter = psolver->m_niter - biter;
+    int niter = psolver->m_niter - m_biter;
     bool bupseg = ((m_nsegup == 0)? true : (niter <= m_nsegup));
     // get the logfile
     //	Logfile& log = GetLogfile();
@@ -637,9 +640,8 @@ void FESlidingInterfaceBW::Update()
     
     // project the surfaces onto each other
     // this will update the gap functions as well
-    static bool bfirst = true;
-    ProjectSurface(m_ss, m_ms, bupseg, (m_breloc && bfirst));
-    bfirst = false;
+    ProjectSurface(m_ss, m_ms, bupseg, (m_breloc && m_bfirst));
+    m_bfirst = false;
     if (m_btwo_pass) ProjectSurface(m_ms, m_ss, bupseg);
     
 	int nsolve_iter = GetFEModel()->GetCurrentStep()->GetFESolver()->m_niter;
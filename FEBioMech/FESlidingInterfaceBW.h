@@ -180,5 +180,10 @@ public:
     bool            m_bshellbm;     //!< flag for prescribing pressure on shell bottom for master surface
     bool            m_bshellbs;     //!< flag for prescribing pressure on shell bottom for slave surface
 
+protected:
+    int	m_naug;		//!< augmentation at last update
+    int	m_biter;	//!< iteration at last augmentation
+    bool	m_bfirst;	//!< first update of this interface
+
     DECLARE_FECORE_CLASS();
 };
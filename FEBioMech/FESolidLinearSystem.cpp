@@ -37,6 +37,9 @@ FESolidLinearSystem::FESolidLinearSystem(FESolver* solver, FERigidSolver* rigidS
 	m_alpha = alpha;
 	m_nreq = nreq;
 	m_stiffnessScale = 1.0;
+
+	// the rigid body stiffness is collected in per-thread buffers
+	if (m_rigidSolver) m_rigidSolver->ZeroRigidStiffness();
 }
 
 // scale factor for stiffness matrix
@@ -77,7 +80,6 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 		FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
 		if (LCM.LinearConstraints() > 0)
 		{
-			#pragma omp critical 
 			LCM.AssembleStiffness(m_K, m_F, m_u, ke.Nodes(), ke.RowIndices(), ke.ColumnsIndices(), ke);
 		}
 
@@ -121,7 +123,7 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 		}
 
 		// see if there are any rigid body dofs here
-		#pragma omp critical 
+		// (this is thread-safe since the contributions are buffered per thread)
 		m_rigidSolver->RigidStiffness(m_K, m_u, m_F, ke, m_alpha);
 	}
 }
@@ -53,6 +53,35 @@ double FESolidMaterial::Density(FEMaterialPoint& pt)
 	return m_density(pt);
 }
 
+//-----------------------------------------------------------------------------
+//! The default implementation evaluates the stress and tangent separately. 
+//! Some tangents use the current Cauchy stress, so it is stored in the 
+//! material point before the tangent is evaluated.
+mat3ds FESolidMaterial::StressAndTangent(FEMaterialPoint& mp, tens4ds& C)
+{
+	mat3ds s = Stress(mp);
+
+	FEElasticMaterialPoint* pt = mp.ExtractData<FEElasticMaterialPoint>();
+	if (pt) pt->m_s = s;
+
+	C = Tangent(mp);
+
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+//! Default batch evaluation, which calls the point-wise functions. Materials can
+//! override this to evaluate parameters once and share work between the points.
+void FESolidMaterial::EvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* C)
+{
+	for (int n = 0; n < npts; ++n)
+	{
+		if (s && C) s[n] = StressAndTangent(*mp[n], C[n]);
+		else if (s) s[n] = Stress(*mp[n]);
+		else if (C) C[n] = Tangent(*mp[n]);
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! calculate the 2nd Piola-Kirchhoff stress at material point, using prescribed Lagrange strain
 //! needed for EAS analyses where the compatible strain (calculated from displacements) is enhanced
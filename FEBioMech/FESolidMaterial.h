@@ -47,6 +47,16 @@ public:
 	//! calculate tangent stiffness at material point
 	virtual tens4ds Tangent(FEMaterialPoint& pt) = 0;
 
+	//! calculate stress and tangent stiffness at material point in one pass.
+	//! Materials that share intermediate quantities between Stress and Tangent
+	//! can override this to avoid evaluating them twice.
+	virtual mat3ds StressAndTangent(FEMaterialPoint& pt, tens4ds& C);
+
+	//! Evaluate the stress and/or tangent at a batch of material points (e.g. all 
+	//! integration points of an element). Either s or C can be null, in which case
+	//! that quantity is not evaluated. The default evaluates the points one by one.
+	virtual void EvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* C);
+
 	//! calculate the 2nd Piola-Kirchhoff stress at material point
 	virtual mat3ds PK2Stress(FEMaterialPoint& pt, const mat3ds E);
 
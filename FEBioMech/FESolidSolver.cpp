@@ -44,6 +44,7 @@ SOFTWARE.*/
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/FESurfaceLoad.h>
 #include <FECore/FEBodyLoad.h>
+#include <FECore/FETelemetry.h>
 #include <assert.h>
 #include "FEBioMech.h"
 
@@ -468,6 +469,15 @@ bool FESolidSolver::Quasin()
 			bconv = true;
 		}
 
+		// write the convergence telemetry
+		if (GetFEModel()->GetTelemetry().IsOpen())
+		{
+			AddTelemetryNorm("residual", normRi, normR1, m_Rtol*normRi);
+			AddTelemetryNorm("energy", normEi, normE1, m_Etol*normEi);
+			AddTelemetryNorm("displacement", normUi, normu, (m_Dtol*m_Dtol)*normU);
+			WriteIterationTelemetry(s, bconv);
+		}
+
 		// check if we have converged. 
 		// If not, calculate the BFGS update vectors
 		if (bconv == false)
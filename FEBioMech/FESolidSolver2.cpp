@@ -50,6 +50,7 @@ SOFTWARE.*/
 #include <FECore/vector.h>
 #include "FESolidLinearSystem.h"
 #include "FEBioMech.h"
+#include <FECore/FETelemetry.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -835,6 +836,8 @@ bool FESolidSolver2::Quasin()
 		feLog("\tstiffness updates             = %d\n", m_qnstrategy->m_nups);
 		feLog("\tright hand side evaluations   = %d\n", m_nrhs);
 		feLog("\tstiffness matrix reformations = %d\n", m_nref);
+		LogLinearSolverIterations();
+		LogElementWorkspaceAllocations();
 		if (m_lineSearch->m_LStol > 0) feLog("\tstep from line search         = %lf\n", s);
 		feLog("\tconvergence norms :     INITIAL         CURRENT         REQUIRED\n");
 		feLog("\t   residual         %15le %15le %15le \n", normRi, normR1, m_Rtol*normRi);
@@ -850,6 +853,15 @@ bool FESolidSolver2::Quasin()
 			bconv = true;
 		}
 
+		// write the convergence telemetry
+		if (fem.GetTelemetry().IsOpen())
+		{
+			AddTelemetryNorm("residual", normRi, normR1, m_Rtol*normRi);
+			AddTelemetryNorm("energy", normEi, normE1, m_Etol*normEi);
+			AddTelemetryNorm("displacement", normUi, normu, (m_Dtol*m_Dtol)*normU);
+			WriteIterationTelemetry(s, bconv);
+		}
+
 		// see if we have exceeded the max residual
 		if ((bconv == false) && (m_Rmax > 0) && (normR1 >= m_Rmax))
 		{
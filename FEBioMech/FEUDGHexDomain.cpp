@@ -46,35 +46,12 @@ void FEUDGHexDomain::SetHourGlassParameter(double hg)
 }
 
 //-----------------------------------------------------------------------------
-void FEUDGHexDomain::InternalForces(FEGlobalVector& R)
+//! The element loop (and its parallelization) is inherited from the base class.
+void FEUDGHexDomain::ElementInternalForce(FESolidElement& el, vector<double>& fe)
 {
-	// element force vector
-	vector<double> fe;
-
-	vector<int> lm;
-
-	int NE = (int)m_Elem.size();
-	for (int i=0; i<NE; ++i)
-	{
-		// get the element
-		FESolidElement& el = m_Elem[i];
-
-		// get the element force vector and initialize it to zero
-		int ndof = 3*el.Nodes();
-		fe.assign(ndof, 0);
-
-		// calculate internal force vector
-		UDGInternalForces(el, fe);
-
-		// get the element's LM vector
-		UnpackLM(el, lm);
-
-		// assemble element 'fe'-vector into global R vector
-		R.Assemble(el.m_node, lm, fe);
-	}
+	UDGInternalForces(el, fe);
 }
 
-
 //-----------------------------------------------------------------------------
 //! calculates the internal equivalent nodal forces for enhanced strain
 //! solid elements.
@@ -491,58 +468,47 @@ void FEUDGHexDomain::UDGMaterialStiffness(FESolidElement &el, matrix &ke)
 }
 
 //-----------------------------------------------------------------------------
-void FEUDGHexDomain::Update(const FETimeInfo& tp)
+void FEUDGHexDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
 {
-	int nint, neln;
-	double* gw;
 	vec3d r0[8], rt[8];
 
-	for (int i=0; i<(int) m_Elem.size(); ++i)
-	{
-		// get the solid element
-		FESolidElement& el = m_Elem[i];
-
-		// get the number of integration points
-		nint = el.GaussPoints();
+	// get the solid element
+	FESolidElement& el = m_Elem[iel];
 
-		// number of nodes
-		neln = el.Nodes();
-
-		// nodal coordinates
-		for (int j=0; j<neln; ++j)
-		{
-			r0[j] = m_pMesh->Node(el.m_node[j]).m_r0;
-			rt[j] = m_pMesh->Node(el.m_node[j]).m_rt;
-		}
+	// number of nodes
+	int neln = el.Nodes();
 
-		// get the integration weights
-		gw = el.GaussWeights();
+	// nodal coordinates
+	for (int j=0; j<neln; ++j)
+	{
+		r0[j] = m_pMesh->Node(el.m_node[j]).m_r0;
+		rt[j] = m_pMesh->Node(el.m_node[j]).m_rt;
+	}
 
-		// for the enhanced strain hex we need a slightly different procedure
-		// for calculating the element's stress. For this element, the stress
-		// is evaluated using an average deformation gradient.
+	// for the enhanced strain hex we need a slightly different procedure
+	// for calculating the element's stress. For this element, the stress
+	// is evaluated using an average deformation gradient.
 
-		// get the material point data
-		FEMaterialPoint& mp = *el.GetMaterialPoint(0);
-		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+	// get the material point data
+	FEMaterialPoint& mp = *el.GetMaterialPoint(0);
+	FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
 
-		// material point coordinates
-		// TODO: I'm not entirly happy with this solution
-		//		 since the material point coordinates are used by most materials.
-		pt.m_r0 = el.Evaluate(r0, 0);
-		pt.m_rt = el.Evaluate(rt, 0);
+	// material point coordinates
+	// TODO: I'm not entirly happy with this solution
+	//		 since the material point coordinates are used by most materials.
+	pt.m_r0 = el.Evaluate(r0, 0);
+	pt.m_rt = el.Evaluate(rt, 0);
 
-		// get the average cartesian derivatives
-		double GX[8], GY[8], GZ[8];
-		AvgCartDerivs(el, GX, GY, GZ);
+	// get the average cartesian derivatives
+	double GX[8], GY[8], GZ[8];
+	AvgCartDerivs(el, GX, GY, GZ);
 
-		// get the average deformation gradient and determinant
-		AvgDefGrad(el, pt.m_F, GX, GY, GZ);
-		pt.m_J = pt.m_F.det();
+	// get the average deformation gradient and determinant
+	AvgDefGrad(el, pt.m_F, GX, GY, GZ);
+	pt.m_J = pt.m_F.det();
 
-		// calculate the stress at this material point
-		pt.m_s = m_pMat->Stress(mp);
-	}
+	// calculate the stress at this material point
+	pt.m_s = m_pMat->Stress(mp);
 }
 
 //-----------------------------------------------------------------------------
@@ -41,14 +41,14 @@ public:
 	void SetHourGlassParameter(double hg);
 
 public:
-	//! calculates the residual
-	void InternalForces(FEGlobalVector& R) override;
-
 	//! calculates the global stiffness matrix for this domain
 	void StiffnessMatrix(FELinearSystem& LS) override;
 
-	// update domain data
-	void Update(const FETimeInfo& tp) override;
+	//! update the element stress
+	void UpdateElementStress(int iel, const FETimeInfo& tp) override;
+
+	//! Calculates the internal stress vector for UDG elements
+	void ElementInternalForce(FESolidElement& el, vector<double>& fe) override;
 
 protected: // element residual contributions
 	//! Calculates the internal stress vector for enhanced strain hex elements
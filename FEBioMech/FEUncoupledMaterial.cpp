@@ -98,6 +98,65 @@ tens4ds FEUncoupledMaterial::Tangent(FEMaterialPoint &mp)
 	return DevTangent(mp) + (IxI - I4*2)*p + IxI*(UJJ(pt.m_J)*pt.m_J);
 }
 
+//-----------------------------------------------------------------------------
+//! Evaluates the total stress and the total spatial tangent in one pass, as a 
+//! batch of one point. The deviatoric part is delegated to DevEvaluateBatch, 
+//! which materials can override.
+mat3ds FEUncoupledMaterial::StressAndTangent(FEMaterialPoint& mp, tens4ds& C)
+{
+	FEMaterialPoint* pmp = &mp;
+	mat3ds s;
+	EvaluateBatch(&pmp, 1, &s, &C);
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+//! The default implementation evaluates the deviatoric stress and tangent 
+//! separately. The total stress is stored in the material point first, since 
+//! some deviatoric tangents depend on it.
+mat3ds FEUncoupledMaterial::DevStressAndTangent(FEMaterialPoint& mp, tens4ds& Cdev)
+{
+	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
+
+	mat3ds s = DevStress(mp);
+	pt.m_s = s + mat3dd(UJ(pt.m_J));
+
+	Cdev = DevTangent(mp);
+
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+//! Batch version of Stress and Tangent. The deviatoric part is evaluated for all
+//! points by DevEvaluateBatch, after which the pressure terms are added.
+void FEUncoupledMaterial::EvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* C)
+{
+	DevEvaluateBatch(mp, npts, s, C);
+
+	mat3dd I(1);
+	tens4ds IxI = dyad1s(I);
+	tens4ds I4  = dyad4s(I);
+	for (int n = 0; n < npts; ++n)
+	{
+		FEElasticMaterialPoint& pt = *mp[n]->ExtractData<FEElasticMaterialPoint>();
+		double p = UJ(pt.m_J);
+		if (s) s[n] += mat3dd(p);
+		if (C) C[n] += (IxI - I4*2)*p + IxI*(UJJ(pt.m_J)*pt.m_J);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Default batch evaluation of the deviatoric stress and tangent
+void FEUncoupledMaterial::DevEvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* Cdev)
+{
+	for (int n = 0; n < npts; ++n)
+	{
+		if (s && Cdev) s[n] = DevStressAndTangent(*mp[n], Cdev[n]);
+		else if (s) s[n] = DevStress(*mp[n]);
+		else if (Cdev) Cdev[n] = DevTangent(*mp[n]);
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! The strain energy density function calculates the total sed as a sum of
 //! two terms, namely the deviatoric sed and U(J).
@@ -66,6 +66,12 @@ public:
 	//! Deviatoric spatial Tangent
 	virtual tens4ds DevTangent(FEMaterialPoint& mp) = 0;
 
+	//! Deviatoric stress and tangent in one pass (default calls DevStress and DevTangent)
+	virtual mat3ds DevStressAndTangent(FEMaterialPoint& mp, tens4ds& Cdev);
+
+	//! Deviatoric stress and/or tangent at a batch of points (default evaluates the points one by one)
+	virtual void DevEvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* Cdev);
+
 	//! Deviatoric strain energy density
 	virtual double DevStrainEnergyDensity(FEMaterialPoint& mp) { return 0; }
     
@@ -112,6 +118,12 @@ public:
 	//! total spatial tangent (do not overload!)
 	tens4ds Tangent(FEMaterialPoint& mp) final;
 
+	//! total stress and spatial tangent (do not overload!)
+	mat3ds StressAndTangent(FEMaterialPoint& mp, tens4ds& C) final;
+
+	//! total stress and/or spatial tangent at a batch of points (do not overload!)
+	void EvaluateBatch(FEMaterialPoint** mp, int npts, mat3ds* s, tens4ds* C) final;
+
 	//! calculate strain energy (do not overload!)
 	double StrainEnergyDensity(FEMaterialPoint& pt) final;
 
@@ -34,6 +34,7 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FEBioMech/FEBioMech.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementWorkspace.h>
 #include "FEBioMix.h"
 
 //-----------------------------------------------------------------------------
@@ -244,12 +245,12 @@ void FEBiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 	int degree_p = dofs.GetVariableInterpolationOrder(m_varP);
 
 	int NE = (int)m_Elem.size();
+	m_ws.Prepare();
 	#pragma omp parallel for shared (NE)
 	for (int i=0; i<NE; ++i)
 	{
-		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		// scratch space of this thread
+		FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
 		
 		// get the element
 		FESolidElement& el = m_Elem[i];
@@ -259,7 +260,8 @@ void FEBiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 
 		// get the element force vector and initialize it to zero
 		int ndof = 4*nel_d;
-		fe.assign(ndof, 0);
+		vector<double>& fe = ws.ElementVector(ndof);
+		vector<int>& lm = ws.LM();
 
 		// calculate internal force vector
 		ElementInternalForce(el, fe);
@@ -370,19 +372,20 @@ void FEBiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<doub
 void FEBiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 4*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = ws.ElementVector(ndof);
+        vector<int>& lm = ws.LM();
         
         // calculate internal force vector
         ElementInternalForceSS(el, fe);
@@ -488,16 +491,18 @@ void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 {
 	// repeat over all solid elements
 	int NE = (int)m_Elem.size();
+	m_ws.Prepare();
     
     #pragma omp parallel for shared(NE)
 	for (int iel=0; iel<NE; ++iel)
 	{
 		FESolidElement& el = m_Elem[iel];
 
-		// element stiffness matrix
-		FEElementMatrix ke(el);
+		// scratch space of this thread
+		FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
 		int ndof = el.Nodes()*4;
-		ke.resize(ndof, ndof);
+		// element stiffness matrix
+		FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
 		
 		// calculate the element stiffness matrix
 		ElementBiphasicStiffness(el, ke, bsymm);
@@ -507,7 +512,7 @@ void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 		// have to create a new lm array and place the equation numbers in the right order.
 		// What we really ought to do is fix the UnpackLM function so that it returns
 		// the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -521,16 +526,18 @@ void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 {
 	// repeat over all solid elements
 	int NE = (int)m_Elem.size();
+	m_ws.Prepare();
 
 	#pragma omp parallel for shared(NE)
 	for (int iel=0; iel<NE; ++iel)
 	{
 		FESolidElement& el = m_Elem[iel];
 
-		// element stiffness matrix
-		FEElementMatrix ke(el);
+		// scratch space of this thread
+		FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
 		int ndof = el.Nodes()*4;
-		ke.resize(ndof, ndof);
+		// element stiffness matrix
+		FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
 		
 		// calculate the element stiffness matrix
 		ElementBiphasicStiffnessSS(el, ke, bsymm);
@@ -540,7 +547,7 @@ void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		// have to create a new lm array and place the equation numbers in the right order.
 		// What we really ought to do is fix the UnpackLM function so that it returns
 		// the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -1015,16 +1022,17 @@ void FEBiphasicSolidDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
     
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     for (int iel=0; iel<NE; ++iel)
     {
         FESolidElement& el = m_Elem[iel];
 
-		// element stiffness matrix
-		FEElementMatrix ke(el);
+		// scratch space of this thread
+		FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         int neln = el.Nodes();
         int ndof = 4*neln;
-        ke.resize(ndof, ndof);
-        ke.zero();
+        // element stiffness matrix
+        FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke);
@@ -1034,7 +1042,7 @@ void FEBiphasicSolidDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         // have to create a new lm array and place the equation numbers in the right order.
         // What we really ought to do is fix the UnpackLM function so that it returns
         // the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
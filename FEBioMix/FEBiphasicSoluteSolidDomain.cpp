@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FEBioMech/FEBioMech.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementWorkspace.h>
 
 //-----------------------------------------------------------------------------
 FEBiphasicSoluteSolidDomain::FEBiphasicSoluteSolidDomain(FEModel* pfem) : FESolidDomain(pfem), FEBiphasicSoluteDomain(pfem), m_dofU(pfem), m_dofSU(pfem), m_dofR(pfem), m_dof(pfem)
@@ -324,19 +325,20 @@ void FEBiphasicSoluteSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FEBiphasicSoluteSolidDomain::InternalForces(FEGlobalVector& R)
 {
     size_t NE = m_Elem.size();
+    m_ws.Prepare();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 5*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = ws.ElementVector(ndof);
+        vector<int>& lm = ws.LM();
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -439,19 +441,20 @@ void FEBiphasicSoluteSolidDomain::ElementInternalForce(FESolidElement& el, vecto
 void FEBiphasicSoluteSolidDomain::InternalForcesSS(FEGlobalVector& R)
 {
     size_t NE = m_Elem.size();
+    m_ws.Prepare();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 5*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = ws.ElementVector(ndof);
+        vector<int>& lm = ws.LM();
         
         // calculate internal force vector
         ElementInternalForceSS(el, fe);
@@ -548,23 +551,25 @@ void FEBiphasicSoluteSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm
 {
     // repeat over all solid elements
     const int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
 		FESolidElement& el = m_Elem[iel];
 
-        // element stiffness matrix
-        FEElementMatrix ke(el);
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         int neln = el.Nodes();
         int ndof = neln*5;
-        ke.resize(ndof, ndof);
+        // element stiffness matrix
+        FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementBiphasicSoluteStiffness(el, ke, bsymm);
 
 		// get lm vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -580,23 +585,25 @@ void FEBiphasicSoluteSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsy
 {
     // repeat over all solid elements
     const int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
 		FESolidElement& el = m_Elem[iel];
 
-        // element stiffness matrix
-        FEElementMatrix ke(el);
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         int neln = el.Nodes();
         int ndof = neln*5;
-        ke.resize(ndof, ndof);
+        // element stiffness matrix
+        FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementBiphasicSoluteStiffnessSS(el, ke, bsymm);
 
 		// get lm vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -41,6 +41,7 @@ SOFTWARE.*/
 #include <FECore/FENodalLoad.h>
 #include <FECore/FESurfaceLoad.h>
 #include "FECore/sys.h"
+#include <FECore/FETelemetry.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -325,6 +326,8 @@ bool FEBiphasicSoluteSolver::Quasin()
 		feLog("\tstiffness updates             = %d\n", m_qnstrategy->m_nups);
 		feLog("\tright hand side evaluations   = %d\n", m_nrhs);
 		feLog("\tstiffness matrix reformations = %d\n", m_nref);
+		LogLinearSolverIterations();
+		LogElementWorkspaceAllocations();
 		if (m_lineSearch->m_LStol > 0) feLog("\tstep from line search         = %lf\n", s);
 		feLog("\tconvergence norms :        INITIAL         CURRENT         REQUIRED\n");
 		feLog("\t residual               %15le %15le %15le\n", normRi, normR1, m_Rtol*normRi);
@@ -344,6 +347,16 @@ bool FEBiphasicSoluteSolver::Quasin()
 			bconv = true;
 		}
 
+		// write the convergence telemetry
+		if (GetFEModel()->GetTelemetry().IsOpen())
+		{
+			AddTelemetryNorm("residual", normRi, normR1, m_Rtol*normRi);
+			AddTelemetryNorm("energy", normEi, normE1, m_Etol*normEi);
+			AddTelemetryNorm("displacement", normDi, normd, (m_Dtol*m_Dtol)*normD);
+			AddTelemetryNorm("fluid pressure", normPi, normp, (m_Ptol*m_Ptol)*normP);
+			WriteIterationTelemetry(s, bconv);
+		}
+
 		// check if we have converged. 
 		// If not, calculate the BFGS update vectors
 		if (bconv == false)
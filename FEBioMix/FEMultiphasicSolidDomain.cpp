@@ -35,15 +35,78 @@ SOFTWARE.*/
 #include "FECore/DOFS.h"
 #include <FEBioMech/FEBioMech.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementWorkspace.h>
 
 #ifndef SQR
 #define SQR(x) ((x)*(x))
 #endif
 
+//-----------------------------------------------------------------------------
+// Containers for the per-solute data of the element kernels. When the number of
+// solutes NSOL is known at compile time the data is stored on the stack. The
+// specialization for NSOL = 0 is used by the generic kernels and sizes the data
+// at runtime.
+template <typename T, int NSOL> class FESoluteArray
+{
+public:
+	explicit FESoluteArray(int n) {}
+	FESoluteArray(int n, const T& v) { assign(n, v); }
+
+	void assign(int n, const T& v) { for (int i=0; i<NSOL; ++i) m_d[i] = v; }
+
+	T& operator [] (int i) { return m_d[i]; }
+	const T& operator [] (int i) const { return m_d[i]; }
+
+private:
+	T	m_d[NSOL];
+};
+
+template <typename T> class FESoluteArray<T, 0>
+{
+public:
+	explicit FESoluteArray(int n) : m_d(n) {}
+	FESoluteArray(int n, const T& v) : m_d(n, v) {}
+
+	void assign(int n, const T& v) { m_d.assign(n, v); }
+
+	T& operator [] (int i) { return m_d[i]; }
+	const T& operator [] (int i) const { return m_d[i]; }
+
+private:
+	vector<T>	m_d;
+};
+
+// NSOL x NSOL matrix of per-solute data, accessed as a[i][j]
+template <typename T, int NSOL> class FESoluteMatrix
+{
+public:
+	explicit FESoluteMatrix(int n) {}
+
+	T* operator [] (int i) { return m_d + i*NSOL; }
+	const T* operator [] (int i) const { return m_d + i*NSOL; }
+
+private:
+	T	m_d[NSOL*NSOL];
+};
+
+template <typename T> class FESoluteMatrix<T, 0>
+{
+public:
+	explicit FESoluteMatrix(int n) : m_n(n), m_d(n*n) {}
+
+	T* operator [] (int i) { return &m_d[i*m_n]; }
+	const T* operator [] (int i) const { return &m_d[i*m_n]; }
+
+private:
+	int			m_n;
+	vector<T>	m_d;
+};
+
 //-----------------------------------------------------------------------------
 FEMultiphasicSolidDomain::FEMultiphasicSolidDomain(FEModel* pfem) : FESolidDomain(pfem), FEMultiphasicDomain(pfem), m_dofU(pfem), m_dofSU(pfem), m_dofR(pfem), m_dof(pfem)
 {
     m_pMat = 0;
+	m_nsolKernel = 0;
 	m_dofU.AddVariable(FEBioMech::GetVariableName(FEBioMech::DISPLACEMENT));
 	m_dofSU.AddVariable(FEBioMech::GetVariableName(FEBioMech::SHELL_DISPLACEMENT));
 	m_dofR.AddVariable(FEBioMech::GetVariableName(FEBioMech::RIGID_ROTATION));
@@ -195,6 +258,10 @@ bool FEMultiphasicSolidDomain::Init()
 	}
 	m_dof = dofs;
 
+	// select the element kernels. Specialized kernels are available for up to
+	// four solutes, otherwise we fall back to the generic kernels.
+	m_nsolKernel = ((nsol >= 1) && (nsol <= 4) ? nsol : 0);
+
     return true;
 }
 
@@ -487,6 +554,7 @@ void FEMultiphasicSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FEMultiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 {
     size_t NE = m_Elem.size();
+    m_ws.Prepare();
     
     // get nodal DOFS
     int nsol = m_pMat->Solutes();
@@ -495,16 +563,16 @@ void FEMultiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = ws.ElementVector(ndof);
+        vector<int>& lm = ws.LM();
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -521,6 +589,20 @@ void FEMultiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 //! calculates the internal equivalent nodal forces for solid elements
 
 void FEMultiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<double>& fe)
+{
+    switch (m_nsolKernel)
+    {
+    case 1: ElementInternalForceT<1>(el, fe); break;
+    case 2: ElementInternalForceT<2>(el, fe); break;
+    case 3: ElementInternalForceT<3>(el, fe); break;
+    case 4: ElementInternalForceT<4>(el, fe); break;
+    default:
+        ElementInternalForceT<0>(el, fe);
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <int NSOL> void FEMultiphasicSolidDomain::ElementInternalForceT(FESolidElement& el, vector<double>& fe)
 {
     int i, isol, n;
     
@@ -537,7 +619,7 @@ void FEMultiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<d
     
     double*	gw = el.GaussWeights();
     
-    const int nsol = m_pMat->Solutes();
+    const int nsol = (NSOL > 0 ? NSOL : m_pMat->Solutes());
     int ndpn = 4+nsol;
     
     const int nreact = m_pMat->Reactions();
@@ -576,9 +658,8 @@ void FEMultiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<d
         // get the flux
         vec3d& w = bpt.m_w;
         
-        vector<vec3d> j(spt.m_j);
-        vector<int> z(nsol);
-        vector<double> kappa(spt.m_k);
+        const vector<vec3d>& j = spt.m_j;
+        FESoluteArray<int, NSOL> z(nsol);
         vec3d je(0,0,0);
         
         for (isol=0; isol<nsol; ++isol) {
@@ -589,7 +670,7 @@ void FEMultiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<d
         
         // evaluate the porosity, its derivative w.r.t. J, and its gradient
         double phiw = m_pMat->Porosity(mp);
-        vector<double> chat(nsol,0);
+        FESoluteArray<double, NSOL> chat(nsol, 0.0);
         
         // get the solvent supply
         double phiwhat = 0;
@@ -633,6 +714,7 @@ void FEMultiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<d
 void FEMultiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
 {
     size_t NE = m_Elem.size();
+    m_ws.Prepare();
     
     // get nodal DOFS
     int nsol = m_pMat->Solutes();
@@ -641,16 +723,16 @@ void FEMultiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = ws.ElementVector(ndof);
+        vector<int>& lm = ws.LM();
         
         // calculate internal force vector
         ElementInternalForceSS(el, fe);
@@ -776,25 +858,26 @@ void FEMultiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
     
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
 		FESolidElement& el = m_Elem[iel];
 
-        // element stiffness matrix
-        FEElementMatrix ke(el);
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
 
         // allocate stiffness matrix
         int neln = el.Nodes();
         int ndof = neln*ndpn;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementMultiphasicStiffness(el, ke, bsymm);
 
 		// get the lm vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -811,25 +894,26 @@ void FEMultiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
     
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    m_ws.Prepare();
     
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
 		FESolidElement& el = m_Elem[iel];
 
-        // element stiffness matrix
-        FEElementMatrix ke(el);
+        // scratch space of this thread
+        FEElementWorkspace& ws = m_ws.GetThreadWorkspace();
 
         // allocate stiffness matrix
         int neln = el.Nodes();
         int ndof = neln*ndpn;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementMultiphasicStiffnessSS(el, ke, bsymm);
 
 		// get the lm vector
-		vector<int> lm;
+		vector<int>& lm = ws.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -842,6 +926,19 @@ void FEMultiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 //! calculates element stiffness matrix for element iel
 //!
 bool FEMultiphasicSolidDomain::ElementMultiphasicStiffness(FESolidElement& el, matrix& ke, bool bsymm)
+{
+    switch (m_nsolKernel)
+    {
+    case 1: return ElementMultiphasicStiffnessT<1>(el, ke, bsymm);
+    case 2: return ElementMultiphasicStiffnessT<2>(el, ke, bsymm);
+    case 3: return ElementMultiphasicStiffnessT<3>(el, ke, bsymm);
+    case 4: return ElementMultiphasicStiffnessT<4>(el, ke, bsymm);
+    }
+    return ElementMultiphasicStiffnessT<0>(el, ke, bsymm);
+}
+
+//-----------------------------------------------------------------------------
+template <int NSOL> bool FEMultiphasicSolidDomain::ElementMultiphasicStiffnessT(FESolidElement& el, matrix& ke, bool bsymm)
 {
     int i, j, isol, jsol, n, ireact, isbm;
     
@@ -861,7 +958,7 @@ bool FEMultiphasicSolidDomain::ElementMultiphasicStiffness(FESolidElement& el, m
     
     double dt = GetFEModel()->GetTime().timeIncrement;
     
-    const int nsol = m_pMat->Solutes();
+    const int nsol = (NSOL > 0 ? NSOL : m_pMat->Solutes());
     int ndpn = 4+nsol;
     
     const int nsbm   = m_pMat->SBMs();
@@ -908,21 +1005,21 @@ bool FEMultiphasicSolidDomain::ElementMultiphasicStiffness(FESolidElement& el, m
         vec3d w = ppt.m_w;
         vec3d gradp = ppt.m_gradp;
         
-        vector<double> c(spt.m_c);
-        vector<vec3d> gradc(spt.m_gradc);
-        vector<int> z(nsol);
+        const vector<double>& c = spt.m_c;
+        const vector<vec3d>& gradc = spt.m_gradc;
+        FESoluteArray<int, NSOL> z(nsol);
         
-        vector<double> kappa(spt.m_k);
+        const vector<double>& kappa = spt.m_k;
         
         // get the charge number
         for (isol=0; isol<nsol; ++isol)
             z[isol] = m_pMat->GetSolute(isol)->ChargeNumber();
         
-        vector<double> dkdJ(spt.m_dkdJ);
-        vector< vector<double> > dkdc(spt.m_dkdc);
-        vector< vector<double> > dkdr(spt.m_dkdr);
-        vector< vector<double> > dkdJr(spt.m_dkdJr);
-        vector< vector< vector<double> > > dkdrc(spt.m_dkdrc);
+        const vector<double>& dkdJ = spt.m_dkdJ;
+        const vector< vector<double> >& dkdc = spt.m_dkdc;
+        const vector< vector<double> >& dkdr = spt.m_dkdr;
+        const vector< vector<double> >& dkdJr = spt.m_dkdJr;
+        const vector< vector< vector<double> > >& dkdrc = spt.m_dkdrc;
         
         // evaluate the porosity and its derivative
         double phiw = m_pMat->Porosity(mp);
@@ -937,22 +1034,22 @@ bool FEMultiphasicSolidDomain::ElementMultiphasicStiffness(FESolidElement& el, m
         mat3ds K = m_pMat->GetPermeability()->Permeability(mp);
         tens4dmm dKdE = m_pMat->GetPermeability()->Tangent_Permeability_Strain(mp);
         
-        vector<mat3ds> dKdc(nsol);
-        vector<mat3ds> D(nsol);
-        vector<tens4dmm> dDdE(nsol);
-        vector< vector<mat3ds> > dDdc(nsol, vector<mat3ds>(nsol));
-        vector<double> D0(nsol);
-        vector< vector<double> > dD0dc(nsol, vector<double>(nsol));
-        vector<double> dodc(nsol);
-        vector<mat3ds> dTdc(nsol);
-        vector<mat3ds> ImD(nsol);
+        FESoluteArray<mat3ds, NSOL> dKdc(nsol);
+        FESoluteArray<mat3ds, NSOL> D(nsol);
+        FESoluteArray<tens4dmm, NSOL> dDdE(nsol);
+        FESoluteMatrix<mat3ds, NSOL> dDdc(nsol);
+        FESoluteArray<double, NSOL> D0(nsol);
+        FESoluteMatrix<double, NSOL> dD0dc(nsol);
+        FESoluteArray<double, NSOL> dodc(nsol);
+        FESoluteArray<mat3ds, NSOL> dTdc(nsol);
+        FESoluteArray<mat3ds, NSOL> ImD(nsol);
         mat3dd I(1);
         
         // evaluate the solvent supply and its derivatives
         mat3ds Phie; Phie.zero();
         double Phip = 0;
-        vector<double> Phic(nsol,0);
-        vector<mat3ds> dchatde(nsol);
+        FESoluteArray<double, NSOL> Phic(nsol, 0.0);
+        FESoluteArray<mat3ds, NSOL> dchatde(nsol);
         if (m_pMat->GetSolventSupply()) {
             Phie = m_pMat->GetSolventSupply()->Tangent_Supply_Strain(mp);
             Phip = m_pMat->GetSolventSupply()->Tangent_Supply_Pressure(mp);
@@ -1011,8 +1108,8 @@ bool FEMultiphasicSolidDomain::ElementMultiphasicStiffness(FESolidElement& el, m
         mat3ds Ki = K.inverse();
         mat3ds Ke(0,0,0,0,0,0);
         tens4d G = (dyad1(Ki,I) - dyad4(Ki,I)*2)*2 - ddot(dyad2(Ki,Ki),dKdE);
-        vector<mat3ds> Gc(nsol);
-        vector<mat3ds> dKedc(nsol);
+        FESoluteArray<mat3ds, NSOL> Gc(nsol);
+        FESoluteArray<mat3ds, NSOL> dKedc(nsol);
         for (isol=0; isol<nsol; ++isol) {
             Ke += ImD[isol]*(kappa[isol]*c[isol]/D0[isol]);
             G += dyad1(ImD[isol],I)*(R*T*c[isol]*J/D0[isol]/phiw*(dkdJ[isol]-kappa[isol]/phiw*dpdJ))
@@ -1031,12 +1128,12 @@ bool FEMultiphasicSolidDomain::ElementMultiphasicStiffness(FESolidElement& el, m
         
         // calculate all the matrices
         vec3d vtmp,gp,qpu;
-        vector<vec3d> gc(nsol),qcu(nsol),wc(nsol),jce(nsol);
-        vector< vector<vec3d> > jc(nsol, vector<vec3d>(nsol));
+        FESoluteArray<vec3d, NSOL> gc(nsol), qcu(nsol), wc(nsol), jce(nsol);
+        FESoluteMatrix<vec3d, NSOL> jc(nsol);
         mat3d wu, jue;
-        vector<mat3d> ju(nsol);
-        vector< vector<double> > qcc(nsol, vector<double>(nsol));
-        vector< vector<double> > dchatdc(nsol, vector<double>(nsol));
+        FESoluteArray<mat3d, NSOL> ju(nsol);
+        FESoluteMatrix<double, NSOL> qcc(nsol);
+        FESoluteMatrix<double, NSOL> dchatdc(nsol);
         double sum;
         mat3ds De;
         for (i=0; i<neln; ++i)
@@ -103,6 +103,13 @@ public:
     //! calculates the element triphasic stiffness matrix
     bool ElementMultiphasicStiffnessSS(FESolidElement& el, matrix& ke, bool bsymm);
     
+protected:
+    // Element kernels specialized on the number of solutes. For NSOL > 0 the
+    // per-solute data is kept in fixed-size arrays; NSOL = 0 is the generic kernel
+    // that sizes everything at runtime.
+    template <int NSOL> void ElementInternalForceT(FESolidElement& el, vector<double>& fe);
+    template <int NSOL> bool ElementMultiphasicStiffnessT(FESolidElement& el, matrix& ke, bool bsymm);
+    
 protected: // overridden from FEElasticDomain, but not implemented in this domain
     void BodyForce(FEGlobalVector& R, FEBodyForce& bf) override {}
     void InertialForces(FEGlobalVector& R, vector<double>& F) override {}
@@ -115,4 +122,6 @@ protected:
 	FEDofList	m_dofSU;
 	FEDofList	m_dofR;
 	FEDofList	m_dof;
+
+	int			m_nsolKernel;	//!< solute count of the specialized element kernels (0 = generic kernels)
 };
@@ -488,6 +488,9 @@ FESlidingInterface2::FESlidingInterface2(FEModel* pfem) : FEContactInterface(pfe
 
 	m_naugmin = 0;
 	m_naugmax = 10;
+	m_naug = 0;
+	m_biter = 0;
+	m_bfirst = true;
 
 	m_dofP = pfem->GetDOFIndex("p");
 
@@ -504,6 +507,11 @@ FESlidingInterface2::~FESlidingInterface2()
 //-----------------------------------------------------------------------------
 bool FESlidingInterface2::Init()
 {
+	// reset the segment update counters
+	m_naug = 0;
+	m_biter = 0;
+	m_bfirst = true;
+
 	// initialize surface data
 	if (m_ss.Init() == false) return false;
 	if (m_ms.Init() == false) return false;
@@ -895,9 +903,6 @@ void FESlidingInterface2::Update()
 
 	double R = m_srad*GetFEModel()->GetMesh().GetBoundingBox().radius();
 
-	static int naug = 0;
-	static int biter = 0;
-
 	FEModel& fem = *GetFEModel();
 	
 	// get the iteration number
@@ -906,13 +911,13 @@ void FESlidingInterface2::Update()
 	FEAnalysis* pstep = fem.GetCurrentStep();
 	FESolver* psolver = pstep->GetFESolver();
 	if (psolver->m_niter == 0) {
-		biter = 0;
-		naug = psolver->m_naug;
-	} else if (psolver->m_naug > naug) {
-		biter = psolver->m_niter;
-		naug = psolver->m_naug;
+		m_biter = 0;
+		m_naug = psolver->m_naug;
+	} else if (psolver->m_naug > m_naug) {
+		m_biter = psolver->m_niter;
+		m_naug = psolver->m_naug;
 	}
-	int niter = psolver->m_niter - biter;
+	int niter = psolver->m_niter - m_biter;
 	bool bupseg = ((m_nsegup == 0)? true : (niter <= m_nsegup));
 	// get the logfile
 //	Logfile& log = GetLogfile();
@@ -920,10 +925,9 @@ void FESlidingInterface2::Update()
 	
 	// project the surfaces onto each other
 	// this will update the gap functions as well
-	static bool bfirst = true;
-	ProjectSurface(m_ss, m_ms, bupseg, (m_breloc && bfirst));
+	ProjectSurface(m_ss, m_ms, bupseg, (m_breloc && m_bfirst));
 	if (m_btwo_pass || m_ms.m_bporo) ProjectSurface(m_ms, m_ss, bupseg);
-	bfirst = false;
+	m_bfirst = false;
 
 	// Update the net contact pressures
 	UpdateContactPressures();
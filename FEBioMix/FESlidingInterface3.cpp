@@ -447,6 +447,9 @@ FESlidingInterface3::FESlidingInterface3(FEModel* pfem) : FEContactInterface(pfe
 	
 	m_naugmin = 0;
 	m_naugmax = 10;
+	m_naug = 0;
+	m_biter = 0;
+	m_bfirst = true;
 
 	m_dofP = pfem->GetDOFIndex("p");
 	m_dofC = pfem->GetDOFIndex("concentration", 0);
@@ -466,6 +469,11 @@ FESlidingInterface3::~FESlidingInterface3()
 //-----------------------------------------------------------------------------
 bool FESlidingInterface3::Init()
 {
+	// reset the segment update counters
+	m_naug = 0;
+	m_biter = 0;
+	m_bfirst = true;
+
 	m_Rgas = GetFEModel()->GetGlobalConstant("R");
 	m_Tabs = GetFEModel()->GetGlobalConstant("T");
 
@@ -1004,22 +1012,19 @@ void FESlidingInterface3::Update()
     
 	double R = m_srad*fem.GetMesh().GetBoundingBox().radius();
 	
-	static int naug = 0;
-	static int biter = 0;
-
 	// get the iteration number
 	// we need this number to see if we can do segment updates or not
 	// also reset number of iterations after each augmentation
 	FEAnalysis* pstep = fem.GetCurrentStep();
 	FESolver* psolver = pstep->GetFESolver();
 	if (psolver->m_niter == 0) {
-		biter = 0;
-		naug = psolver->m_naug;
-	} else if (psolver->m_naug > naug) {
-		biter = psolver->m_niter;
-		naug = psolver->m_naug;
+		m_biter = 0;
+		m_naug = psolver->m_naug;
+	} else if (psolver->m_naug > m_naug) {
+		m_biter = psolver->m_niter;
+		m_naug = psolver->m_naug;
 	}
-	int niter = psolver->m_niter - biter;
+	int niter = psolver->m_niter - m_biter;
 	bool bupseg = ((m_nsegup == 0)? true : (niter <= m_nsegup));
 	// get the logfile
 	//	Logfile& log = GetLogfile();
@@ -1027,10 +1032,9 @@ void FESlidingInterface3::Update()
 	
 	// project the surfaces onto each other
 	// this will update the gap functions as well
-    static bool bfirst = true;
-    ProjectSurface(m_ss, m_ms, bupseg, (m_breloc && bfirst));
+    ProjectSurface(m_ss, m_ms, bupseg, (m_breloc && m_bfirst));
 	if (m_btwo_pass || m_ss.m_bporo) ProjectSurface(m_ms, m_ss, bupseg);
-    bfirst = false;
+    m_bfirst = false;
 	
 	// Update the net contact pressures
 	UpdateContactPressures();
@@ -210,6 +210,9 @@ public:
 protected:
 	int	m_dofP;
 	int	m_dofC;
+	int	m_naug;		//!< augmentation at last update
+	int	m_biter;	//!< iteration at last augmentation
+	bool	m_bfirst;	//!< first update of this interface
 
 	DECLARE_FECORE_CLASS();
 };
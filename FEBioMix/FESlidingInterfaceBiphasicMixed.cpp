@@ -573,6 +573,9 @@ FESlidingInterfaceBiphasicMixed::FESlidingInterfaceBiphasicMixed(FEModel* pfem)
     
     m_naugmin = 0;
     m_naugmax = 10;
+    m_naug = 0;
+    m_biter = 0;
+    m_bfirst = true;
     
     m_bfreeze = false;
     
@@ -591,6 +594,11 @@ FESlidingInterfaceBiphasicMixed::~FESlidingInterfaceBiphasicMixed()
 //-----------------------------------------------------------------------------
 bool FESlidingInterfaceBiphasicMixed::Init()
 {
+    // reset the segment update counters
+    m_naug = 0;
+    m_biter = 0;
+    m_bfirst = true;
+
     // initialize surface data
     if (m_ss.Init() == false) return false;
     if (m_ms.Init() == false) return false;
@@ -995,9 +1003,6 @@ void FESlidingInterfaceBiphasicMixed::Update()
 
     double R = m_srad*GetFEModel()->GetMesh().GetBoundingBox().radius();
     
-    static int naug = 0;
-    static int biter = 0;
-    
     FEModel& fem = *GetFEModel();
     
     // get the iteration number
@@ -1006,8 +1011,8 @@ void FESlidingInterfaceBiphasicMixed::Update()
     FEAnalysis* pstep = fem.GetCurrentStep();
     FESolver* psolver = pstep->GetFESolver();
     if (psolver->m_niter == 0) {
-        biter = 0;
-        naug = psolver->m_naug;
+        m_biter = 0;
+        m_naug = psolver->m_naug;
         // check update of auto-penalty
         if (m_bupdtpen) {
             // calculate the penalty
@@ -1019,11 +1024,11 @@ void FESlidingInterfaceBiphasicMixed::Update()
                 if (m_ms.m_bporo) CalcAutoPressurePenalty(m_ms);
             }
         }
-    } else if (psolver->m_naug > naug) {
-        biter = psolver->m_niter;
-        naug = psolver->m_naug;
+    } else if (psolver->m_naug > m_naug) {
+        m_biter = psolver->m_niter;
+        m_naug = psolver->m_naug;
     }
-    int niter = psolver->m_niter - biter;
+    int niter = psolver->m_niter - m_biter;
     bool bupseg = ((m_nsegup == 0)? true : (niter <= m_nsegup));
     // get the logfile
     //	Logfile& log = GetLogfile();
@@ -1031,10 +1036,9 @@ void FESlidingInterfaceBiphasicMixed::Update()
     
     // project the surfaces onto each other
     // this will update the gap functions as well
-    static bool bfirst = true;
-    ProjectSurface(m_ss, m_ms, bupseg, (m_breloc && bfirst));
+    ProjectSurface(m_ss, m_ms, bupseg, (m_breloc && m_bfirst));
     if (m_btwo_pass || m_ms.m_bporo) ProjectSurface(m_ms, m_ss, bupseg);
-    bfirst = false;
+    m_bfirst = false;
     
     // Call InitSlidingSurface on the first iteration of each time step
 	int nsolve_iter = psolver->m_niter;
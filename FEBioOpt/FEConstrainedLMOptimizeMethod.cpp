@@ -42,6 +42,9 @@ BEGIN_FECORE_CLASS(FEConstrainedLMOptimizeMethod, FEOptimizeMethod)
 	ADD_PARAMETER(m_tau   , "tau"         );
 	ADD_PARAMETER(m_fdiff , "f_diff_scale");
 	ADD_PARAMETER(m_nmax  , "max_iter"    );
+	ADD_PARAMETER(m_nsolves , "concurrent_solves");
+	ADD_PARAMETER(m_nthreads, "solve_threads"    );
+	ADD_PARAMETER(m_maxmem  , "max_memory"       );
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -68,6 +71,14 @@ void clevmar_cb(double *p, double *hx, int m, int n, void *adata)
 
 	// store the last calculated values
 	pLM->m_yopt = y;
+	pLM->m_aopt = a;
+}
+
+//-----------------------------------------------------------------------------
+void clevmar_jac(double *p, double *jac, int m, int n, void *adata)
+{
+	FEConstrainedLMOptimizeMethod* pLM = (FEConstrainedLMOptimizeMethod*) adata;
+	pLM->Jacobian(p, jac, m, n);
 }
 
 //-----------------------------------------------------------------------------
@@ -149,14 +160,24 @@ bool FEConstrainedLMOptimizeMethod::Solve(FEOptimizeData *pOpt, vector<double>&
 				b[i] = con.b;
 			}
 
-			int ret = dlevmar_blec_dif(clevmar_cb, p, q, ma, ndata, lb, ub, A, b, NC, 0, itmax, opts, 0, 0, 0, (void*) this);
+			// When we can solve concurrently, we provide the jacobian so that the
+			// perturbed problems are all solved at once. Otherwise, levmar does the differencing.
+			int ret = 0;
+			if (m_nsolves > 1)
+				ret = dlevmar_blec_der(clevmar_cb, clevmar_jac, p, q, ma, ndata, lb, ub, A, b, NC, 0, itmax, opts, 0, 0, 0, (void*) this);
+			else
+				ret = dlevmar_blec_dif(clevmar_cb, p, q, ma, ndata, lb, ub, A, b, NC, 0, itmax, opts, 0, 0, 0, (void*) this);
 
 			delete [] b;
 			delete [] A;
 		}
 		else
 		{
-			int ret = dlevmar_bc_dif(clevmar_cb, p, q, ma, ndata, lb, ub, 0, itmax, opts, 0, 0, 0, (void*) this);
+			int ret = 0;
+			if (m_nsolves > 1)
+				ret = dlevmar_bc_der(clevmar_cb, clevmar_jac, p, q, ma, ndata, lb, ub, 0, itmax, opts, 0, 0, 0, (void*) this);
+			else
+				ret = dlevmar_bc_dif(clevmar_cb, p, q, ma, ndata, lb, ub, 0, itmax, opts, 0, 0, 0, (void*) this);
 		}
 
 		for (int i=0; i<ma; ++i) a[i] = p[i];
@@ -211,18 +232,57 @@ void FEConstrainedLMOptimizeMethod::ObjFun(vector<double>& x, vector<double>& a,
 
 	// now calculate the derivatives using forward differences
 	int ndata = (int)x.size();
-	vector<double> a1(a);
-	vector<double> y1(ndata);
+	vector< vector<double> > a1(ma, a);
 	for (int i=0; i<ma; ++i)
 	{
 		double b = opt.GetInputParameter(i)->ScaleFactor();
 
-		a1[i] = a1[i] + dir[i]*m_fdiff*(b + fabs(a[i]));
+		a1[i][i] = a[i] + dir[i]*m_fdiff*(b + fabs(a[i]));
+	}
+
+	vector< vector<double> > y1;
+	if (opt.FESolve(a1, y1) == false) throw FEErrorTermination();
+
+	for (int i=0; i<ma; ++i)
+	{
+		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[i][j] - y[j])/(a1[i][i] - a[i]);
+	}
+}
 
-		if (opt.FESolve(a1) == false) throw FEErrorTermination();
-		opt.GetObjective().Evaluate(y1);
-		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[j] - y[j])/(a1[i] - a[i]);
-		a1[i] = a[i];
+//-----------------------------------------------------------------------------
+// Calculates the jacobian at p. The perturbed problems are independent so they
+// are passed to the optimization data in one batch. Levmar evaluates the 
+// function at p before it asks for the jacobian, so the unperturbed values are
+// taken from the last evaluation. Only when that was done at a different point
+// the unperturbed problem is added to the batch.
+// The jacobian is stored row-wise (n x m), as levmar expects.
+void FEConstrainedLMOptimizeMethod::Jacobian(double* p, double* jac, int m, int n)
+{
+	FEOptimizeData& opt = *m_pOpt;
+
+	vector<double> a(p, p + m);
+	bool bsolve_a = ((a != m_aopt) || ((int)m_yopt.size() != n));
+
+	vector< vector<double> > a1(m, a);
+	for (int j=0; j<m; ++j)
+	{
+		FEInputParameter& var = *opt.GetInputParameter(j);
+		double b = var.ScaleFactor();
+
+		// use a backward difference when we would step outside the bounds
+		double dj = m_fdiff*(b + fabs(a[j]));
+		if (a[j] + dj > var.MaxValue()) dj = -dj;
+		a1[j][j] = a[j] + dj;
+	}
+	if (bsolve_a) a1.push_back(a);
+
+	vector< vector<double> > y1;
+	if (opt.FESolve(a1, y1) == false) throw FEErrorTermination();
+
+	const vector<double>& y = (bsolve_a ? y1[m] : m_yopt);
+	for (int i=0; i<n; ++i)
+	{
+		for (int j=0; j<m; ++j) jac[i*m + j] = (y1[j][i] - y[i])/(a1[j][j] - a[j]);
 	}
 }
 
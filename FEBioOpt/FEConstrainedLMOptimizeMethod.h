@@ -41,6 +41,9 @@ public:
 
 	FEOptimizeData* GetOptimizeData() { return m_pOpt; }
 
+	// evaluate the jacobian with forward differences
+	void Jacobian(double* p, double* jac, int m, int n);
+
 protected:
 	FEOptimizeData* m_pOpt;
 
@@ -58,6 +61,7 @@ public:
 
 public:
 	vector<double>	m_yopt;	// optimal y-values
+	vector<double>	m_aopt;	// parameters of the last evaluation
 
 	DECLARE_FECORE_CLASS();
 };
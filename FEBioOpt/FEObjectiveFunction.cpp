@@ -71,7 +71,13 @@ double FEObjectiveFunction::Evaluate(vector<double>& y)
 	// evaluate the functions
 	EvaluateFunctions(y);
 
+	return ObjectiveValue(y);
+}
+
+double FEObjectiveFunction::ObjectiveValue(const vector<double>& y)
+{
 	// get the measurement vector
+	int ndata = Measurements();
 	vector<double> y0(ndata);
 	GetMeasurements(y0);
 
@@ -69,6 +69,9 @@ public:
 	// evaluate objective function
 	double Evaluate();
 
+	// calculate the objective function for the function values f
+	double ObjectiveValue(const vector<double>& f);
+
 	// print output to screen or not
 	void SetVerbose(bool b) { m_verbose = b; }
 
@@ -93,11 +93,30 @@ bool FEModelParameter::SetValue(double newValue)
 	return true;
 }
 
+//=============================================================================
+// Solves parameter points with the model of an optimization data object
+class FEOptimizeWorker : public FESweepWorker
+{
+public:
+	FEOptimizeWorker(FEOptimizeData* opt) : m_opt(opt) {}
+
+	bool Solve(const vector<double>& a, vector<double>& y) override
+	{
+		if (m_opt->FESolve(a) == false) return false;
+		m_opt->GetObjective().Evaluate(y);
+		return true;
+	}
+
+private:
+	FEOptimizeData*	m_opt;
+};
+
 //=============================================================================
 
 //-----------------------------------------------------------------------------
 FEOptimizeData::FEOptimizeData(FEModel* fem) : m_fem(fem)
 {
+	m_runner = 0;
 	m_pSolver = 0;
 	m_pTask = 0;
 	m_niter = 0;
@@ -108,6 +127,10 @@ FEOptimizeData::FEOptimizeData(FEModel* fem) : m_fem(fem)
 FEOptimizeData::~FEOptimizeData(void)
 {
 	delete m_pSolver;
+	delete m_runner;
+
+	for (size_t i = 0; i < m_clone.size(); ++i) delete m_clone[i];
+	for (size_t i = 0; i < m_cloneFem.size(); ++i) delete m_cloneFem[i];
 }
 
 //-----------------------------------------------------------------------------
@@ -130,6 +153,26 @@ bool FEOptimizeData::Init()
 	if (m_pTask->Init(0) == false) return false;
 	GetFEModel()->UnBlockLog();
 
+	// initialize the input parameters and objective
+	if (InitVariables() == false) return false;
+
+	// setup the runner for solving batches of parameters. When we can solve 
+	// concurrently, the runner gets a worker for each model copy. Otherwise, 
+	// the batches are solved with this model.
+	m_runner = new FESweepRunner(m_fem);
+	m_runner->SetSolveThreads(m_pSolver->m_nthreads);
+	if (m_pSolver->m_nsolves > 1)
+	{
+		if (CreateClones(m_pSolver->m_nsolves) == false) return false;
+	}
+	if (m_runner->Workers() == 0) m_runner->AddWorker(new FEOptimizeWorker(this));
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEOptimizeData::InitVariables()
+{
 	// initialize all input parameters
 	for (int i=0; i<(int)m_Var.size(); ++i)
 	{
@@ -187,6 +230,9 @@ bool FEOptimizeData::Solve()
 //!
 bool FEOptimizeData::Input(const char *szfile)
 {
+	// we keep the file name so we can create the optimization data for model copies
+	m_szfile = szfile;
+
 	FEOptimizeInput in;
 	if (in.Input(szfile, this) == false) return false;
 	return true;
@@ -239,3 +285,81 @@ bool FEOptimizeData::FESolve(const vector<double>& a)
 
 	return bret;
 }
+
+//-----------------------------------------------------------------------------
+//! Create up to n copies of the model, as many as fit in the memory budget.
+//! Each copy gets its own optimization data, read from the same input file, so
+//! that input parameters and objective functions are bound to that copy.
+bool FEOptimizeData::CreateClones(int n)
+{
+	FEModelState state(*GetFEModel());
+	if (state.Store() == false)
+	{
+		feLogError("Failed to store model state for concurrent solves.");
+		return false;
+	}
+
+	n = FESweepRunner::MaxWorkers(n, m_pSolver->m_maxmem, state.EstimateMemory());
+	if (n < 2) return true;
+
+	// The copies are created one after another on this thread, since model
+	// components number their instances with shared counters. The IDs are 
+	// then restored from the stored state.
+	for (int i = 0; i < n; ++i)
+	{
+		FEModel* pfem = state.CreateCopy();
+		if (pfem == nullptr)
+		{
+			feLogError("Failed to create model copies for concurrent solves.");
+			return false;
+		}
+		m_cloneFem.push_back(pfem);
+
+		// setup the optimization data
+		FEOptimizeData* opt = new FEOptimizeData(pfem);
+		m_clone.push_back(opt);
+		if (opt->Input(m_szfile.c_str()) == false) return false;
+		if (opt->m_pTask == 0) opt->m_pTask = fecore_new<FECoreTask>("solve", pfem);
+		if (opt->InitVariables() == false) return false;
+
+		m_runner->AddWorker(new FEOptimizeWorker(opt));
+	}
+
+	feLog("Created %d model copies for concurrent solves.\n", n);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Solve the FE problem for several sets of parameters. If model copies were
+//! created, the solves are distributed over the copies and run concurrently.
+//! Otherwise, the solves are done one after another with this model.
+bool FEOptimizeData::FESolve(const vector< vector<double> >& a, vector< vector<double> >& y)
+{
+	if (m_runner == 0) return false;
+
+	int nvar = InputParameters();
+	for (size_t n = 0; n < a.size(); ++n)
+	{
+		if (nvar != (int)a[n].size()) return false;
+	}
+
+	// The copies don't log anything, so we report the new values here.
+	if (m_clone.empty() == false)
+	{
+		for (size_t n = 0; n < a.size(); ++n)
+		{
+			m_niter++;
+			feLog("\n----- Iteration: %d -----\n", m_niter);
+			for (int i = 0; i < nvar; ++i)
+			{
+				FEInputParameter& var = *GetInputParameter(i);
+				string name = var.GetName();
+				feLog("%-15s = %lg\n", name.c_str(), a[n][i]);
+			}
+		}
+	}
+
+	vector<int> status;
+	return m_runner->Run(a, y, status);
+}
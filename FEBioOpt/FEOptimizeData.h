@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FECore/FECoreTask.h>
 #include "FEObjectiveFunction.h"
+#include "FESweepRunner.h"
 #include <vector>
 #include <string>
 using namespace std;
@@ -144,6 +145,9 @@ public:
 	//! solve the FE problem with a new set of parameters
 	bool FESolve(const vector<double>& a);
 
+	//! solve the FE problem for several sets of parameters and return the measurement vectors
+	bool FESolve(const vector< vector<double> >& a, vector< vector<double> >& y);
+
 public:
 	// return the number of input parameters
 	int InputParameters() { return (int)m_Var.size(); }
@@ -174,6 +178,16 @@ public:
 
 	bool RunTask();
 
+	//! return the runner that solves batches of parameters
+	FESweepRunner* GetRunner() { return m_runner; }
+
+protected:
+	//! initialize the input parameters and objective function
+	bool InitVariables();
+
+	//! create copies of the model for concurrent solves
+	bool CreateClones(int n);
+
 public:
 	int	m_niter;	// nr of minor iterations (i.e. FE solves)
 
@@ -188,4 +202,9 @@ protected:
 
 	std::vector<FEInputParameter*>	    m_Var;
 	std::vector<OPT_LIN_CONSTRAINT>		m_LinCon;
+
+	std::string						m_szfile;		//!< optimization input file
+	std::vector<FEOptimizeData*>	m_clone;		//!< optimization data of model copies
+	std::vector<FEModel*>			m_cloneFem;		//!< model copies used for concurrent solves
+	FESweepRunner*					m_runner;		//!< distributes batches of solves over the models
 };
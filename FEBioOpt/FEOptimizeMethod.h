@@ -52,7 +52,7 @@ enum LogLevel {
 class FEOptimizeMethod : public FEParamContainer
 {
 public:
-	FEOptimizeMethod() { m_print_level = PRINT_ITERATIONS; }
+	FEOptimizeMethod() { m_print_level = PRINT_ITERATIONS; m_nsolves = 1; m_nthreads = 1; m_maxmem = 0.0; }
 
 	// Implement this function for solve an optimization problem
 	// should return the optimal values for the input parameters in a, the optimal
@@ -64,4 +64,7 @@ public:
 public:
 	int		m_loglevel;		//!< log file output level
 	int		m_print_level;	//!< level of detailed output
+	int		m_nsolves;		//!< max nr of FE solves that can run concurrently
+	int		m_nthreads;		//!< nr of threads for each concurrent FE solve
+	double	m_maxmem;		//!< memory budget (in MB) for model copies (0 = no limit)
 };
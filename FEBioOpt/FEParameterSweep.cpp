@@ -59,9 +59,122 @@ void FESweepParam::SetValue(double v)
 	*m_pd = v;
 }
 
+//-----------------------------------------------------------------------------
+// find a double parameter of a model
+static double* FindModelParameter(FEModel* fem, const string& name)
+{
+	FEParamValue val = fem->GetParameterValue(ParamString(name.c_str()));
+
+	// see if we found the parameter
+	if (val.isValid() == false)
+	{
+		feLogErrorEx(fem, "Cannot find parameter %s", name.c_str());
+		return nullptr;
+	}
+
+	// see if it's the correct type
+	if (val.type() != FE_PARAM_DOUBLE)
+	{
+		feLogErrorEx(fem, "Invalid parameter type for parameter %s", name.c_str());
+		return nullptr;
+	}
+
+	// make sure we have a valid data pointer
+	double* pd = (double*)val.data_ptr();
+	if (pd == 0)
+	{
+		feLogErrorEx(fem, "Invalid data pointer for parameter %s", name.c_str());
+		return nullptr;
+	}
+
+	return pd;
+}
+
+//-----------------------------------------------------------------------------
+// Solves sweep points with one model
+class FESweepModelWorker : public FESweepWorker
+{
+public:
+	FESweepModelWorker(FEModel* fem, bool blog) : m_fem(fem), m_blog(blog) { m_niter = 0; }
+
+	bool Init(const vector<FESweepParam>& params, const vector<string>& results)
+	{
+		for (size_t i = 0; i<params.size(); ++i)
+		{
+			double* pd = FindModelParameter(m_fem, params[i].m_paramName);
+			if (pd == nullptr) return false;
+			m_pd.push_back(pd);
+			m_names.push_back(params[i].m_paramName);
+		}
+
+		for (size_t i = 0; i<results.size(); ++i)
+		{
+			double* pd = FindModelParameter(m_fem, results[i]);
+			if (pd == nullptr) return false;
+			m_pr.push_back(pd);
+		}
+
+		return true;
+	}
+
+	bool Solve(const vector<double>& a, vector<double>& y) override
+	{
+		FEModel& fem = *m_fem;
+
+		++m_niter;
+		if (m_blog) feLogEx(m_fem, "\n----- Iteration: %d -----\n", m_niter);
+
+		// set the input parameters
+		assert(m_pd.size() == a.size());
+		for (size_t i = 0; i<m_pd.size(); ++i)
+		{
+			*m_pd[i] = a[i];
+			if (m_blog) feLogEx(m_fem, "%-15s = %lg\n", m_names[i].c_str(), a[i]);
+		}
+
+		// reset the FEM data
+		fem.BlockLog();
+
+		// reset model
+		fem.Reset();
+
+		// solve the FE problem
+		bool bret = fem.Solve();
+
+		fem.UnBlockLog();
+
+		// collect the results
+		y.resize(m_pr.size());
+		for (size_t i = 0; i<m_pr.size(); ++i) y[i] = *m_pr[i];
+
+		return bret;
+	}
+
+private:
+	FEModel*		m_fem;
+	bool			m_blog;
+	int				m_niter;
+	vector<double*>	m_pd;
+	vector<double*>	m_pr;
+	vector<string>	m_names;
+};
+
+//-----------------------------------------------------------------------------
 FEParameterSweep::FEParameterSweep(FEModel* fem) : FECoreTask(fem)
 {
 	m_niter = 0;
+	m_nsolves = 1;
+	m_nthreads = 1;
+	m_maxmem = 0.0;
+	m_bresume = false;
+	m_runner = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+FEParameterSweep::~FEParameterSweep()
+{
+	delete m_runner;
+	for (size_t i = 0; i<m_copy.size(); ++i) delete m_copy[i];
 }
 
 //! initialization
@@ -80,6 +193,9 @@ bool FEParameterSweep::Init(const char* szfile)
 	GetFEModel()->GetCurrentStep()->SetPlotHint(FE_PLOT_APPEND);
 	GetFEModel()->GetCurrentStep()->SetPlotLevel(FE_PLOT_FINAL);
 
+	// setup the runner
+	if (InitRunner() == false) return false;
+
 	return true;
 }
 
@@ -94,34 +210,60 @@ bool FEParameterSweep::InitParams()
 	{
 		FESweepParam& p = m_params[i];
 
-		// find the variable
-		string name = p.m_paramName;
-		FEParamValue val = fem.GetParameterValue(ParamString(name.c_str()));
+		// store the pointer to the parameter
+		p.m_pd = FindModelParameter(&fem, p.m_paramName);
+		if (p.m_pd == nullptr) return false;
+	}
 
-		// see if we found the parameter
-		if (val.isValid() == false)
-		{
-			feLogError("Cannot find parameter %s", name.c_str());
-			return false;
-		}
+	return true;
+}
 
-		// see if it's the correct type
-		if (val.type() != FE_PARAM_DOUBLE)
+//-----------------------------------------------------------------------------
+// Setup the runner that solves the sweep points. When we can solve concurrently, 
+// the runner gets a worker for each model copy. Otherwise, the points are
+// solved with this model.
+bool FEParameterSweep::InitRunner()
+{
+	FEModel& fem = *GetFEModel();
+
+	m_runner = new FESweepRunner(&fem);
+	m_runner->SetSolveThreads(m_nthreads);
+
+	if (m_nsolves > 1)
+	{
+		FEModelState state(fem);
+		if (state.Store() == false)
 		{
-			feLogError("Invalid parameter type for parameter %s", name.c_str());
+			feLogError("Failed to store model state for concurrent solves.");
 			return false;
 		}
 
-		// make sure we have a valid data pointer
-		double* pd = (double*)val.data_ptr();
-		if (pd == 0)
+		int n = FESweepRunner::MaxWorkers(m_nsolves, m_maxmem, state.EstimateMemory());
+		if (n > 1)
 		{
-			feLogError("Invalid data pointer for parameter %s", name.c_str());
-			return false;
+			for (int i = 0; i<n; ++i)
+			{
+				FEModel* pfem = state.CreateCopy();
+				if (pfem == nullptr)
+				{
+					feLogError("Failed to create model copies for concurrent solves.");
+					return false;
+				}
+				m_copy.push_back(pfem);
+
+				FESweepModelWorker* w = new FESweepModelWorker(pfem, false);
+				m_runner->AddWorker(w);
+				if (w->Init(m_params, m_results) == false) return false;
+			}
+			feLog("Created %d model copies for concurrent solves.\n", n);
 		}
+	}
 
-		// store the pointer to the parameter
-		p.m_pd = pd;
+	if (m_runner->Workers() == 0)
+	{
+		FESweepModelWorker* w = new FESweepModelWorker(&fem, true);
+		m_runner->AddWorker(w);
+		if (w->Init(m_params, m_results) == false) return false;
 	}
 
 	return true;
@@ -163,6 +305,20 @@ bool FEParameterSweep::Input(const char* szfile)
 			// looks good, so throw it on the pile
 			m_params.push_back(p);
 		}
+		else if (tag == "result")
+		{
+			const char* szname = tag.AttributeValue("name");
+			m_results.push_back(szname);
+		}
+		else if (tag == "concurrent_solves") tag.value(m_nsolves);
+		else if (tag == "solve_threads") tag.value(m_nthreads);
+		else if (tag == "max_memory") tag.value(m_maxmem);
+		else if (tag == "results_file")
+		{
+			const char* szresume = tag.AttributeValue("resume", true);
+			if (szresume) m_bresume = (atoi(szresume) != 0);
+			m_file = tag.szvalue();
+		}
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	} while (!tag.isend());
@@ -184,12 +340,12 @@ bool FEParameterSweep::Run()
 		a[i] = pi.m_min;
 	}
 
-	// run the parameter sweep
+	// collect the sweep points
+	vector< vector<double> > pts;
 	bool bdone = false;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (FESolve(a) == false) return false;
+		pts.push_back(a);
 
 		// update indices
 		for (size_t i = 0; i<ma; ++i)
@@ -203,37 +359,25 @@ bool FEParameterSweep::Run()
 	}
 	while (!bdone);
 
-	return true;
-}
-
-bool FEParameterSweep::FESolve(const vector<double>& a)
-{
-	++m_niter;
-	feLog("\n----- Iteration: %d -----\n", m_niter);
-
-	// set the input parameters
-	size_t nvar = m_params.size();
-	assert(nvar == a.size());
-	for (int i = 0; i<nvar; ++i)
+	// open the results table
+	if (m_file.empty() == false)
 	{
-		FESweepParam& var = m_params[i];
-		var.SetValue(a[i]);
-
-		string name = var.m_paramName;
-		feLog("%-15s = %lg\n", name.c_str(), a[i]);
+		vector<string> paramNames(ma);
+		for (size_t i = 0; i<ma; ++i) paramNames[i] = m_params[i].m_paramName;
+		if (m_runner->OpenTable(m_file, paramNames, m_results, m_bresume) == false)
+		{
+			feLogError("Failed to open results table %s", m_file.c_str());
+			return false;
+		}
 	}
 
-	// reset the FEM data
-	FEModel& fem = *GetFEModel();
-	fem.BlockLog();
-
-	// reset model
-	fem.Reset();
-
-	// solve the FE problem
-	bool bret = fem.Solve();
+	// run the parameter sweep
+	vector< vector<double> > y;
+	vector<int> status;
+	bool bret = m_runner->Run(pts, y, status);
+	m_runner->CloseTable();
 
-	fem.UnBlockLog();
+	m_niter = (int)pts.size();
 
 	return bret;
 }
@@ -26,6 +26,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/FECoreTask.h>
+#include "FESweepRunner.h"
 
 // This class represents a parameter that will be swept
 class FESweepParam
@@ -45,10 +46,13 @@ public:
 
 // This task implements a parameter sweep, where the same model is run similar times,
 // each time with one or more parameters modified.
+// The points of the sweep are independent, so they can be solved concurrently on copies of 
+// the model. In that case, only the results table is written for each point (and no plot file). 
 class FEParameterSweep : public FECoreTask
 {
 public:
 	FEParameterSweep(FEModel* fem);
+	~FEParameterSweep();
 
 	//! initialization
 	bool Init(const char* szfile) override;
@@ -59,9 +63,19 @@ public:
 private:
 	bool Input(const char* szfile);
 	bool InitParams();
-	bool FESolve(const vector<double>& a);
+	bool InitRunner();
 
 private:
 	vector<FESweepParam>	m_params;
+	vector<string>			m_results;		//!< model parameters that are reported for each point
 	int						m_niter;
+
+	int				m_nsolves;		//!< max nr of concurrent solves
+	int				m_nthreads;		//!< nr of threads for each concurrent solve
+	double			m_maxmem;		//!< memory budget (in MB) for model copies (0 = no limit)
+	string			m_file;			//!< results table
+	bool			m_bresume;		//!< resume a previous sweep from the results table
+
+	FESweepRunner*		m_runner;
+	vector<FEModel*>	m_copy;		//!< model copies used for concurrent solves
 };
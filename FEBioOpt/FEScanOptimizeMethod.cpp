@@ -32,13 +32,23 @@ SOFTWARE.*/
 #include "FECore/log.h"
 
 BEGIN_FECORE_CLASS(FEScanOptimizeMethod, FEOptimizeMethod)
-
+	ADD_PARAMETER(m_nsolves , "concurrent_solves");
+	ADD_PARAMETER(m_nthreads, "solve_threads"    );
+	ADD_PARAMETER(m_maxmem  , "max_memory"       );
+	ADD_PARAMETER(m_file    , "results_file"     );
+	ADD_PARAMETER(m_bresume , "resume"           );
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
 // FEScanOptimizeMethod
 //-----------------------------------------------------------------------------
 
+FEScanOptimizeMethod::FEScanOptimizeMethod()
+{
+	m_bresume = false;
+}
+
+//-----------------------------------------------------------------------------
 bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vector<double>& ymin, double* minObj)
 {
 	if (pOpt == 0) return false;
@@ -54,25 +64,12 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 		a[i] = var->MinValue();
 	}
 
-	// loop until done
-	vector<double> y(ma, 0.0);
+	// collect all the grid points
+	vector< vector<double> > pts;
 	bool bdone = false;
-	double fmin = 0.0;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (opt.FESolve(a) == false) return false;
-
-		// calculate objective function
-		double fobj = obj.Evaluate(y);
-
-		// update minimum
-		if ((fmin == 0.0) || (fobj < fmin))
-		{
-			fmin = fobj;
-			amin = a;
-			ymin = y;
-		}
+		pts.push_back(a);
 
 		// update indices
 		for (int i=0; i<ma; ++i)
@@ -86,6 +83,50 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 	}
 	while (!bdone);
 
+	// the grid points are independent so the runner can solve them concurrently
+	FESweepRunner* runner = opt.GetRunner();
+	if (runner == 0) return false;
+
+	// open the results table
+	int ndata = obj.Measurements();
+	if (m_file.empty() == false)
+	{
+		vector<string> paramNames(ma), resultNames(ndata);
+		for (int i=0; i<ma; ++i) paramNames[i] = opt.GetInputParameter(i)->GetName();
+		for (int i=0; i<ndata; ++i)
+		{
+			char sz[32] = { 0 };
+			sprintf(sz, "y%d", i + 1);
+			resultNames[i] = sz;
+		}
+		if (runner->OpenTable(m_file, paramNames, resultNames, m_bresume) == false)
+		{
+			feLogErrorEx(opt.GetFEModel(), "Failed to open results table %s", m_file.c_str());
+			return false;
+		}
+	}
+
+	vector< vector<double> > y;
+	bool bret = opt.FESolve(pts, y);
+	runner->CloseTable();
+	if (bret == false) return false;
+
+	// find the minimum
+	double fmin = 0.0;
+	for (size_t n=0; n<pts.size(); ++n)
+	{
+		// calculate objective function
+		double fobj = obj.ObjectiveValue(y[n]);
+
+		// update minimum
+		if ((n == 0) || (fobj < fmin))
+		{
+			fmin = fobj;
+			amin = pts[n];
+			ymin = y[n];
+		}
+	}
+
 	// store the optimum data
 	if (minObj) *minObj = fmin;
 
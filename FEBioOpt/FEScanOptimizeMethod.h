@@ -34,11 +34,17 @@ SOFTWARE.*/
 class FEScanOptimizeMethod : public FEOptimizeMethod
 {
 public:
+	FEScanOptimizeMethod();
+
 	// this implements the solution algorithm.
 	// returns the optimal parameter values in amin
 	// returns the optimal measurement vector in ymin
 	// returns the optimal objective function value in minObj
 	bool Solve(FEOptimizeData* pOpt, vector<double>& amin, vector<double>& ymin, double* minObj) override;
 
+public:
+	std::string	m_file;		//!< results table
+	bool		m_bresume;	//!< resume from the results table
+
 	DECLARE_FECORE_CLASS();
 };
@@ -0,0 +1,311 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FESweepRunner.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FESolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/log.h>
+#include <FECore/sys.h>
+#include <FEBioMech/FEMechModel.h>
+#include <math.h>
+
+//=============================================================================
+// FEModelState
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+FEModelState::FEModelState(FEModel& fem) : m_fem(fem), m_ar(fem)
+{
+	// the rigid system is streamed with the geometry, so copies of a
+	// mechanics model need to be mechanics models as well.
+	m_bmech = (dynamic_cast<FEMechModel*>(&fem) != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool FEModelState::Store()
+{
+	try
+	{
+		// We call the FEModel version directly since derived classes may 
+		// stream additional data (e.g. output) that we don't want to copy.
+		m_ar.clear();
+		m_ar.Open(true, false);
+		m_fem.FEModel::Serialize(m_ar);
+	}
+	catch (...)
+	{
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FEModel* FEModelState::CreateCopy()
+{
+	FEModel* fem = (m_bmech ? new FEMechModel : new FEModel);
+	try
+	{
+		DumpMemStream dmp(*fem);
+		dmp.Open(true, false);
+		dmp.write(m_ar.data(), 1, m_ar.size());
+		dmp.Open(false, false);
+		fem->FEModel::Serialize(dmp);
+	}
+	catch (...)
+	{
+		delete fem;
+		return nullptr;
+	}
+	return fem;
+}
+
+//-----------------------------------------------------------------------------
+//! The estimate is the size of the model state plus the storage of the 
+//! stiffness matrix, where we leave room for the fill-in of a direct solver.
+double FEModelState::EstimateMemory()
+{
+	double bytes = (double) m_ar.size();
+
+	FEAnalysis* step = m_fem.GetCurrentStep();
+	FESolver* solver = (step ? step->GetFESolver() : nullptr);
+	FEGlobalMatrix* K = (solver ? solver->GetStiffnessMatrix() : nullptr);
+	if (K && K->GetSparseMatrixPtr())
+	{
+		bytes += 4.0*K->NonZeroes()*(sizeof(double) + sizeof(int));
+	}
+
+	return bytes;
+}
+
+//=============================================================================
+// FESweepRunner
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+FESweepRunner::FESweepRunner(FEModel* fem) : m_fem(fem)
+{
+	m_nthreads = 1;
+	m_fp = nullptr;
+	m_nres = 0;
+}
+
+//-----------------------------------------------------------------------------
+FESweepRunner::~FESweepRunner()
+{
+	CloseTable();
+	for (size_t i = 0; i < m_worker.size(); ++i) delete m_worker[i];
+}
+
+//-----------------------------------------------------------------------------
+void FESweepRunner::AddWorker(FESweepWorker* w)
+{
+	m_worker.push_back(w);
+}
+
+//-----------------------------------------------------------------------------
+int FESweepRunner::MaxWorkers(int nsolves, double maxMemory, double modelMemory)
+{
+	int n = (nsolves < 1 ? 1 : nsolves);
+	if ((maxMemory > 0.0) && (modelMemory > 0.0))
+	{
+		int m = (int) (maxMemory*1024.0*1024.0 / modelMemory);
+		if (m < n) n = m;
+	}
+	return (n < 1 ? 1 : n);
+}
+
+//-----------------------------------------------------------------------------
+// The results table is a text file with one row per point. Each row contains
+// the point index, the status (1 = solved, 0 = failed), the parameter values
+// and the result values. Lines starting with # are comments.
+bool FESweepRunner::OpenTable(const std::string& file, const std::vector<std::string>& paramNames, const std::vector<std::string>& resultNames, bool bresume)
+{
+	CloseTable();
+	m_row.clear();
+	m_nres = (int) resultNames.size();
+
+	int ncols = 2 + (int) paramNames.size() + m_nres;
+
+	// read the rows we already have
+	if (bresume)
+	{
+		FILE* fp = fopen(file.c_str(), "rt");
+		if (fp)
+		{
+			char szline[4096] = { 0 };
+			while (fgets(szline, sizeof(szline), fp))
+			{
+				if ((szline[0] == '#') || (szline[0] == '\n')) continue;
+
+				std::vector<double> row;
+				char* sz = szline;
+				char* szend = nullptr;
+				do
+				{
+					double v = strtod(sz, &szend);
+					if (szend == sz) break;
+					row.push_back(v);
+					sz = szend;
+				}
+				while (true);
+
+				if ((int) row.size() != ncols)
+				{
+					feLogErrorEx(m_fem, "Results table %s does not match this sweep.", file.c_str());
+					fclose(fp);
+					return false;
+				}
+
+				// only points that were solved are reused
+				if (row[1] == 1.0) m_row.push_back(row);
+			}
+			fclose(fp);
+
+			m_fp = fopen(file.c_str(), "at");
+			if (m_fp == nullptr) return false;
+			return true;
+		}
+	}
+
+	// create a new table
+	m_fp = fopen(file.c_str(), "wt");
+	if (m_fp == nullptr) return false;
+
+	fprintf(m_fp, "# index status");
+	for (size_t i = 0; i < paramNames.size(); ++i) fprintf(m_fp, " %s", paramNames[i].c_str());
+	for (size_t i = 0; i < resultNames.size(); ++i) fprintf(m_fp, " %s", resultNames[i].c_str());
+	fprintf(m_fp, "\n");
+	fflush(m_fp);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FESweepRunner::CloseTable()
+{
+	if (m_fp) fclose(m_fp);
+	m_fp = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void FESweepRunner::WriteRow(int n, const std::vector<double>& a, const std::vector<double>& y, int status)
+{
+	if (m_fp == nullptr) return;
+
+	fprintf(m_fp, "%d %d", n, status);
+	for (size_t i = 0; i < a.size(); ++i) fprintf(m_fp, " %.17lg", a[i]);
+	for (int i = 0; i < m_nres; ++i) fprintf(m_fp, " %.17lg", (i < (int) y.size() ? y[i] : 0.0));
+	fprintf(m_fp, "\n");
+
+	// flush so that the table can be used to resume the sweep
+	fflush(m_fp);
+}
+
+//-----------------------------------------------------------------------------
+bool FESweepRunner::Run(const std::vector< std::vector<double> >& pts, std::vector< std::vector<double> >& res, std::vector<int>& status)
+{
+	int N = (int) pts.size();
+	res.assign(N, std::vector<double>());
+	status.assign(N, 0);
+
+	int NW = Workers();
+	if (NW == 0) return false;
+
+	// see which points are already in the results table
+	std::vector<int> todo;
+	for (int n = 0; n < N; ++n)
+	{
+		const std::vector<double>& a = pts[n];
+		for (size_t i = 0; i < m_row.size(); ++i)
+		{
+			const std::vector<double>& row = m_row[i];
+			if ((int) row[0] != n) continue;
+
+			bool bmatch = (row.size() == a.size() + m_nres + 2);
+			for (size_t j = 0; bmatch && (j < a.size()); ++j)
+			{
+				if (fabs(row[j + 2] - a[j]) > 1e-12*(1.0 + fabs(a[j]))) bmatch = false;
+			}
+
+			if (bmatch)
+			{
+				res[n].assign(row.begin() + 2 + a.size(), row.end());
+				status[n] = 1;
+				break;
+			}
+		}
+		if (status[n] == 0) todo.push_back(n);
+	}
+
+	int NT = (int) todo.size();
+	if (NT < N) feLogEx(m_fem, "Resuming sweep: %d of %d points read from results table.\n", N - NT, N);
+
+	if (NW == 1)
+	{
+		// With only one worker we solve the points on the calling thread, 
+		// so that the solve can use all the threads.
+		for (int i = 0; i < NT; ++i)
+		{
+			int n = todo[i];
+			status[n] = (m_worker[0]->Solve(pts[n], res[n]) ? 1 : 0);
+			WriteRow(n, pts[n], res[n], status[n]);
+		}
+	}
+	else
+	{
+		// Each thread uses its own worker, so a model is never used by two solves at the same time.
+		// Nesting is only enabled for this region, so that later parallel regions are not affected.
+		int nthreads = m_nthreads;
+		int nested = omp_get_nested();
+		if (nthreads > 1) omp_set_nested(1);
+
+#pragma omp parallel for num_threads(NW) schedule(dynamic, 1)
+		for (int i = 0; i < NT; ++i)
+		{
+			if (nthreads > 0) omp_set_num_threads(nthreads);
+
+			int n = todo[i];
+			FESweepWorker* w = m_worker[omp_get_thread_num()];
+			status[n] = (w->Solve(pts[n], res[n]) ? 1 : 0);
+
+#pragma omp critical (sweep_table)
+			WriteRow(n, pts[n], res[n], status[n]);
+		}
+
+		omp_set_nested(nested);
+	}
+
+	for (int n = 0; n < N; ++n)
+	{
+		if (status[n] == 0) return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,121 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <FECore/DumpMemStream.h>
+#include <vector>
+#include <string>
+#include <stdio.h>
+
+class FEModel;
+
+//-----------------------------------------------------------------------------
+//! This class stores the state of an initialized model so that copies of the
+//! model can be created from it. The copies are created by streaming the state
+//! into a new model, as is done for cold restarts. Only the FEModel data is
+//! copied, so copies do not write any output (e.g. plot or log files).
+class FEModelState
+{
+public:
+	FEModelState(FEModel& fem);
+
+	//! store the model state. Returns false if the model could not be serialized.
+	bool Store();
+
+	//! create a new copy of the model. Returns null on failure.
+	FEModel* CreateCopy();
+
+	//! size of the stored state (in bytes)
+	size_t Size() const { return m_ar.size(); }
+
+	//! estimated memory (in bytes) used by one copy of the model
+	double EstimateMemory();
+
+private:
+	FEModel&		m_fem;
+	DumpMemStream	m_ar;
+	bool			m_bmech;
+};
+
+//-----------------------------------------------------------------------------
+//! A worker solves parameter points on its own model. 
+class FESweepWorker
+{
+public:
+	virtual ~FESweepWorker() {}
+
+	//! solve the model for the parameters a and return the results in y
+	virtual bool Solve(const std::vector<double>& a, std::vector<double>& y) = 0;
+};
+
+//-----------------------------------------------------------------------------
+//! The sweep runner evaluates a list of independent parameter points. Each
+//! worker runs on its own thread, so with more than one worker the points are
+//! solved concurrently. Finished points can be streamed to a results table, 
+//! which can also be used to resume a partially completed sweep.
+class FESweepRunner
+{
+public:
+	FESweepRunner(FEModel* fem);
+	~FESweepRunner();
+
+	//! add a worker. The runner takes ownership of the worker.
+	void AddWorker(FESweepWorker* w);
+
+	//! return the number of workers
+	int Workers() const { return (int)m_worker.size(); }
+
+	//! set the number of threads that each worker may use (0 = default)
+	void SetSolveThreads(int n) { m_nthreads = n; }
+
+	//! open the results table. If bresume is true, the points already in the
+	//! table will be read and are not solved again.
+	bool OpenTable(const std::string& file, const std::vector<std::string>& paramNames, const std::vector<std::string>& resultNames, bool bresume);
+
+	//! close the results table
+	void CloseTable();
+
+	//! evaluate all points. On return, res contains the results of each point and
+	//! status is one for points that were solved (or read from the table) and zero otherwise.
+	bool Run(const std::vector< std::vector<double> >& pts, std::vector< std::vector<double> >& res, std::vector<int>& status);
+
+public:
+	//! number of workers that can run concurrently within the memory budget (in MB, 0 = no limit)
+	static int MaxWorkers(int nsolves, double maxMemory, double modelMemory);
+
+private:
+	void WriteRow(int n, const std::vector<double>& a, const std::vector<double>& y, int status);
+
+private:
+	FEModel*	m_fem;
+	int			m_nthreads;
+	std::vector<FESweepWorker*>	m_worker;
+
+	FILE*		m_fp;		//!< results table
+	int			m_nres;		//!< number of result columns
+	std::vector< std::vector<double> >	m_row;	//!< rows read from results table (resume)
+};
@@ -33,6 +33,8 @@ SOFTWARE.*/
 #include "FETangentDiagnostic.h"
 #include "FERestartDiagnostics.h"
 #include "FEJFNKTangentDiagnostic.h"
+#include "FETensorBenchmark.h"
+#include "FEModelBenchmark.h"
 
 namespace FEBioTest
 {
@@ -42,5 +44,7 @@ void InitModule()
 	REGISTER_FECORE_CLASS(FEBioDiagnostic, "diagnose");
 	REGISTER_FECORE_CLASS(FERestartDiagnostic, "restart_test");
 	REGISTER_FECORE_CLASS(FEJFNKTangentDiagnostic, "jfnk tangent test");
+	REGISTER_FECORE_CLASS(FETensorBenchmark, "tensor benchmark");
+	REGISTER_FECORE_CLASS(FEModelBenchmark, "benchmark");
 }
 }
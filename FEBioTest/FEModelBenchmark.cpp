@@ -0,0 +1,924 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEModelBenchmark.h"
+#include <FEBioMech/FEElasticSolidDomain.h>
+#include <FEBioMech/FENeoHookean.h>
+#include <FEBioXML/XMLReader.h>
+#include <FEBioXML/xmltool.h>
+#include <FEBioXML/FEBioMaterialSection.h>
+#include <FEBioXML/FEModelBuilder.h>
+#include <FEBioPlot/FEBioPlotFile.h>
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/FELinearConstraintManager.h>
+#include <FECore/FESurfacePairConstraint.h>
+#include <FECore/FESurface.h>
+#include <FECore/FEFixedBC.h>
+#include <FECore/FEPrescribedDOF.h>
+#include <FECore/FELoadCurve.h>
+#include <FECore/FEMeshAdaptor.h>
+#include <FECore/FEElementWorkspace.h>
+#include <FECore/FETelemetry.h>
+#include <FECore/FEException.h>
+#include <FECore/FECoreKernel.h>
+#include <FECore/log.h>
+#include <omp.h>
+
+//-----------------------------------------------------------------------------
+FEModelBenchmark::FEModelBenchmark(FEModel* fem) : FECoreTask(fem)
+{
+	m_elemType = "hex8";
+	m_nx = m_ny = m_nz = 10;
+	m_niter = 3;
+	m_strain = 0.05;
+	m_brefine = false;
+	m_outFile = "benchmark.json";
+
+	m_pmat = nullptr;
+	m_pci = nullptr;
+
+	m_bottom = m_top = nullptr;
+	m_elems = 0;
+	m_nnz = 0;
+	m_plotBytes = 0.0;
+	m_hanging = 0;
+
+	// this is a solid mechanics problem
+	FECoreKernel::GetInstance().SetActiveModule("solid");
+	fem->SetModuleName("solid");
+
+	// create an analysis step with a single time step
+	FEAnalysis* pstep = new FEAnalysis(fem);
+	pstep->m_ntime = 1;
+	pstep->m_dt0 = 1.0;
+	pstep->SetPlotLevel(FE_PLOT_NEVER);
+
+	// create the (Newton) solver
+	FESolver* psolver = fecore_new<FESolver>("solid", fem);
+	assert(psolver);
+	pstep->SetFESolver(psolver);
+
+	fem->AddStep(pstep);
+	fem->SetCurrentStep(pstep);
+}
+
+//-----------------------------------------------------------------------------
+// The control file is optional. Without it, a 10x10x10 hex8 box with a 
+// neo-Hookean material and the default linear solver is used.
+bool FEModelBenchmark::Init(const char* szfile)
+{
+	if (szfile && szfile[0])
+	{
+		if (ReadControlFile(szfile) == false) return false;
+	}
+
+	if (BuildModel() == false) return false;
+
+	if (GetFEModel()->Init() == false) return false;
+
+	// like a mesh adaptor, the refinement needs an initialized model
+	if (m_brefine && (Refine() == false)) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Reads the control file. The materials are defined as in the FEBio input files.
+class FEModelBenchmarkImport : public FEFileImport
+{
+public:
+	bool Load(FEModel& fem, FEModelBenchmark* task, const char* szfile);
+};
+
+//-----------------------------------------------------------------------------
+class FEModelBenchmarkSection : public FEFileSection
+{
+public:
+	FEModelBenchmarkSection(FEFileImport* pim, FEModelBenchmark* task) : FEFileSection(pim), m_task(task) {}
+	void Parse(XMLTag& tag) override;
+
+private:
+	FEModelBenchmark*	m_task;
+};
+
+//-----------------------------------------------------------------------------
+bool FEModelBenchmarkImport::Load(FEModel& fem, FEModelBenchmark* task, const char* szfile)
+{
+	XMLReader xml;
+	if (xml.Open(szfile) == false)
+	{
+		fprintf(stderr, "\nERROR: Failed to open %s\n\n", szfile);
+		return false;
+	}
+
+	XMLTag tag;
+	if (xml.FindTag("febio_benchmark", tag) == false)
+	{
+		fprintf(stderr, "\nERROR: Failed to read %s\n\n", szfile);
+		return false;
+	}
+
+	m_builder = new FEModelBuilder(fem);
+
+	bool bret = true;
+	try
+	{
+		FEModelBenchmarkSection section(this, task);
+		section.Parse(tag);
+	}
+	catch (XMLReader::Error& e)
+	{
+		fprintf(stderr, "\nERROR: %s\n\n", e.what());
+		bret = false;
+	}
+	catch (FEFileException& e)
+	{
+		fprintf(stderr, "\nERROR: %s (line %d)\n\n", e.GetErrorString(), xml.GetCurrentLine());
+		bret = false;
+	}
+
+	delete m_builder;
+	m_builder = nullptr;
+
+	xml.Close();
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+void FEModelBenchmarkSection::Parse(XMLTag& tag)
+{
+	FEModelBenchmark& task = *m_task;
+	FEModel& fem = *GetFEModel();
+
+	++tag;
+	do
+	{
+		if      (tag == "element"   ) task.m_elemType = tag.szvalue();
+		else if (tag == "iterations") tag.value(task.m_niter);
+		else if (tag == "strain"    ) tag.value(task.m_strain);
+		else if (tag == "refine"    ) tag.value(task.m_brefine);
+		else if (tag == "plot_file" ) task.m_plotFile = tag.szvalue();
+		else if (tag == "output"    ) task.m_outFile = tag.szvalue();
+		else if (tag == "mesh")
+		{
+			// either one value for all directions, or one for each
+			int n[3] = { 0 };
+			int nread = tag.value(n, 3);
+			if (nread == 1) n[1] = n[2] = n[0];
+			else if (nread != 3) throw XMLReader::InvalidValue(tag);
+			task.m_nx = n[0]; task.m_ny = n[1]; task.m_nz = n[2];
+		}
+		else if (tag == "Material")
+		{
+			FEBioMaterialSection materials(GetFileReader());
+			materials.Parse(tag);
+		}
+		else if (tag == "solver")
+		{
+			ReadParameterList(tag, fem.GetCurrentStep()->GetFESolver());
+		}
+		else if (tag == "linear_solver")
+		{
+			ClassDescriptor* cd = fexml::readParameterList(tag);
+			if (cd == nullptr) throw XMLReader::InvalidTag(tag);
+
+			// only this task's Newton solver uses it, so the kernel's default stays untouched
+			FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(fem.GetCurrentStep()->GetFESolver());
+			LinearSolver* ls = nullptr;
+			if (solver) ls = (LinearSolver*)FECoreKernel::GetInstance().Create(FELINEARSOLVER_ID, &fem, *cd);
+			delete cd;
+			if (ls == nullptr) throw XMLReader::InvalidTag(tag);
+
+			if (solver->m_plinsolve) delete solver->m_plinsolve;
+			solver->m_plinsolve = ls;
+		}
+		else if (tag == "contact")
+		{
+			const char* sztype = tag.AttributeValue("type");
+			task.m_pci = fecore_new<FESurfacePairConstraint>(sztype, &fem);
+			if (task.m_pci == nullptr) throw XMLReader::InvalidAttributeValue(tag, "type", sztype);
+			ReadParameterList(tag, task.m_pci);
+		}
+		else throw XMLReader::InvalidTag(tag);
+
+		++tag;
+	}
+	while (!tag.isend());
+}
+
+//-----------------------------------------------------------------------------
+bool FEModelBenchmark::ReadControlFile(const char* szfile)
+{
+	FEModelBenchmarkImport im;
+	if (im.Load(*GetFEModel(), this, szfile) == false) return false;
+
+	if ((m_elemType != "hex8") && (m_elemType != "tet4"))
+	{
+		fprintf(stderr, "\nERROR: Unknown element type %s\n\n", m_elemType.c_str());
+		return false;
+	}
+
+	if ((m_nx < 1) || (m_ny < 1) || (m_nz < 1) || (m_niter < 1) || ((m_pci != nullptr) && (m_nz < 2)))
+	{
+		fprintf(stderr, "\nERROR: Invalid benchmark parameters in %s\n\n", szfile);
+		return false;
+	}
+
+	// the refinement skips the bottom and top layers of the box
+	if (m_brefine && ((m_elemType != "hex8") || (m_pci != nullptr) || (m_nz < 3)))
+	{
+		fprintf(stderr, "\nERROR: Refinement requires a hex8 box without contact and with at least 3 elements in z\n\n");
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Build the box. Without contact, this is a single box. With contact, the box is
+// split in two halves and the contact interface is defined on the faces that 
+// touch. The bottom is fixed and the top is compressed.
+bool FEModelBenchmark::BuildModel()
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+
+	// default material (only the first material is used)
+	if (fem.Materials() == 0)
+	{
+		FENeoHookean* pm = dynamic_cast<FENeoHookean*>(fecore_new<FEMaterial>("neo-Hookean", &fem));
+		assert(pm);
+		pm->m_E = 1.0;
+		pm->m_v = 0.3;
+		fem.AddMaterial(pm);
+	}
+	m_pmat = fem.GetMaterial(0);
+
+	// the mesh owns the node sets
+	m_bottom = new FENodeSet(&fem);
+	m_bottom->SetName("bottom");
+	mesh.AddNodeSet(m_bottom);
+
+	m_top = new FENodeSet(&fem);
+	m_top->SetName("top");
+	mesh.AddNodeSet(m_top);
+
+	if (m_pci == nullptr)
+	{
+		int n0 = AddBox(m_nz, 0.0, 1.0);
+		if (n0 < 0) return false;
+	}
+	else
+	{
+		int nz0 = m_nz / 2;
+		int nz1 = m_nz - nz0;
+		double zm = (double) nz0 / m_nz;
+		int n0 = AddBox(nz0, 0.0, zm);
+		int n1 = AddBox(nz1, zm, 1.0);
+		if ((n0 < 0) || (n1 < 0)) return false;
+
+		// the primary surface is the top of the lower box and the secondary
+		// surface is the bottom of the upper box
+		AddContactSurface(true , n0, nz0, nz0);
+		AddContactSurface(false, n1, nz1, 0);
+		fem.AddSurfacePairConstraint(m_pci);
+	}
+
+	// fix the bottom and compress the top
+	const int dof_X = fem.GetDOFIndex("x");
+	const int dof_Y = fem.GetDOFIndex("y");
+	const int dof_Z = fem.GetDOFIndex("z");
+	fem.AddBoundaryCondition(new FEFixedBC(&fem, dof_X, m_bottom));
+	fem.AddBoundaryCondition(new FEFixedBC(&fem, dof_Y, m_bottom));
+	fem.AddBoundaryCondition(new FEFixedBC(&fem, dof_Z, m_bottom));
+	fem.AddBoundaryCondition(new FEFixedBC(&fem, dof_X, m_top));
+	fem.AddBoundaryCondition(new FEFixedBC(&fem, dof_Y, m_top));
+
+	FELoadCurve* plc = new FELoadCurve(&fem);
+	plc->Add(0.0, 0.0);
+	plc->Add(1.0, 1.0);
+	fem.AddLoadController(plc);
+
+	FEPrescribedDOF* pdc = new FEPrescribedDOF(&fem, dof_Z, m_top);
+	pdc->SetScale(-m_strain, 0);
+	fem.AddBoundaryCondition(pdc);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The nodes are numbered as in FEBoxMesh::Create. For tet4, each hex is split in six 
+// tets around its main diagonal, which gives a conforming mesh.
+int FEModelBenchmark::AddBox(int nz, double z0, double z1)
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+	const int nx = m_nx, ny = m_ny;
+
+	// create the nodes
+	int n0 = mesh.Nodes();
+	int nodes = (nx + 1)*(ny + 1)*(nz + 1);
+	mesh.AddNodes(nodes);
+	mesh.SetDOFS(fem.GetDOFS().GetTotalDOFS());
+
+	int n = n0;
+	for (int i = 0; i <= nx; ++i)
+		for (int j = 0; j <= ny; ++j)
+			for (int k = 0; k <= nz; ++k, ++n)
+			{
+				FENode& node = mesh.Node(n);
+				node.m_r0 = vec3d((double) i / nx, (double) j / ny, z0 + ((z1 - z0)*k) / nz);
+				node.m_rt = node.m_r0;
+				node.m_rid = -1;
+
+				if ((k == 0) && (z0 <= 0.0)) m_bottom->Add(n);
+				if ((k == nz) && (z1 >= 1.0)) m_top->Add(n);
+			}
+
+	// create the domain
+	bool btet = (m_elemType == "tet4");
+	FE_Element_Spec es;
+	es.eclass = FE_Element_Class::FE_ELEM_SOLID;
+	es.eshape = (btet ? FE_Element_Shape::ET_TET4 : FE_Element_Shape::ET_HEX8);
+	es.etype = (btet ? FE_Element_Type::FE_TET4G4 : FE_Element_Type::FE_HEX8G8);
+
+	FECoreKernel& fecore = FECoreKernel::GetInstance();
+	FEDomain* dom = fecore.CreateDomain(es, &mesh, m_pmat);
+	FEElasticSolidDomain* pd = dynamic_cast<FEElasticSolidDomain*>(dom);
+	if (pd == nullptr)
+	{
+		delete dom;
+		feLogError("The benchmark requires an elastic solid material.");
+		return -1;
+	}
+
+	int hexes = nx*ny*nz;
+	int elems = (btet ? 6 * hexes : hexes);
+	pd->Create(elems, es.etype);
+	pd->SetMatID(0);
+	mesh.AddDomain(pd);
+	m_dom.push_back(pd);
+
+	// the Kuhn subdivision of a hex
+	const int TET[6][4] = { {0,1,2,6}, {0,2,3,6}, {0,3,7,6}, {0,7,4,6}, {0,4,5,6}, {0,5,1,6} };
+
+	int ne = 0;
+	for (int i = 0; i < nx; ++i)
+		for (int j = 0; j < ny; ++j)
+			for (int k = 0; k < nz; ++k)
+			{
+				int hn[8];
+				hn[0] = n0 + (i  )*(ny+1)*(nz+1) + (j  )*(nz+1) + (k  );
+				hn[1] = n0 + (i+1)*(ny+1)*(nz+1) + (j  )*(nz+1) + (k  );
+				hn[2] = n0 + (i+1)*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k  );
+				hn[3] = n0 + (i  )*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k  );
+				hn[4] = n0 + (i  )*(ny+1)*(nz+1) + (j  )*(nz+1) + (k+1);
+				hn[5] = n0 + (i+1)*(ny+1)*(nz+1) + (j  )*(nz+1) + (k+1);
+				hn[6] = n0 + (i+1)*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k+1);
+				hn[7] = n0 + (i  )*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k+1);
+
+				if (btet)
+				{
+					for (int l = 0; l < 6; ++l, ++ne)
+					{
+						FESolidElement& el = pd->Element(ne);
+						el.SetID(m_elems + ne + 1);
+						for (int m = 0; m < 4; ++m) el.m_node[m] = hn[TET[l][m]];
+					}
+				}
+				else
+				{
+					FESolidElement& el = pd->Element(ne);
+					el.SetID(m_elems + ne + 1);
+					for (int m = 0; m < 8; ++m) el.m_node[m] = hn[m];
+					ne++;
+				}
+			}
+
+	pd->CreateMaterialPointData();
+	m_elems += elems;
+
+	return n0;
+}
+
+//-----------------------------------------------------------------------------
+// The faces are oriented so that the normal points out of the box. For tet4, the
+// faces are split along the same diagonal as the tets.
+void FEModelBenchmark::AddContactSurface(bool bprimary, int n0, int nz, int k)
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	const int nx = m_nx, ny = m_ny;
+
+	bool btri = (m_elemType == "tet4");
+	bool bnodal = m_pci->UseNodalIntegration();
+	int ntype;
+	if (btri) ntype = (bnodal ? FE_TRI3NI : FE_TRI3G3);
+	else ntype = (bnodal ? FE_QUAD4NI : FE_QUAD4G4);
+
+	FESurface& s = *(bprimary ? m_pci->GetMasterSurface() : m_pci->GetSlaveSurface());
+	s.Create((btri ? 2 : 1)*nx*ny, ntype);
+	mesh.AddSurface(&s);
+
+	int nf = 0;
+	for (int i = 0; i < nx; ++i)
+		for (int j = 0; j < ny; ++j)
+		{
+			int a = n0 + (i  )*(ny+1)*(nz+1) + (j  )*(nz+1) + k;
+			int b = n0 + (i+1)*(ny+1)*(nz+1) + (j  )*(nz+1) + k;
+			int c = n0 + (i+1)*(ny+1)*(nz+1) + (j+1)*(nz+1) + k;
+			int d = n0 + (i  )*(ny+1)*(nz+1) + (j+1)*(nz+1) + k;
+
+			// the top face of the lower box points up, the bottom face of the upper box points down
+			if (bprimary == false) { int t = b; b = d; d = t; }
+
+			if (btri)
+			{
+				FESurfaceElement& f0 = s.Element(nf++);
+				f0.m_node[0] = a; f0.m_node[1] = b; f0.m_node[2] = c;
+				FESurfaceElement& f1 = s.Element(nf++);
+				f1.m_node[0] = a; f1.m_node[1] = c; f1.m_node[2] = d;
+			}
+			else
+			{
+				FESurfaceElement& f = s.Element(nf++);
+				f.m_node[0] = a; f.m_node[1] = b; f.m_node[2] = c; f.m_node[3] = d;
+			}
+		}
+}
+
+//-----------------------------------------------------------------------------
+// Selects every other hex of the box (in a checkerboard pattern). The bottom and 
+// top layers are skipped, so that no hanging nodes end up on the faces with
+// boundary conditions.
+class FECheckerboardCriterion : public FEMeshAdaptorCriterion
+{
+public:
+	FECheckerboardCriterion(FEModel* fem, int ny, int nz) : FEMeshAdaptorCriterion(fem), m_ny(ny), m_nz(nz) {}
+
+	bool Check(FEElement& el, double& elemVal) override
+	{
+		// the element IDs follow the numbering of AddBox
+		int n = el.GetID() - 1;
+		int k = n % m_nz;
+		int j = (n / m_nz) % m_ny;
+		int i = n / (m_ny*m_nz);
+		elemVal = 0.0;
+		return ((k > 0) && (k < m_nz - 1) && ((i + j + k) % 2 == 0));
+	}
+
+private:
+	int	m_ny, m_nz;
+};
+
+//-----------------------------------------------------------------------------
+// Refine every other hex with FEHexRefine. The faces between refined and unrefined
+// hexes get hanging nodes, which FEHexRefine ties down with linear constraints.
+bool FEModelBenchmark::Refine()
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+
+	FEMeshAdaptor* refine = fecore_new<FEMeshAdaptor>("hex_refine", &fem);
+	if (refine == nullptr) return false;
+
+	FECheckerboardCriterion criterion(&fem, m_ny, m_nz);
+	refine->SetProperty(refine->FindPropertyIndex("criterion"), &criterion);
+
+	// Apply returns false when the mesh was changed
+	bool bok = (refine->Apply(0) == false);
+	delete refine;
+	if (bok == false)
+	{
+		feLogError("Failed refining the mesh.");
+		return false;
+	}
+	m_elems = mesh.Elements();
+
+	// find the elements with hanging nodes
+	m_hanging = 0;
+	for (int i = 0; i < mesh.Nodes(); ++i) if (mesh.Node(i).HasFlags(FENode::HANGING)) m_hanging++;
+
+	m_lcElem.clear();
+	for (size_t i = 0; i < m_dom.size(); ++i)
+	{
+		FEElasticSolidDomain& dom = *m_dom[i];
+		for (int j = 0; j < dom.Elements(); ++j)
+		{
+			FESolidElement& el = dom.Element(j);
+			for (int k = 0; k < el.Nodes(); ++k)
+			{
+				if (mesh.Node(el.m_node[k]).HasFlags(FENode::HANGING))
+				{
+					m_lcElem.push_back(std::make_pair((int)i, j));
+					break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Run a fixed number of full-Newton iterations. The steps follow FENewtonSolver::Quasin,
+// but each phase is timed separately.
+bool FEModelBenchmark::Run()
+{
+	FEModel& fem = *GetFEModel();
+	FEAnalysis* pstep = fem.GetCurrentStep();
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(pstep->GetFESolver());
+	if (solver == nullptr) return false;
+
+	// activate the step and initialize the solver
+	if (pstep->Activate() == false) return false;
+	if (solver->InitEquations() == false) return false;
+	if (solver->Init() == false) return false;
+	if (fem.GetLinearConstraintManager().Initialize() == false) return false;
+
+	// advance to the end of the time step
+	FETimeInfo& tp = fem.GetTime();
+	tp.timeIncrement = pstep->m_dt0;
+	tp.currentTime += pstep->m_dt0;
+	if (solver->InitStep(tp.currentTime) == false) return false;
+	solver->PrepStep();
+
+	// open the plot file
+	FEBioPlotFile* plt = nullptr;
+	if (m_plotFile.empty() == false)
+	{
+		TimerTracker t(&m_plot.timer);
+		plt = new FEBioPlotFile(fem);
+		plt->AddVariable("displacement");
+		plt->AddVariable("stress");
+		if (plt->Open(fem, m_plotFile.c_str()) == false)
+		{
+			feLogError("Failed creating PLOT database.");
+			delete plt;
+			return false;
+		}
+	}
+
+	feLog("\nRunning benchmark: %d elements, %d equations, %d threads\n", m_elems, solver->m_neq, omp_get_max_threads());
+
+	LinearSolver* ls = solver->m_plinsolve;
+	bool bok = true;
+	try
+	{
+		for (int n = 0; n < m_niter; ++n)
+		{
+			solver->m_niter = n;
+
+			// the matrix profile of contact problems changes in every iteration
+			if ((n == 0) || (fem.SurfacePairConstraints() > 0))
+			{
+				TimerTracker t(&m_profile.timer); m_profile.calls++;
+				if (solver->CreateStiffness(n == 0) == false) { bok = false; break; }
+			}
+			m_nnz = solver->m_pK->NonZeroes();
+
+			// element stiffness only
+			ElementStiffness();
+
+			// constraint assembly (this is undone by the zeroing below)
+			if (m_lcElem.empty() == false) ConstraintScatter();
+
+			// element stiffness and assembly
+			{
+				TimerTracker t(&m_assembly.timer); m_assembly.calls++;
+				solver->m_pK->Zero();
+				zero(solver->m_Fd);
+				bok = solver->StiffnessMatrix();
+			}
+			if (bok == false) break;
+
+			{
+				TimerTracker t(&m_factor.timer); m_factor.calls++;
+				bok = ls->Factor();
+			}
+			if (bok == false) break;
+
+			// the initial residual needs the contribution of the prescribed dofs
+			if (n == 0)
+			{
+				{
+					TimerTracker t(&m_residual.timer); m_residual.calls++;
+					bok = solver->Residual(solver->m_R0);
+				}
+				if (bok == false) break;
+				solver->m_R0 += solver->m_Fd;
+			}
+
+			{
+				TimerTracker t(&m_backsolve.timer); m_backsolve.calls++;
+				bok = ls->BackSolve(solver->m_ui, solver->m_R0);
+			}
+			if (bok == false) break;
+
+			// update the solution
+			solver->Update(solver->m_ui);
+			solver->m_Ui += solver->m_ui;
+
+			{
+				TimerTracker t(&m_residual.timer); m_residual.calls++;
+				bok = solver->Residual(solver->m_R0);
+			}
+			if (bok == false) break;
+
+			double rnorm = sqrt(solver->m_R0*solver->m_R0);
+			m_norm.push_back(rnorm);
+			feLog(" %d: residual norm = %lg\n", n + 1, rnorm);
+
+			if (plt)
+			{
+				TimerTracker t(&m_plot.timer); m_plot.calls++;
+				plt->Write(fem, (float) (n + 1));
+			}
+		}
+	}
+	catch (NegativeJacobian e)
+	{
+		feLogError("Negative jacobian was detected at element %d at gauss point %d\njacobian = %lg\n", e.m_iel, e.m_ng + 1, e.m_vol);
+		bok = false;
+	}
+	catch (DoRunningRestart)
+	{
+		// the domain already reported the error
+		bok = false;
+	}
+	catch (LinearSolverFailed)
+	{
+		feLogError("Linear solver failed to find solution.");
+		bok = false;
+	}
+	catch (FactorizationError)
+	{
+		feLogError("Fatal error in factorization of stiffness matrix.");
+		bok = false;
+	}
+
+	if (plt)
+	{
+		{
+			TimerTracker t(&m_plot.timer);
+			plt->Close();
+		}
+		delete plt;
+
+		FILE* fp = fopen(m_plotFile.c_str(), "rb");
+		if (fp)
+		{
+			fseek(fp, 0, SEEK_END);
+			m_plotBytes = (double) ftell(fp);
+			fclose(fp);
+		}
+	}
+
+	if (bok == false)
+	{
+		feLogError("Benchmark failed.");
+		return false;
+	}
+
+	WriteReport();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// This mirrors FEElasticSolidDomain::StiffnessMatrix, but skips the assembly.
+void FEModelBenchmark::ElementStiffness()
+{
+	TimerTracker t(&m_stiffness.timer); m_stiffness.calls++;
+
+	for (size_t i = 0; i < m_dom.size(); ++i)
+	{
+		FEElasticSolidDomain& dom = *m_dom[i];
+		int NE = dom.Elements();
+		dom.ElementWorkspaces().Prepare();
+
+		#pragma omp parallel for shared (NE)
+		for (int iel = 0; iel < NE; ++iel)
+		{
+			FESolidElement& el = dom.Element(iel);
+			FEElementWorkspace& ws = dom.ElementWorkspaces().GetThreadWorkspace();
+			int ndof = 3 * el.Nodes();
+			FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
+			dom.ElementGeometricalStiffness(el, ke);
+			dom.ElementMaterialStiffness(el, ke);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Evaluates the element matrices of the elements with hanging nodes in three passes:
+// without assembly, with the lock-free constraint assembly of FELinearConstraintManager, 
+// and with the same assembly inside an omp critical section, which is how the
+// element loops used to serialize it. The difference with the first pass is the 
+// time of the constraint assembly.
+void FEModelBenchmark::ConstraintScatter()
+{
+	FEModel& fem = *GetFEModel();
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(fem.GetCurrentStep()->GetFESolver());
+	FELinearConstraintManager& LCM = fem.GetLinearConstraintManager();
+	FEGlobalMatrix& K = *solver->m_pK;
+	vector<double>& F = solver->m_Fd;
+	vector<double>& u = solver->m_ui;
+
+	for (size_t i = 0; i < m_dom.size(); ++i) m_dom[i]->ElementWorkspaces().Prepare();
+
+	Phase* phase[3] = { &m_lcStiffness, &m_lcScatter, &m_lcCritical };
+	const int NE = (int) m_lcElem.size();
+	for (int pass = 0; pass < 3; ++pass)
+	{
+		TimerTracker t(&phase[pass]->timer); phase[pass]->calls++;
+
+		#pragma omp parallel for shared (NE)
+		for (int n = 0; n < NE; ++n)
+		{
+			FEElasticSolidDomain& dom = *m_dom[m_lcElem[n].first];
+			FESolidElement& el = dom.Element(m_lcElem[n].second);
+			FEElementWorkspace& ws = dom.ElementWorkspaces().GetThreadWorkspace();
+
+			vector<int>& lm = ws.LM();
+			dom.UnpackLM(el, lm);
+
+			int ndof = 3 * el.Nodes();
+			FEElementMatrix& ke = ws.ElementMatrix(el, ndof, ndof);
+			ke.SetIndices(lm);
+			dom.ElementGeometricalStiffness(el, ke);
+			dom.ElementMaterialStiffness(el, ke);
+
+			if (pass == 1)
+			{
+				LCM.AssembleStiffness(K, F, u, ke.Nodes(), ke.RowIndices(), ke.ColumnsIndices(), ke);
+			}
+			else if (pass == 2)
+			{
+				#pragma omp critical
+				LCM.AssembleStiffness(K, F, u, ke.Nodes(), ke.RowIndices(), ke.ColumnsIndices(), ke);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// The bandwidth of the matrix phases is based on the size of the global matrix 
+// (values and indices), which is a lower bound of the actual memory traffic. In
+// particular, the fill-in of the direct solvers is not accounted for.
+void FEModelBenchmark::WriteReport()
+{
+	FEModel& fem = *GetFEModel();
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(fem.GetCurrentStep()->GetFESolver());
+
+	double matBytes = (double) m_nnz * (sizeof(double) + sizeof(int));
+
+	// the assembly time is the time of the stiffness matrix evaluation minus the 
+	// time needed to evaluate the element matrices
+	double tasm = m_assembly.timer.GetTime() - m_stiffness.timer.GetTime();
+
+	feLog("\nBenchmark results:\n");
+	feLog("\telements         : %d (%s)\n", m_elems, m_elemType.c_str());
+	feLog("\tequations        : %d\n", solver->m_neq);
+	feLog("\tnonzeroes        : %d\n", m_nnz);
+	feLog("\tthreads          : %d\n", omp_get_max_threads());
+	feLog("\tresidual         : %lg s (%d calls)\n", m_residual.timer.GetTime(), m_residual.calls);
+	feLog("\tstiffness        : %lg s (%d calls)\n", m_stiffness.timer.GetTime(), m_stiffness.calls);
+	feLog("\tassembly         : %lg s (%d calls)\n", (tasm > 0.0 ? tasm : 0.0), m_assembly.calls);
+	feLog("\tfactorization    : %lg s (%d calls)\n", m_factor.timer.GetTime(), m_factor.calls);
+	feLog("\tback-solve       : %lg s (%d calls)\n", m_backsolve.timer.GetTime(), m_backsolve.calls);
+	if (m_plotFile.empty() == false) feLog("\tplot output      : %lg s (%d states)\n", m_plot.timer.GetTime(), m_plot.calls);
+
+	// the constraint assembly times exclude the element matrices
+	FELinearConstraintManager& LCM = fem.GetLinearConstraintManager();
+	double tlc0 = m_lcStiffness.timer.GetTime();
+	double tlc1 = m_lcScatter.timer.GetTime() - tlc0;
+	double tlc2 = m_lcCritical.timer.GetTime() - tlc0;
+	if (m_lcElem.empty() == false)
+	{
+		feLog("\thanging nodes    : %d (%d constraints, %d elements)\n", m_hanging, LCM.LinearConstraints(), (int) m_lcElem.size());
+		feLog("\tconstraints      : %lg s (lock-free), %lg s (critical) (%d calls)\n", tlc1, tlc2, m_lcScatter.calls);
+	}
+
+	FETelemetry out;
+	if (out.Open(m_outFile.c_str()) == false)
+	{
+		feLogError("Failed creating benchmark output file %s.", m_outFile.c_str());
+		return;
+	}
+
+	out.BeginRecord("benchmark");
+	out.Write("element", m_elemType.c_str());
+	out.Write("nx", m_nx);
+	out.Write("ny", m_ny);
+	out.Write("nz", m_nz);
+	out.Write("elements", m_elems);
+	out.Write("nodes", fem.GetMesh().Nodes());
+	out.Write("equations", solver->m_neq);
+	out.Write("nnz", m_nnz);
+	out.Write("threads", omp_get_max_threads());
+	out.Write("material", m_pmat->GetTypeStr());
+	out.Write("linear_solver", (solver->m_plinsolve ? solver->m_plinsolve->GetTypeStr() : "none"));
+	out.Write("contact", (m_pci ? m_pci->GetTypeStr() : "none"));
+	out.Write("refine", m_brefine);
+	out.Write("iterations", m_niter);
+
+	WritePhase(out, "residual", m_residual, m_elems, 0.0, 0.0);
+	WritePhase(out, "stiffness", m_stiffness, m_elems, 0.0, 0.0);
+
+	out.BeginObject("assembly");
+	out.Write("time", (tasm > 0.0 ? tasm : 0.0));
+	out.Write("calls", m_assembly.calls);
+	if (tasm > 0.0)
+	{
+		out.Write("elements_per_s", m_assembly.calls*(double)m_elems / tasm);
+		out.Write("nnz_per_s", m_assembly.calls*(double)m_nnz / tasm);
+		out.Write("gb_per_s", m_assembly.calls*matBytes*1e-9 / tasm);
+	}
+	out.EndObject();
+
+	WritePhase(out, "factorization", m_factor, 0.0, m_nnz, matBytes);
+	WritePhase(out, "back_solve", m_backsolve, 0.0, m_nnz, matBytes);
+	WritePhase(out, "profile", m_profile, 0.0, 0.0, 0.0);
+
+	if (m_plotFile.empty() == false)
+	{
+		// the plot time includes opening and closing the file, so we report the total bandwidth
+		double t = m_plot.timer.GetTime();
+		out.BeginObject("plot");
+		out.Write("time", t);
+		out.Write("calls", m_plot.calls);
+		if (t > 0.0)
+		{
+			out.Write("elements_per_s", m_plot.calls*(double)m_elems / t);
+			out.Write("gb_per_s", m_plotBytes*1e-9 / t);
+		}
+		out.EndObject();
+	}
+
+	if (m_lcElem.empty() == false)
+	{
+		out.BeginObject("constraints");
+		out.Write("hanging_nodes", m_hanging);
+		out.Write("linear_constraints", LCM.LinearConstraints());
+		out.Write("elements", (int) m_lcElem.size());
+		out.Write("calls", m_lcScatter.calls);
+		out.Write("stiffness_time", tlc0);
+		out.Write("lock_free_time", tlc1);
+		out.Write("critical_time", tlc2);
+		out.EndObject();
+	}
+
+	if (m_norm.empty() == false) out.Write("residual_norms", &m_norm[0], (int) m_norm.size());
+	out.EndRecord();
+	out.Close();
+}
+
+//-----------------------------------------------------------------------------
+// write the timing of a phase. The rates are only written when the amount of 
+// work per call is non-zero.
+void FEModelBenchmark::WritePhase(FETelemetry& out, const char* szname, Phase& p, double elems, double nnz, double bytes)
+{
+	double t = p.timer.GetTime();
+	out.BeginObject(szname);
+	out.Write("time", t);
+	out.Write("calls", p.calls);
+	if (t > 0.0)
+	{
+		if (elems > 0.0) out.Write("elements_per_s", p.calls*elems / t);
+		if (nnz   > 0.0) out.Write("nnz_per_s"     , p.calls*nnz / t);
+		if (bytes > 0.0) out.Write("gb_per_s"      , p.calls*bytes*1e-9 / t);
+	}
+	out.EndObject();
+}
@@ -0,0 +1,132 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <FECore/FECoreTask.h>
+#include <FECore/Timer.h>
+#include <string>
+#include <vector>
+
+class FEMaterial;
+class FESurfacePairConstraint;
+class FEElasticSolidDomain;
+class FENodeSet;
+class FETelemetry;
+
+//-----------------------------------------------------------------------------
+// Scalable benchmark of the nonlinear solution pipeline. A box of nx*ny*nz 
+// hex8 (or tet4) elements is compressed and a fixed number of full-Newton 
+// iterations is run. The time spent in the residual, element stiffness, 
+// assembly, factorization, back-solve and plot output is measured and written
+// as a JSON record (elements/s, nnz/s, GB/s), so that runs with different 
+// mesh sizes and thread counts can be collected into scaling curves. 
+// Optionally, the box is split in two halves that are connected by a contact 
+// interface, or every other hex is refined, which creates hanging nodes that
+// are tied down with linear constraints. All settings are read from an 
+// (optional) control file.
+class FEModelBenchmark : public FECoreTask
+{
+	friend class FEModelBenchmarkSection;
+
+	// timing data of one phase of a Newton iteration
+	struct Phase
+	{
+		Phase() : calls(0) {}
+		Timer	timer;
+		int		calls;
+	};
+
+public:
+	FEModelBenchmark(FEModel* fem);
+
+	bool Init(const char* szfile) override;
+
+	bool Run() override;
+
+private:
+	bool ReadControlFile(const char* szfile);
+
+	bool BuildModel();
+
+	// add a box of m_nx*m_ny*nz elements between z0 and z1. Returns the index of the first node.
+	int AddBox(int nz, double z0, double z1);
+
+	// add a contact surface on the face k of the box that starts at node n0
+	void AddContactSurface(bool bprimary, int n0, int nz, int k);
+
+	// refine every other hex of the box
+	bool Refine();
+
+	// evaluate the element stiffness matrices without assembling them
+	void ElementStiffness();
+
+	// assemble the linear constraints of the elements with hanging nodes
+	void ConstraintScatter();
+
+	void WriteReport();
+
+	void WritePhase(FETelemetry& out, const char* szname, Phase& p, double elems, double nnz, double bytes);
+
+private:
+	// control parameters
+	std::string	m_elemType;		// element type ("hex8" or "tet4")
+	int			m_nx, m_ny, m_nz;	// nr of elements in each direction
+	int			m_niter;		// nr of Newton iterations
+	double		m_strain;		// applied compressive strain
+	bool		m_brefine;		// refine every other hex (hex8 only)
+	std::string	m_plotFile;		// plot file (no plot output when empty)
+	std::string	m_outFile;		// JSON output file
+
+	FEMaterial*					m_pmat;		// material of the box (the model's first material)
+	FESurfacePairConstraint*	m_pci;		// contact interface (optional)
+
+	// model data
+	std::vector<FEElasticSolidDomain*>	m_dom;
+	FENodeSet*	m_bottom;	// nodes at z = 0
+	FENodeSet*	m_top;		// nodes at z = 1
+	int			m_elems;	// total nr of elements
+	int			m_nnz;		// nr of nonzeroes of the global stiffness matrix
+	double		m_plotBytes;	// size of the plot file
+	int			m_hanging;		// nr of hanging nodes
+	std::vector<std::pair<int, int> >	m_lcElem;	// elements with hanging nodes (domain, element)
+
+	std::vector<double>	m_norm;	// residual norm after each iteration
+
+	// timing data
+	Phase	m_residual;
+	Phase	m_stiffness;
+	Phase	m_assembly;
+	Phase	m_factor;
+	Phase	m_backsolve;
+	Phase	m_plot;
+	Phase	m_profile;
+	Phase	m_lcStiffness;	// element matrices of the elements with hanging nodes
+	Phase	m_lcScatter;	// same, with the lock-free constraint assembly
+	Phase	m_lcCritical;	// same, with the constraint assembly in a critical section
+};
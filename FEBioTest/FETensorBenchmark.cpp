@@ -0,0 +1,291 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FETensorBenchmark.h"
+#include <FECore/tens4ds_batch.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <FEBioXML/XMLReader.h>
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------
+namespace {
+
+	double frand() { return rand() / (double)RAND_MAX - 0.5; }
+
+	double max_diff(const tens4ds& a, const tens4ds& b)
+	{
+		double m = 0.0;
+		for (int i = 0; i < tens4ds::NNZ; ++i) m = max(m, fabs(a.d[i] - b.d[i]));
+		return m;
+	}
+
+	double max_diff(const mat3ds& a, const mat3ds& b)
+	{
+		mat3ds d = a - b;
+		return max(max(max(fabs(d.xx()), fabs(d.yy())), max(fabs(d.zz()), fabs(d.xy()))), max(fabs(d.yz()), fabs(d.xz())));
+	}
+
+	double max_diff(const matrix& a, const matrix& b)
+	{
+		double m = 0.0;
+		for (int i = 0; i < a.rows(); ++i)
+			for (int j = 0; j < a.columns(); ++j) m = max(m, fabs(a[i][j] - b[i][j]));
+		return m;
+	}
+
+	// material stiffness of one integration point, as evaluated in 
+	// FEElasticSolidDomain::ElementMaterialStiffness
+	void material_stiffness(tens4ds& c, const vec3d* G, double w, int neln, matrix& ke)
+	{
+		double D[6][6], DBL[6][3];
+		c.extract(D);
+		for (int i = 0, i3 = 0; i < neln; ++i, i3 += 3)
+		{
+			double Gxi = G[i].x, Gyi = G[i].y, Gzi = G[i].z;
+			for (int j = 0, j3 = 0; j < neln; ++j, j3 += 3)
+			{
+				double Gxj = G[j].x, Gyj = G[j].y, Gzj = G[j].z;
+				for (int k = 0; k < 6; ++k)
+				{
+					DBL[k][0] = (D[k][0]*Gxj + D[k][3]*Gyj + D[k][5]*Gzj);
+					DBL[k][1] = (D[k][1]*Gyj + D[k][3]*Gxj + D[k][4]*Gzj);
+					DBL[k][2] = (D[k][2]*Gzj + D[k][4]*Gyj + D[k][5]*Gxj);
+				}
+				for (int k = 0; k < 3; ++k)
+				{
+					ke[i3  ][j3 + k] += (Gxi*DBL[0][k] + Gyi*DBL[3][k] + Gzi*DBL[5][k])*w;
+					ke[i3+1][j3 + k] += (Gyi*DBL[1][k] + Gxi*DBL[3][k] + Gzi*DBL[4][k])*w;
+					ke[i3+2][j3 + k] += (Gzi*DBL[2][k] + Gyi*DBL[4][k] + Gxi*DBL[5][k])*w;
+				}
+			}
+		}
+	}
+
+	// time a function that is evaluated nrep times (in ms per evaluation)
+	template <class F> double time_it(F f, int nrep)
+	{
+		Timer t;
+		t.start();
+		for (int i = 0; i < nrep; ++i) f();
+		t.stop();
+		return 1000.0*t.GetTime() / nrep;
+	}
+}
+
+//-----------------------------------------------------------------------------
+FETensorBenchmark::FETensorBenchmark(FEModel* fem) : FECoreTask(fem)
+{
+	m_nrepeat = 200;
+}
+
+//-----------------------------------------------------------------------------
+// The benchmark does not need a model, so the file is only used for the 
+// control parameters. Without it, a single batch of 4096 points is used.
+bool FETensorBenchmark::Init(const char* szfile)
+{
+	if (szfile && szfile[0])
+	{
+		if (ReadControlFile(szfile) == false) return false;
+	}
+
+	if (m_npoints.empty()) m_npoints.push_back(4096);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FETensorBenchmark::ReadControlFile(const char* szfile)
+{
+	XMLReader xml;
+	if (xml.Open(szfile) == false)
+	{
+		fprintf(stderr, "\nERROR: Failed to open %s\n\n", szfile);
+		return false;
+	}
+
+	XMLTag tag;
+	if (xml.FindTag("febio_tensor_benchmark", tag) == false)
+	{
+		fprintf(stderr, "\nERROR: Failed to read %s\n\n", szfile);
+		return false;
+	}
+
+	bool bret = true;
+	try
+	{
+		++tag;
+		do
+		{
+			if (tag == "points")
+			{
+				const int MAX_SIZES = 32;
+				int n[MAX_SIZES];
+				int nread = tag.value(n, MAX_SIZES);
+				for (int i = 0; i < nread; ++i)
+				{
+					if (n[i] <= 0) throw XMLReader::InvalidValue(tag);
+					m_npoints.push_back(n[i]);
+				}
+			}
+			else if (tag == "repeat")
+			{
+				tag.value(m_nrepeat);
+				if (m_nrepeat <= 0) throw XMLReader::InvalidValue(tag);
+			}
+			else throw XMLReader::InvalidTag(tag);
+
+			++tag;
+		}
+		while (!tag.isend());
+	}
+	catch (XMLReader::Error& e)
+	{
+		fprintf(stderr, "\nERROR: %s\n\n", e.what());
+		bret = false;
+	}
+
+	xml.Close();
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+bool FETensorBenchmark::Run()
+{
+	for (int npoints : m_npoints) RunBatch(npoints);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FETensorBenchmark::RunBatch(int npoints)
+{
+	const int N = npoints;
+	const int nrep = m_nrepeat;
+
+	// setup random input data
+	vector<mat3ds> a(N), b(N), m3(N);
+	vector<tens4ds> c(N), d(N), t4(N);
+	vector<double> s(N), lam(N), mu(N);
+	vector<mat3d> f(N);
+	mat3ds_batch A(N), B(N), M3(N);
+	mat3d_batch F(N);
+	tens4ds_batch C(N), D(N), T4(N);
+	for (int n = 0; n < N; ++n)
+	{
+		a[n] = mat3ds(frand(), frand(), frand(), frand(), frand(), frand());
+		b[n] = mat3ds(frand(), frand(), frand(), frand(), frand(), frand());
+		for (int i = 0; i < tens4ds::NNZ; ++i) { c[n].d[i] = frand(); d[n].d[i] = frand(); }
+		s[n] = frand();
+		lam[n] = frand();
+		mu[n] = frand();
+
+		f[n] = mat3d(frand(), frand(), frand(), frand(), frand(), frand(), frand(), frand(), frand());
+
+		A.set(n, a[n]); B.set(n, b[n]);
+		C.set(n, c[n]); D.set(n, d[n]);
+		F.set(n, f[n]);
+	}
+
+	// shape function gradients and weights of hex8 elements
+	const int NEN = 8;
+	vector<vec3d> G(N*NEN);
+	vector<double> w(N);
+	for (int n = 0; n < N; ++n)
+	{
+		for (int i = 0; i < NEN; ++i) G[n*NEN + i] = vec3d(frand(), frand(), frand());
+		w[n] = frand();
+	}
+	matrix ks(3*NEN, 3*NEN), kb(3*NEN, 3*NEN);
+	const mat3dd I(1);
+
+	feLog("\nTensor benchmark: %d points, %d repetitions\n\n", N, nrep);
+	feLog("%-16s%14s%14s%10s%14s\n", "operator", "scalar (ms)", "batch (ms)", "speedup", "max diff");
+	feLog("--------------------------------------------------------------------------\n");
+
+	// report timings and the max difference between the two implementations
+	auto report = [&](const char* szname, double ts, double tb, double err) {
+		feLog("%-16s%14.4lf%14.4lf%10.2lf%14.3lg\n", szname, ts, tb, (tb > 0 ? ts / tb : 0.0), err);
+	};
+	auto diff4 = [&]() {
+		double err = 0.0;
+		for (int n = 0; n < N; ++n) err = max(err, max_diff(t4[n], T4.get(n)));
+		return err;
+	};
+
+	double ts, tb;
+
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) t4[n] = dyad1s(a[n]); }, nrep);
+	tb = time_it([&]() { dyad1s(A, T4); }, nrep);
+	report("dyad1s(a)", ts, tb, diff4());
+
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) t4[n] = dyad1s(a[n], b[n]); }, nrep);
+	tb = time_it([&]() { dyad1s(A, B, T4); }, nrep);
+	report("dyad1s(a,b)", ts, tb, diff4());
+
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) t4[n] = dyad4s(a[n]); }, nrep);
+	tb = time_it([&]() { dyad4s(A, T4); }, nrep);
+	report("dyad4s(a)", ts, tb, diff4());
+
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) t4[n] = dyad4s(a[n], b[n]); }, nrep);
+	tb = time_it([&]() { dyad4s(A, B, T4); }, nrep);
+	report("dyad4s(a,b)", ts, tb, diff4());
+
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) t4[n] = ddots(c[n], d[n]); }, nrep);
+	tb = time_it([&]() { ddots(C, D, T4); }, nrep);
+	report("ddots(c,d)", ts, tb, diff4());
+
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) m3[n] = c[n].dot(a[n]); }, nrep);
+	tb = time_it([&]() { ddot(C, A, M3); }, nrep);
+	double err = 0.0;
+	for (int n = 0; n < N; ++n) err = max(err, max_diff(m3[n], M3.get(n)));
+	report("c:a", ts, tb, err);
+
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) t4[n] = c[n].pp(f[n]); }, nrep);
+	tb = time_it([&]() { pp(C, F, T4); }, nrep);
+	report("c.pp(F)", ts, tb, diff4());
+
+	// the following operators update the result, so it is reset first
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) t4[n] = c[n] + d[n]*s[n]; }, nrep);
+	tb = time_it([&]() { T4 = C; axpy(D, &s[0], T4); }, nrep);
+	report("c + d*s", ts, tb, diff4());
+
+	ts = time_it([&]() { for (int n = 0; n < N; ++n) t4[n] = c[n] + dyad1s(I)*lam[n] + dyad4s(I)*(2.0*mu[n]); }, nrep);
+	tb = time_it([&]() { T4 = C; add_isotropic(&lam[0], &mu[0], T4); }, nrep);
+	report("isotropic", ts, tb, diff4());
+
+	// BL^T*D*BL, summed over all points
+	ts = time_it([&]() { ks.zero(); for (int n = 0; n < N; ++n) material_stiffness(c[n], &G[n*NEN], w[n], NEN, ks); }, nrep);
+	tb = time_it([&]() { kb.zero(); add_material_stiffness(C, &G[0], &w[0], NEN, kb); }, nrep);
+	report("BL'*D*BL", ts, tb, max_diff(ks, kb));
+
+	feLog("\n");
+}
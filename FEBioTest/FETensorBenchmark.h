@@ -0,0 +1,63 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <FECore/FECoreTask.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Micro-benchmark for the tensor algebra. Each operator is evaluated for a 
+// set of random points, once with the mat3ds/tens4ds operators and once with 
+// the batch kernels, and the timings and the max difference are reported.
+// The optional control file sets the batch sizes and the number of repetitions:
+//
+//   <febio_tensor_benchmark>
+//     <points>64,512,4096</points>
+//     <repeat>200</repeat>
+//   </febio_tensor_benchmark>
+//
+// The benchmark is repeated for each batch size.
+class FETensorBenchmark : public FECoreTask
+{
+public:
+	FETensorBenchmark(FEModel* fem);
+
+	bool Init(const char* szfile) override;
+
+	bool Run() override;
+
+private:
+	bool ReadControlFile(const char* szfile);
+
+	void RunBatch(int npoints);
+
+private:
+	std::vector<int>	m_npoints;	// batch sizes (number of points)
+	int		m_nrepeat;	// number of times each operator is evaluated
+};
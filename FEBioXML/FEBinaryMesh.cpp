@@ -0,0 +1,1073 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEBinaryMesh.h"
+#include "FEModelBuilder.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/FEDomain.h>
+#include <FECore/FEShellDomain.h>
+#include <FECore/FEMaterial.h>
+#include <FECore/FENodeDataMap.h>
+#include <FECore/FEDomainMap.h>
+#include <FECore/FESurfaceMap.h>
+#include <FECore/FEElementLibrary.h>
+#include <FECore/log.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace FEBinaryMesh;
+
+//-----------------------------------------------------------------------------
+// CRC-32 lookup table. This is built during static initialization so that
+// crc32 can be called concurrently.
+class FECRC32Table
+{
+public:
+	FECRC32Table()
+	{
+		for (unsigned int i = 0; i < 256; ++i)
+		{
+			unsigned int c = i;
+			for (int k = 0; k < 8; ++k) c = (c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1);
+			m_table[i] = c;
+		}
+	}
+
+	unsigned int operator [] (int i) const { return m_table[i]; }
+
+private:
+	unsigned int	m_table[256];
+};
+
+static const FECRC32Table crc_table;
+
+//-----------------------------------------------------------------------------
+unsigned int FEBinaryMesh::crc32(const void* data, size_t size, unsigned int crc)
+{
+	const unsigned char* p = (const unsigned char*)data;
+	crc = ~crc;
+	for (size_t i = 0; i < size; ++i) crc = crc_table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+//-----------------------------------------------------------------------------
+// The binary mesh format is defined as little-endian.
+static bool is_little_endian()
+{
+	unsigned int n = 1;
+	return (*((unsigned char*)&n) == 1);
+}
+
+//-----------------------------------------------------------------------------
+// element type names, as used in the FEBio input file
+static const char* element_type_name(const FEElement& el)
+{
+	switch (el.Type())
+	{
+	case FE_TET10G4        : return "TET10G4";
+	case FE_TET10G8        : return "TET10G8";
+	case FE_TET10GL11      : return "TET10GL11";
+	case FE_TET15G8        : return "TET15G8";
+	case FE_TET15G11       : return "TET15G11";
+	case FE_TET15G15       : return "TET15G15";
+	case FE_HEX20G8        : return "HEX20G8";
+	case FE_PENTA15G8      : return "PENTA15G8";
+	case FE_SHELL_QUAD4G12 : return "QUAD4G12";
+	case FE_SHELL_QUAD8G27 : return "QUAD8G27";
+	case FE_SHELL_TRI3G9   : return "TRI3G9";
+	case FE_SHELL_TRI6G21  : return "TRI6G21";
+	default:
+		break;
+	}
+
+	switch (el.Shape())
+	{
+	case ET_HEX8   : return "hex8";
+	case ET_HEX20  : return "hex20";
+	case ET_HEX27  : return "hex27";
+	case ET_PENTA6 : return "penta6";
+	case ET_PENTA15: return "penta15";
+	case ET_PYRA5  : return "pyra5";
+	case ET_TET4   : return "tet4";
+	case ET_TET5   : return "tet5";
+	case ET_TET10  : return "tet10";
+	case ET_TET15  : return "tet15";
+	case ET_TET20  : return "tet20";
+	case ET_QUAD4  : return "quad4";
+	case ET_QUAD8  : return "quad8";
+	case ET_QUAD9  : return "quad9";
+	case ET_TRI3   : return "tri3";
+	case ET_TRI6   : return "tri6";
+	case ET_TRUSS2 : return "truss2";
+	default:
+		break;
+	}
+	return 0;
+}
+
+//=============================================================================
+// Helper class for assembling the data of a chunk. 
+// Every item starts on an 8-byte boundary.
+class FEBinaryChunk
+{
+public:
+	FEBinaryChunk(unsigned int id) : m_id(id) {}
+
+	unsigned int GetID() const { return m_id; }
+
+	const std::vector<char>& GetBuffer() const { return m_buf; }
+
+	void write(int n) { append(&n, sizeof(int)); }
+
+	void write(const std::string& s)
+	{
+		write((int)s.size());
+		append(s.c_str(), s.size());
+	}
+
+	template <typename T> void write(const T* v, size_t n)
+	{
+		append(v, n*sizeof(T));
+	}
+
+private:
+	void append(const void* pd, size_t size)
+	{
+		const char* p = (const char*)pd;
+		m_buf.insert(m_buf.end(), p, p + size);
+		size_t pad = (8 - (m_buf.size() % 8)) % 8;
+		m_buf.insert(m_buf.end(), pad, 0);
+	}
+
+private:
+	unsigned int		m_id;
+	std::vector<char>	m_buf;
+};
+
+//=============================================================================
+// Helper class for reading the items of a chunk. Arrays are not copied, but
+// returned as pointers into the chunk data.
+class FEBinaryChunkReader
+{
+public:
+	FEBinaryChunkReader(const char* data, size_t size) : m_p(data), m_end(data + size) {}
+
+	bool read(int& n)
+	{
+		const int* pn = array<int>(1);
+		if (pn == 0) return false;
+		n = *pn;
+		return true;
+	}
+
+	bool read(std::string& s)
+	{
+		int n = 0;
+		if ((read(n) == false) || (n < 0)) return false;
+		const char* sz = array<char>(n);
+		if ((sz == 0) && (n > 0)) return false;
+		s.assign(sz, n);
+		return true;
+	}
+
+	template <typename T> const T* array(size_t n)
+	{
+		size_t size = n*sizeof(T);
+		size_t pad = (8 - (size % 8)) % 8;
+		if (m_p + size + pad > m_end) return 0;
+		const T* p = (const T*)m_p;
+		m_p += size + pad;
+		return p;
+	}
+
+private:
+	const char*	m_p;
+	const char*	m_end;
+};
+
+//=============================================================================
+// Read-only memory mapping of a file.
+class FEMappedFile
+{
+public:
+	FEMappedFile() : m_data(0), m_size(0) {}
+	~FEMappedFile() { Close(); }
+
+	bool Open(const char* szfile)
+	{
+#ifdef WIN32
+		m_file = CreateFileA(szfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (m_file == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(m_file, &size) == FALSE) { Close(); return false; }
+		m_size = (size_t)size.QuadPart;
+		m_map = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (m_map == NULL) { Close(); return false; }
+		m_data = (const char*)MapViewOfFile(m_map, FILE_MAP_READ, 0, 0, 0);
+		if (m_data == 0) { Close(); return false; }
+#else
+		int fd = open(szfile, O_RDONLY);
+		if (fd < 0) return false;
+		struct stat st;
+		if ((fstat(fd, &st) != 0) || (st.st_size == 0)) { close(fd); return false; }
+		m_size = (size_t)st.st_size;
+		void* p = mmap(0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (p == MAP_FAILED) { m_size = 0; return false; }
+		m_data = (const char*)p;
+#endif
+		return true;
+	}
+
+	void Close()
+	{
+#ifdef WIN32
+		if (m_data) UnmapViewOfFile(m_data);
+		if (m_map) CloseHandle(m_map);
+		if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+		m_map = NULL;
+		m_file = INVALID_HANDLE_VALUE;
+#else
+		if (m_data) munmap((void*)m_data, m_size);
+#endif
+		m_data = 0;
+		m_size = 0;
+	}
+
+	const char* Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+
+private:
+	const char*	m_data;
+	size_t		m_size;
+#ifdef WIN32
+	HANDLE	m_file = INVALID_HANDLE_VALUE;
+	HANDLE	m_map = NULL;
+#endif
+};
+
+//=============================================================================
+FEBinaryMeshWriter::FEBinaryMeshWriter()
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEBinaryMeshWriter::Write(FEModel& fem, const char* szfile)
+{
+	if (is_little_endian() == false) { m_err = "Binary mesh files can only be written on little-endian platforms."; return false; }
+
+	FEModel* pfem = &fem;
+	FEMesh& mesh = fem.GetMesh();
+	std::vector<FEBinaryChunk*> chunks;
+
+	// nodes
+	int NN = mesh.Nodes();
+	{
+		FEBinaryChunk* ch = new FEBinaryChunk(CHUNK_NODES);
+		std::vector<int> id(NN);
+		std::vector<double> r(3 * NN);
+		for (int i = 0; i < NN; ++i)
+		{
+			FENode& node = mesh.Node(i);
+			id[i] = node.GetID();
+			r[3*i    ] = node.m_r0.x;
+			r[3*i + 1] = node.m_r0.y;
+			r[3*i + 2] = node.m_r0.z;
+		}
+		ch->write(NN);
+		if (NN > 0)
+		{
+			ch->write(&id[0], NN);
+			ch->write(&r[0], 3 * NN);
+		}
+		chunks.push_back(ch);
+	}
+
+	// domains
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		int NE = dom.Elements();
+		if (NE == 0) continue;
+
+		// we can only write domains that can also be defined in the input file
+		const char* sztype = element_type_name(dom.ElementRef(0));
+		if ((sztype == 0) || (dom.Class() == FE_DOMAIN_DISCRETE))
+		{
+			feLogWarningEx(pfem, "Domain %s cannot be written to binary mesh file.", dom.GetName().c_str());
+			continue;
+		}
+
+		// get the material name
+		string matName;
+		FEMaterial* mat = dom.GetMaterial();
+		if (mat)
+		{
+			matName = mat->GetName();
+			if (matName.empty())
+			{
+				char szid[32] = { 0 };
+				sprintf(szid, "%d", mat->GetID());
+				matName = szid;
+			}
+		}
+
+		int neln = dom.ElementRef(0).Nodes();
+		if (neln == 0) continue;
+		FEShellDomain* shell = dynamic_cast<FEShellDomain*>(&dom);
+		int flags = (shell ? SHELL_THICKNESS : 0);
+
+		std::vector<int> id(NE), node(NE*neln);
+		std::vector<double> h0;
+		if (shell) h0.resize(NE*neln);
+		for (int j = 0; j < NE; ++j)
+		{
+			FEElement& el = dom.ElementRef(j);
+			assert(el.Nodes() == neln);
+			id[j] = el.GetID();
+			for (int k = 0; k < neln; ++k) node[j*neln + k] = el.m_node[k];
+			if (shell)
+			{
+				FEShellElement& se = shell->Element(j);
+				for (int k = 0; k < neln; ++k) h0[j*neln + k] = se.m_h0[k];
+			}
+		}
+
+		FEBinaryChunk* ch = new FEBinaryChunk(CHUNK_DOMAIN);
+		ch->write(dom.GetName());
+		ch->write(string(sztype));
+		ch->write(matName);
+		ch->write(flags);
+		ch->write(NE);
+		ch->write(neln);
+		ch->write(&id[0], NE);
+		ch->write(&node[0], NE*neln);
+		if (shell) ch->write(&h0[0], NE*neln);
+		chunks.push_back(ch);
+	}
+
+	// node sets
+	for (int i = 0; i < mesh.NodeSets(); ++i)
+	{
+		FENodeSet& set = *mesh.NodeSet(i);
+		int n = set.Size();
+		std::vector<int> node(n);
+		for (int j = 0; j < n; ++j) node[j] = set[j];
+
+		FEBinaryChunk* ch = new FEBinaryChunk(CHUNK_NODESET);
+		ch->write(set.GetName());
+		ch->write(n);
+		if (n > 0) ch->write(&node[0], n);
+		chunks.push_back(ch);
+	}
+
+	// element sets
+	for (int i = 0; i < mesh.ElementSets(); ++i)
+	{
+		FEElementSet& set = mesh.ElementSet(i);
+		const std::vector<int>& elemList = set.GetElementIDList();
+		int n = (int)elemList.size();
+
+		FEBinaryChunk* ch = new FEBinaryChunk(CHUNK_ELEMSET);
+		ch->write(set.GetName());
+		ch->write(n);
+		if (n > 0) ch->write(&elemList[0], n);
+		chunks.push_back(ch);
+	}
+
+	// surfaces
+	for (int i = 0; i < mesh.FacetSets(); ++i)
+	{
+		FEFacetSet& set = mesh.FacetSet(i);
+		int n = set.Faces();
+		std::vector<int> ntype(n), node;
+		for (int j = 0; j < n; ++j)
+		{
+			const FEFacetSet::FACET& face = set.Face(j);
+			ntype[j] = face.ntype;
+			for (int k = 0; k < face.ntype; ++k) node.push_back(face.node[k]);
+		}
+		int m = (int)node.size();
+
+		FEBinaryChunk* ch = new FEBinaryChunk(CHUNK_SURFACE);
+		ch->write(set.GetName());
+		ch->write(n);
+		ch->write(m);
+		if (n > 0) ch->write(&ntype[0], n);
+		if (m > 0) ch->write(&node[0], m);
+		chunks.push_back(ch);
+	}
+
+	// mesh data
+	for (int i = 0; i < mesh.DataMaps(); ++i)
+	{
+		FEDataMap* map = mesh.GetDataMap(i);
+
+		string setName;
+		int fmt = FMT_ITEM;
+		if (dynamic_cast<FENodeDataMap*>(map))
+		{
+			FENodeDataMap* nodeMap = dynamic_cast<FENodeDataMap*>(map);
+			if (nodeMap->GetNodeSet()) setName = nodeMap->GetNodeSet()->GetName();
+			fmt = FMT_NODE;
+		}
+		else if (dynamic_cast<FEDomainMap*>(map))
+		{
+			FEDomainMap* domMap = dynamic_cast<FEDomainMap*>(map);
+			if (domMap->GetElementSet()) setName = domMap->GetElementSet()->GetName();
+			fmt = domMap->StorageFormat();
+		}
+		else if (dynamic_cast<FESurfaceMap*>(map))
+		{
+			FESurfaceMap* surfMap = dynamic_cast<FESurfaceMap*>(map);
+			if (surfMap->GetFacetSet()) setName = surfMap->GetFacetSet()->GetName();
+			fmt = surfMap->StorageFormat();
+		}
+
+		if (setName.empty())
+		{
+			feLogWarningEx(pfem, "Data map %s cannot be written to binary mesh file.", map->GetName().c_str());
+			continue;
+		}
+
+		int n = map->BufferSize();
+
+		FEBinaryChunk* ch = new FEBinaryChunk(CHUNK_MESHDATA);
+		ch->write((int)map->DataMapType());
+		ch->write((int)map->DataType());
+		ch->write(fmt);
+		ch->write(map->GetName());
+		ch->write(setName);
+		ch->write(n);
+		if (n > 0) ch->write(map->GetBuffer(), n);
+		chunks.push_back(ch);
+	}
+
+	// setup the file header
+	HEADER hdr;
+	hdr.magic = FEBM_MAGIC;
+	hdr.version = FEBM_VERSION;
+	hdr.chunks = (unsigned int) chunks.size();
+	hdr.checksum = 0;
+	hdr.size = 0;
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		const std::vector<char>& buf = chunks[i]->GetBuffer();
+
+		CHUNK chunk;
+		chunk.id = chunks[i]->GetID();
+		chunk.reserved = 0;
+		chunk.size = (long long) buf.size();
+
+		hdr.checksum = crc32(&chunk, sizeof(CHUNK), hdr.checksum);
+		if (buf.empty() == false) hdr.checksum = crc32(&buf[0], buf.size(), hdr.checksum);
+		hdr.size += sizeof(CHUNK) + chunk.size;
+	}
+
+	// write the file
+	bool bret = true;
+	FILE* fp = fopen(szfile, "wb");
+	if (fp == 0) { m_err = string("Failed opening file ") + szfile; bret = false; }
+	else
+	{
+		fwrite(&hdr, sizeof(HEADER), 1, fp);
+		for (size_t i = 0; i < chunks.size(); ++i)
+		{
+			const std::vector<char>& buf = chunks[i]->GetBuffer();
+
+			CHUNK chunk;
+			chunk.id = chunks[i]->GetID();
+			chunk.reserved = 0;
+			chunk.size = (long long)buf.size();
+
+			fwrite(&chunk, sizeof(CHUNK), 1, fp);
+			if (buf.empty() == false) fwrite(&buf[0], 1, buf.size(), fp);
+		}
+		if (ferror(fp)) { m_err = string("Failed writing file ") + szfile; bret = false; }
+		fclose(fp);
+	}
+
+	for (size_t i = 0; i < chunks.size(); ++i) delete chunks[i];
+
+	return bret;
+}
+
+//=============================================================================
+FEBinaryMeshReader::FEBinaryMeshReader()
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEBinaryMeshReader::errf(const char* szerr, ...)
+{
+	char sz[1024] = { 0 };
+	va_list args;
+	va_start(args, szerr);
+	vsnprintf(sz, 1023, szerr, args);
+	va_end(args);
+	m_err = sz;
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// The contents of the chunks of a binary mesh file. Arrays point directly into
+// the mapped file data.
+namespace {
+
+struct NODE_DATA
+{
+	int				n = -1;
+	const int*		id = 0;
+	const double*	r = 0;
+};
+
+struct DOMAIN_DATA
+{
+	std::string		name, type, matName;
+	int				flags = 0, NE = 0, neln = 0;
+	const int*		id = 0;
+	const int*		node = 0;
+	const double*	h0 = 0;
+	FEMaterial*		pmat = 0;
+	FE_Element_Spec	espec;
+	FEDomain*		pdom = 0;
+};
+
+struct NODESET_DATA
+{
+	std::string		name;
+	int				n = 0;
+	const int*		node = 0;
+};
+
+struct ELEMSET_DATA
+{
+	std::string		name;
+	int				n = 0;
+	const int*		id = 0;
+};
+
+struct SURFACE_DATA
+{
+	std::string		name;
+	int				n = 0, m = 0;
+	const int*		ntype = 0;
+	const int*		node = 0;
+};
+
+struct MESHDATA_DATA
+{
+	int				mapType = 0, dataType = 0, fmt = 0, n = 0;
+	std::string		name, setName;
+	const double*	v = 0;
+};
+
+}
+
+//-----------------------------------------------------------------------------
+// The file is read in two passes. The first pass reads and validates all the
+// chunks and creates the domains, and the second pass builds the mesh. This way, 
+// the mesh is not modified when the file contains errors. 
+bool FEBinaryMeshReader::Load(const char* szfile, FEModelBuilder& builder)
+{
+	if (is_little_endian() == false) return errf("Binary mesh files can only be read on little-endian platforms.");
+
+	// map the file
+	FEMappedFile file;
+	if (file.Open(szfile) == false) return errf("Failed opening binary mesh file %s.", szfile);
+
+	// check the header
+	if (file.Size() < sizeof(HEADER)) return errf("%s is not a valid binary mesh file.", szfile);
+	HEADER hdr;
+	memcpy(&hdr, file.Data(), sizeof(HEADER));
+	if (hdr.magic != FEBM_MAGIC) return errf("%s is not a valid binary mesh file.", szfile);
+	if ((hdr.version >> 8) != (FEBM_VERSION >> 8)) return errf("Unsupported binary mesh file version (%d.%d).", hdr.version >> 8, hdr.version & 0xFF);
+	if ((hdr.size < 0) || ((size_t)hdr.size != file.Size() - sizeof(HEADER))) return errf("Binary mesh file %s is truncated.", szfile);
+
+	const char* data = file.Data() + sizeof(HEADER);
+	size_t size = (size_t) hdr.size;
+	if (crc32(data, size) != hdr.checksum) return errf("Checksum error in binary mesh file %s.", szfile);
+
+	FEModel& fem = builder.GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+
+	// --- pass 1: read the chunks ---
+	NODE_DATA nodes;
+	std::vector<DOMAIN_DATA> domains;
+	std::vector<NODESET_DATA> nodeSets;
+	std::vector<ELEMSET_DATA> elemSets;
+	std::vector<SURFACE_DATA> surfaces;
+	std::vector<MESHDATA_DATA> meshData;
+
+	size_t pos = 0;
+	for (unsigned int nchunk = 0; nchunk < hdr.chunks; ++nchunk)
+	{
+		if (pos + sizeof(CHUNK) > size) return errf("Binary mesh file %s is corrupt.", szfile);
+		CHUNK chunk;
+		memcpy(&chunk, data + pos, sizeof(CHUNK));
+		pos += sizeof(CHUNK);
+		if ((chunk.size < 0) || (pos + (size_t)chunk.size > size)) return errf("Binary mesh file %s is corrupt.", szfile);
+
+		FEBinaryChunkReader ar(data + pos, (size_t)chunk.size);
+		pos += (size_t)chunk.size;
+
+		switch (chunk.id)
+		{
+		case CHUNK_NODES:
+		{
+			if (nodes.n >= 0) return errf("Multiple node sections in binary mesh file.");
+			int n = 0;
+			if ((ar.read(n) == false) || (n < 0)) return errf("Error reading nodes.");
+			nodes.id = ar.array<int>(n);
+			nodes.r = ar.array<double>(3 * n);
+			if ((n > 0) && ((nodes.id == 0) || (nodes.r == 0))) return errf("Error reading nodes.");
+			nodes.n = n;
+		}
+		break;
+		case CHUNK_DOMAIN:
+		{
+			DOMAIN_DATA d;
+			if (!ar.read(d.name) || !ar.read(d.type) || !ar.read(d.matName) || !ar.read(d.flags) || !ar.read(d.NE) || !ar.read(d.neln)) return errf("Error reading domain.");
+			if ((d.NE <= 0) || (d.neln <= 0) || (d.neln > FEElement::MAX_NODES)) return errf("Error reading domain %s.", d.name.c_str());
+			d.id = ar.array<int>(d.NE);
+			d.node = ar.array<int>(d.NE*d.neln);
+			d.h0 = (d.flags & SHELL_THICKNESS ? ar.array<double>(d.NE*d.neln) : 0);
+			if ((d.id == 0) || (d.node == 0) || ((d.flags & SHELL_THICKNESS) && (d.h0 == 0))) return errf("Error reading domain %s.", d.name.c_str());
+			domains.push_back(d);
+		}
+		break;
+		case CHUNK_NODESET:
+		{
+			NODESET_DATA ns;
+			if (!ar.read(ns.name) || !ar.read(ns.n) || (ns.n < 0)) return errf("Error reading node set.");
+			ns.node = ar.array<int>(ns.n);
+			if ((ns.n > 0) && (ns.node == 0)) return errf("Error reading node set %s.", ns.name.c_str());
+			nodeSets.push_back(ns);
+		}
+		break;
+		case CHUNK_ELEMSET:
+		{
+			ELEMSET_DATA es;
+			if (!ar.read(es.name) || !ar.read(es.n) || (es.n <= 0)) return errf("Error reading element set.");
+			es.id = ar.array<int>(es.n);
+			if (es.id == 0) return errf("Error reading element set %s.", es.name.c_str());
+			elemSets.push_back(es);
+		}
+		break;
+		case CHUNK_SURFACE:
+		{
+			SURFACE_DATA sd;
+			if (!ar.read(sd.name) || !ar.read(sd.n) || !ar.read(sd.m) || (sd.n < 0) || (sd.m < 0)) return errf("Error reading surface.");
+			sd.ntype = ar.array<int>(sd.n);
+			sd.node = ar.array<int>(sd.m);
+			if (((sd.n > 0) && (sd.ntype == 0)) || ((sd.m > 0) && (sd.node == 0))) return errf("Error reading surface %s.", sd.name.c_str());
+			surfaces.push_back(sd);
+		}
+		break;
+		case CHUNK_MESHDATA:
+		{
+			MESHDATA_DATA md;
+			if (!ar.read(md.mapType) || !ar.read(md.dataType) || !ar.read(md.fmt) || !ar.read(md.name) || !ar.read(md.setName) || !ar.read(md.n) || (md.n < 0)) return errf("Error reading mesh data.");
+			md.v = ar.array<double>(md.n);
+			if ((md.n > 0) && (md.v == 0)) return errf("Error reading mesh data %s.", md.name.c_str());
+			meshData.push_back(md);
+		}
+		break;
+		default:
+			// skip unknown chunks, so that minor version updates remain readable
+			break;
+		}
+	}
+
+	// --- pass 1: validate the data ---
+
+	// all node indices in the file are relative to this offset
+	int N0 = mesh.Nodes();
+	int NN = nodes.n;
+	if ((NN < 0) && (domains.empty() == false || nodeSets.empty() == false || surfaces.empty() == false))
+		return errf("Binary mesh file %s does not define nodes.", szfile);
+
+	// node IDs must be increasing and larger than the IDs of the existing nodes
+	int max_id = 0;
+	if (N0 > 0) max_id = mesh.Node(N0 - 1).GetID();
+	for (int i = 0; i < NN; ++i)
+	{
+		if (nodes.id[i] <= max_id) return errf("Invalid node ID %d in binary mesh file.", nodes.id[i]);
+		max_id = nodes.id[i];
+	}
+
+	// collect the element IDs (and nr of element nodes) of the existing mesh and the file
+	std::vector<std::pair<int, int> > elems;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		for (int j = 0; j < dom.Elements(); ++j)
+		{
+			FEElement& el = dom.ElementRef(j);
+			elems.push_back(std::make_pair(el.GetID(), el.Nodes()));
+		}
+	}
+
+	for (size_t n = 0; n < domains.size(); ++n)
+	{
+		DOMAIN_DATA& d = domains[n];
+
+		// find the material (by name first, then by ID)
+		d.pmat = fem.FindMaterial(d.matName.c_str());
+		if (d.pmat == 0)
+		{
+			int nmat = atoi(d.matName.c_str()) - 1;
+			if ((nmat < 0) || (nmat >= fem.Materials())) return errf("Invalid material %s for domain %s.", d.matName.c_str(), d.name.c_str());
+			d.pmat = fem.GetMaterial(nmat);
+		}
+
+		// check the element type
+		d.espec = builder.ElementSpec(d.type.c_str());
+		if (FEElementLibrary::IsValid(d.espec) == false) return errf("Invalid element type %s.", d.type.c_str());
+		FEElementTraits* traits = FEElementLibrary::GetElementTraits(d.espec.etype);
+		if ((traits == 0) || (traits->m_neln != d.neln)) return errf("Invalid element in domain %s.", d.name.c_str());
+
+		for (int i = 0; i < d.NE*d.neln; ++i)
+		{
+			if ((d.node[i] < 0) || (d.node[i] >= NN)) return errf("Invalid node index in domain %s.", d.name.c_str());
+		}
+
+		for (int i = 0; i < d.NE; ++i) elems.push_back(std::make_pair(d.id[i], d.neln));
+	}
+
+	// element IDs must be unique
+	std::sort(elems.begin(), elems.end());
+	std::vector<int> elemIDs(elems.size());
+	for (size_t i = 0; i < elems.size(); ++i) elemIDs[i] = elems[i].first;
+	for (size_t i = 1; i < elemIDs.size(); ++i)
+	{
+		if (elemIDs[i] == elemIDs[i - 1]) return errf("Duplicate element ID %d in binary mesh file.", elemIDs[i]);
+	}
+
+	for (size_t n = 0; n < nodeSets.size(); ++n)
+	{
+		const NODESET_DATA& ns = nodeSets[n];
+		for (int i = 0; i < ns.n; ++i)
+		{
+			if ((ns.node[i] < 0) || (ns.node[i] >= NN)) return errf("Invalid node index in node set %s.", ns.name.c_str());
+		}
+	}
+
+	for (size_t n = 0; n < elemSets.size(); ++n)
+	{
+		const ELEMSET_DATA& es = elemSets[n];
+		for (int i = 0; i < es.n; ++i)
+		{
+			if (std::binary_search(elemIDs.begin(), elemIDs.end(), es.id[i]) == false) return errf("Invalid element ID in element set %s.", es.name.c_str());
+		}
+	}
+
+	for (size_t n = 0; n < surfaces.size(); ++n)
+	{
+		const SURFACE_DATA& sd = surfaces[n];
+		int k = 0;
+		for (int i = 0; i < sd.n; ++i)
+		{
+			int nf = sd.ntype[i];
+			if ((nf <= 0) || (nf > FEFacetSet::FACET::MAX_NODES) || (k + nf > sd.m)) return errf("Invalid facet in surface %s.", sd.name.c_str());
+			for (int j = 0; j < nf; ++j, ++k)
+			{
+				if ((sd.node[k] < 0) || (sd.node[k] >= NN)) return errf("Invalid node index in surface %s.", sd.name.c_str());
+			}
+		}
+	}
+
+	for (size_t n = 0; n < meshData.size(); ++n)
+	{
+		const MESHDATA_DATA& md = meshData[n];
+		if ((md.dataType < FE_DOUBLE) || (md.dataType > FE_MAT3DS)) return errf("Invalid data type for mesh data %s.", md.name.c_str());
+
+		// The set must be defined in the mesh or in the file. Like FEMesh's Find functions
+		// in pass 2, we look in the mesh first. The nr of items of the map depends on the set.
+		bool bfound = false;
+		int nitems = 0;
+		switch (md.mapType)
+		{
+		case FE_NODE_DATA_MAP:
+		{
+			FENodeSet* ps = mesh.FindNodeSet(md.setName);
+			if (ps) { bfound = true; nitems = ps->Size(); }
+			for (size_t i = 0; (i < nodeSets.size()) && !bfound; ++i)
+			{
+				if (nodeSets[i].name == md.setName) { bfound = true; nitems = nodeSets[i].n; }
+			}
+		}
+		break;
+		case FE_DOMAIN_MAP:
+		{
+			if ((md.fmt != FMT_ITEM) && (md.fmt != FMT_MULT)) return errf("Invalid storage format for mesh data %s.", md.name.c_str());
+			std::vector<int> setIDs;
+			FEElementSet* ps = mesh.FindElementSet(md.setName);
+			if (ps)
+			{
+				bfound = true;
+				setIDs.resize(ps->Elements());
+				for (int i = 0; i < ps->Elements(); ++i) setIDs[i] = (*ps)[i];
+			}
+			for (size_t i = 0; (i < elemSets.size()) && !bfound; ++i)
+			{
+				if (elemSets[i].name == md.setName) { bfound = true; setIDs.assign(elemSets[i].id, elemSets[i].id + elemSets[i].n); }
+			}
+
+			// FMT_MULT stores a value for each node of the largest element
+			int maxNodes = 1;
+			if (md.fmt == FMT_MULT)
+			{
+				maxNodes = 0;
+				for (size_t i = 0; i < setIDs.size(); ++i)
+				{
+					size_t k = std::lower_bound(elemIDs.begin(), elemIDs.end(), setIDs[i]) - elemIDs.begin();
+					if ((k < elems.size()) && (elems[k].first == setIDs[i]) && (elems[k].second > maxNodes)) maxNodes = elems[k].second;
+				}
+			}
+			nitems = (int)setIDs.size()*maxNodes;
+		}
+		break;
+		case FE_SURFACE_MAP:
+		{
+			if ((md.fmt != FMT_MULT) && (md.fmt != FMT_NODE)) return errf("Invalid storage format for mesh data %s.", md.name.c_str());
+
+			// FMT_MULT stores a value for each node of the largest facet, FMT_NODE one for each surface node
+			FEFacetSet* ps = mesh.FindFacetSet(md.setName);
+			if (ps)
+			{
+				bfound = true;
+				if (md.fmt == FMT_MULT)
+				{
+					int maxNodes = 0;
+					for (int i = 0; i < ps->Faces(); ++i) if (ps->Face(i).ntype > maxNodes) maxNodes = ps->Face(i).ntype;
+					nitems = ps->Faces()*maxNodes;
+				}
+				else nitems = ps->GetNodeList().Size();
+			}
+			for (size_t i = 0; (i < surfaces.size()) && !bfound; ++i)
+			{
+				const SURFACE_DATA& sd = surfaces[i];
+				if (sd.name != md.setName) continue;
+				bfound = true;
+				if (md.fmt == FMT_MULT)
+				{
+					int maxNodes = 0;
+					for (int j = 0; j < sd.n; ++j) if (sd.ntype[j] > maxNodes) maxNodes = sd.ntype[j];
+					nitems = sd.n*maxNodes;
+				}
+				else
+				{
+					std::vector<int> nodeList(sd.node, sd.node + sd.m);
+					std::sort(nodeList.begin(), nodeList.end());
+					nitems = (int)(std::unique(nodeList.begin(), nodeList.end()) - nodeList.begin());
+				}
+			}
+		}
+		break;
+		default:
+			return errf("Invalid map type for mesh data %s.", md.name.c_str());
+		}
+		if (bfound == false) return errf("Invalid set %s for mesh data %s.", md.setName.c_str(), md.name.c_str());
+		if (nitems*fecore_data_size((FEDataType)md.dataType) != md.n) return errf("Size mismatch for mesh data %s.", md.name.c_str());
+	}
+
+	// create the domains, so that the mesh is only modified once we know that
+	// all the element types and materials can be combined
+	for (size_t n = 0; n < domains.size(); ++n)
+	{
+		DOMAIN_DATA& d = domains[n];
+		d.pdom = builder.CreateDomain(d.espec, d.pmat);
+		if (d.pdom == 0)
+		{
+			for (size_t m = 0; m < n; ++m) delete domains[m].pdom;
+			return errf("Failed creating domain %s.", d.name.c_str());
+		}
+	}
+
+	// --- pass 2: build the mesh ---
+
+	// nodes
+	if (NN > 0)
+	{
+		mesh.AddNodes(NN);
+		for (int i = 0; i < NN; ++i)
+		{
+			FENode& node = mesh.Node(N0 + i);
+			const double* r = nodes.r + 3*i;
+			node.m_r0 = vec3d(r[0], r[1], r[2]);
+			node.m_rt = node.m_r0;
+			node.SetID(nodes.id[i]);
+		}
+
+		// tell the file reader to rebuild the node ID table
+		builder.BuildNodeList();
+	}
+
+	// domains
+	for (size_t n = 0; n < domains.size(); ++n)
+	{
+		const DOMAIN_DATA& d = domains[n];
+
+		FEDomain* pdom = d.pdom;
+		pdom->Create(d.NE, d.espec.etype);
+		pdom->SetMatID(d.pmat->GetID() - 1);
+		pdom->SetName(d.name);
+
+		for (int i = 0; i < d.NE; ++i)
+		{
+			FEElement& el = pdom->ElementRef(i);
+			el.SetID(d.id[i]);
+			const int* en = d.node + i*d.neln;
+			for (int j = 0; j < d.neln; ++j) el.m_node[j] = N0 + en[j];
+			if (d.id[i] > builder.m_maxid) builder.m_maxid = d.id[i];
+		}
+
+		if (d.h0)
+		{
+			FEShellDomain* shell = dynamic_cast<FEShellDomain*>(pdom);
+			if (shell)
+			{
+				for (int i = 0; i < d.NE; ++i)
+				{
+					FEShellElement& el = shell->Element(i);
+					for (int j = 0; j < d.neln; ++j) el.m_h0[j] = d.h0[i*d.neln + j];
+				}
+			}
+		}
+
+		mesh.AddDomain(pdom);
+
+		// assign material point data
+		pdom->CreateMaterialPointData();
+	}
+
+	// node sets
+	for (size_t n = 0; n < nodeSets.size(); ++n)
+	{
+		const NODESET_DATA& ns = nodeSets[n];
+		std::vector<int> nodeList(ns.n);
+		for (int i = 0; i < ns.n; ++i) nodeList[i] = N0 + ns.node[i];
+
+		FENodeSet* ps = fecore_alloc(FENodeSet, &fem);
+		ps->SetName(ns.name);
+		ps->Add(nodeList);
+		mesh.AddNodeSet(ps);
+	}
+
+	// element sets
+	for (size_t n = 0; n < elemSets.size(); ++n)
+	{
+		const ELEMSET_DATA& es = elemSets[n];
+		std::vector<int> elemList(es.id, es.id + es.n);
+
+		// see if all elements belong to the same domain
+		FEDomain* dom = 0;
+		for (int i = 0; i < es.n; ++i)
+		{
+			FEElement* el = mesh.FindElementFromID(elemList[i]);
+			FEDomain* dom_i = dynamic_cast<FEDomain*>(el->GetMeshPartition());
+			if (i == 0) dom = dom_i;
+			else if (dom != dom_i) dom = 0;
+		}
+
+		FEElementSet* pg = fecore_alloc(FEElementSet, &fem);
+		pg->SetName(es.name);
+		if (dom) pg->Create(dom, elemList); else pg->Create(elemList);
+		mesh.AddElementSet(pg);
+	}
+
+	// surfaces
+	for (size_t n = 0; n < surfaces.size(); ++n)
+	{
+		const SURFACE_DATA& sd = surfaces[n];
+		FEFacetSet* ps = fecore_alloc(FEFacetSet, &fem);
+		ps->Create(sd.n);
+		ps->SetName(sd.name);
+		int k = 0;
+		for (int i = 0; i < sd.n; ++i)
+		{
+			FEFacetSet::FACET& face = ps->Face(i);
+			face.ntype = sd.ntype[i];
+			for (int j = 0; j < face.ntype; ++j, ++k) face.node[j] = N0 + sd.node[k];
+		}
+		mesh.AddFacetSet(ps);
+	}
+
+	// mesh data
+	for (size_t n = 0; n < meshData.size(); ++n)
+	{
+		const MESHDATA_DATA& md = meshData[n];
+
+		FEDataMap* map = 0;
+		switch (md.mapType)
+		{
+		case FE_NODE_DATA_MAP:
+		{
+			FENodeDataMap* nodeMap = new FENodeDataMap((FEDataType)md.dataType);
+			nodeMap->Create(mesh.FindNodeSet(md.setName));
+			map = nodeMap;
+		}
+		break;
+		case FE_DOMAIN_MAP:
+		{
+			FEDomainMap* domMap = new FEDomainMap((FEDataType)md.dataType, (Storage_Fmt)md.fmt);
+			domMap->Create(mesh.FindElementSet(md.setName));
+			map = domMap;
+		}
+		break;
+		case FE_SURFACE_MAP:
+		{
+			FESurfaceMap* surfMap = new FESurfaceMap((FEDataType)md.dataType);
+			surfMap->Create(mesh.FindFacetSet(md.setName), 0.0, (Storage_Fmt)md.fmt);
+			map = surfMap;
+		}
+		break;
+		}
+
+		// the size was checked in pass 1
+		assert(map->BufferSize() == md.n);
+		if (md.n > 0) memcpy(map->GetBuffer(), md.v, md.n*sizeof(double));
+		map->SetName(md.name);
+		mesh.AddDataMap(map);
+	}
+
+	return true;
+}
@@ -0,0 +1,134 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "febioxml_api.h"
+#include <string>
+#include <vector>
+
+class FEModel;
+class FEModelBuilder;
+
+//-----------------------------------------------------------------------------
+// The binary mesh file (.febm) is a companion format to the FEBio input file
+// that stores the (usually very large) geometry of a model in binary form.
+// All data is stored as little-endian arrays, aligned on 8-byte boundaries.
+//
+// The file starts with a fixed-size header, followed by a sequence of chunks.
+// Each chunk consists of a chunk header (id and size) and the chunk data.
+// The checksum in the file header is the CRC-32 of everything that follows
+// the header.
+//
+// chunk         | data
+// --------------+-------------------------------------------------------------
+// NODES         | n, id[n], r[3n]
+// DOMAIN        | name, type, material, flags, n, neln, id[n], node[n*neln], (h0[n*neln])
+// NODESET       | name, n, node[n]
+// ELEMSET       | name, n, id[n]
+// SURFACE       | name, n, m, ntype[n], node[m]
+// MESHDATA      | map type, data type, format, name, set name, n, v[n]
+//
+// Node indices are zero-based and relative to the first node of the file. 
+// Element sets reference elements by their ID. Mesh data maps reference the 
+// node set, surface or element set they are defined on by name.
+namespace FEBinaryMesh
+{
+	enum { FEBM_MAGIC = 0x4D424546 };	// "FEBM"
+	enum { FEBM_VERSION = 0x0100 };
+
+	enum ChunkID {
+		CHUNK_NODES    = 0x01,
+		CHUNK_DOMAIN   = 0x02,
+		CHUNK_NODESET  = 0x03,
+		CHUNK_ELEMSET  = 0x04,
+		CHUNK_SURFACE  = 0x05,
+		CHUNK_MESHDATA = 0x06
+	};
+
+	// domain flags
+	enum { SHELL_THICKNESS = 0x01 };
+
+	// file header
+	struct HEADER
+	{
+		unsigned int	magic;		// magic number (FEBM)
+		unsigned int	version;	// file format version
+		unsigned int	chunks;		// number of chunks
+		unsigned int	checksum;	// CRC-32 of data following this header
+		long long		size;		// size of data following this header (in bytes)
+	};
+
+	// chunk header
+	struct CHUNK
+	{
+		unsigned int	id;			// chunk ID
+		unsigned int	reserved;	// (padding)
+		long long		size;		// size of chunk data (in bytes)
+	};
+
+	// calculate the CRC-32 of a block of data
+	FEBIOXML_API unsigned int crc32(const void* data, size_t size, unsigned int crc = 0);
+}
+
+//-----------------------------------------------------------------------------
+// Exports the mesh of a model to a binary mesh file.
+class FEBIOXML_API FEBinaryMeshWriter
+{
+public:
+	FEBinaryMeshWriter();
+
+	// write the mesh of the model to file
+	bool Write(FEModel& fem, const char* szfile);
+
+	// get the error string of the last error
+	const std::string& GetErrorString() const { return m_err; }
+
+private:
+	std::string	m_err;
+};
+
+//-----------------------------------------------------------------------------
+// Reads a binary mesh file and adds its contents to the model's mesh.
+// The file is memory-mapped and the mesh arrays are filled directly from the 
+// mapped data. 
+class FEBIOXML_API FEBinaryMeshReader
+{
+public:
+	FEBinaryMeshReader();
+
+	// read the file and add its geometry to the model that is being built
+	bool Load(const char* szfile, FEModelBuilder& builder);
+
+	// get the error string of the last error
+	const std::string& GetErrorString() const { return m_err; }
+
+private:
+	bool errf(const char* szerr, ...);
+
+private:
+	std::string	m_err;
+};
@@ -134,6 +134,7 @@ protected:
 	void ParseNodeSetSection    (XMLTag& tag);
 	void ParseEdgeSection       (XMLTag& tag);
 	void ParseElementSetSection (XMLTag& tag);
+	void ParseIncludeSection    (XMLTag& tag);
 
 	// New functions for parsing parts
 	void ParsePart(XMLTag& tag, FEBModel::Part* part);
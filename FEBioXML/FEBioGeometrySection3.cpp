@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include "FEBioMech/FEElasticMaterial.h"
 #include "FECore/FECoreKernel.h"
 #include <FECore/FENodeNodeList.h>
+#include "FEBinaryMesh.h"
 
 //-----------------------------------------------------------------------------
 // functions defined in FEBioGeometrySection
@@ -64,6 +65,7 @@ void FEBioGeometrySection3::Parse(XMLTag& tag)
 		else if (tag == "NodeSetSet" ) ParseNodeSetSetSection (tag);
 		else if (tag == "Part"       ) ParsePartSection       (tag);
 		else if (tag == "Instance"   ) ParseInstanceSection   (tag);
+		else if (tag == "Include"    ) ParseIncludeSection    (tag);
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	}
@@ -262,6 +264,26 @@ void FEBioGeometrySection3::ParseInstanceSection(XMLTag& tag)
 	GetBuilder()->BuildNodeList();
 }
 
+//-----------------------------------------------------------------------------
+//! Reads the geometry from a binary mesh file (.febm)
+void FEBioGeometrySection3::ParseIncludeSection(XMLTag& tag)
+{
+	// see if we need to pre-pend a path
+	char szin[512];
+	strcpy(szin, tag.szvalue());
+	char* ch = strrchr(szin, '\\');
+	if (ch == 0) ch = strrchr(szin, '/');
+	if (ch == 0)
+	{
+		// pre-pend the name with the input path
+		sprintf(szin, "%s%s", GetFileReader()->GetFilePath(), tag.szvalue());
+	}
+
+	// read the file
+	FEBinaryMeshReader reader;
+	if (reader.Load(szin, *GetBuilder()) == false) throw XMLReader::Error(tag, reader.GetErrorString());
+}
+
 //-----------------------------------------------------------------------------
 //! Reads the Nodes section of the FEBio input file
 void FEBioGeometrySection3::ParseNodeSection(XMLTag& tag)
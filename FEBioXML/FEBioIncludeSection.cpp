@@ -28,10 +28,12 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEBioIncludeSection.h"
+#include "FEBinaryMesh.h"
 
 //-----------------------------------------------------------------------------
 //! Parse the Include section (new in version 2.0)
-//! This section includes the contents of another FEB file.
+//! This section includes the contents of another FEB file, or the geometry
+//! stored in a binary mesh file (.febm).
 void FEBioIncludeSection::Parse(XMLTag& tag)
 {
 	// see if we need to pre-pend a path
@@ -45,6 +47,21 @@ void FEBioIncludeSection::Parse(XMLTag& tag)
 		sprintf(szin, "%s%s", GetFileReader()->GetFilePath(), tag.szvalue());
 	}
 
+	// binary mesh files are read directly into the mesh
+	const char* szext = strrchr(szin, '.');
+	if (szext && (strcmp(szext, ".febm") == 0))
+	{
+		FEBinaryMeshReader reader;
+		if (reader.Load(szin, *GetBuilder()) == false)
+			throw XMLReader::Error(tag, reader.GetErrorString());
+
+		// allocate the degrees of freedom
+		FEModel& fem = *GetFEModel();
+		int MAX_DOFS = fem.GetDOFS().GetTotalDOFS();
+		fem.GetMesh().SetDOFS(MAX_DOFS);
+		return;
+	}
+
 	// read the file
 	if (GetFEBioImport()->ReadFile(szin, false) == false)
 		throw XMLReader::InvalidValue(tag);
@@ -58,8 +58,7 @@ bool BFGSSolver::Init()
 	int neq = m_pns->m_neq;
 
 	// allocate storage for BFGS update vectors
-	m_V.resize(m_max_buf_size, neq);
-	m_W.resize(m_max_buf_size, neq);
+	m_ups.Init(neq, m_max_buf_size);
 
 	m_D.resize(neq);
 	m_G.resize(neq);
@@ -85,6 +84,9 @@ bool BFGSSolver::Init()
 
 bool BFGSSolver::Update(double s, vector<double>& ui, vector<double>& R0, vector<double>& R1)
 {
+	// the update counter is reset when the stiffness matrix is reformed
+	if (m_nups == 0) m_ups.Clear();
+
 	// calculate the BFGS update vectors
 	int neq = m_neq;
 	for (int i = 0; i<neq; ++i)
@@ -112,20 +114,21 @@ bool BFGSSolver::Update(double s, vector<double>& ui, vector<double>& R0, vector
 	// make sure c is less than the the maximum.
 	if (c > m_cmax) return false;
 
-	// get the correct buffer to fill
-	int n = (m_nups % m_max_buf_size);
-
 	// do the update only when allowed
 	if ((m_nups < m_max_buf_size) || (m_cycle_buffer == true))
 	{
-		double* vn = m_V[n];
-		double* wn = m_W[n];
+		// make room for the new update by dropping the oldest one
+		if (m_ups.IsFull()) m_ups.RemoveOldest();
 
-		for (int i=0; i<neq; ++i)	
+		// calculate the BFGS update vectors v (in m_H) and w (in m_D).
+		// The history stores the update as I + w*v^T.
+#pragma omp parallel for
+		for (int i=0; i<neq; ++i)
 		{
-			vn[i] = -m_H[i]*c - m_G[i];
-			wn[i] = m_D[i]*dgi;
+			m_H[i] = -m_H[i]*c - m_G[i];
+			m_D[i] = m_D[i]*dgi;
 		}
+		m_ups.Add(&m_D[0], &m_H[0]);
 	}
 
 	// increment update counter
@@ -144,32 +147,14 @@ void BFGSSolver::SolveEquations(vector<double>& x, vector<double>& b)
 	// make sure we need to do work
 	if (m_neq ==0) return;
 
+	// the update counter is reset when the stiffness matrix is reformed
+	if (m_nups == 0) m_ups.Clear();
+
 	// create temporary storage
 	tmp = b;
 
-	// number of updates can be larger than buffer size, so clamp it
-	int nups = (m_nups> m_max_buf_size ? m_max_buf_size : m_nups);
-
-	// get the "0" buffer index
-	int n0 = 0;
-	if ((m_nups > m_max_buf_size) && (m_cycle_buffer == true))
-	{
-		n0 = m_nups % m_max_buf_size;
-	}
-
-	// loop over all update vectors
-	for (int i=nups-1; i>=0; --i)
-	{
-		int n = (n0 + i) % m_max_buf_size;
-
-		double* vi = m_V[n];
-		double* wi = m_W[n];
-
-		double wr = 0;
-		for (int j = 0; j<m_neq; j++) wr += wi[j] * tmp[j];
-
-		for (int j = 0; j<m_neq; j++) tmp[j] += vi[j] * wr;
-	}
+	// apply the updates in reverse order
+	m_ups.ApplyTranspose(&tmp[0]);
 
 	// perform a backsubstitution
 	if (m_plinsolve->BackSolve(x, tmp) == false)
@@ -177,17 +162,12 @@ void BFGSSolver::SolveEquations(vector<double>& x, vector<double>& b)
 		throw LinearSolverFailed();
 	}
 
-	// loop again over all update vectors
-	for (int i = 0; i<nups; ++i)
-	{
-		int n = (n0 + i) % m_max_buf_size;
-
-		double* vi = m_V[n];
-		double* wi = m_W[n];
-
-		double vr = 0;
-		for (int j = 0; j<m_neq; ++j) vr += vi[j] * x[j];
+	// apply the updates again
+	m_ups.Apply(&x[0]);
+}
 
-		for (int j = 0; j<m_neq; ++j) x[j] += wi[j] * vr;
-	}
+//-----------------------------------------------------------------------------
+size_t BFGSSolver::UpdateMemory() const
+{
+	return m_ups.UpdateMemory();
 }
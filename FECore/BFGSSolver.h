@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include "vector.h"
 #include "LinearSolver.h"
 #include "FENewtonStrategy.h"
+#include "FEQuasiNewtonUpdates.h"
 
 //-----------------------------------------------------------------------------
 //! The BFGSSolver solves a nonlinear system of equations using the BFGS method.
@@ -52,14 +53,16 @@ public:
 	//! solve the equations
 	void SolveEquations(vector<double>& x, vector<double>& b) override;
 
+	//! memory needed for storing one update
+	size_t UpdateMemory() const override;
+
 public:
 	// keep a pointer to the linear solver
 	LinearSolver*	m_plinsolve;	//!< pointer to linear solver
 	int				m_neq;		//!< number of equations
 
 	// BFGS update vectors
-	matrix			m_V;		//!< BFGS update vector
-	matrix			m_W;		//!< BFGS update vector
+	FEQuasiNewtonUpdates	m_ups;	//!< BFGS update history
 	vector<double>	m_D, m_G, m_H;	//!< temp vectors for calculating BFGS update vectors
 
 	vector<double>	tmp;
@@ -48,6 +48,9 @@ public: // overloaded from base class
 	size_t size() const { return m_nsize; }
 	size_t reserved() const { return m_nreserved; }
 
+	//! direct access to the stream buffer
+	const char* data() const { return m_pb; }
+
 protected:
 	void grow_buffer(size_t l);
 	void set_position(size_t l);
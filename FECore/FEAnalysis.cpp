@@ -38,6 +38,7 @@ SOFTWARE.*/
 #include "FELinearConstraintManager.h"
 #include "FEShellDomain.h"
 #include "FEMeshAdaptor.h"
+#include "FETelemetry.h"
 
 REGISTER_SUPER_CLASS(FEAnalysis, FEANALYSIS_ID);
 
@@ -407,6 +408,9 @@ bool FEAnalysis::Solve()
 		// Solve the time step
 		int ierr = SolveTimeStep();
 
+		// write the convergence telemetry of this time step
+		WriteTimeStepTelemetry(ierr);
+
 		// see if we want to abort
 		if (ierr == 2) 
 		{
@@ -489,6 +493,32 @@ bool FEAnalysis::Solve()
 	return bconv;
 }
 
+//-----------------------------------------------------------------------------
+// Write a telemetry record for the last time step. The stream is flushed so that 
+// monitoring tools see the progress of the run.
+void FEAnalysis::WriteTimeStepTelemetry(int ierr)
+{
+	FEModel& fem = *GetFEModel();
+	FETelemetry& tlm = fem.GetTelemetry();
+	if (tlm.IsOpen() == false) return;
+
+	const char* szstatus[] = { "converged", "failed", "aborted" };
+
+	FESolver* psolver = GetFESolver();
+	tlm.BeginRecord("time_step");
+	tlm.Write("step", fem.GetCurrentStepIndex() + 1);
+	tlm.Write("time_step", m_ntimesteps + 1);
+	tlm.Write("time", fem.GetCurrentTime());
+	tlm.Write("dt", m_dt);
+	tlm.Write("status", szstatus[(ierr >= 0) && (ierr <= 2) ? ierr : 1]);
+	tlm.Write("iters", psolver->m_niter);
+	tlm.Write("reforms", psolver->m_ntotref);
+	tlm.Write("rhs", psolver->m_nrhs);
+	tlm.Write("retries", (m_timeController ? m_timeController->m_nretries : 0));
+	tlm.EndRecord();
+	tlm.Flush();
+}
+
 //-----------------------------------------------------------------------------
 // This function calls the FE Solver for solving this analysis and also handles
 // all the exceptions. 
@@ -137,6 +137,9 @@ private:
 	// 2 = abort
 	int SolveTimeStep();
 
+	// write the convergence telemetry of the last time step
+	void WriteTimeStepTelemetry(int ierr);
+
 	// initialize the solver
 	bool InitSolver();
 
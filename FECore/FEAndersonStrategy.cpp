@@ -0,0 +1,287 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEAndersonStrategy.h"
+#include "LinearSolver.h"
+#include "FEException.h"
+#include "FENewtonSolver.h"
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(FEAndersonStrategy, FENewtonStrategy)
+	ADD_PARAMETER(m_beta, FE_RANGE_LEFT_OPEN(0.0, 1.0), "beta");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+//! constructor
+FEAndersonStrategy::FEAndersonStrategy(FEModel* fem) : FENewtonStrategy(fem)
+{
+	m_beta = 1.0;
+
+	m_neq = 0;
+	m_plinsolve = nullptr;
+
+	m_nhist = 0;
+	m_next = 0;
+	m_bfn = false;
+}
+
+//-----------------------------------------------------------------------------
+//! Initialization
+bool FEAndersonStrategy::Init()
+{
+	if (m_pns == nullptr) return false;
+
+	// the window size defaults to the max nr of updates
+	if (m_max_buf_size <= 0) m_max_buf_size = m_maxups;
+
+	int neq = m_pns->m_neq;
+
+	// allocate storage for the history
+	int m = (m_max_buf_size > 0 ? m_max_buf_size : 1);
+	m_dX.resize(m, neq);
+	m_dF.resize(m, neq);
+	m_H.resize(m, m);
+	m_f.resize(neq, 0.0);
+	m_fn.resize(neq, 0.0);
+
+	m_neq = neq;
+	m_nups = 0;
+
+	m_plinsolve = m_pns->GetLinearSolver();
+
+	ClearHistory();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEAndersonStrategy::ClearHistory()
+{
+	m_nhist = 0;
+	m_next = 0;
+	m_bfn = false;
+}
+
+//-----------------------------------------------------------------------------
+//! Presolve update
+void FEAndersonStrategy::PreSolveUpdate()
+{
+	// the residual changes at the start of a time step (or augmentation)
+	// so the history no longer applies
+	ClearHistory();
+}
+
+//-----------------------------------------------------------------------------
+bool FEAndersonStrategy::ReformStiffness()
+{
+	// the history is only valid for the factorization it was built with
+	ClearHistory();
+	return FENewtonStrategy::ReformStiffness();
+}
+
+//-----------------------------------------------------------------------------
+size_t FEAndersonStrategy::UpdateMemory() const
+{
+	// two difference vectors per update
+	return 2 * sizeof(double) * (size_t)m_neq;
+}
+
+//-----------------------------------------------------------------------------
+//! perform a quasi-Newton udpate
+//! This stores the differences in the iterates and the fixed-point residuals 
+//! of the last step.
+bool FEAndersonStrategy::Update(double s, vector<double>& ui, vector<double>& R0, vector<double>& R1)
+{
+	// calculate the fixed-point residual at the new iterate
+	m_fn.assign(m_neq, 0.0);
+	if (m_plinsolve->BackSolve(m_fn, R1) == false)
+		throw LinearSolverFailed();
+	m_bfn = true;
+
+	int M = m_max_buf_size;
+	if ((M > 0) && ((m_nhist < M) || m_cycle_buffer))
+	{
+		int n = m_next;
+		double* dx = m_dX[n];
+		double* df = m_dF[n];
+		int neq = m_neq;
+		double ff = 0.0;
+#pragma omp parallel for reduction(+:ff)
+		for (int i = 0; i < neq; ++i)
+		{
+			dx[i] = s*ui[i];
+			df[i] = m_fn[i] - m_f[i];
+			ff += df[i] * df[i];
+		}
+
+		// if the fixed-point residual did not change, there is nothing to learn
+		if (ff > 0.0)
+		{
+			// update the inner products
+			if (m_nhist < M) m_nhist++;
+			int n0 = (m_next - m_nhist + 1 + M) % M;
+			for (int k = 0; k < m_nhist; ++k)
+			{
+				int j = (n0 + k) % M;
+				const double* dfj = m_dF[j];
+				double h = 0.0;
+#pragma omp parallel for reduction(+:h)
+				for (int i = 0; i < neq; ++i) h += df[i] * dfj[i];
+				m_H[n][j] = m_H[j][n] = h;
+			}
+			m_next = (m_next + 1) % M;
+		}
+		else if (m_nhist == M)
+		{
+			// the oldest difference was overwritten
+			m_nhist--;
+		}
+	}
+
+	m_nups++;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Solve the (small) least-squares problem min |f - dF*g| for the mixing coefficients g.
+//! The normal equations are solved with a Cholesky factorization. If the history is 
+//! (nearly) linearly dependent, the oldest differences are dropped.
+bool FEAndersonStrategy::SolveMixing(vector<double>& g)
+{
+	int M = m_max_buf_size;
+	int neq = m_neq;
+
+	while (m_nhist > 0)
+	{
+		int m = m_nhist;
+		int n0 = (m_next - m + M) % M;
+
+		// right-hand side dF^T*f
+		vector<double> r(m);
+		for (int k = 0; k < m; ++k)
+		{
+			const double* dfk = m_dF[(n0 + k) % M];
+			double rk = 0.0;
+#pragma omp parallel for reduction(+:rk)
+			for (int i = 0; i < neq; ++i) rk += dfk[i] * m_f[i];
+			r[k] = rk;
+		}
+
+		// Cholesky factorization of dF^T*dF
+		matrix L(m, m); L.zero();
+		double hmax = 0.0;
+		for (int k = 0; k < m; ++k) { int sk = (n0 + k) % M; if (m_H[sk][sk] > hmax) hmax = m_H[sk][sk]; }
+		bool bok = true;
+		for (int j = 0; j < m && bok; ++j)
+		{
+			int sj = (n0 + j) % M;
+			double d = m_H[sj][sj];
+			for (int k = 0; k < j; ++k) d -= L[j][k] * L[j][k];
+			if (d <= 1e-12*hmax) bok = false;
+			else
+			{
+				L[j][j] = sqrt(d);
+				for (int i = j + 1; i < m; ++i)
+				{
+					int si = (n0 + i) % M;
+					double v = m_H[si][sj];
+					for (int k = 0; k < j; ++k) v -= L[i][k] * L[j][k];
+					L[i][j] = v / L[j][j];
+				}
+			}
+		}
+
+		if (bok)
+		{
+			// forward and back substitution
+			g.resize(m);
+			for (int i = 0; i < m; ++i)
+			{
+				double v = r[i];
+				for (int k = 0; k < i; ++k) v -= L[i][k] * g[k];
+				g[i] = v / L[i][i];
+			}
+			for (int i = m - 1; i >= 0; --i)
+			{
+				double v = g[i];
+				for (int k = i + 1; k < m; ++k) v -= L[k][i] * g[k];
+				g[i] = v / L[i][i];
+			}
+			return true;
+		}
+
+		// drop the oldest difference and try again
+		m_nhist--;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//! solve the equations
+void FEAndersonStrategy::SolveEquations(vector<double>& x, vector<double>& b)
+{
+	// the update counter is reset when the stiffness matrix is reformed
+	if (m_nups == 0) ClearHistory();
+
+	// calculate the fixed-point residual K^{-1}*R of the current iterate
+	// (this was already done in the last update)
+	if (m_bfn) m_f = m_fn;
+	else
+	{
+		m_f = x;
+		if (m_plinsolve->BackSolve(m_f, b) == false)
+			throw LinearSolverFailed();
+	}
+	m_bfn = false;
+
+	// x = beta*f - (dX + beta*dF)*g
+	int neq = m_neq;
+	double beta = m_beta;
+#pragma omp parallel for
+	for (int i = 0; i < neq; ++i) x[i] = beta*m_f[i];
+
+	vector<double> g;
+	if (SolveMixing(g))
+	{
+		int M = m_max_buf_size;
+		int m = m_nhist;
+		int n0 = (m_next - m + M) % M;
+		for (int k = 0; k < m; ++k)
+		{
+			const double* dxk = m_dX[(n0 + k) % M];
+			const double* dfk = m_dF[(n0 + k) % M];
+			double gk = g[k];
+#pragma omp parallel for
+			for (int i = 0; i < neq; ++i) x[i] -= gk*(dxk[i] + beta*dfk[i]);
+		}
+	}
+}
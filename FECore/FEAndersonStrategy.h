@@ -0,0 +1,92 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "matrix.h"
+#include "FENewtonStrategy.h"
+
+//-----------------------------------------------------------------------------
+//! This class implements an Anderson-accelerated (type-II) Newton strategy. 
+//! The iterations with a fixed stiffness matrix K are viewed as a fixed-point 
+//! iteration x <- x + K^{-1}*R(x). The step is accelerated by combining the last 
+//! few iterates such that the (linearized) fixed-point residual is minimized.
+//! This allows the same factorization to be reused for more iterations before 
+//! a stiffness reformation is needed.
+class FECORE_API FEAndersonStrategy : public FENewtonStrategy
+{
+public:
+	//! constructor
+	FEAndersonStrategy(FEModel* fem);
+
+	//! Initialization
+	bool Init() override;
+
+	//! perform a quasi-Newton udpate
+	bool Update(double s, vector<double>& ui, vector<double>& R0, vector<double>& R1) override;
+
+	//! solve the equations
+	void SolveEquations(vector<double>& x, vector<double>& b) override;
+
+	//! Presolve update
+	void PreSolveUpdate() override;
+
+	//! reform the stiffness matrix
+	bool ReformStiffness() override;
+
+	//! memory needed for storing one update
+	size_t UpdateMemory() const override;
+
+private:
+	// clear the history
+	void ClearHistory();
+
+	// solve the least-squares problem for the mixing coefficients
+	bool SolveMixing(vector<double>& g);
+
+public:
+	double	m_beta;		//!< mixing (relaxation) parameter
+
+private:
+	// keep a pointer to the linear solver
+	LinearSolver*	m_plinsolve;	//!< pointer to linear solver
+	int				m_neq;			//!< number of equations
+
+	// history of differences in iterates and fixed-point residuals
+	matrix			m_dX;		//!< differences in iterates (one row per slot)
+	matrix			m_dF;		//!< differences in fixed-point residuals (one row per slot)
+	matrix			m_H;		//!< inner products dF_i*dF_j (slot order)
+	int				m_nhist;	//!< number of differences stored
+	int				m_next;		//!< slot for the next difference
+
+	vector<double>	m_f;		//!< fixed-point residual K^{-1}*R of the current iterate
+	vector<double>	m_fn;		//!< fixed-point residual of the next iterate
+	bool			m_bfn;		//!< m_fn is valid for the next solve
+
+	DECLARE_FECORE_CLASS();
+};
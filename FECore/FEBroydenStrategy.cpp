@@ -51,9 +51,9 @@ bool FEBroydenStrategy::Init()
 	int neq = m_pns->m_neq;
 
 	// allocate storage for Broyden update vectors
-	m_R.resize(m_max_buf_size, neq);
-	m_D.resize(m_max_buf_size, neq);
-	m_rho.resize(m_max_buf_size);
+	m_ups.Init(neq, m_max_buf_size);
+	m_a.resize(neq);
+	m_d.resize(neq);
 	m_q.resize(neq, 0.0);
 
 	m_neq = neq;
@@ -74,8 +74,12 @@ void FEBroydenStrategy::PreSolveUpdate()
 
 //-----------------------------------------------------------------------------
 //! perform a quasi-Newton udpate
+//! Each Broyden update is stored as I + rho*(d - r)*d^T.
 bool FEBroydenStrategy::Update(double s, vector<double>& ui, vector<double>& R0, vector<double>& R1)
 {
+	// the update counter is reset when the stiffness matrix is reformed
+	if (m_nups == 0) m_ups.Clear();
+
 	// calculate q1
 	m_q.assign(m_neq, 0.0);
 	if (m_plinsolve->BackSolve(m_q, R1) == false)
@@ -84,37 +88,31 @@ bool FEBroydenStrategy::Update(double s, vector<double>& ui, vector<double>& R0,
 	// only update when allowed
 	if ((m_nups < m_max_buf_size) || (m_cycle_buffer == true))
 	{
-		// since the number of updates can be larger than buffer size we need to clamp
-		int nups = (m_nups >= m_max_buf_size ? m_max_buf_size - 1 : m_nups);
+		// make room for the new update by dropping the oldest one
+		if (m_ups.IsFull()) m_ups.RemoveOldest();
 
-		// get the "0" buffer index
-		int n0 = (m_nups >= m_max_buf_size ? (m_nups + 1) % m_max_buf_size : 0);
-		int n1 = (m_nups >= m_max_buf_size ? (m_nups) % m_max_buf_size : m_nups);
-
-		// loop over update vectors
-		for (int j = 0; j<nups; ++j)
-		{
-			int n = (n0 + j) % m_max_buf_size;
-
-			double w = 0.0;
-			for (int i = 0; i<m_neq; ++i) w += (m_D[n][i] * m_q[i]);
-
-			double g = m_rho[n] * w;
-			for (int i = 0; i<m_neq; ++i) m_q[i] += g*(m_D[n][i] - m_R[n][i]);
-		}
+		// apply the previous updates
+		m_ups.Apply(&m_q[0]);
 
 		// form and store the next update vector
+		int neq = m_neq;
 		double rhoi = 0.0;
-		for (int i = 0; i<m_neq; ++i)
+#pragma omp parallel for reduction(+:rhoi)
+		for (int i = 0; i<neq; ++i)
 		{
 			double ri = m_q[i] - ui[i];
 			double di = -s*ui[i];
-			m_R[n1][i] = ri;
-			m_D[n1][i] = di;
+			m_a[i] = di - ri;
+			m_d[i] = di;
 
 			rhoi += di*ri;
 		}
-		m_rho[n1] = 1.0 / (rhoi);
+		double rho = 1.0 / rhoi;
+
+#pragma omp parallel for
+		for (int i = 0; i<neq; ++i) m_a[i] *= rho;
+
+		m_ups.Add(&m_a[0], &m_d[0]);
 	}
 
 	m_nups++;
@@ -126,8 +124,12 @@ bool FEBroydenStrategy::Update(double s, vector<double>& ui, vector<double>& R0,
 //! solve the equations
 void FEBroydenStrategy::SolveEquations(vector<double>& x, vector<double>& b)
 {
+	// the update counter is reset when the stiffness matrix is reformed
+	if (m_nups == 0) m_ups.Clear();
+
 	// loop over update vectors
-	if (m_nups == 0)
+	int nups = m_ups.Updates();
+	if (nups == 0)
 	{
 		if (m_plinsolve->BackSolve(x, b) == false)
 			throw LinearSolverFailed();
@@ -136,50 +138,30 @@ void FEBroydenStrategy::SolveEquations(vector<double>& x, vector<double>& b)
 	}
 	else
 	{
-		// since the number of updates can be larger than buffer size we need to clamp
-		int nups = (m_nups > m_max_buf_size ? m_max_buf_size : m_nups);
-
-		// get the first and last buffer index
-		int n0 = 0;
-		int n1 = nups - 1;
-		if ((m_nups > m_max_buf_size) && (m_cycle_buffer == true))
-		{
-			n0 = m_nups % m_max_buf_size;
-			n1 = (m_nups - 1) % m_max_buf_size;
-		}
-
 		if (m_bnewStep)
 		{
 			m_q = x;
 			if (m_plinsolve->BackSolve(m_q, b) == false)
 				throw LinearSolverFailed();
 
-			for (int j = 0; j<nups - 1; ++j)
-			{
-				int n = (n0 + j) % m_max_buf_size;
-
-				double w = 0.0;
-				for (int i = 0; i<m_neq; ++i) w += (m_D[n][i] * m_q[i]);
-
-				double g = m_rho[n] * w;
-				for (int i = 0; i<m_neq; ++i) m_q[i] += g*(m_D[n][i] - m_R[n][i]);
-			}
+			// apply all but the last update
+			m_ups.Apply(&m_q[0], nups - 1);
 
 			m_bnewStep = false;
 		}
 
 		// calculate solution
-		double rho = 0.0;
-		for (int i = 0; i<m_neq; ++i) rho += m_D[n1][i] * m_q[i];
-		rho *= m_rho[n1];
-
-		for (int i = 0; i<m_neq; ++i)
-		{
-			x[i] = m_q[i] + rho*(m_D[n1][i] - m_R[n1][i]);
-		}
+		x = m_q;
+		m_ups.ApplyUpdate(&x[0], nups - 1);
 	}
 }
 
+//-----------------------------------------------------------------------------
+size_t FEBroydenStrategy::UpdateMemory() const
+{
+	return m_ups.UpdateMemory();
+}
+
 /*
 //-----------------------------------------------------------------------------
 //! perform a quasi-Newton udpate
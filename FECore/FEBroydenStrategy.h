@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "matrix.h"
 #include "FENewtonStrategy.h"
+#include "FEQuasiNewtonUpdates.h"
 
 //-----------------------------------------------------------------------------
 //! This class implements the Broyden quasi-newton strategy. 
@@ -50,6 +51,9 @@ public:
 	//! Presolve update
 	virtual void PreSolveUpdate() override;
 
+	//! memory needed for storing one update
+	size_t UpdateMemory() const override;
+
 private:
 	// keep a pointer to the linear solver
 	LinearSolver*	m_plinsolve;	//!< pointer to linear solver
@@ -57,9 +61,8 @@ private:
 
 	bool		m_bnewStep;
 
-	// Broyden update vectors
-	matrix			m_R;		//!< Broyden update vector "r"
-	matrix			m_D;		//!< Broydeb update vector "delta"
-	vector<double>	m_rho;		//!< temp vectors for calculating Broyden update vectors
+	// Broyden updates
+	FEQuasiNewtonUpdates	m_ups;	//!< Broyden update history
+	vector<double>	m_a, m_d;	//!< temp vectors for calculating Broyden update vectors
 	vector<double>	m_q;		//!< temp storage for q
 };
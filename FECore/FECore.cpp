@@ -52,6 +52,7 @@ SOFTWARE.*/
 #include "BFGSSolver.h"
 #include "FEBroydenStrategy.h"
 #include "JFNKStrategy.h"
+#include "FEAndersonStrategy.h"
 #include "FENodeSet.h"
 #include "FEFacetSet.h"
 #include "FEElementSet.h"
@@ -150,6 +151,7 @@ REGISTER_FECORE_CLASS(FEPIDController , "PID");
 REGISTER_FECORE_CLASS(BFGSSolver       , "BFGS");
 REGISTER_FECORE_CLASS(FEBroydenStrategy, "Broyden");
 REGISTER_FECORE_CLASS(JFNKStrategy     , "JFNK");
+REGISTER_FECORE_CLASS(FEAndersonStrategy, "Anderson");
 
 // preconditioners
 REGISTER_FECORE_CLASS(DiagonalPreconditioner, "diagonal");
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "FEMeshPartition.h"
+#include "FEElementWorkspace.h"
 
 // forward declaration of material class
 class FEMaterial;
@@ -74,10 +75,16 @@ public:
 	//! Activate the domain
 	virtual void Activate();
 
+	//! the workspaces of the element loops
+	FEElementWorkspacePool& ElementWorkspaces() { return m_ws; }
+
 protected:
 	// helper function for activating dof lists
 	void Activate(const FEDofList& dof);
 
 	// helper function for unpacking element dofs
 	void UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm);
+
+protected:
+	FEElementWorkspacePool	m_ws;	//!< workspaces for the element loops
 };
@@ -25,16 +25,48 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 
 
-
 #include "stdafx.h"
 #include "FEEdgeList.h"
 #include "FEMesh.h"
 #include "FENodeNodeList.h"
 #include "FEDomain.h"
 #include "FEElementList.h"
-#include <set>
+#include "parallel_sort.h"
+#include <stdint.h>
 using namespace std;
 
+//-----------------------------------------------------------------------------
+// The edge tables of the elements. The third column is the mid-edge node of 
+// the quadratic elements.
+static const int ETET[6][3] = { { 0, 1, 4 },{ 1, 2, 5 },{ 2, 0, 6 },{ 0, 3, 7 },{ 1, 3, 8 },{ 2, 3, 9 } };
+static const int EHEX[12][3] = { { 0, 1, 8 },{ 1, 2, 9 },{ 2, 3, 10 },{ 3, 0, 11 },{ 4, 5, 12 },{ 5, 6, 13 },{ 6, 7, 14 },{ 7, 4, 15 },{ 0, 4, 16 },{ 1, 5, 17 },{ 2, 6, 18 },{ 3, 7, 19 } };
+
+// Get the edge table of an element. Returns the number of edges, or 0 if the element is not supported.
+// If bquad is false, only linear elements are supported.
+static int element_edges(const FEElement& el, bool bquad, const int (*&E)[3], int& ntype)
+{
+	switch (el.Shape())
+	{
+	case ET_TET4:
+	case ET_TET5: E = ETET; ntype = 2; return 6;
+	case ET_HEX8: E = EHEX; ntype = 2; return 12;
+	case ET_TET10: if (bquad) { E = ETET; ntype = 3; return 6; } break;
+	case ET_HEX20: if (bquad) { E = EHEX; ntype = 3; return 12; } break;
+	default:
+		break;
+	}
+	return 0;
+}
+
+// Pack an edge into a 64-bit key that does not depend on the edge's orientation.
+// Sorting these keys orders the edges by their smallest, then largest node number.
+static inline uint64_t edge_key(int a, int b)
+{
+	if (a > b) { int t = a; a = b; b = t; }
+	return ((uint64_t)a << 32) | (uint64_t)(unsigned int)b;
+}
+
+//-----------------------------------------------------------------------------
 FEEdgeList::FEEdgeList() : m_mesh(nullptr)
 {
 
@@ -60,194 +92,160 @@ FEMesh* FEEdgeList::GetMesh()
 	return m_mesh;
 }
 
-struct edge_less
-{
-	bool operator ()(const pair<int, int>& lhs, const pair<int, int>& rhs)
-	{
-		int na0 = lhs.first;
-		int na1 = lhs.second;
-		if (na0 > na1) { int tmp = na0; na0 = na1; na1 = tmp; }
-
-		int nb0 = rhs.first;
-		int nb1 = rhs.second;
-		if (nb0 > nb1) { int tmp = nb0; nb0 = nb1; nb1 = tmp; }
-
-		if (na0 != nb0) return na0 < nb0;
-		else return na1 < nb1;
-	}
-};
-
-struct EDGE_less
-{
-	bool operator ()(const FEEdgeList::EDGE& lhs, const FEEdgeList::EDGE& rhs)
-	{
-		int na0 = lhs.node[0];
-		int na1 = lhs.node[1];
-		if (na0 > na1) { int tmp = na0; na0 = na1; na1 = tmp; }
-
-		int nb0 = rhs.node[0];
-		int nb1 = rhs.node[1];
-		if (nb0 > nb1) { int tmp = nb0; nb0 = nb1; nb1 = tmp; }
-
-		if (na0 != nb0) return na0 < nb0;
-		else return na1 < nb1;
-	}
-};
-
-
+//-----------------------------------------------------------------------------
+// The edges are found by sorting the packed keys of all element edges and 
+// removing the duplicates. Only linear tets and hexes are supported.
 bool FEEdgeList::Create(FEMesh* pmesh)
 {
 	if (pmesh == nullptr) return false;
 	m_mesh = pmesh;
 	FEMesh& mesh = *pmesh;
 
-	// create the node-node list
 	FEElementList elemList(mesh);
+	vector<FEElement*> elem = elemList.ElementPointers();
+	int NE = (int)elem.size();
 
-	set<pair<int, int>, edge_less> edgeSet;
-
-	const int ETET[6][2] = { { 0, 1 },{ 1, 2 },{ 2, 0 },{ 0, 3 },{ 1, 3 },{ 2, 3 } };
-	const int EHEX[12][2] = { { 0, 1 },{ 1, 2 },{ 2, 3 },{ 3, 0 },{ 4, 5 },{ 5, 6 },{ 6, 7 },{ 7, 4 },{ 0, 4 },{ 1, 5 },{ 2, 6 },{ 3, 7 } };
-
-	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it)
+	// count the element edges
+	vector<int> off(NE + 1, 0);
+	for (int i = 0; i < NE; ++i)
 	{
-		FEElement& el = *it;
+		const int (*E)[3]; int ntype;
+		int ne = element_edges(*elem[i], false, E, ntype);
+		if (ne == 0) return false;
+		off[i + 1] = off[i] + ne;
+	}
 
-		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5))
-		{
-			for (int i = 0; i < 6; ++i)
-			{
-				pair<int, int> edge;
-				edge.first = el.m_node[ETET[i][0]];
-				edge.second = el.m_node[ETET[i][1]];
-
-				edgeSet.insert(edge);
-			}
-		}
-		else if (el.Shape() == ET_HEX8)
-		{
-			for (int i = 0; i < 12; ++i)
-			{
-				pair<int, int> edge;
-				edge.first = el.m_node[EHEX[i][0]];
-				edge.second = el.m_node[EHEX[i][1]];
-
-				edgeSet.insert(edge);
-			}
-		}
-		else return false;
+	// create the edge keys
+	vector<uint64_t> key(off[NE]);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < NE; ++i)
+	{
+		const FEElement& el = *elem[i];
+		const int (*E)[3]; int ntype;
+		int ne = element_edges(el, false, E, ntype);
+		uint64_t* pk = &key[off[i]];
+		for (int j = 0; j < ne; ++j) pk[j] = edge_key(el.m_node[E[j][0]], el.m_node[E[j][1]]);
 	}
 
-	// copy set into a vector
-	size_t edges = edgeSet.size();
+	// sort and remove duplicates
+	parallel_sort(key);
+	key.erase(unique(key.begin(), key.end()), key.end());
+
+	// build the edge list
+	int edges = (int)key.size();
 	m_edgeList.resize(edges);
-	set< pair<int, int>, edge_less>::iterator edgeIter = edgeSet.begin();
-	for (size_t i = 0; i < edges; ++i, ++edgeIter)
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < edges; ++i)
 	{
-		const pair<int, int>& edge = *edgeIter;
-		EDGE& Edge = m_edgeList[i];
-		Edge.ntype = 2;
-		int n0 = edge.first;
-		int n1 = edge.second;
-		if (n0 > n1) { int tmp = n0; n0 = n1; n1 = tmp; }
-		Edge.node[0] = n0;
-		Edge.node[1] = n1;
+		EDGE& edge = m_edgeList[i];
+		edge.ntype = 2;
+		edge.node[0] = (int)(key[i] >> 32);
+		edge.node[1] = (int)(key[i] & 0xFFFFFFFF);
+		edge.node[2] = -1;
 	}
+	BuildNodeEdgeTable();
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// Same as above, but for the local node numbers of a domain. This also supports
+// quadratic tets and hexes. The edges are stored with the orientation of the first
+// element that references them.
 bool FEEdgeList::Create(FEDomain* dom)
 {
 	if (dom == nullptr) return false;
 	m_mesh = dom->GetMesh();
-	FEMesh& mesh = *m_mesh;
-
-	set<EDGE, EDGE_less> edgeSet;
 
-	const int ETET[6][2] = { { 0, 1 },{ 1, 2 },{ 2, 0 },{ 0, 3 },{ 1, 3 },{ 2, 3 } };
-	const int ETET10[6][3] = { { 0, 1, 4 },{ 1, 2, 5 },{ 2, 0, 6 },{ 0, 3, 7 },{ 1, 3, 8 },{ 2, 3, 9 } };
-	const int EHEX[12][2] = { { 0, 1 },{ 1, 2 },{ 2, 3 },{ 3, 0 },{ 4, 5 },{ 5, 6 },{ 6, 7 },{ 7, 4 },{ 0, 4 },{ 1, 5 },{ 2, 6 },{ 3, 7 } };
-	const int EHEX20[12][3] = { { 0, 1, 8 },{ 1, 2, 9 },{ 2, 3, 10 },{ 3, 0, 11 },{ 4, 5, 12 },{ 5, 6, 13 },{ 6, 7, 14 },{ 7, 4, 15 },{ 0, 4, 16 },{ 1, 5, 17 },{ 2, 6, 18 },{ 3, 7, 19 } };
+	int NE = dom->Elements();
 
-	for (int i = 0; i<dom->Elements(); ++i)
+	// count the element edges
+	vector<int> off(NE + 1, 0);
+	for (int i = 0; i < NE; ++i)
 	{
-		FEElement& el = dom->ElementRef(i);
+		const int (*E)[3]; int ntype;
+		int ne = element_edges(dom->ElementRef(i), true, E, ntype);
+		if (ne == 0) return false;
+		off[i + 1] = off[i] + ne;
+	}
 
-		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5))
-		{
-			for (int i = 0; i < 6; ++i)
-			{
-				EDGE edge;
-				edge.ntype = 2;
-				edge.node[0] = el.m_lnode[ETET[i][0]];
-				edge.node[1] = el.m_lnode[ETET[i][1]];
-				edge.node[2] = -1;
-
-				edgeSet.insert(edge);
-			}
-		}
-		else if (el.Shape() == ET_HEX8)
-		{
-			for (int i = 0; i < 12; ++i)
-			{
-				EDGE edge;
-				edge.ntype = 2;
-				edge.node[0] = el.m_lnode[EHEX[i][0]];
-				edge.node[1] = el.m_lnode[EHEX[i][1]];
-				edge.node[2] = -1;
-
-				edgeSet.insert(edge);
-			}
-		}
-		else if (el.Shape() == ET_HEX20)
-		{
-			for (int i = 0; i < 12; ++i)
-			{
-				EDGE edge;
-				edge.ntype = 3;
-				edge.node[0] = el.m_lnode[EHEX20[i][0]];
-				edge.node[1] = el.m_lnode[EHEX20[i][1]];
-				edge.node[2] = el.m_lnode[EHEX20[i][2]];
-
-				edgeSet.insert(edge);
-			}
-		}
-		else if (el.Shape() == ET_TET10)
+	// create the edge keys. The position is added so that duplicates are sorted in element order.
+	vector< pair<uint64_t, int> > key(off[NE]);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < NE; ++i)
+	{
+		const FEElement& el = dom->ElementRef(i);
+		const int (*E)[3]; int ntype;
+		int ne = element_edges(el, true, E, ntype);
+		for (int j = 0; j < ne; ++j)
 		{
-			for (int i = 0; i < 6; ++i)
-			{
-				EDGE edge;
-				edge.ntype = 3;
-				edge.node[0] = el.m_lnode[ETET10[i][0]];
-				edge.node[1] = el.m_lnode[ETET10[i][1]];
-				edge.node[2] = el.m_lnode[ETET10[i][2]];
-
-				edgeSet.insert(edge);
-			}
+			int n = off[i] + j;
+			key[n].first = edge_key(el.m_lnode[E[j][0]], el.m_lnode[E[j][1]]);
+			key[n].second = n;
 		}
-		else return false;
 	}
 
-	// copy set into a vector
-	size_t edges = edgeSet.size();
+	// sort and keep the first occurence of each edge
+	parallel_sort(key);
+	key.erase(unique(key.begin(), key.end(), [](const pair<uint64_t, int>& a, const pair<uint64_t, int>& b) { return a.first == b.first; }), key.end());
+
+	// build the edge list
+	int edges = (int)key.size();
 	m_edgeList.resize(edges);
-	set< EDGE, EDGE_less>::iterator edgeIter = edgeSet.begin();
-	for (size_t i = 0; i < edges; ++i, ++edgeIter)
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < edges; ++i)
 	{
-		m_edgeList[i] = *edgeIter;
+		int n = key[i].second;
+		int iel = (int)(upper_bound(off.begin(), off.end(), n) - off.begin()) - 1;
+		const FEElement& el = dom->ElementRef(iel);
+		const int (*E)[3]; int ntype;
+		element_edges(el, true, E, ntype);
+		const int* ej = E[n - off[iel]];
+
+		EDGE& edge = m_edgeList[i];
+		edge.ntype = ntype;
+		edge.node[0] = el.m_lnode[ej[0]];
+		edge.node[1] = el.m_lnode[ej[1]];
+		edge.node[2] = (ntype == 3 ? el.m_lnode[ej[2]] : -1);
 	}
+	BuildNodeEdgeTable();
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// Since the edges are sorted by their smallest node, the edges of each node are
+// stored consecutively and the table only needs to store where they start.
+void FEEdgeList::BuildNodeEdgeTable()
+{
+	int edges = (int)m_edgeList.size();
+	int NN = 0;
+	if (edges > 0)
+	{
+		const EDGE& edge = m_edgeList[edges - 1];
+		NN = (edge.node[0] < edge.node[1] ? edge.node[0] : edge.node[1]) + 1;
+	}
+
+	m_NET.assign(NN + 1, 0);
+	for (int i = 0; i < edges; ++i)
+	{
+		const EDGE& edge = m_edgeList[i];
+		int n0 = (edge.node[0] < edge.node[1] ? edge.node[0] : edge.node[1]);
+		m_NET[n0 + 1]++;
+	}
+	for (int i = 0; i < NN; ++i) m_NET[i + 1] += m_NET[i];
+}
+
+//-----------------------------------------------------------------------------
 int FEEdgeList::FindEdge(int a, int b)
 {
-	for (int i = 0; i < (int)m_edgeList.size(); ++i)
+	if (a > b) { int t = a; a = b; b = t; }
+	if ((a < 0) || (a + 1 >= (int)m_NET.size())) return -1;
+
+	for (int i = m_NET[a]; i < m_NET[a + 1]; ++i)
 	{
-		EDGE& edge = m_edgeList[i];
-		if ((edge.node[0] == a) && (edge.node[1] == b)) return i;
-		if ((edge.node[0] == b) && (edge.node[1] == a)) return i;
+		const EDGE& edge = m_edgeList[i];
+		if ((edge.node[0] == b) || (edge.node[1] == b)) return i;
 	}
 	return -1;
 }
@@ -272,74 +270,23 @@ const std::vector<int>& FEElementEdgeList::EdgeList(int elem) const
 // NOTE: This only works for TET4 and HEX8 elements!
 bool FEElementEdgeList::Create(FEElementList& elemList, FEEdgeList& edgeList)
 {
-	FEMesh& mesh = *edgeList.GetMesh();
-
-	const int ETET[6][2] = { { 0, 1 },{ 1, 2 },{ 2, 0 },{ 0, 3 },{ 1, 3 },{ 2, 3 } };
-	const int EHEX[12][2] = { { 0, 1 },{ 1, 2 },{ 2, 3 },{ 3, 0 },{ 4, 5 },{ 5, 6 },{ 6, 7 },{ 7, 4 },{ 0, 4 },{ 1, 5 },{ 2, 6 },{ 3, 7 } };
-
-	int NN = mesh.Nodes();
-	vector<pair<int, int> > NI;
-	NI.resize(NN);
-	for (int i = 0; i<NN; ++i) NI[i].second = 0;
-	for (int i = edgeList.Edges() - 1; i >= 0; --i)
-	{
-		const FEEdgeList::EDGE& et = edgeList.Edge(i);
-		NI[et.node[0]].first = i;
-		NI[et.node[0]].second++;
-	}
-
-	int NE = mesh.Elements();
+	vector<FEElement*> elem = elemList.ElementPointers();
+	int NE = (int)elem.size();
 	m_EEL.resize(NE);
-	int i = 0;
-	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it, ++i)
+
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < NE; ++i)
 	{
-		const FEElement& el = *it;
+		const FEElement& el = *elem[i];
 		vector<int>& EELi = m_EEL[i];
-		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5))
-		{
-			EELi.resize(6);
-			for (int j = 0; j<6; ++j)
-			{
-				int n0 = el.m_node[ETET[j][0]];
-				int n1 = el.m_node[ETET[j][1]];
-
-				if (n1 < n0) { int nt = n1; n1 = n0; n0 = nt; }
-
-				int l0 = NI[n0].first;
-				int ln = NI[n0].second;
-				for (int l = 0; l<ln; ++l)
-				{
-					assert(edgeList[l0 + l].node[0] == n0);
-					if (edgeList[l0 + l].node[1] == n1)
-					{
-						EELi[j] = l0 + l;
-						break;
-					}
-				}
-			}
-		}
-		else if (el.Shape() == FE_Element_Shape::ET_HEX8)
+
+		const int (*E)[3]; int ntype;
+		int ne = element_edges(el, false, E, ntype);
+		EELi.resize(ne);
+		for (int j = 0; j < ne; ++j)
 		{
-			EELi.resize(12);
-			for (int j = 0; j<12; ++j)
-			{
-				int n0 = el.m_node[EHEX[j][0]];
-				int n1 = el.m_node[EHEX[j][1]];
-
-				if (n1 < n0) { int nt = n1; n1 = n0; n0 = nt; }
-
-				int l0 = NI[n0].first;
-				int ln = NI[n0].second;
-				for (int l = 0; l<ln; ++l)
-				{
-					assert(edgeList[l0 + l].node[0] == n0);
-					if (edgeList[l0 + l].node[1] == n1)
-					{
-						EELi[j] = l0 + l;
-						break;
-					}
-				}
-			}
+			EELi[j] = edgeList.FindEdge(el.m_node[E[j][0]], el.m_node[E[j][1]]);
+			assert(EELi[j] >= 0);
 		}
 	}
 	return true;
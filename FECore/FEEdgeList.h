@@ -59,9 +59,13 @@ public:
 
 	int FindEdge(int a, int b);
 
+private:
+	void BuildNodeEdgeTable();
+
 private:
 	FEMesh*				m_mesh;
 	std::vector<EDGE>	m_edgeList;
+	std::vector<int>	m_NET;		// for each node, the first edge whose smallest node is this node
 };
 
 class FECORE_API FEElementEdgeList
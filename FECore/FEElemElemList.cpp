@@ -25,13 +25,39 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 
 
-
 #include "stdafx.h"
 #include "FEElemElemList.h"
-#include "FENodeElemList.h"
 #include "FESolidDomain.h"
 #include "FESurface.h"
 #include "FEMesh.h"
+#include "parallel_sort.h"
+#include <stdint.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// Key of an element face. The corner nodes are sorted, so that identical faces
+// have identical keys, regardless of their orientation.
+struct ELEM_FACE
+{
+	int	n[4];	// sorted corner nodes (n[3] = -1 for triangles)
+	int	nn;		// number of face nodes (faces only match if this is the same)
+	int	M;		// index into the neighbor list
+
+	bool SameFace(const ELEM_FACE& f) const
+	{
+		return (nn == f.nn) && (n[0] == f.n[0]) && (n[1] == f.n[1]) && (n[2] == f.n[2]) && (n[3] == f.n[3]);
+	}
+
+	bool operator < (const ELEM_FACE& f) const
+	{
+		if (n[0] != f.n[0]) return n[0] < f.n[0];
+		if (n[1] != f.n[1]) return n[1] < f.n[1];
+		if (n[2] != f.n[2]) return n[2] < f.n[2];
+		if (n[3] != f.n[3]) return n[3] < f.n[3];
+		if (nn != f.nn) return nn < f.nn;
+		return M < f.M;
+	}
+};
 
 //-----------------------------------------------------------------------------
 FEElemElemList::FEElemElemList(void)
@@ -54,7 +80,6 @@ void FEElemElemList::Init()
 
 	// count nr of neighbors
 	int NN = 0, n = 0, nf;
-	m_ref[0] = 0;
 	for (int i=0; i<m.Domains(); ++i)
 	{
 		FEDomain& dom = m.Domain(i);
@@ -62,7 +87,7 @@ void FEElemElemList::Init()
 		{
 			FEElement& el = dom.ElementRef(j);
 			nf = el.Faces();
-			if (n != 0) m_ref[n] = m_ref[n-1] + nf;
+			m_ref[n] = NN;
 			NN += nf;
 		}
 	}
@@ -74,6 +99,8 @@ void FEElemElemList::Init()
 }
 
 //-----------------------------------------------------------------------------
+// The neighbors are found by sorting the keys of all element faces. Faces that
+// are shared by two elements end up next to each other in the sorted list.
 bool FEElemElemList::Create(FEMesh* pmesh)
 {
 	// store a pointer to the mesh
@@ -83,86 +110,99 @@ bool FEElemElemList::Create(FEMesh* pmesh)
 	// initialize data structures
 	Init();
 
-	// create the node element list
-	FENodeElemList NEL;
-	NEL.Create(m);
-
-	// loop over all solid elements first
-	int en0[FEElement::MAX_NODES], en1[FEElement::MAX_NODES], n0, n1, M = 0;
-	int nf0, nf1;
+	// get the elements and the element that owns each face
+	int NE = m.Elements();
+	int NF = (int)m_pel.size();
+	vector<FEElement*> elem(NE);
+	vector<int> owner(NF);
+	vector<char> isShell(NE);
+	int ne = 0;
 	for (int nd=0; nd<m.Domains(); ++nd)
 	{
 		FEDomain& dom = m.Domain(nd);
-		for (int i=0; i<dom.Elements(); ++i)
+		for (int i=0; i<dom.Elements(); ++i, ++ne)
 		{
-			FEElement& el = dom.ElementRef(i);
-			
-			// get the number of neighbors
-			nf0 = el.Faces();
+			elem[ne] = &dom.ElementRef(i);
+			isShell[ne] = (dom.Class() == FE_DOMAIN_SHELL ? 1 : 0);
+			int nf = elem[ne]->Faces();
+			for (int j=0; j<nf; ++j) owner[m_ref[ne] + j] = ne;
+		}
+	}
+
+	// create the face keys
+	vector<ELEM_FACE> key(NF);
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NE; ++i)
+	{
+		FEElement& el = *elem[i];
+		int en[FEElement::MAX_NODES];
+		int nf = el.Faces();
+		for (int j=0; j<nf; ++j)
+		{
+			int M = m_ref[i] + j;
+			ELEM_FACE& f = key[M];
+			f.M = M;
+			f.nn = el.GetFace(j, en);
 
-			// loop over all neighbors
-			for (int j=0; j<nf0; ++j, ++M)
+			if ((f.nn == 3) || (f.nn == 6) || (f.nn == 7))
 			{
-				// get the face nodes
-				n0 = el.GetFace(j, en0);
-
-				// find the neighbor element
-				m_pel[M] = 0;
-				m_peli[M] = -1;
-
-				// loop over all possible candidates
-				int nval = NEL.Valence(en0[0]);
-				FEElement** pne = NEL.ElementList(en0[0]);
-				int* pnei = NEL.ElementIndexList(en0[0]);
-				for (int k=0; k<nval; ++k)
-				{
-					// make sure we don't compare the current element
-					if (pne[k] != &el)
-					{
-						// get the number of faces
-						nf1 = pne[k]->Faces();
-
-						// see if any of these faces match en0
-						for (int l=0; l<nf1; ++l)
-						{
-							n1 = pne[k]->GetFace(l, en1);
-
-							// make sure the faces have the same nr of nodes
-							if (n1 == n0)
-							{
-								// check triangles
-								if ((n0 == 3) || (n0 == 6) || (n0 ==7))
-								{
-									if (((en0[0] == en1[0]) || (en0[0] == en1[1]) || (en0[0] == en1[2])) &&
-										((en0[1] == en1[0]) || (en0[1] == en1[1]) || (en0[1] == en1[2])) &&
-										((en0[2] == en1[0]) || (en0[2] == en1[1]) || (en0[2] == en1[2])))
-									{
-										// found it!
-										m_pel[M] = pne[k];
-										m_peli[M] = pnei[k];
-										break;
-									}
-								}
-								// check quads
-								else if ((n0 == 4) || (n0 == 8) || (n0 == 9))
-								{
-									if (((en0[0] == en1[0]) || (en0[0] == en1[1]) || (en0[0] == en1[2]) || (en0[0] == en1[3])) &&
-										((en0[1] == en1[0]) || (en0[1] == en1[1]) || (en0[1] == en1[2]) || (en0[1] == en1[3])) &&
-										((en0[2] == en1[0]) || (en0[2] == en1[1]) || (en0[2] == en1[2]) || (en0[2] == en1[3])) &&
-										((en0[3] == en1[0]) || (en0[3] == en1[1]) || (en0[3] == en1[2]) || (en0[3] == en1[3])))
-									{
-										// found it!
-										m_pel[M] = pne[k];
-										m_peli[M] = pnei[k];
-										break;
-									}
-								}
-							}
-
-							if (m_pel[M] != 0) break;
-						}
-					}
-				}
+				f.n[0] = en[0]; f.n[1] = en[1]; f.n[2] = en[2]; f.n[3] = -1;
+				sort(f.n, f.n + 3);
+			}
+			else if ((f.nn == 4) || (f.nn == 8) || (f.nn == 9))
+			{
+				f.n[0] = en[0]; f.n[1] = en[1]; f.n[2] = en[2]; f.n[3] = en[3];
+				sort(f.n, f.n + 4);
+			}
+			else
+			{
+				// other faces never match
+				f.n[0] = f.n[1] = f.n[2] = f.n[3] = -1;
+				f.nn = -M - 1;
+			}
+
+			m_pel[M] = 0;
+			m_peli[M] = -1;
+		}
+	}
+
+	// sort the faces
+	parallel_sort(key);
+
+	// find the groups of identical faces
+	vector<int> group;
+	group.reserve(NF / 2 + 1);
+	for (int i=0; i<NF; ++i)
+	{
+		if ((i == 0) || (key[i].SameFace(key[i - 1]) == false)) group.push_back(i);
+	}
+	int NG = (int)group.size();
+	group.push_back(NF);
+
+	// connect the faces in each group. If more than two elements share a face
+	// shells are preferred over solids (as in FENodeElemList), and then the 
+	// element with the lowest index.
+#pragma omp parallel for schedule(static)
+	for (int g=0; g<NG; ++g)
+	{
+		int i0 = group[g], i1 = group[g + 1];
+		if (i1 - i0 < 2) continue;
+
+		for (int i=i0; i<i1; ++i)
+		{
+			int M = key[i].M;
+			int ei = owner[M];
+			int nbr = -1;
+			for (int j=i0; j<i1; ++j)
+			{
+				int ej = owner[key[j].M];
+				if (ej == ei) continue;
+				if ((nbr == -1) || (isShell[ej] > isShell[nbr]) || ((isShell[ej] == isShell[nbr]) && (ej < nbr))) nbr = ej;
+			}
+			if (nbr >= 0)
+			{
+				m_pel[M] = elem[nbr];
+				m_peli[M] = nbr;
 			}
 		}
 	}
@@ -194,59 +234,50 @@ bool FEElemElemList::Create(const FESurface* psurf)
 		NN += nf;
 	}
 
-	m_pel.resize(NN);
-
-	// create the node element list
-	FENodeElemList NEL;
-	NEL.Create(*psurf);
+	m_pel.assign(NN, 0);
 
-	// loop over all facets
-	int en0[3], en1[3], M = 0;
-	int nf0, nf1;
+	// create the keys of all facet edges
+	vector< pair<uint64_t, int> > key(NN);
+	vector<int> owner(NN);
+#pragma omp parallel for schedule(static)
 	for (int i=0; i<NE; ++i)
 	{
 		const FESurfaceElement& el = psurf->Element(i);
-			
-		// get the number of neighbors
-		nf0 = el.facet_edges();
-
-		// loop over all neighbors
-		for (int j=0; j<nf0; ++j, ++M)
+		int en[3];
+		int nf = el.facet_edges();
+		for (int j=0; j<nf; ++j)
 		{
-			// get the edge nodes
-			el.facet_edge(j, en0);
+			int M = m_ref[i] + j;
+			el.facet_edge(j, en);
+			int a = en[0], b = en[1];
+			if (a > b) { int t = a; a = b; b = t; }
+			key[M].first = ((uint64_t)a << 32) | (uint64_t)(unsigned int)b;
+			key[M].second = M;
+			owner[M] = i;
+		}
+	}
 
-			// find the neighbor element
-			m_pel[M] = 0;
+	// sort the edges, so that shared edges are next to each other
+	parallel_sort(key);
+
+	// for each edge, the neighbor is the first other facet that shares it
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NN; ++i)
+	{
+		int M = key[i].second;
+		int ei = owner[M];
+
+		// find the start of the group
+		int i0 = i;
+		while ((i0 > 0) && (key[i0 - 1].first == key[i].first)) i0--;
 
-			// loop over all possible candidates
-			int nval = NEL.Valence(en0[0]);
-			FEElement** pne = NEL.ElementList(en0[0]);
-			for (int k=0; k<nval; ++k)
+		for (int j=i0; (j<NN) && (key[j].first == key[i].first); ++j)
+		{
+			int ej = owner[key[j].second];
+			if (ej != ei)
 			{
-				// make sure we don't compare the current element
-				if (pne[k] != &el)
-				{
-					// get the number of edges
-					FESurfaceElement& me = dynamic_cast<FESurfaceElement&>(*pne[k]);
-					nf1 = me.facet_edges();
-
-					// see if any of these edges match en0
-					for (int l=0; l<nf1; ++l)
-					{
-						me.facet_edge(l, en1);
-
-						if (((en0[0] == en1[0]) || (en0[0] == en1[1])) &&
-							((en0[1] == en1[0]) || (en0[1] == en1[1])))
-							{
-								// found it!
-								m_pel[M] = pne[k];
-								break;
-							}
-					}
-
-					if (m_pel[M] != 0) break;
-				}
+				m_pel[M] = const_cast<FESurfaceElement*>(&psurf->Element(ej));
+				break;
 			}
 		}
 	}
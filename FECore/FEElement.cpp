@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FEElement.h"
 #include "DumpStream.h"
 #include <math.h>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 FEElementState::FEElementState(const FEElementState& s)
@@ -52,6 +53,21 @@ FEElementState& FEElementState::operator = (const FEElementState& s)
 	return (*this);
 }
 
+//-----------------------------------------------------------------------------
+void FEElement::Swap(FEElement& el)
+{
+	std::swap(m_nID, el.m_nID);
+	std::swap(m_lid, el.m_lid);
+	std::swap(m_mat, el.m_mat);
+	std::swap(m_status, el.m_status);
+	std::swap(m_pT, el.m_pT);
+	std::swap(m_lm, el.m_lm);
+	std::swap(m_val, el.m_val);
+	m_node.swap(el.m_node);
+	m_lnode.swap(el.m_lnode);
+	m_State.Swap(el.m_State);
+}
+
 //-----------------------------------------------------------------------------
 //! clear material point data
 void FEElement::ClearData()
@@ -62,6 +62,9 @@ public:
 	//! operator for easy access to element data
 	FEMaterialPoint*& operator [] (int n) { return m_data[n]; }
 
+	//! exchange the state data (without copying the material points)
+	void Swap(FEElementState& s) { m_data.swap(s.m_data); }
+
 private:
 	vector<FEMaterialPoint*>	m_data;
 };
@@ -163,6 +166,11 @@ public:
 		m_State[n] = pmp; 
 	}
 
+	//! exchange all data with another element of the same partition.
+	//! Unlike the assignment operator this does not copy the material points.
+	//! NOTE: the material points' element pointers are not updated.
+	void Swap(FEElement& el);
+
 	//! serialize
 	//! NOTE: state data is not serialized by the element. This has to be done by the domains.
 	virtual void Serialize(DumpStream& ar);
@@ -63,3 +63,15 @@ void FEElementList::iterator::operator ++ ()
 		}
 	}
 }
+
+std::vector<FEElement*> FEElementList::ElementPointers()
+{
+	std::vector<FEElement*> elem;
+	elem.reserve(m_mesh.Elements());
+	for (int i = 0; i < m_mesh.Domains(); ++i)
+	{
+		FEDomain& dom = m_mesh.Domain(i);
+		for (int j = 0; j < dom.Elements(); ++j) elem.push_back(&dom.ElementRef(j));
+	}
+	return elem;
+}
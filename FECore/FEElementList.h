@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "fecore_api.h"
+#include <vector>
 
 class FEMesh;
 class FEElement;
@@ -68,6 +69,9 @@ public:
 	iterator begin() { return iterator(&m_mesh); }
 	iterator end() { return iterator(); }
 
+	//! get pointers to all elements (in the same order as the iterator), for random access
+	FECORE_API std::vector<FEElement*> ElementPointers();
+
 private:
 	FEMesh&	m_mesh;
 };
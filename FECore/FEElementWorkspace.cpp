@@ -0,0 +1,159 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEElementWorkspace.h"
+#include "sys.h"
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+FEElementWorkspace::FEElementWorkspace()
+{
+	// reserve enough space for the largest elements so that the element vectors
+	// do not need to grow in most cases.
+	const int nmax = FEElement::MAX_NODES*MAX_NODE_DOFS;
+	m_fe.reserve(nmax);
+	m_lm.reserve(nmax);
+	m_lmcap = m_lm.capacity();
+	m_nalloc = 0;
+}
+
+//-----------------------------------------------------------------------------
+FEElementWorkspace::~FEElementWorkspace()
+{
+	for (size_t i = 0; i < m_ke.size(); ++i) delete m_ke[i];
+	m_ke.clear();
+}
+
+//-----------------------------------------------------------------------------
+size_t FEElementWorkspace::MatrixCapacity(const FEElementMatrix& ke) const
+{
+	return ke.RowIndices().capacity() + ke.ColumnsIndices().capacity() + ke.Nodes().capacity();
+}
+
+//-----------------------------------------------------------------------------
+FEElementMatrix& FEElementWorkspace::ElementMatrix(const FEElement& el, int nrows, int ncols)
+{
+	// see if we already have a matrix of this size
+	FEElementMatrix* pke = nullptr;
+	for (size_t i = 0; i < m_ke.size(); ++i)
+	{
+		FEElementMatrix& ke = *m_ke[i];
+		if ((ke.rows() == nrows) && (ke.columns() == ncols))
+		{
+			// the index vectors may have grown when the matrix was used last
+			size_t cap = MatrixCapacity(ke);
+			if (cap != m_kecap[i]) { m_nalloc++; m_kecap[i] = cap; }
+			pke = &ke;
+			break;
+		}
+	}
+
+	// if not, allocate a new one
+	if (pke == nullptr)
+	{
+		pke = new FEElementMatrix(nrows, ncols);
+		pke->RowIndices().reserve(nrows);
+		pke->ColumnsIndices().reserve(ncols);
+		pke->SetNodes(el.m_node);
+		m_ke.push_back(pke);
+		m_kecap.push_back(MatrixCapacity(*pke));
+		m_nalloc++;
+	}
+
+	FEElementMatrix& ke = *pke;
+	ke.SetNodes(el.m_node);
+	ke.zero();
+	return ke;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<double>& FEElementWorkspace::ElementVector(int n)
+{
+	if (n > (int)m_fe.capacity()) m_nalloc++;
+	m_fe.assign(n, 0.0);
+	return m_fe;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<int>& FEElementWorkspace::LM()
+{
+	// the LM vector may have grown when it was used last
+	if (m_lm.capacity() != m_lmcap) { m_nalloc++; m_lmcap = m_lm.capacity(); }
+	return m_lm;
+}
+
+//-----------------------------------------------------------------------------
+FEElementWorkspacePool::FEElementWorkspacePool()
+{
+
+}
+
+//-----------------------------------------------------------------------------
+FEElementWorkspacePool::FEElementWorkspacePool(const FEElementWorkspacePool&)
+{
+
+}
+
+//-----------------------------------------------------------------------------
+FEElementWorkspacePool::~FEElementWorkspacePool()
+{
+	for (size_t i = 0; i < m_ws.size(); ++i) delete m_ws[i];
+	m_ws.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEElementWorkspacePool::Prepare()
+{
+	// the number of threads may have changed since the last call
+	int nt = omp_get_max_threads();
+	for (int i = (int)m_ws.size(); i < nt; ++i) m_ws.push_back(new FEElementWorkspace);
+}
+
+//-----------------------------------------------------------------------------
+FEElementWorkspace& FEElementWorkspacePool::GetThreadWorkspace()
+{
+	int n = omp_get_thread_num();
+	assert(n < (int)m_ws.size());
+	return *m_ws[n];
+}
+
+//-----------------------------------------------------------------------------
+int FEElementWorkspacePool::TotalAllocations() const
+{
+	int n = 0;
+	for (size_t i = 0; i < m_ws.size(); ++i) n += m_ws[i]->Allocations();
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+void FEElementWorkspacePool::ResetAllocations()
+{
+	for (size_t i = 0; i < m_ws.size(); ++i) m_ws[i]->ResetAllocations();
+}
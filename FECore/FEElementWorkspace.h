@@ -0,0 +1,111 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "FEGlobalMatrix.h"
+#include "FEElement.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Scratch space for the element loops of the domain classes.
+//! A workspace is used by one thread, which can borrow an element matrix,
+//! an element vector and an LM vector from it inside a parallel loop. The buffers 
+//! keep their memory from one element (and one Newton iteration) to the next, so 
+//! once every element type of the domain has been processed the element loops 
+//! no longer allocate. The workspace counts the allocations it had to do, so 
+//! this can be verified. Note that a borrowed buffer is only valid until the next
+//! time the same buffer is requested from the same workspace.
+class FECORE_API FEElementWorkspace
+{
+	enum { MAX_NODE_DOFS = 8 };	// nr of dofs per node we reserve memory for
+
+public:
+	FEElementWorkspace();
+	~FEElementWorkspace();
+
+	//! Get a zeroed element matrix of the requested size, with its node list set to the element's nodes.
+	FEElementMatrix& ElementMatrix(const FEElement& el, int nrows, int ncols);
+
+	//! Get a zeroed element vector of the requested size
+	std::vector<double>& ElementVector(int n);
+
+	//! Get the LM vector (its content is undefined)
+	std::vector<int>& LM();
+
+	//! nr of allocations done by this workspace since the last reset
+	int Allocations() const { return m_nalloc; }
+
+	//! reset the allocation counter
+	void ResetAllocations() { m_nalloc = 0; }
+
+private:
+	FEElementWorkspace(const FEElementWorkspace&);
+	void operator = (const FEElementWorkspace&);
+
+	size_t MatrixCapacity(const FEElementMatrix& ke) const;
+
+private:
+	std::vector<FEElementMatrix*>	m_ke;		//!< element matrices (one for each size requested so far)
+	std::vector<size_t>				m_kecap;	//!< capacity of the element matrices' index vectors
+	std::vector<double>				m_fe;		//!< element vector
+	std::vector<int>				m_lm;		//!< LM vector
+	size_t							m_lmcap;	//!< capacity of m_lm at the last request
+	int								m_nalloc;	//!< nr of allocations since last reset
+};
+
+//-----------------------------------------------------------------------------
+//! The workspaces of the threads that run the element loops of a domain. 
+//! Each domain owns its workspaces, so that models that are solved concurrently 
+//! do not share them. Call Prepare() before entering the parallel region and then
+//! use GetThreadWorkspace() inside the loop.
+class FECORE_API FEElementWorkspacePool
+{
+public:
+	FEElementWorkspacePool();
+	~FEElementWorkspacePool();
+
+	//! Copies start with their own (empty) workspaces.
+	FEElementWorkspacePool(const FEElementWorkspacePool&);
+	void operator = (const FEElementWorkspacePool&) {}
+
+	//! make sure that there is a workspace for each thread. (Must be called outside a parallel region.)
+	void Prepare();
+
+	//! get the workspace of the calling thread
+	FEElementWorkspace& GetThreadWorkspace();
+
+	//! total nr of allocations of all workspaces since the last reset
+	int TotalAllocations() const;
+
+	//! reset the allocation counters (Must be called outside a parallel region.)
+	void ResetAllocations();
+
+private:
+	std::vector<FEElementWorkspace*>	m_ws;	//!< the workspaces, one for each thread
+};
@@ -33,6 +33,36 @@ SOFTWARE.*/
 #include "FEElemElemList.h"
 #include "FEElementList.h"
 #include "FEEdgeList.h"
+#include "parallel_sort.h"
+#include <stdint.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// A face key stores the sorted corner nodes of a face (the 4th node is -1 for 
+// triangles) and the face's index. Sorting the keys brings identical faces together.
+struct FACE_KEY
+{
+	int	n[4];
+	int	index;
+
+	void set(const int* node, int nn, int i)
+	{
+		n[0] = node[0]; n[1] = node[1]; n[2] = node[2]; n[3] = (nn == 4 ? node[3] : -1);
+		sort(n, n + (nn == 4 ? 4 : 3));
+		index = i;
+	}
+
+	bool SameFace(const FACE_KEY& k) const { return (n[0] == k.n[0]) && (n[1] == k.n[1]) && (n[2] == k.n[2]) && (n[3] == k.n[3]); }
+
+	bool operator < (const FACE_KEY& k) const
+	{
+		if (n[0] != k.n[0]) return n[0] < k.n[0];
+		if (n[1] != k.n[1]) return n[1] < k.n[1];
+		if (n[2] != k.n[2]) return n[2] < k.n[2];
+		if (n[3] != k.n[3]) return n[3] < k.n[3];
+		return index < k.index;
+	}
+};
 
 bool FEFaceList::FACE::IsEqual(int* n) const
 {
@@ -143,40 +173,43 @@ bool FEFaceList::Create(FEMesh& mesh, FEElemElemList& EEL)
 {
 	m_mesh = &mesh;
 
-	// get the number of elements in this mesh
-	int NE = mesh.Elements();
-
-	// count the number of facets we have to create
-	int NF = 0;
 	FEElementList EL(mesh);
-	FEElementList::iterator it = EL.begin();
-	for (int i = 0; i<NE; ++i, ++it)
+	vector<FEElement*> elem = EL.ElementPointers();
+	int NE = (int)elem.size();
+
+	// count the number of facets each element creates. Interior facets are
+	// created by the element with the lowest ID.
+	vector<int> off(NE + 1, 0);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i<NE; ++i)
 	{
-		FEElement& el = *it;
+		FEElement& el = *elem[i];
 		int nf = el.Faces();
+		int NF = 0;
 		for (int j = 0; j<nf; ++j)
 		{
 			FEElement* pen = EEL.Neighbor(i, j);
-			if (pen == 0) ++NF;
-			if ((pen != 0) && (el.GetID() < pen->GetID())) ++NF;
+			if ((pen == 0) || (el.GetID() < pen->GetID())) ++NF;
 		}
+		off[i + 1] = NF;
 	}
+	for (int i = 0; i < NE; ++i) off[i + 1] += off[i];
 
 	// create the facet list
-	m_faceList.resize(NF);
+	m_faceList.resize(off[NE]);
 
 	// build the facets
-	int face[FEElement::MAX_NODES];
-	NF = 0;
-	it = EL.begin();
-	for (int i = 0; i<NE; ++i, ++it)
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i<NE; ++i)
 	{
-		FEElement& el = *it;
+		FEElement& el = *elem[i];
+		int face[FEElement::MAX_NODES];
 		int nf = el.Faces();
+		int NF = off[i];
 		for (int j = 0; j<nf; ++j)
 		{
 			FEElement* pen = EEL.Neighbor(i, j);
-			if ((pen == 0) || ((pen != 0) && (el.GetID() < pen->GetID())))
+			if ((pen == 0) || (el.GetID() < pen->GetID()))
 			{
 				FACE& se = m_faceList[NF++];
 				el.GetFace(j, face);
@@ -212,15 +245,18 @@ bool FEFaceList::Create(FEMesh& mesh, FEElemElemList& EEL)
 // build the neighbor list
 void FEFaceList::BuildNeighbors()
 {
-	// build a node-face list
-	FENodeFaceList NFL;
-	NFL.Create(*this);
-
-	for (int i = 0; i < Faces(); ++i)
+	// create a key for each edge of the surface facets. The key also stores
+	// the facet and the local edge index as 4*facet + edge.
+	int NF = Faces();
+	vector<int> off(NF + 1, 0);
+	for (int i = 0; i < NF; ++i) off[i + 1] = off[i] + (m_faceList[i].nsurf == 1 ? m_faceList[i].ntype : 0);
+
+	vector< pair<uint64_t, int> > key(off[NF]);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < NF; ++i)
 	{
 		FACE& f = m_faceList[i];
 		f.nbr[0] = f.nbr[1] = f.nbr[2] = f.nbr[3] = -1;
-
 		if (f.nsurf == 1)
 		{
 			int fn = f.ntype;
@@ -228,24 +264,36 @@ void FEFaceList::BuildNeighbors()
 			{
 				int n0 = f.node[j];
 				int n1 = f.node[(j + 1) % fn];
+				if (n0 > n1) { int t = n0; n0 = n1; n1 = t; }
+				key[off[i] + j].first = ((uint64_t)n0 << 32) | (uint64_t)(unsigned int)n1;
+				key[off[i] + j].second = 4*i + j;
+			}
+		}
+	}
 
-				int nval = NFL.Faces(n0);
-				std::vector<int> fl = NFL.FaceList(n0);
-				for (int k = 0; k < nval; ++k)
-				{
-					if (fl[k] != i)
-					{
-						FACE& fk = m_faceList[fl[k]];
-						if ((fk.nsurf == 1) && fk.HasEdge(n0, n1))
-						{
-							f.nbr[j] = fl[k];
-							break;
-						}
-					}
-				}
-				assert(f.nbr[j] != -1);
+	// sort the edges so that shared edges are next to each other
+	parallel_sort(key);
+
+	// the neighbor across an edge is the first other facet that shares it
+	int NK = (int)key.size();
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < NK; ++i)
+	{
+		int nf = key[i].second / 4;
+		int j = key[i].second % 4;
+
+		int i0 = i;
+		while ((i0 > 0) && (key[i0 - 1].first == key[i].first)) i0--;
+		for (int k = i0; (k < NK) && (key[k].first == key[i].first); ++k)
+		{
+			int nk = key[k].second / 4;
+			if (nk != nf)
+			{
+				m_faceList[nf].nbr[j] = nk;
+				break;
 			}
 		}
+		assert(m_faceList[nf].nbr[j] != -1);
 	}
 }
 
@@ -270,9 +318,18 @@ bool FENodeFaceList::Create(FEFaceList& FL)
 	FEMesh& mesh = *FL.GetMesh();
 
 	int NN = mesh.Nodes();
-	m_NFL.resize(NN);
+	m_NFL.assign(NN, vector<int>());
 
+	// count the node valences first, so that each list is allocated only once
 	int NF = FL.Faces();
+	vector<int> nval(NN, 0);
+	for (int i = 0; i < NF; ++i)
+	{
+		const FEFaceList::FACE& face = FL[i];
+		for (int j = 0; j < face.ntype; ++j) nval[face.node[j]]++;
+	}
+	for (int i = 0; i < NN; ++i) m_NFL[i].reserve(nval[i]);
+
 	for (int i = 0; i < NF; ++i)
 	{
 		const FEFaceList::FACE& face = FL[i];
@@ -295,8 +352,6 @@ FEElementFaceList::FEElementFaceList()
 //NOTE: only works for hex elements
 bool FEElementFaceList::Create(FEElementList& elemList, FEFaceList& faceList)
 {
-	FEMesh& mesh = *faceList.GetMesh();
-
 	const int FTET[4][3] = {
 		{ 0, 1, 3},
 		{ 1, 2, 3},
@@ -312,66 +367,46 @@ bool FEElementFaceList::Create(FEElementList& elemList, FEFaceList& faceList)
 		{ 3, 2, 1, 0 },
 		{ 4, 5, 6, 7 }};
 
-	// build a node face table for FT to facilitate searching
-	int NN = mesh.Nodes();
-	vector<vector<int> > NFT; NFT.resize(NN);
-	for (int i = 0; i<faceList.Faces(); ++i)
+	// sort the faces by their nodes, so we can use a binary search
+	int NF = faceList.Faces();
+	vector<FACE_KEY> key(NF);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < NF; ++i)
 	{
 		const FEFaceList::FACE& f = faceList.Face(i);
-		NFT[f.node[0]].push_back(i);
-		NFT[f.node[1]].push_back(i);
-		NFT[f.node[2]].push_back(i);
-		if (f.ntype == 4) NFT[f.node[3]].push_back(i);
+		key[i].set(f.node, f.ntype, i);
 	}
+	parallel_sort(key);
 
-	int NE = mesh.Elements();
+	vector<FEElement*> elem = elemList.ElementPointers();
+	int NE = (int)elem.size();
 	m_EFL.resize(NE);
-	int i = 0;
-	for (FEElementList::iterator it = elemList.begin(); it != elemList.end(); ++it, ++i)
+	bool bok = true;
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < NE; ++i)
 	{
-		const FEElement& el = *it;
+		const FEElement& el = *elem[i];
 		vector<int>& EFLi = m_EFL[i];
-		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5))
-		{
-			EFLi.resize(4);
-			for (int j = 0; j < 4; ++j)
-			{
-				int fj[3] = { el.m_node[FTET[j][0]], el.m_node[FTET[j][1]], el.m_node[FTET[j][2]] };
-				EFLi[j] = -1;
-				vector<int>& nfi = NFT[fj[0]];
-				for (int k = 0; k<(int)nfi.size(); ++k)
-				{
-					const FEFaceList::FACE& fk = faceList.Face(nfi[k]);
-					if (fk.IsEqual(fj))
-					{
-						EFLi[j] = nfi[k];
-						break;
-					}
-				}
-			}
-		}
-		else if (el.Shape() == FE_Element_Shape::ET_HEX8)
+
+		int nf = 0, nn = 0;
+		const int* F = 0;
+		if ((el.Shape() == ET_TET4) || (el.Shape() == ET_TET5)) { nf = 4; nn = 3; F = FTET[0]; }
+		else if (el.Shape() == FE_Element_Shape::ET_HEX8) { nf = 6; nn = 4; F = FHEX[0]; }
+		else { bok = false; continue; }
+
+		EFLi.resize(nf);
+		for (int j = 0; j < nf; ++j)
 		{
-			EFLi.resize(6);
-			for (int j = 0; j < 6; ++j)
-			{
-				int fj[4] = { el.m_node[FHEX[j][0]], el.m_node[FHEX[j][1]], el.m_node[FHEX[j][2]], el.m_node[FHEX[j][3]] };
-				EFLi[j] = -1;
-				vector<int>& nfi = NFT[fj[0]];
-				for (int k = 0; k<(int)nfi.size(); ++k)
-				{
-					const FEFaceList::FACE& fk = faceList.Face(nfi[k]);
-					if (fk.IsEqual(fj))
-					{
-						EFLi[j] = nfi[k];
-						break;
-					}
-				}
-			}
+			int fj[4];
+			for (int k = 0; k < nn; ++k) fj[k] = el.m_node[F[nn*j + k]];
+
+			FACE_KEY kj;
+			kj.set(fj, nn, -1);
+			vector<FACE_KEY>::const_iterator it = lower_bound(key.begin(), key.end(), kj);
+			EFLi[j] = (((it != key.end()) && it->SameFace(kj)) ? it->index : -1);
 		}
-		else return false;
 	}
-	return true;
+	return bok;
 }
 
 //=============================================================================
@@ -382,17 +417,16 @@ FEFaceEdgeList::FEFaceEdgeList()
 
 bool FEFaceEdgeList::Create(FEFaceList& faceList, FEEdgeList& edgeList)
 {
-	FENodeEdgeList NEL;
-	NEL.Create(edgeList);
-
 	int faces = faceList.Faces();
 	m_FEL.resize(faces);
+	bool bok = true;
+#pragma omp parallel for schedule(static)
 	for (int i = 0; i < faces; ++i)
 	{
 		vector<int>& edges = m_FEL[i];
 		edges.clear();
 
-		FEFaceList::FACE face = faceList.Face(i);
+		const FEFaceList::FACE& face = faceList.Face(i);
 
 		// find the corresponding edges
 		int n = face.ntype;
@@ -401,26 +435,14 @@ bool FEFaceEdgeList::Create(FEFaceList& faceList, FEEdgeList& edgeList)
 			int a = face.node[j];
 			int b = face.node[(j + 1) % n];
 
-			int edge = -1;
-			const std::vector<int>& a_edges = NEL.EdgeList(a);
-			for (int k = 0; k < a_edges.size(); ++k)
-			{
-				const FEEdgeList::EDGE& ek = edgeList[a_edges[k]];
-				if (((ek.node[0] == a) && (ek.node[1] == b)) ||
-					((ek.node[1] == a) && (ek.node[0] == b)))
-				{
-					edge = a_edges[k];
-					break;
-				}
-			}
-
+			int edge = edgeList.FindEdge(a, b);
 			assert(edge >= 0);
-			if (edge == -1) return false;
+			if (edge == -1) bok = false;
 			edges.push_back(edge);
 		}
 	}
 
-	return true;
+	return bok;
 }
 
 int FEFaceEdgeList::Edges(int nface)
@@ -446,7 +468,17 @@ bool FENodeEdgeList::Create(FEEdgeList& edgeList)
 	int N = mesh->Nodes();
 	m_NEL.resize(N);
 
+	// count the node valences first, so that each list is allocated only once
 	int NE = edgeList.Edges();
+	vector<int> nval(N, 0);
+	for (int i = 0; i < NE; ++i)
+	{
+		const FEEdgeList::EDGE& edge = edgeList[i];
+		nval[edge.node[0]]++;
+		nval[edge.node[1]]++;
+	}
+	for (int i = 0; i < N; ++i) m_NEL[i].reserve(nval[i]);
+
 	for (int i = 0; i < NE; ++i)
 	{
 		const FEEdgeList::EDGE& edge = edgeList[i];
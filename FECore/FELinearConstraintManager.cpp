@@ -132,6 +132,9 @@ void FELinearConstraintManager::BuildMatrixProfile(FEGlobalMatrix& G)
 	int nlin = (int)m_LinC.size();
 	if (nlin == 0) return;
 
+	// the equation numbers are known now, so we can compile the constraints
+	BuildTransformation();
+
 	FEAnalysis* pstep = m_fem->GetCurrentStep();
 	FEMesh& mesh = m_fem->GetMesh();
 
@@ -381,120 +384,135 @@ void FELinearConstraintManager::AssembleResidual(vector<double>& R, vector<int>&
 }
 
 //-----------------------------------------------------------------------------
-void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<double>& R, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke)
+//! Compile the linear constraints into a sparse transformation operator. Row l
+//! of the operator stores the equation numbers and coefficients of the slave
+//! dofs of constraint l. This must be called after the equation numbers are 
+//! assigned. It is called when the matrix profile is built.
+void FELinearConstraintManager::BuildTransformation()
 {
 	FEMesh& mesh = m_fem->GetMesh();
 
+	int nlin = LinearConstraints();
+	m_Tp.assign(nlin + 1, 0);
+	for (int i = 0; i < nlin; ++i) m_Tp[i + 1] = m_Tp[i] + (int)m_LinC[i].slave.size();
+
+	int nnz = m_Tp[nlin];
+	m_Teq.resize(nnz);
+	m_Tv.resize(nnz);
+	for (int i = 0; i < nlin; ++i)
+	{
+		FELinearConstraint& lc = m_LinC[i];
+		int n0 = m_Tp[i];
+		for (int k = 0; k < (int)lc.slave.size(); ++k)
+		{
+			FELinearConstraint::DOF& sk = lc.slave[k];
+			m_Teq[n0 + k] = mesh.Node(sk.node).m_ID[sk.dof];
+			m_Tv [n0 + k] = sk.val;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Assemble the constrained part of the element matrix into the reduced global
+//! matrix. The constrained dofs are eliminated with the transformation operator,
+//! i.e. the contribution T^T*ke*T is scattered directly into the global matrix.
+//! This function is thread-safe: the matrix uses atomic updates and so do the 
+//! updates of the right-hand side. 
+void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<double>& R, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke)
+{
+	if (en.empty()) return;
+
 	int ndof = ke.rows();
 	int ndn = ndof / (int)en.size();
 	const int nodes = (int)en.size();
 
 	SparseMatrix& K = *(&G);
 
+	// find the constraint each of the element's dofs belongs to
+	const int MAXDOF = 256;
+	int lcbuf[MAXDOF];
+	vector<int> lcvec;
+	int* lc = lcbuf;
+	if (ndof > MAXDOF) { lcvec.resize(ndof); lc = &lcvec[0]; }
+
+	bool bconstrained = false;
+	for (int i = 0; i < ndof; ++i)
+	{
+		int nodei = i / ndn;
+		lc[i] = (nodei < nodes ? m_LCT(en[nodei], i%ndn) : -1);
+		if (lc[i] >= 0) bconstrained = true;
+	}
+	if (bconstrained == false) return;
+
 	// loop over all stiffness components 
 	// and correct for linear constraints
 	for (int i = 0; i<ndof; ++i)
 	{
-		int nodei = i / ndn;
-		int li = (nodei < nodes ? m_LCT(en[nodei], i%ndn) : -1);
+		int li = lc[i];
+
+		// the row of the transformation operator for dof i
+		int ni = 1, Ii = lmi[i];
+		const int* Ti = &Ii;
+		double one = 1.0;
+		const double* Tvi = &one;
+		if (li >= 0)
+		{
+			assert(lmi[i] == -1);
+			ni = m_Tp[li + 1] - m_Tp[li];
+			Ti = &m_Teq[m_Tp[li]];
+			Tvi = &m_Tv[m_Tp[li]];
+		}
+
 		for (int j = 0; j < ndof; ++j)
 		{
-			int nodej = j / ndn;
-			int lj = (nodej < nodes ? m_LCT(en[nodej], j%ndn) : -1);
-			if ((li >= 0) && (lj < 0))
-			{
-				// dof i is constrained
-				FELinearConstraint& Li = m_LinC[li];
+			int lj = lc[j];
 
-				assert(lmi[i] == -1);
+			// the unconstrained part was already assembled
+			if ((li < 0) && (lj < 0)) continue;
 
-				vector<FELinearConstraint::DOF>::iterator is = Li.slave.begin();
-				for (int k = 0; k < (int)Li.slave.size(); ++k, ++is)
-				{
-					int I = mesh.Node(is->node).m_ID[is->dof];
-					int J = lmj[j];
-					double kij = is->val*ke[i][j];
-					if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
-					else
-					{
-						// adjust for prescribed dofs
-						J = -J - 2;
-						if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
-					}
-				}
-			}
-			else if ((lj >= 0) && (li < 0))
-			{
-				// dof j is constrained
-				FELinearConstraint& Lj = m_LinC[lj];
+			double kij = ke[i][j];
+			if (kij == 0.0) continue;
 
+			// the column of the transformation operator for dof j
+			int nj = 1, Ij = lmj[j];
+			const int* Tj = &Ij;
+			const double* Tvj = &one;
+			if (lj >= 0)
+			{
 				assert(lmj[j] == -1);
+				nj = m_Tp[lj + 1] - m_Tp[lj];
+				Tj = &m_Teq[m_Tp[lj]];
+				Tvj = &m_Tv[m_Tp[lj]];
+			}
 
-				vector<FELinearConstraint::DOF>::iterator js = Lj.slave.begin();
+			for (int k = 0; k < ni; ++k)
+			{
+				int I = Ti[k];
+				if (I < 0) continue;
 
-				for (int k = 0; k < (int)Lj.slave.size(); ++k, ++js)
+				double ti = Tvi[k] * kij;
+				for (int l = 0; l < nj; ++l)
 				{
-					int I = lmi[i];
-					int J = mesh.Node(js->node).m_ID[js->dof];
-					double kij = js->val*ke[i][j];
-					if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
+					int J = Tj[l];
+					double v = ti * Tvj[l];
+					if (J >= 0) K.add(I, J, v);
 					else
 					{
 						// adjust for prescribed dofs
 						J = -J - 2;
-						if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
-					}
-				}
-
-				// adjust right-hand side for inhomogeneous linear constraints
-				if (Lj.m_off != 0.0)
-				{
-					double ri = ke[i][j] * m_up[lj];
-					int I = lmi[i];
-					if (I >= 0) R[i] -= ri;
-				}
-			}
-			else if ((li >= 0) && (lj >= 0))
-			{
-				// both dof i and j are constrained
-				FELinearConstraint& Li = m_LinC[li];
-				FELinearConstraint& Lj = m_LinC[lj];
-
-				vector<FELinearConstraint::DOF>::iterator is = Li.slave.begin();
-				vector<FELinearConstraint::DOF>::iterator js = Lj.slave.begin();
-
-				assert(lmi[i] == -1);
-				assert(lmj[j] == -1);
-
-				for (int k = 0; k < (int)Li.slave.size(); ++k, ++is)
-				{
-					js = Lj.slave.begin();
-					for (int l = 0; l < (int)Lj.slave.size(); ++l, ++js)
-					{
-						int I = mesh.Node(is->node).m_ID[is->dof];
-						int J = mesh.Node(js->node).m_ID[js->dof];;
-						double kij = ke[i][j] * is->val*js->val;
-
-						if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
-						else
+						if (J >= 0)
 						{
-							// adjust for prescribed dofs
-							J = -J - 2;
-							if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
+							#pragma omp atomic
+							R[I] -= v*ui[J];
 						}
 					}
 				}
 
-				// adjust for inhomogeneous linear constraints
-				if (Lj.m_off != 0.0)
+				// adjust right-hand side for inhomogeneous linear constraints
+				if ((lj >= 0) && (m_LinC[lj].m_off != 0.0))
 				{
-					is = Li.slave.begin();
-					for (int k = 0; k < (int)Li.slave.size(); ++k, ++is)
-					{
-						int I = mesh.Node(is->node).m_ID[is->dof];
-						double ri = is->val * ke[i][j] * m_up[lj];
-						if (I >= 0) R[i] -= ri;
-					}
+					#pragma omp atomic
+					R[I] -= ti * m_up[lj];
 				}
 			}
 		}
@@ -89,9 +89,17 @@ public:
 protected:
 	void InitTable();
 
+	// compile the constraints into the sparse transformation operator
+	void BuildTransformation();
+
 private:
 	FEModel* m_fem;
 	vector<FELinearConstraint>	m_LinC;		//!< linear constraints data
 	table<int>					m_LCT;		//!< linear constraint table
 	vector<double>				m_up;		//!< the inhomogenous component of the linear constraint
+
+	// sparse transformation operator (compressed row format, one row per constraint)
+	vector<int>		m_Tp;	//!< row pointers
+	vector<int>		m_Teq;	//!< equation numbers of slave dofs
+	vector<double>	m_Tv;	//!< slave coefficients
 };
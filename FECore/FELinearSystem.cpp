@@ -98,8 +98,7 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 		}
 	}
 
-#pragma omp critical
-	{
+	// adjust for linear constraints
 	FEModel* fem = m_solver->GetFEModel();
 	FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
 	if (LCM.LinearConstraints())
@@ -107,7 +106,6 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 		const vector<int>& en = ke.Nodes();
 		LCM.AssembleStiffness(m_K, m_F, m_u, en, lmi, lmj, ke);
 	}
-	} // omp critical
 }
 
 //-----------------------------------------------------------------------------
@@ -629,6 +629,9 @@ void FEMesh::ClearDomains()
 //! Rebuild the LUT
 void FEMesh::RebuildLUT()
 {
+	// the node-element list stores element pointers as well
+	m_NEL.Clear();
+
 	if (m_LUT) delete m_LUT;
 	m_LUT = new FEElementLUT(*this);
 }
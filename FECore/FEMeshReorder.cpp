@@ -0,0 +1,212 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEMeshReorder.h"
+#include "FEMesh.h"
+#include "FESolidDomain.h"
+#include "FESurface.h"
+#include <algorithm>
+#include <stdint.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// nr of bits per coordinate (3*21 = 63 bits fit in the 64-bit key)
+#define CURVE_BITS	21
+
+//-----------------------------------------------------------------------------
+// Interleave the bits of the three coordinates into one key.
+static uint64_t interleave(const unsigned int x[3])
+{
+	uint64_t key = 0;
+	for (int b = CURVE_BITS - 1; b >= 0; --b)
+		for (int i = 0; i < 3; ++i) key = (key << 1) | ((x[i] >> b) & 1);
+	return key;
+}
+
+//-----------------------------------------------------------------------------
+// Calculate the Hilbert index of a point with integer coordinates.
+// This uses Skilling's algorithm ("Programming the Hilbert curve", 2004) to 
+// convert the coordinates to the transposed Hilbert index, which is then interleaved.
+static uint64_t hilbert_key(unsigned int x[3])
+{
+	const unsigned int M = 1u << (CURVE_BITS - 1);
+
+	// inverse undo
+	for (unsigned int Q = M; Q > 1; Q >>= 1)
+	{
+		unsigned int P = Q - 1;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (x[i] & Q) x[0] ^= P;
+			else
+			{
+				unsigned int t = (x[0] ^ x[i]) & P;
+				x[0] ^= t;
+				x[i] ^= t;
+			}
+		}
+	}
+
+	// Gray encode
+	for (int i = 1; i < 3; ++i) x[i] ^= x[i - 1];
+	unsigned int t = 0;
+	for (unsigned int Q = M; Q > 1; Q >>= 1)
+		if (x[2] & Q) t ^= Q - 1;
+	for (int i = 0; i < 3; ++i) x[i] ^= t;
+
+	return interleave(x);
+}
+
+//-----------------------------------------------------------------------------
+FEMeshReorder::FEMeshReorder(int method) : m_method(method)
+{
+}
+
+//-----------------------------------------------------------------------------
+void FEMeshReorder::Sort(const vector<vec3d>& points, vector<int>& P) const
+{
+	int N = (int)points.size();
+	P.resize(N);
+	for (int i = 0; i < N; ++i) P[i] = i;
+	if ((N == 0) || (m_method == REORDER_NONE)) return;
+
+	// get the bounding box
+	vec3d r0 = points[0], r1 = points[0];
+	for (int i = 1; i < N; ++i)
+	{
+		const vec3d& r = points[i];
+		r0.x = std::min(r0.x, r.x); r1.x = std::max(r1.x, r.x);
+		r0.y = std::min(r0.y, r.y); r1.y = std::max(r1.y, r.y);
+		r0.z = std::min(r0.z, r.z); r1.z = std::max(r1.z, r.z);
+	}
+
+	// use the same scale in all directions so the curve is not distorted
+	double L = r1.x - r0.x;
+	if (r1.y - r0.y > L) L = r1.y - r0.y;
+	if (r1.z - r0.z > L) L = r1.z - r0.z;
+	const double maxCoord = (double)((1u << CURVE_BITS) - 1);
+	double s = (L > 0.0 ? maxCoord / L : 0.0);
+
+	// calculate the keys
+	vector< pair<uint64_t, int> > key(N);
+	#pragma omp parallel for
+	for (int i = 0; i < N; ++i)
+	{
+		const vec3d& r = points[i];
+		unsigned int x[3];
+		x[0] = (unsigned int)((r.x - r0.x)*s);
+		x[1] = (unsigned int)((r.y - r0.y)*s);
+		x[2] = (unsigned int)((r.z - r0.z)*s);
+
+		key[i].first = (m_method == REORDER_HILBERT ? hilbert_key(x) : interleave(x));
+		key[i].second = i;
+	}
+
+	// sort the keys (ties are broken by the original index)
+	sort(key.begin(), key.end());
+	for (int i = 0; i < N; ++i) P[i] = key[i].second;
+}
+
+//-----------------------------------------------------------------------------
+void FEMeshReorder::NodeOrder(FEMesh& mesh, vector<int>& P) const
+{
+	int NN = mesh.Nodes();
+	vector<vec3d> r(NN);
+	for (int i = 0; i < NN; ++i) r[i] = mesh.Node(i).m_r0;
+	Sort(r, P);
+}
+
+//-----------------------------------------------------------------------------
+int FEMeshReorder::ReorderElements(FEMesh& mesh) const
+{
+	if (m_method == REORDER_NONE) return 0;
+
+	// Some surfaces store pointers to their parent elements, which will be 
+	// invalidated. So we store the element IDs and find the elements again afterwards.
+	int NS = mesh.Surfaces();
+	vector< vector<int> > surfElem(NS);
+	for (int n = 0; n < NS; ++n)
+	{
+		FESurface& surf = mesh.Surface(n);
+		int NE = surf.Elements();
+		surfElem[n].assign(2*NE, -1);
+		for (int i = 0; i < NE; ++i)
+		{
+			FESurfaceElement& el = surf.Element(i);
+			for (int k = 0; k < 2; ++k)
+				if (el.m_elem[k]) surfElem[n][2*i + k] = el.m_elem[k]->GetID();
+		}
+	}
+
+	int ndom = 0;
+	for (int n = 0; n < mesh.Domains(); ++n)
+	{
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(&mesh.Domain(n));
+		if ((dom == nullptr) || (dom->Elements() < 2)) continue;
+
+		// calculate the element centroids in the reference configuration
+		int NE = dom->Elements();
+		vector<vec3d> c(NE);
+		for (int i = 0; i < NE; ++i)
+		{
+			FESolidElement& el = dom->Element(i);
+			int ne = el.Nodes();
+			vec3d r(0, 0, 0);
+			for (int j = 0; j < ne; ++j) r += mesh.Node(el.m_node[j]).m_r0;
+			c[i] = r / (double)ne;
+		}
+
+		vector<int> P;
+		Sort(c, P);
+		dom->Permute(P);
+		ndom++;
+	}
+	if (ndom == 0) return 0;
+
+	// the element lookup tables store element pointers, so they need to be rebuilt
+	mesh.RebuildLUT();
+
+	for (int n = 0; n < NS; ++n)
+	{
+		FESurface& surf = mesh.Surface(n);
+		int NE = surf.Elements();
+		for (int i = 0; i < NE; ++i)
+		{
+			FESurfaceElement& el = surf.Element(i);
+			for (int k = 0; k < 2; ++k)
+			{
+				int id = surfElem[n][2*i + k];
+				if (id >= 0) el.m_elem[k] = mesh.FindElementFromID(id);
+			}
+		}
+	}
+
+	return ndom;
+}
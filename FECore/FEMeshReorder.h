@@ -0,0 +1,68 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "vec3d.h"
+#include <vector>
+
+class FEMesh;
+
+//-----------------------------------------------------------------------------
+//! This class calculates locality-improving orderings of the mesh nodes and
+//! elements. Items are sorted along a space-filling curve (Hilbert or Morton)
+//! through their reference positions, so that items that are close in space
+//! are also close in memory and in the equation numbering.
+//! Node and element IDs are never changed, so the output is not affected.
+class FECORE_API FEMeshReorder
+{
+public:
+	enum ReorderMethod {
+		REORDER_NONE,
+		REORDER_HILBERT,
+		REORDER_MORTON
+	};
+
+public:
+	FEMeshReorder(int method = REORDER_HILBERT);
+
+	//! Calculate the permutation that sorts the points along the curve.
+	//! On return, P[i] is the index of the point at position i.
+	void Sort(const std::vector<vec3d>& points, std::vector<int>& P) const;
+
+	//! Calculate a node permutation (same convention as FENodeReorder::Apply)
+	void NodeOrder(FEMesh& mesh, std::vector<int>& P) const;
+
+	//! Reorder the elements of all solid domains along the curve through
+	//! the element centroids. This must be done before the model is initialized.
+	//! Returns the number of domains that were reordered.
+	int ReorderElements(FEMesh& mesh) const;
+
+private:
+	int	m_method;
+};
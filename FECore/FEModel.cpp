@@ -57,6 +57,8 @@ SOFTWARE.*/
 #include "LinearSolver.h"
 #include "FETimeStepController.h"
 #include "Timer.h"
+#include "FETelemetry.h"
+#include "FEMeshReorder.h"
 #include <stdarg.h>
 using namespace std;
 
@@ -139,6 +141,7 @@ public:
 
 	std::vector<LoadParam>		m_Param;	//!< list of parameters controller by load controllers
 	std::vector<Timer>			m_timers;	// list of timers
+	FETelemetry					m_telemetry;	// convergence telemetry
 
 public:
 	FEAnalysis*		m_pStep;	//!< pointer to current analysis step
@@ -446,6 +449,10 @@ bool FEModel::Init()
 		if (pd->Init() == false) return false;
 	}
 */
+	// reorder the elements for better memory locality
+	// NOTE: This must be done before anything stores element pointers or local element indices.
+	if (ReorderMesh() == false) return false;
+
 	// check step data
 	for (int i = 0; i<(int)m_imp->m_Step.size(); ++i)
 	{
@@ -822,6 +829,21 @@ bool FEModel::InitModelLoads()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! Reorders the elements of the solid domains along a space-filling curve, if 
+//! requested by the solver of the first step. 
+bool FEModel::ReorderMesh()
+{
+	FESolver* solver = m_imp->m_Step[0]->GetFESolver();
+	if ((solver == nullptr) || (solver->m_reorder == FEMeshReorder::REORDER_NONE)) return true;
+
+	FEMeshReorder mod(solver->m_reorder);
+	int ndom = mod.ReorderElements(GetMesh());
+	feLog("Reordered elements of %d solid domain(s) for memory locality.\n", ndom);
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! Does one-time initialization of the Mesh data. Call FEMesh::Reset for resetting 
 //! the mesh data.
@@ -1924,6 +1946,12 @@ Timer* FEModel::GetTimer(int i)
 	return &(m_imp->m_timers[i]);
 }
 
+//-----------------------------------------------------------------------------
+FETelemetry& FEModel::GetTelemetry()
+{
+	return m_imp->m_telemetry;
+}
+
 //-----------------------------------------------------------------------------
 //! return number of mesh adaptors
 int FEModel::MeshAdaptors()
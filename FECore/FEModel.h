@@ -57,6 +57,7 @@ class FEModelData;
 class FEDataArray;
 class FEMeshAdaptor;
 class Timer;
+class FETelemetry;
 
 //-----------------------------------------------------------------------------
 // struct that breaks down memory usage of FEModel
@@ -135,6 +136,9 @@ public:
 	//! Initialize the mesh
 	bool InitMesh();
 
+	//! Reorder the mesh elements for memory locality (see FESolver::m_reorder)
+	bool ReorderMesh();
+
 	//! Initialize shells
 	virtual void InitShells();
 
@@ -416,6 +420,9 @@ public:
 	// return a timer by index
 	Timer* GetTimer(int i);
 
+	// return the convergence telemetry stream
+	FETelemetry& GetTelemetry();
+
 protected:
 	FEParamValue GetMeshParameter(const ParamString& paramString);
 
@@ -28,6 +28,8 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FENewtonSolver.h"
+#include "FEPODBasis.h"
+#include "FEReducedOrderSolver.h"
 #include "FEModel.h"
 #include "FEGlobalMatrix.h"
 #include "LinearSolver.h"
@@ -39,6 +41,7 @@ SOFTWARE.*/
 #include "FEDomain.h"
 #include "DumpStream.h"
 #include "FELinearSystem.h"
+#include "FETelemetry.h"
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -59,8 +62,16 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 	ADD_PARAMETER(m_Rmin, FE_RANGE_GREATER_OR_EQUAL(0.0), "min_residual");
 	ADD_PARAMETER(m_Rmax, FE_RANGE_GREATER_OR_EQUAL(0.0), "max_residual");
 
+	// reduced-order model parameters
+	ADD_PARAMETER(m_romMode             , "rom_mode", 0, "off\0train\0reduced\0");
+	ADD_PARAMETER(m_romFile             , "rom_snapshots");
+	ADD_PARAMETER(m_romTol              , FE_RANGE_GREATER(0.0), "rom_tol");
+	ADD_PARAMETER(m_romEnergy           , FE_RANGE_LEFT_OPEN(0.0, 1.0), "rom_energy");
+	ADD_PARAMETER(m_romMaxModes         , FE_RANGE_GREATER(0), "rom_max_modes");
+	ADD_PARAMETER(m_romAppend           , "rom_append");
+
 	// obsolete parameters (Should be set via the qn_method)
-	ADD_PARAMETER(m_qndefault           , "qnmethod", 0, "BFGS\0BROYDEN\0JFNK\0");
+	ADD_PARAMETER(m_qndefault           , "qnmethod", 0, "BFGS\0BROYDEN\0JFNK\0ANDERSON\0");
 	ADD_PARAMETER(m_maxups              , FE_RANGE_GREATER_OR_EQUAL(0.0), "max_ups" );
 	ADD_PARAMETER(m_max_buf_size        , FE_RANGE_GREATER_OR_EQUAL(0), "qn_max_buffer_size");
 	ADD_PARAMETER(m_cycle_buffer        , "qn_cycle_buffer");
@@ -79,6 +90,12 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_maxref = 15;
 
 	m_nref = 0;
+	m_nlsiter = 0;
+	m_nwsalloc = 0;
+	m_nwsallocLog = 0;
+	m_tlmLinIters = 0;
+	m_tlmRefs = 0;
+	m_tlmAllocs = 0;
 
     m_neq = 0;
     m_plinsolve = 0;
@@ -89,6 +106,12 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_Rmin = 1.0e-20;
 	m_Rmax = 0;     // not used if zero
 
+	m_romMode = ROM_OFF;
+	m_romTol = 0.05;
+	m_romEnergy = 0.99999;
+	m_romMaxModes = 50;
+	m_romAppend = false;
+
 	m_cmax   = 1e5;
 	m_maxups = 10;
 	m_max_buf_size = 0;
@@ -287,6 +310,12 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 			feLog("\tNr of equations ........................... : %d\n", neq);
 			feLog("\tNr of nonzeroes in stiffness matrix ....... : %d\n", nnz);
 
+			size_t qnmem = m_qnstrategy->UpdateMemory();
+			if (qnmem > 0)
+			{
+				feLog("\tMemory per stiffness update (MB) .......... : %lg\n", qnmem / (1024.0*1024.0));
+			}
+
 			int parts = m_plinsolve->Partitions();
 			if (parts > 1)
 			{
@@ -358,6 +387,32 @@ bool FENewtonSolver::AllocateLinearSystem()
 		}
 	}
 
+	// in reduced-order mode, we wrap the linear solver so that the Newton system
+	// is projected onto the POD basis that was created from the training snapshots.
+	// The basis is rebuilt when the number of equations has changed since it was created.
+	FEReducedOrderSolver* prom = dynamic_cast<FEReducedOrderSolver*>(m_plinsolve);
+	if (prom && (prom->Equations() != m_neq))
+	{
+		m_plinsolve = prom->ReleaseFullSolver();
+		delete prom;
+		prom = nullptr;
+	}
+	if ((m_romMode == ROM_REDUCED) && (prom == nullptr))
+	{
+		FEPODBasis basis;
+		if (basis.Create(m_romFile.c_str(), m_neq, m_romEnergy, m_romMaxModes))
+		{
+			FEReducedOrderSolver* rom = new FEReducedOrderSolver(GetFEModel(), m_plinsolve, basis);
+			rom->SetTolerance(m_romTol);
+			m_plinsolve = rom;
+			feLog("Reduced-order model: %d modes from %d snapshots (energy = %lg)\n", basis.Modes(), basis.Snapshots(), basis.Energy());
+		}
+		else
+		{
+			feLogWarning("Failed to create reduced-order basis from snapshot file \"%s\".\nThe full model will be solved.", m_romFile.c_str());
+		}
+	}
+
 	Matrix_Type mtype = MatrixType();
 	SparseMatrix* pS = m_qnstrategy->CreateSparseMatrix(mtype);
 	if ((pS == 0) && (m_msymm == REAL_SYMMETRIC))
@@ -408,6 +463,7 @@ bool FENewtonSolver::Init()
 		case QN_BFGS   : SetSolutionStrategy(fecore_new<FENewtonStrategy>("BFGS"   , GetFEModel())); break;
 		case QN_BROYDEN: SetSolutionStrategy(fecore_new<FENewtonStrategy>("Broyden", GetFEModel())); break;
 		case QN_JFNK   : SetSolutionStrategy(fecore_new<FENewtonStrategy>("JFNK"   , GetFEModel())); break;
+		case QN_ANDERSON: SetSolutionStrategy(fecore_new<FENewtonStrategy>("Anderson", GetFEModel())); break;
 		default:
 			feLogError("Invalid quasi-Newton option (%d)", m_qndefault);
 			return false;
@@ -437,6 +493,20 @@ bool FENewtonSolver::Init()
 	// we let the linear solver allocate the correct type of matrix format
 	if (AllocateLinearSystem() == false) return false;
 
+	// in training mode, a new run starts a new snapshot file
+	if ((m_romMode == ROM_TRAIN) && (m_romAppend == false))
+	{
+		FEModel& fem = *GetFEModel();
+		FEAnalysis* step = fem.GetCurrentStep();
+		if ((fem.GetCurrentStepIndex() == 0) && step && (step->m_ntimesteps == 0))
+		{
+			if (FEPODBasis::ClearSnapshots(m_romFile.c_str()) == false)
+			{
+				feLogWarning("Failed to clear snapshot file \"%s\".", m_romFile.c_str());
+			}
+		}
+	}
+
 	// Base class initialization and validation
 	if (FESolver::Init() == false) return false;
 
@@ -510,6 +580,10 @@ bool FENewtonSolver::SolveStep()
 	m_ntotref = 0;
 	m_naug = 0;		// nr of augmentations
 
+	// store the solution at the start of the time step so that we can
+	// extract the solution increment of this step as a snapshot
+	if (m_romMode == ROM_TRAIN) m_romU0 = m_Ut;
+
 	try
 	{
 		// let's try to call Quasin
@@ -584,6 +658,26 @@ bool FENewtonSolver::SolveStep()
 		feLog("\nconvergence summary\n");
 		feLog("    number of iterations   : %d\n", m_niter);
 		feLog("    number of reformations : %d\n", m_nref);
+
+		// reduced-order model
+		if (m_romMode == ROM_TRAIN)
+		{
+			// store the converged solution increment as a snapshot
+			vector<double> dU(m_Ut);
+			if (m_romU0.size() == dU.size())
+			{
+				for (size_t i = 0; i < dU.size(); ++i) dU[i] -= m_romU0[i];
+			}
+			if (FEPODBasis::AppendSnapshot(m_romFile.c_str(), dU) == false)
+			{
+				feLogWarning("Failed to write snapshot to \"%s\".", m_romFile.c_str());
+			}
+		}
+		else if (m_romMode == ROM_REDUCED)
+		{
+			FEReducedOrderSolver* rom = dynamic_cast<FEReducedOrderSolver*>(m_plinsolve);
+			if (rom) rom->PrintSummary();
+		}
 	}
 
 	return bret;
@@ -626,6 +720,8 @@ bool FENewtonSolver::Quasin()
 		feLog("\tstiffness updates             = %d\n", m_qnstrategy->m_nups);
 		feLog("\tright hand side evaluations   = %d\n", m_nrhs);
 		feLog("\tstiffness matrix reformations = %d\n", m_nref);
+		LogLinearSolverIterations();
+		LogElementWorkspaceAllocations();
 		if (m_lineSearch->m_LStol > 0) feLog("\tstep from line search         = %lf\n", ls);
 
 		// check convergence
@@ -755,6 +851,19 @@ bool FENewtonSolver::CheckConvergence(int niter, const vector<double>& ui, doubl
 		bconv = true;
 	}
 
+	// write the convergence telemetry
+	if (GetFEModel()->GetTelemetry().IsOpen())
+	{
+		AddTelemetryNorm("residual", m_residuNorm.norm0, m_residuNorm.norm, m_Rtol*m_residuNorm.norm0);
+		AddTelemetryNorm("energy", m_energyNorm.norm0, m_energyNorm.norm, m_Etol*m_energyNorm.norm0);
+		for (int i = 0; i < vars; ++i)
+		{
+			ConvergenceInfo& c = m_solutionNorm[i];
+			AddTelemetryNorm(m_Var[c.nvar].m_szname, c.norm0, c.normi, (c.tol*c.tol)*c.norm);
+		}
+		WriteIterationTelemetry(ls, bconv);
+	}
+
 	// see if we have exceeded the max residual
 	if ((bconv == false) && (m_Rmax > 0) && (m_residuNorm.norm >= m_Rmax))
 	{
@@ -776,6 +885,106 @@ void FENewtonSolver::SolveLinearSystem(vector<double>& x, vector<double>& R)
 		throw LinearSolverFailed();
 }
 
+//-----------------------------------------------------------------------------
+//! Print the nr of iterations the linear solver needed since the last call.
+//! This is only done for iterative solvers.
+void FENewtonSolver::LogLinearSolverIterations()
+{
+	if ((m_plinsolve == nullptr) || (m_plinsolve->IsIterative() == false)) return;
+
+	int niter = m_plinsolve->GetStats().iterations;
+	if (niter < m_nlsiter) m_nlsiter = 0;
+	feLog("\tlinear solver iterations      = %d\n", niter - m_nlsiter);
+	m_nlsiter = niter;
+}
+
+//-----------------------------------------------------------------------------
+//! Print the nr of times the element workspaces had to allocate memory since the last call.
+//! Once all element types have been processed this should stay at zero.
+void FENewtonSolver::LogElementWorkspaceAllocations()
+{
+	int nalloc = ElementWorkspaceAllocations();
+	feLog("\telement workspace allocations = %d\n", nalloc - m_nwsallocLog);
+	m_nwsallocLog = nalloc;
+}
+
+//-----------------------------------------------------------------------------
+//! Add the allocation counters of the domains' element workspaces to the running total
+//! and reset them. Returns the total nr of allocations so far.
+int FENewtonSolver::ElementWorkspaceAllocations()
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEElementWorkspacePool& ws = mesh.Domain(i).ElementWorkspaces();
+		m_nwsalloc += ws.TotalAllocations();
+		ws.ResetAllocations();
+	}
+	return m_nwsalloc;
+}
+
+//-----------------------------------------------------------------------------
+void FENewtonSolver::AddTelemetryNorm(const char* szname, double norm0, double norm, double required)
+{
+	TelemetryNorm n;
+	n.name = szname;
+	n.norm[0] = norm0;
+	n.norm[1] = norm;
+	n.norm[2] = required;
+	m_tlmNorms.push_back(n);
+}
+
+//-----------------------------------------------------------------------------
+//! Write a telemetry record for the current Newton iteration. Besides the convergence
+//! norms that were added with AddTelemetryNorm, this records whether the stiffness matrix 
+//! was reformed, the linear solver iterations, the element workspace allocations and the 
+//! time spent in each of the model's timers since the last record.
+void FENewtonSolver::WriteIterationTelemetry(double ls, bool bconv)
+{
+	FEModel& fem = *GetFEModel();
+	FETelemetry& tlm = fem.GetTelemetry();
+	if (tlm.IsOpen() == false) { m_tlmNorms.clear(); return; }
+
+	const FETimeInfo& tp = fem.GetTime();
+	FEAnalysis* step = fem.GetCurrentStep();
+
+	// the counters are reset at the start of each time step, or when the linear solver is recreated
+	bool breformed = (m_ntotref < m_tlmRefs ? (m_ntotref > 0) : (m_ntotref > m_tlmRefs));
+	m_tlmRefs = m_ntotref;
+
+	int nlsiter = 0;
+	if (m_plinsolve)
+	{
+		int n = m_plinsolve->GetStats().iterations;
+		nlsiter = (n < m_tlmLinIters ? n : n - m_tlmLinIters);
+		m_tlmLinIters = n;
+	}
+
+	int nalloc = ElementWorkspaceAllocations();
+	int nwsalloc = nalloc - m_tlmAllocs;
+	m_tlmAllocs = nalloc;
+
+	tlm.BeginRecord("iteration");
+	tlm.Write("step", fem.GetCurrentStepIndex() + 1);
+	tlm.Write("time_step", (step ? step->m_ntimesteps + 1 : 0));
+	tlm.Write("time", tp.currentTime);
+	tlm.Write("dt", tp.timeIncrement);
+	tlm.Write("iter", m_niter + 1);
+	tlm.Write("rhs", m_nrhs);
+	tlm.Write("reformed", breformed);
+	tlm.Write("ls", ls);
+	tlm.Write("converged", bconv);
+	tlm.BeginObject("norms");
+	for (size_t i = 0; i < m_tlmNorms.size(); ++i) tlm.Write(m_tlmNorms[i].name, m_tlmNorms[i].norm, 3);
+	tlm.EndObject();
+	tlm.Write("linear_iters", nlsiter);
+	tlm.Write("allocations", nwsalloc);
+	tlm.WriteTimerDeltas(fem);
+	tlm.EndRecord();
+
+	m_tlmNorms.clear();
+}
+
 //-----------------------------------------------------------------------------
 //! rewind solver
 //! This is called when the time step failed.
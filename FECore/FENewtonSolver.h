@@ -43,7 +43,17 @@ enum QN_STRATEGY
 {
 	QN_BFGS,
 	QN_BROYDEN,
-	QN_JFNK
+	QN_JFNK,
+	QN_ANDERSON
+};
+
+//-----------------------------------------------------------------------------
+//! reduced-order model modes
+enum ROM_MODE
+{
+	ROM_OFF,		//!< solve the full model
+	ROM_TRAIN,		//!< solve the full model and store solution snapshots
+	ROM_REDUCED		//!< solve the model projected onto the POD basis of the snapshots
 };
 
 //-----------------------------------------------------------------------------
@@ -169,6 +179,22 @@ public:
 	//! solve the linear system of equations
 	void SolveLinearSystem(vector<double>& x, vector<double>& R);
 
+	//! print the nr of linear solver iterations since the last call (iterative solvers only)
+	void LogLinearSolverIterations();
+
+	//! print the nr of element workspace allocations since the last call
+	void LogElementWorkspaceAllocations();
+
+	//! collect the allocations of the domains' element workspaces and return the total so far
+	int ElementWorkspaceAllocations();
+
+	//! Add a convergence norm to the telemetry record of the current iteration.
+	//! The name must remain valid until the record is written.
+	void AddTelemetryNorm(const char* szname, double norm0, double norm, double required);
+
+	//! Write the telemetry record of the current iteration (does nothing when telemetry is off)
+	void WriteIterationTelemetry(double ls, bool bconv);
+
 	//! Do a Quasi-Newton step
 	//! This is called from SolveStep.
 	virtual bool Quasin();
@@ -232,11 +258,34 @@ public:
 
 	// counters
 	int		m_nref;			//!< nr of stiffness retormations
+	int		m_nlsiter;		//!< linear solver iterations at last report
+	int		m_nwsalloc;		//!< total element workspace allocations
+	int		m_nwsallocLog;	//!< element workspace allocations at last report
+
+	// convergence telemetry
+	struct TelemetryNorm
+	{
+		const char*	name;
+		double		norm[3];	// initial, current, required
+	};
+	vector<TelemetryNorm>	m_tlmNorms;		//!< norms of the current iteration
+	int		m_tlmLinIters;	//!< linear solver iterations at last telemetry record
+	int		m_tlmRefs;		//!< total reformations at last telemetry record
+	int		m_tlmAllocs;	//!< element workspace allocations at last telemetry record
 
 	// Error handling
 	bool	m_bzero_diagonal;	//!< check for zero diagonals
 	double	m_zero_tol;			//!< tolerance for zero diagonal
 
+	// reduced-order model
+	int			m_romMode;		//!< reduced-order mode (see ROM_MODE)
+	std::string	m_romFile;		//!< snapshot file
+	double		m_romTol;		//!< tolerance on the relative residual of the reduced solution
+	double		m_romEnergy;	//!< energy fraction retained by the POD basis
+	int			m_romMaxModes;	//!< max nr of POD modes
+	bool		m_romAppend;	//!< append snapshots to an existing snapshot file (training mode)
+	vector<double>	m_romU0;	//!< total solution at start of time step (training mode)
+
 	// linear solver data
 	LinearSolver*		m_plinsolve;	//!< the linear solver
 	FEGlobalMatrix*		m_pK;			//!< global stiffness matrix
@@ -25,13 +25,14 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 
 
-
 #include "stdafx.h"
 #include "FENodeNodeList.h"
 #include "FENodeElemList.h"
 #include "FEMesh.h"
 #include "FEDomain.h"
-#include <stdlib.h>
+#include "sys.h"
+#include <algorithm>
+using namespace std;
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -47,215 +48,122 @@ FENodeNodeList::~FENodeNodeList()
 
 }
 
-FENodeNodeList* FENodeNodeList::m_pthis = 0;
-
 //////////////////////////////////////////////////////////////////////
 // FENodeNodeList
 //////////////////////////////////////////////////////////////////////
 
 void FENodeNodeList::Create(FEMesh& mesh)
 {
-	int i, j, k, n, m;
-
-	// get the nr of nodes
-	int NN = mesh.Nodes();
-
 	// create the node-element list
 	FENodeElemList EL; 
 	EL.Create(mesh);
 
-	// create the nodal tag array
-	vector<int> tag; tag.assign(NN, 0);
+	Create(EL, mesh.Nodes());
+}
 
-	// calculate nodal valences
-	m_nval.assign(NN, 0);
-	m_pn.resize(NN);
+//-----------------------------------------------------------------------------
+void FENodeNodeList::Create(FEDomain& dom)
+{
+	// create the node-element list
+	FENodeElemList EL; 
+	EL.Create(dom);
 
-	int nsize = 0;
-	int* en;
-	vector<int> buf(NN);
-	int nb;
-	for (i=0; i<NN; ++i)
+	Create(EL, dom.GetMesh()->Nodes());
+}
+
+//-----------------------------------------------------------------------------
+// Collect the nodes adjacent to node i, in the order in which they are first found.
+// The tag array marks the nodes that were already collected. It must be zero on
+// entry, and is reset before returning.
+static int adjacent_nodes(FENodeElemList& EL, int i, vector<char>& tag, vector<int>& buf)
+{
+	int nb = 0;
+	int n = EL.Valence(i);
+	FEElement** pe = EL.ElementList(i);
+	for (int j=0; j<n; ++j)
 	{
-		nb = 0;
-		n = EL.Valence(i);
-		FEElement** pe = EL.ElementList(i);
-		for (j=0; j<n; ++j)
+		FEElement* pel = pe[j];
+		int m = pel->Nodes();
+		int* en = &pel->m_node[0];
+		for (int k=0; k<m; ++k)
 		{
-			FEElement* pel = pe[j];
-			m = pel->Nodes();
-			en = &pel->m_node[0];
-			for (k=0; k<m; ++k)
-				if ((en[k] != i) && (tag[ en[k] ] == 0))
-				{
-					++m_nval[i];
-					++tag[en[k]];
-					buf[nb++] = en[k];
-					++nsize;
-				}
+			int nk = en[k];
+			if ((nk != i) && (tag[nk] == 0))
+			{
+				tag[nk] = 1;
+				if (nb == (int)buf.size()) buf.resize(2*nb + 32);
+				buf[nb++] = nk;
+			}
 		}
-
-		// clear the tag array
-		for (j=0; j<nb; ++j) tag[ buf[j] ] = 0;
-		nb = 0;
 	}
 
-	// create the node reference array
-	m_nref.resize(nsize);
-
-	// set nref pointers
-	m_pn[0] = 0;
-	for (i=1; i<NN; ++i)
-	{
-		m_pn[i] = m_pn[i-1] + m_nval[i-1];
-	}
-
-	// reset valence pointers
-	for (i=0; i<NN; ++i) m_nval[i] = 0;
-
-	// fill the nref pointers
-	for (i=0; i<NN; ++i)
-	{
-		nb = 0;
-		n = EL.Valence(i);
-		FEElement** pe = EL.ElementList(i);
-		for (j=0; j<n; ++j)
-		{
-			FEElement* pel = pe[j];
-			m = pel->Nodes();
-			en = &pel->m_node[0];
-			for (k=0; k<m; ++k)
-				if ((en[k] != i) && (tag[ en[k] ] == 0))
-				{
-					m_nref[m_pn[i] + m_nval[i]] = en[k];	
-
-					++tag[en[k]];
-					++m_nval[i];
-					buf[nb++] = en[k];
-					++nsize;
-				}
-		}
+	// clear the tag array
+	for (int j=0; j<nb; ++j) tag[buf[j]] = 0;
 
-		// clear the tag array
-		for (j=0; j<nb; ++j) tag[ buf[j] ] = 0;
-		nb = 0;
-	}
+	return nb;
 }
 
 //-----------------------------------------------------------------------------
-void FENodeNodeList::Create(FEDomain& dom)
+// The nodes are split in blocks that are processed in parallel. Each block collects 
+// its adjacency lists in a separate buffer, which are then copied into the CSR arrays.
+// Each thread uses its own tag array to remove the duplicates.
+void FENodeNodeList::Create(FENodeElemList& EL, int NN)
 {
-	int i, j, k, n, m;
-
-	// get the mesh
-	FEMesh& mesh = *dom.GetMesh();
-
-	// get the nr of nodes
-	int NN = mesh.Nodes();
-
-	// create the node-element list
-	FENodeElemList EL; 
-	EL.Create(dom);
-
-	// create the nodal tag array
-	vector<int> tag; tag.assign(NN, 0);
-
-	// calculate nodal valences
 	m_nval.assign(NN, 0);
 	m_pn.resize(NN);
 
-	int nsize = 0;
-	int* en;
-	vector<int> buf(NN);
-	int nb;
-	for (i=0; i<NN; ++i)
+	const int nt = omp_get_max_threads();
+	vector<int> start(nt + 1);
+	for (int t = 0; t <= nt; ++t) start[t] = (int)(((long long)NN * t) / nt);
+	vector< vector<int> > blockList(nt);
+
+#pragma omp parallel num_threads(nt)
 	{
-		nb = 0;
-		n = EL.Valence(i);
-		FEElement** pe = EL.ElementList(i);
-		for (j=0; j<n; ++j)
+		vector<int> buf(64);
+		vector<char> tag(NN, 0);
+		for (int t = omp_get_thread_num(); t < nt; t += omp_get_num_threads())
 		{
-			FEElement* pel = pe[j];
-			m = pel->Nodes();
-			en = &pel->m_node[0];
-			for (k=0; k<m; ++k)
-				if ((en[k] != i) && (tag[ en[k] ] == 0))
-				{
-					++m_nval[i];
-					++tag[en[k]];
-					buf[nb++] = en[k];
-					++nsize;
-				}
+			vector<int>& L = blockList[t];
+			for (int i = start[t]; i < start[t + 1]; ++i)
+			{
+				int nb = adjacent_nodes(EL, i, tag, buf);
+				m_nval[i] = nb;
+				L.insert(L.end(), buf.begin(), buf.begin() + nb);
+			}
 		}
-
-		// clear the tag array
-		for (j=0; j<nb; ++j) tag[ buf[j] ] = 0;
-		nb = 0;
 	}
 
-	// create the node reference array
-	m_nref.resize(nsize);
-
 	// set nref pointers
-	m_pn[0] = 0;
-	for (i=1; i<NN; ++i)
+	int nsize = 0;
+	for (int i=0; i<NN; ++i)
 	{
-		m_pn[i] = m_pn[i-1] + m_nval[i-1];
+		m_pn[i] = nsize;
+		nsize += m_nval[i];
 	}
 
-	// reset valence pointers
-	for (i=0; i<NN; ++i) m_nval[i] = 0;
-
-	// fill the nref pointers
-	for (i=0; i<NN; ++i)
+	// copy the blocks into the node reference array
+	m_nref.resize(nsize);
+#pragma omp parallel for schedule(static, 1) num_threads(nt)
+	for (int t = 0; t < nt; ++t)
 	{
-		nb = 0;
-		n = EL.Valence(i);
-		FEElement** pe = EL.ElementList(i);
-		for (j=0; j<n; ++j)
-		{
-			FEElement* pel = pe[j];
-			m = pel->Nodes();
-			en = &pel->m_node[0];
-			for (k=0; k<m; ++k)
-				if ((en[k] != i) && (tag[ en[k] ] == 0))
-				{
-					m_nref[m_pn[i] + m_nval[i]] = en[k];	
-
-					++tag[en[k]];
-					++m_nval[i];
-					buf[nb++] = en[k];
-					++nsize;
-				}
-		}
-
-		// clear the tag array
-		for (j=0; j<nb; ++j) tag[ buf[j] ] = 0;
-		nb = 0;
+		if (start[t] < start[t + 1])
+			copy(blockList[t].begin(), blockList[t].end(), m_nref.begin() + m_pn[start[t]]);
 	}
 }
 
-
 ///////////////////////////////////////////////////////////////////////////////
 
-int FENodeNodeList::compare(const void* e1, const void* e2)
-{
-	int n1 = *((int*) e1);
-	int n2 = *((int*) e2);
-
-	FENodeNodeList& L = *m_pthis;
-
-	return (L.Valence(n1) - L.Valence(n2));
-}
-
+//-----------------------------------------------------------------------------
+// Sort the adjacent nodes of each node by their valence. The sort is stable,
+// so nodes with the same valence remain in the order in which they were found.
 void FENodeNodeList::Sort()
 {
-	int n, *pn;
-	m_pthis = this;
-	for (int i=0; i<Size(); ++i)
+	const int NN = Size();
+	const vector<int>& val = m_nval;
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (int i=0; i<NN; ++i)
 	{
-		n = Valence(i);
-		pn = NodeList(i);
-		qsort(pn, n, sizeof(int), compare);
+		int* pn = NodeList(i);
+		stable_sort(pn, pn + Valence(i), [&val](int a, int b) { return val[a] < val[b]; });
 	}
 }
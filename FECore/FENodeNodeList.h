@@ -32,6 +32,7 @@ SOFTWARE.*/
 
 class FEMesh;
 class FEDomain;
+class FENodeElemList;
 
 //-----------------------------------------------------------------------------
 //! The FENodeNodeList class is a utility class that determines for each node 
@@ -62,11 +63,12 @@ public:
 
 	void Sort();
 
+protected:
+	//! build the list from a node-element list
+	void Create(FENodeElemList& EL, int NN);
+
 protected:
 	std::vector<int>	m_nval;	// nodal valences
 	std::vector<int>	m_nref;	// adjacent nodes indices
 	std::vector<int>	m_pn;	// start index into the nref array
-
-	static FENodeNodeList*	m_pthis;
-	static int compare(const void* e1, const void* e2);
 };
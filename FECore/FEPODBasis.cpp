@@ -0,0 +1,163 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEPODBasis.h"
+#include "matrix.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// defined in svd.cpp
+void svdcmp(matrix& a, vector<double>& w, matrix& v);
+
+//-----------------------------------------------------------------------------
+FEPODBasis::FEPODBasis()
+{
+	m_nsnap = 0;
+	m_energy = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+//! Each snapshot is stored as the number of entries followed by the values.
+bool FEPODBasis::AppendSnapshot(const char* szfile, const vector<double>& u)
+{
+	FILE* fp = fopen(szfile, "ab");
+	if (fp == nullptr) return false;
+
+	int neq = (int)u.size();
+	bool bok = (fwrite(&neq, sizeof(int), 1, fp) == 1);
+	if (bok && (neq > 0)) bok = (fwrite(&u[0], sizeof(double), neq, fp) == (size_t) neq);
+
+	fclose(fp);
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool FEPODBasis::ClearSnapshots(const char* szfile)
+{
+	FILE* fp = fopen(szfile, "wb");
+	if (fp == nullptr) return false;
+	fclose(fp);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEPODBasis::Create(const char* szfile, int neq, double energy, int maxModes)
+{
+	m_V.clear();
+	m_nsnap = 0;
+	m_energy = 0.0;
+
+	// read the snapshots
+	// (snapshots of a different size are skipped)
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+
+	vector< vector<double> > S;
+	int n = 0;
+	while (fread(&n, sizeof(int), 1, fp) == 1)
+	{
+		if (n < 0) break;
+		vector<double> s(n);
+		if ((n > 0) && (fread(&s[0], sizeof(double), n, fp) != (size_t) n)) break;
+		if (n == neq) S.push_back(s);
+	}
+	fclose(fp);
+
+	int ns = (int)S.size();
+	if (ns == 0) return false;
+	m_nsnap = ns;
+
+	// correlation matrix of the snapshots
+	matrix G(ns, ns);
+	for (int i = 0; i < ns; ++i)
+		for (int j = i; j < ns; ++j)
+		{
+			double gij = 0.0;
+			for (int k = 0; k < neq; ++k) gij += S[i][k] * S[j][k];
+			G[i][j] = G[j][i] = gij;
+		}
+
+	// Since G is symmetric positive semi-definite, its singular value decomposition
+	// gives the eigenvalues (w) and eigenvectors (columns of G).
+	vector<double> w(ns);
+	matrix V(ns, ns);
+	svdcmp(G, w, V);
+
+	// sort the eigenvalues in decreasing order
+	vector<int> order(ns);
+	for (int i = 0; i < ns; ++i) order[i] = i;
+	sort(order.begin(), order.end(), [&](int a, int b) { return w[a] > w[b]; });
+
+	double wtot = 0.0;
+	for (int i = 0; i < ns; ++i) wtot += w[i];
+	if (wtot <= 0.0) return false;
+
+	if (maxModes <= 0) maxModes = ns;
+	double wsum = 0.0;
+	for (int l = 0; (l < ns) && ((int)m_V.size() < maxModes); ++l)
+	{
+		int k = order[l];
+		if (w[k] <= 1e-12*w[order[0]]) break;
+
+		// mode k = S*g_k / sqrt(w_k)
+		vector<double> v(neq, 0.0);
+		for (int i = 0; i < ns; ++i)
+		{
+			double gik = G[i][k];
+			const vector<double>& si = S[i];
+			for (int j = 0; j < neq; ++j) v[j] += gik*si[j];
+		}
+
+		// orthonormalize against the previous modes to clean up round-off
+		for (size_t m = 0; m < m_V.size(); ++m)
+		{
+			const vector<double>& vm = m_V[m];
+			double a = 0.0;
+			for (int j = 0; j < neq; ++j) a += vm[j] * v[j];
+			for (int j = 0; j < neq; ++j) v[j] -= a*vm[j];
+		}
+		double norm = 0.0;
+		for (int j = 0; j < neq; ++j) norm += v[j] * v[j];
+		norm = sqrt(norm);
+		if (norm == 0.0) continue;
+		for (int j = 0; j < neq; ++j) v[j] /= norm;
+
+		m_V.push_back(v);
+		wsum += w[k];
+
+		if (wsum >= energy*wtot) break;
+	}
+	m_energy = wsum / wtot;
+
+	return (m_V.empty() == false);
+}
@@ -0,0 +1,72 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! This class builds a proper orthogonal decomposition (POD) basis from a set
+//! of solution snapshots. The snapshots are collected in a binary file during
+//! training runs (see FENewtonSolver, rom_mode = "train"). The basis is built
+//! with the method of snapshots, i.e. from the eigenvectors of the (small) 
+//! correlation matrix of the snapshots.
+class FECORE_API FEPODBasis
+{
+public:
+	FEPODBasis();
+
+	//! Append a snapshot to the snapshot file
+	static bool AppendSnapshot(const char* szfile, const std::vector<double>& u);
+
+	//! Remove all snapshots from the snapshot file
+	static bool ClearSnapshots(const char* szfile);
+
+	//! Read the snapshots with neq entries from file and build the basis. The modes 
+	//! are selected until the fraction energy of the snapshot energy is captured, 
+	//! but no more than maxModes modes are retained.
+	bool Create(const char* szfile, int neq, double energy, int maxModes);
+
+	//! nr of modes
+	int Modes() const { return (int)m_V.size(); }
+
+	//! get a mode
+	const std::vector<double>& Mode(int i) const { return m_V[i]; }
+
+	//! nr of snapshots used for building the basis
+	int Snapshots() const { return m_nsnap; }
+
+	//! fraction of the snapshot energy captured by the basis
+	double Energy() const { return m_energy; }
+
+private:
+	std::vector< std::vector<double> >	m_V;	//!< orthonormal modes
+	int		m_nsnap;	//!< nr of snapshots
+	double	m_energy;	//!< captured energy fraction
+};
@@ -0,0 +1,244 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEQuasiNewtonUpdates.h"
+#include <assert.h>
+#include <string.h>
+
+// size of the row blocks used in the matrix-vector products
+#define QN_BLOCK_SIZE	2048
+
+//-----------------------------------------------------------------------------
+FEQuasiNewtonUpdates::FEQuasiNewtonUpdates()
+{
+	m_neq = 0;
+	m_max = 0;
+	m_nups = 0;
+	m_first = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FEQuasiNewtonUpdates::Init(int neq, int maxups)
+{
+	m_neq = neq;
+	m_max = maxups;
+
+	m_A.resize(maxups, neq);
+	m_B.resize(maxups, neq);
+	m_G.resize(maxups, maxups);
+	m_S.resize(maxups, maxups);
+
+	m_z.resize(maxups + 1);
+	m_y.resize(maxups + 1);
+
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEQuasiNewtonUpdates::Clear()
+{
+	m_nups = 0;
+	m_first = 0;
+}
+
+//-----------------------------------------------------------------------------
+size_t FEQuasiNewtonUpdates::UpdateMemory() const
+{
+	// two update vectors per update
+	return 2 * sizeof(double) * (size_t)m_neq;
+}
+
+//-----------------------------------------------------------------------------
+void FEQuasiNewtonUpdates::RemoveOldest()
+{
+	if (m_nups == 0) return;
+	m_first = (m_first + 1) % m_max;
+	m_nups--;
+	BuildCompactMatrix();
+}
+
+//-----------------------------------------------------------------------------
+void FEQuasiNewtonUpdates::Add(const double* a, const double* b)
+{
+	assert(m_nups < m_max);
+	if (m_nups >= m_max) return;
+
+	// store the update vectors
+	int n = Slot(m_nups);
+	memcpy(m_A[n], a, m_neq * sizeof(double));
+	memcpy(m_B[n], b, m_neq * sizeof(double));
+	m_nups++;
+
+	// update the inner products with the new vectors
+	MultTranspose(m_A, m_nups, b, &m_z[0]);
+	MultTranspose(m_B, m_nups, a, &m_y[0]);
+	for (int i = 0; i < m_nups; ++i)
+	{
+		int si = Slot(i);
+		m_G[n][si] = m_z[i];
+		m_G[si][n] = m_y[i];
+	}
+
+	BuildCompactMatrix();
+}
+
+//-----------------------------------------------------------------------------
+//! The compact representation follows from the recursion
+//! F_m*...*F_0 = (I + a_m*b_m^T)*(I + A*S*B^T), which adds the row
+//! S[m][j] = sum_i (b_m*a_i)*S[i][j] to S.
+void FEQuasiNewtonUpdates::BuildCompactMatrix()
+{
+	int m = m_nups;
+	for (int r = 0; r < m; ++r)
+	{
+		const double* gr = m_G[Slot(r)];
+		for (int j = 0; j < r; ++j)
+		{
+			double s = 0.0;
+			for (int i = j; i < r; ++i) s += gr[Slot(i)] * m_S[i][j];
+			m_S[r][j] = s;
+		}
+		m_S[r][r] = 1.0;
+		for (int j = r + 1; j < m; ++j) m_S[r][j] = 0.0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEQuasiNewtonUpdates::Apply(double* x, int m)
+{
+	if ((m < 0) || (m > m_nups)) m = m_nups;
+	if (m == 0) return;
+
+	// z = B^T*x
+	MultTranspose(m_B, m, x, &m_z[0]);
+
+	// y = S*z
+	for (int i = 0; i < m; ++i)
+	{
+		double s = 0.0;
+		for (int j = 0; j <= i; ++j) s += m_S[i][j] * m_z[j];
+		m_y[i] = s;
+	}
+
+	// x += A*y
+	MultAdd(m_A, m, &m_y[0], x);
+}
+
+//-----------------------------------------------------------------------------
+void FEQuasiNewtonUpdates::ApplyTranspose(double* x, int m)
+{
+	if ((m < 0) || (m > m_nups)) m = m_nups;
+	if (m == 0) return;
+
+	// z = A^T*x
+	MultTranspose(m_A, m, x, &m_z[0]);
+
+	// y = S^T*z
+	for (int i = 0; i < m; ++i)
+	{
+		double s = 0.0;
+		for (int j = i; j < m; ++j) s += m_S[j][i] * m_z[j];
+		m_y[i] = s;
+	}
+
+	// x += B*y
+	MultAdd(m_B, m, &m_y[0], x);
+}
+
+//-----------------------------------------------------------------------------
+void FEQuasiNewtonUpdates::ApplyUpdate(double* x, int i)
+{
+	assert((i >= 0) && (i < m_nups));
+	int n = Slot(i);
+
+	// this is a "matrix" with a single vector
+	double bx = 0.0;
+	const double* a = m_A[n];
+	const double* b = m_B[n];
+	int neq = m_neq;
+#pragma omp parallel for reduction(+:bx)
+	for (int j = 0; j < neq; ++j) bx += b[j] * x[j];
+
+#pragma omp parallel for
+	for (int j = 0; j < neq; ++j) x[j] += a[j] * bx;
+}
+
+//-----------------------------------------------------------------------------
+// The rows are processed in blocks so that each block of x is read from memory 
+// only once for all the update vectors.
+void FEQuasiNewtonUpdates::MultTranspose(const matrix& Q, int m, const double* x, double* z)
+{
+	for (int i = 0; i < m; ++i) z[i] = 0.0;
+
+	int neq = m_neq;
+	int nblocks = (neq + QN_BLOCK_SIZE - 1) / QN_BLOCK_SIZE;
+
+#pragma omp parallel
+	{
+		std::vector<double> zt(m, 0.0);
+
+#pragma omp for schedule(static)
+		for (int nb = 0; nb < nblocks; ++nb)
+		{
+			int j0 = nb * QN_BLOCK_SIZE;
+			int j1 = (j0 + QN_BLOCK_SIZE < neq ? j0 + QN_BLOCK_SIZE : neq);
+			for (int i = 0; i < m; ++i)
+			{
+				const double* qi = Q[Slot(i)];
+				double s = 0.0;
+				for (int j = j0; j < j1; ++j) s += qi[j] * x[j];
+				zt[i] += s;
+			}
+		}
+
+#pragma omp critical
+		for (int i = 0; i < m; ++i) z[i] += zt[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEQuasiNewtonUpdates::MultAdd(const matrix& Q, int m, const double* z, double* x)
+{
+	int neq = m_neq;
+	int nblocks = (neq + QN_BLOCK_SIZE - 1) / QN_BLOCK_SIZE;
+
+#pragma omp parallel for schedule(static)
+	for (int nb = 0; nb < nblocks; ++nb)
+	{
+		int j0 = nb * QN_BLOCK_SIZE;
+		int j1 = (j0 + QN_BLOCK_SIZE < neq ? j0 + QN_BLOCK_SIZE : neq);
+		for (int i = 0; i < m; ++i)
+		{
+			const double* qi = Q[Slot(i)];
+			double zi = z[i];
+			for (int j = j0; j < j1; ++j) x[j] += qi[j] * zi;
+		}
+	}
+}
@@ -0,0 +1,100 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "matrix.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! This class stores a history of rank-one quasi-Newton updates F_i = I + a_i*b_i^T 
+//! as a tall-skinny block of update vectors. The product of the updates is kept in 
+//! the compact form F_{m-1}*...*F_0 = I + A*S*B^T, where S is a small lower-triangular 
+//! matrix. This way, the updates are applied with two (threaded) blocked matrix-vector 
+//! products, instead of a sequence of dot products and axpys. 
+class FECORE_API FEQuasiNewtonUpdates
+{
+public:
+	FEQuasiNewtonUpdates();
+
+	//! allocate storage for maxups updates of size neq
+	void Init(int neq, int maxups);
+
+	//! remove all updates
+	void Clear();
+
+	//! number of updates stored
+	int Updates() const { return m_nups; }
+
+	//! returns true if no more updates can be stored
+	bool IsFull() const { return (m_nups >= m_max); }
+
+	//! remove the oldest update
+	void RemoveOldest();
+
+	//! add the update F = I + a*b^T. The buffer should not be full.
+	void Add(const double* a, const double* b);
+
+	//! x = F_{m-1}*...*F_0*x, i.e. apply the m oldest updates, starting with the oldest.
+	//! If m < 0, all updates are applied.
+	void Apply(double* x, int m = -1);
+
+	//! x = (F_{m-1}*...*F_0)^T*x
+	void ApplyTranspose(double* x, int m = -1);
+
+	//! x = F_i*x
+	void ApplyUpdate(double* x, int i);
+
+	//! memory needed for storing one update (in bytes)
+	size_t UpdateMemory() const;
+
+private:
+	int Slot(int i) const { return (m_first + i) % m_max; }
+
+	// evaluate the compact representation S
+	void BuildCompactMatrix();
+
+	// z = Q^T*x, where Q are the first m (logical) vectors of the history
+	void MultTranspose(const matrix& Q, int m, const double* x, double* z);
+
+	// x += Q*z
+	void MultAdd(const matrix& Q, int m, const double* z, double* x);
+
+private:
+	int		m_neq;		//!< size of update vectors
+	int		m_max;		//!< max number of updates
+	int		m_nups;		//!< number of updates stored
+	int		m_first;	//!< slot of the oldest update
+
+	matrix	m_A;	//!< update vectors a (one row per slot)
+	matrix	m_B;	//!< update vectors b (one row per slot)
+	matrix	m_G;	//!< inner products G[i][j] = b_i*a_j (slot order)
+	matrix	m_S;	//!< compact representation (logical order)
+
+	std::vector<double>	m_z, m_y;	//!< temp buffers
+};
@@ -0,0 +1,286 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEReducedOrderSolver.h"
+#include "FEPODBasis.h"
+#include "log.h"
+#include <math.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+FEReducedOrderSolver::FEReducedOrderSolver(FEModel* fem, LinearSolver* solver, const FEPODBasis& basis) : LinearSolver(fem)
+{
+	m_solver = solver;
+	m_pA = nullptr;
+	m_tol = 0.05;
+	m_fullFactored = false;
+
+	int M = basis.Modes();
+	m_V.resize(M);
+	for (int i = 0; i < M; ++i) m_V[i] = basis.Mode(i);
+	m_neq = (M > 0 ? (int)m_V[0].size() : 0);
+
+	m_nreduced = 0;
+	m_nfull = 0;
+	m_maxErr = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+FEReducedOrderSolver::~FEReducedOrderSolver()
+{
+	delete m_solver;
+}
+
+//-----------------------------------------------------------------------------
+void FEReducedOrderSolver::SetTolerance(double tol)
+{
+	m_tol = tol;
+}
+
+//-----------------------------------------------------------------------------
+LinearSolver* FEReducedOrderSolver::GetFullSolver()
+{
+	return m_solver;
+}
+
+//-----------------------------------------------------------------------------
+LinearSolver* FEReducedOrderSolver::ReleaseFullSolver()
+{
+	LinearSolver* ls = m_solver;
+	m_solver = nullptr;
+	return ls;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* FEReducedOrderSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	m_pA = m_solver->CreateSparseMatrix(ntype);
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool FEReducedOrderSolver::SetSparseMatrix(SparseMatrix* pA)
+{
+	m_pA = pA;
+	return m_solver->SetSparseMatrix(pA);
+}
+
+//-----------------------------------------------------------------------------
+bool FEReducedOrderSolver::PreProcess()
+{
+	return m_solver->PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+//! Project the matrix onto the reduced basis. The full matrix is only factored
+//! when a reduced solve is not accurate enough.
+bool FEReducedOrderSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+
+	m_fullFactored = false;
+
+	// the basis can only be used for a matrix of the same size
+	if ((Modes() > 0) && (m_pA->Rows() != m_neq))
+	{
+		feLogWarning("The reduced-order basis has %d equations, but the model has %d.\nThe full model will be solved.", m_neq, m_pA->Rows());
+		m_V.clear();
+		m_KV.clear();
+	}
+
+	// calculate K*V
+	if (Modes() > 0)
+	{
+		TimerTracker t(&m_reducedTime);
+		int neq = m_pA->Rows();
+		int M = Modes();
+		m_KV.resize(M);
+		for (int i = 0; i < M; ++i)
+		{
+			m_KV[i].resize(neq);
+			if (m_pA->mult_vector(&m_V[i][0], &m_KV[i][0]) == false)
+			{
+				// this matrix format does not support matrix-vector products,
+				// so we'll have to solve the full model
+				feLogWarning("The matrix format of the linear solver does not support the reduced-order model.");
+				m_V.clear();
+				m_KV.clear();
+				break;
+			}
+		}
+	}
+
+	// without a basis, we can only solve the full model
+	if (Modes() == 0)
+	{
+		TimerTracker t(&m_fullTime);
+		m_fullFactored = m_solver->Factor();
+		return m_fullFactored;
+	}
+
+	TimerTracker t(&m_reducedTime);
+	int neq = m_pA->Rows();
+	int M = Modes();
+
+	// reduced matrix Kr = V^T*K*V
+	matrix Kr(M, M);
+	for (int i = 0; i < M; ++i)
+		for (int j = 0; j < M; ++j)
+		{
+			const vector<double>& vi = m_V[i];
+			const vector<double>& kvj = m_KV[j];
+			double kij = 0.0;
+			for (int k = 0; k < neq; ++k) kij += vi[k] * kvj[k];
+			Kr[i][j] = kij;
+		}
+
+	m_Kri = Kr.inverse();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEReducedOrderSolver::BackSolve(double* x, double* b)
+{
+	int neq = m_pA->Rows();
+	int M = Modes();
+
+	// try the reduced solve first
+	if (m_fullFactored == false)
+	{
+		TimerTracker t(&m_reducedTime);
+
+		double normb = 0.0;
+		for (int i = 0; i < neq; ++i) normb += b[i] * b[i];
+		normb = sqrt(normb);
+		if (normb == 0.0)
+		{
+			for (int i = 0; i < neq; ++i) x[i] = 0.0;
+			UpdateStats(0);
+			return true;
+		}
+
+		// solve the reduced system
+		vector<double> br(M, 0.0), a(M, 0.0);
+		for (int i = 0; i < M; ++i)
+		{
+			const vector<double>& vi = m_V[i];
+			for (int k = 0; k < neq; ++k) br[i] += vi[k] * b[k];
+		}
+		for (int i = 0; i < M; ++i)
+			for (int j = 0; j < M; ++j) a[i] += m_Kri[i][j] * br[j];
+
+		// error estimate from the residual r = b - K*V*a
+		double normr = 0.0;
+		for (int k = 0; k < neq; ++k)
+		{
+			double rk = b[k];
+			for (int i = 0; i < M; ++i) rk -= m_KV[i][k] * a[i];
+			normr += rk*rk;
+		}
+		double err = sqrt(normr) / normb;
+
+		if (err <= m_tol)
+		{
+			for (int k = 0; k < neq; ++k)
+			{
+				double xk = 0.0;
+				for (int i = 0; i < M; ++i) xk += m_V[i][k] * a[i];
+				x[k] = xk;
+			}
+
+			if (err > m_maxErr) m_maxErr = err;
+			m_nreduced++;
+			UpdateStats(0);
+			return true;
+		}
+	}
+
+	// fall back to the full model
+	TimerTracker t(&m_fullTime);
+	if (m_fullFactored == false)
+	{
+		if (m_solver->Factor() == false) return false;
+		m_fullFactored = true;
+	}
+
+	int niter = m_solver->GetStats().iterations;
+	bool bret = m_solver->BackSolve(x, b);
+	UpdateStats(m_solver->GetStats().iterations - niter);
+	m_nfull++;
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+void FEReducedOrderSolver::Destroy()
+{
+	if (m_solver) m_solver->Destroy();
+	LinearSolver::Destroy();
+}
+
+//-----------------------------------------------------------------------------
+bool FEReducedOrderSolver::IsIterative() const
+{
+	return m_solver->IsIterative();
+}
+
+//-----------------------------------------------------------------------------
+void FEReducedOrderSolver::SetPrintLevel(int n)
+{
+	m_solver->SetPrintLevel(n);
+}
+
+//-----------------------------------------------------------------------------
+void FEReducedOrderSolver::PrintSummary()
+{
+	double tr = m_reducedTime.GetTime();
+	double tf = m_fullTime.GetTime();
+
+	feLog("\nreduced-order model summary (%d modes)\n", Modes());
+	feLog("    reduced solves         : %d\n", m_nreduced);
+	feLog("    full solves            : %d\n", m_nfull);
+	feLog("    max error estimate     : %lg\n", m_maxErr);
+	feLog("    reduced solver time    : %lg\n", tr);
+	feLog("    full solver time       : %lg\n", tf);
+
+	// estimate the speedup from the average cost of a full solve
+	if ((m_nfull > 0) && (m_nreduced > 0) && (tf > 0.0))
+	{
+		double tfull = (tf / m_nfull)*(m_nreduced + m_nfull);
+		feLog("    estimated speedup      : %lg\n", tfull / (tr + tf));
+	}
+
+	m_nreduced = 0;
+	m_nfull = 0;
+	m_maxErr = 0.0;
+	m_reducedTime.reset();
+	m_fullTime.reset();
+}
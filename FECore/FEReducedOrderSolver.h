@@ -0,0 +1,97 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "LinearSolver.h"
+#include "matrix.h"
+#include "Timer.h"
+
+class FEPODBasis;
+
+//-----------------------------------------------------------------------------
+//! Linear solver for the reduced-order (POD-Galerkin) mode of the Newton solvers.
+//! This solver wraps the actual linear solver. When the matrix is factored, the
+//! system is projected onto the POD basis V, i.e. Kr = V^T*K*V, and back-solves
+//! are done in the reduced space. When the residual of the reduced solution
+//! exceeds the tolerance, the full system is factored and solved instead.
+class FECORE_API FEReducedOrderSolver : public LinearSolver
+{
+public:
+	//! constructor. This solver takes ownership of the wrapped solver.
+	FEReducedOrderSolver(FEModel* fem, LinearSolver* solver, const FEPODBasis& basis);
+	~FEReducedOrderSolver();
+
+	//! set the tolerance on the relative residual of the reduced solution
+	void SetTolerance(double tol);
+
+	//! get the wrapped linear solver
+	LinearSolver* GetFullSolver();
+
+	//! Return the wrapped linear solver and give up its ownership
+	LinearSolver* ReleaseFullSolver();
+
+	//! nr of equations of the POD basis
+	int Equations() const { return m_neq; }
+
+public: // overrides from LinearSolver
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+	bool SetSparseMatrix(SparseMatrix* pA) override;
+	bool PreProcess() override;
+	bool Factor() override;
+	bool BackSolve(double* x, double* b) override;
+	using LinearSolver::BackSolve;
+	void Destroy() override;
+	bool IsIterative() const override;
+	void SetPrintLevel(int n) override;
+
+public:
+	//! nr of modes
+	int Modes() const { return (int)m_V.size(); }
+
+	//! print a summary of the reduced and full solves since the last call
+	void PrintSummary();
+
+private:
+	LinearSolver*	m_solver;		//!< the full linear solver
+	SparseMatrix*	m_pA;			//!< the (full) sparse matrix
+	double			m_tol;			//!< tolerance on relative residual
+	int				m_neq;			//!< nr of equations of the POD basis
+
+	std::vector< std::vector<double> >	m_V;	//!< POD modes
+	std::vector< std::vector<double> >	m_KV;	//!< K*V
+	matrix	m_Kri;			//!< inverse of reduced matrix
+	bool	m_fullFactored;	//!< the full matrix was factored for the current matrix
+
+	// counters
+	int		m_nreduced;		//!< nr of reduced solves
+	int		m_nfull;		//!< nr of full solves
+	double	m_maxErr;		//!< max error estimate of accepted reduced solves
+	Timer	m_reducedTime;	//!< time spent in reduced factorizations and solves
+	Timer	m_fullTime;		//!< time spent in full factorizations and solves
+};
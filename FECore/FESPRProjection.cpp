@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FESPRProjection.h"
 #include "FESolidDomain.h"
 #include "FEMesh.h"
+#include "matrix.h"
 using namespace std;
 
 //-------------------------------------------------------------------------------------------------
@@ -45,192 +46,311 @@ void FESPRProjection::SetInterpolationOrder(int p)
 }
 
 //-------------------------------------------------------------------------------------------------
-//! Projects the integration point data, stored in d, onto the nodes of the domain.
-//! The result is stored in o.
-void FESPRProjection::Project(FESolidDomain& dom, const vector< vector<double> >& d, vector<double>& o)
+// Determine the number of degrees of freedom of the patch polynomial and the number of corner nodes.
+// Returns false if the element shape is not supported.
+static bool spr_patch_size(int nshape, int p, int& ndof, int& ncn)
+{
+	switch (nshape)
+	{
+	case ET_TET4  :
+	case ET_TET5  : { ndof =  4; ncn = 4; } break;
+	case ET_TET10 : { ndof =  4; ncn = 4; } break;
+	case ET_TET15 : { ndof = (p == 1 ? 4 : 10); ncn = 4; } break;
+	case ET_TET20 : { ndof = 10; ncn = 4; } break;
+	case ET_HEX8  : { ndof =  7; ncn = 8; } break;
+	case ET_HEX20 : { ndof = (p == 1 ? 7 : 10); ncn = 8; } break;
+	case ET_HEX27 : { ndof = (p == 1 ? 7 : 10); ncn = 8; } break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// evaluate the patch polynomial basis at the relative position r
+static inline void spr_basis(const vec3d& r, int ndof, double* pk)
+{
+	pk[0] = 1.0; pk[1] = r.x; pk[2] = r.y; pk[3] = r.z;
+	if (ndof >=  7) { pk[4] = r.x*r.y; pk[5] = r.y*r.z; pk[6] = r.x*r.z; }
+	if (ndof >= 10) { pk[7] = r.x*r.x; pk[8] = r.y*r.y; pk[9] = r.z*r.z; }
+}
+
+//-------------------------------------------------------------------------------------------------
+FESPRPatchOperator::FESPRPatchOperator()
+{
+	m_p = -1;
+	m_ndof = 0;
+	m_nelem = 0;
+	m_nnodes = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+bool FESPRPatchOperator::IsValid(FESolidDomain& dom, int p) const
+{
+	int ndof, ncn;
+	if (spr_patch_size(dom.GetElementShape(), p, ndof, ncn) == false) return false;
+	if (ndof != m_ndof) return false;
+	if (m_nelem != dom.Elements()) return false;
+	if (m_nnodes != dom.Nodes()) return false;
+	if ((int)m_lid.size() != dom.GetMesh()->Nodes()) return false;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! Setup the patch operators. Each corner node with enough sampling points in its patch
+//! (i.e. the elements attached to the node) gets the inverse of its least-squares matrix.
+//! All positions are taken in the reference configuration, so the operators remain valid
+//! for the entire analysis.
+bool FESPRPatchOperator::Create(FESolidDomain& dom, int p)
 {
-	// get the mesh
 	FEMesh& mesh = *dom.GetMesh();
 	int NN = dom.Nodes();
+	int NE = dom.Elements();
+	int NM = mesh.Nodes();
 
-	// allocate output array
-	o.assign(NN, 0.0);
-
-	// check element type
 	int NDOF = -1;	// number of degrees of freedom of polynomial
 	int NCN  = -1;	// number of corner nodes
-	int nshape = dom.GetElementShape();
-	switch (nshape)
+	if (spr_patch_size(dom.GetElementShape(), p, NDOF, NCN) == false) return false;
+
+	m_p = p;
+	m_ndof = NDOF;
+	m_nelem = NE;
+	m_nnodes = NN;
+
+	// mesh to domain node indices
+	m_lid.assign(NM, -1);
+	for (int i = 0; i < NN; ++i) m_lid[dom.NodeIndex(i)] = i;
+
+	// For higher order elements we need to make sure that we don't process the edge nodes.
+	// We assume here that the first NCN nodes of the element are the corner nodes 
+	// and that all other nodes are edge or interior nodes.
+	vector<char> edge(NN, 0);
+	for (int i = 0; i < NE; ++i)
 	{
-	case ET_TET4   :
-	case ET_TET5   : { NDOF =  4; NCN = 4; } break;
-	case ET_TET10  : { NDOF =  4; NCN = 4; } break;
-	case ET_TET15  : 
-		{
-			NDOF = (m_p == 1 ? 4 : 10); 
-			NCN = 4; 
-		}
-		break;
-	case ET_TET20 : { NDOF = 10; NCN = 4; } break;
-	case ET_HEX8  : { NDOF =  7; NCN = 8; } break;
-	case ET_HEX20 : { NDOF = (m_p == 1 ? 7 : 10); NCN = 8; } break;
-	case ET_HEX27 : { NDOF = (m_p == 1 ? 7 : 10); NCN = 8; } break;
-	default:
-		return;
+		FESolidElement& el = dom.Element(i);
+		int ne = el.Nodes();
+		for (int j = NCN; j < ne; ++j) edge[m_lid[el.m_node[j]]] = 1;
 	}
 
-	// we keep a tag array to keep track of which nodes we processed
-	int NM = mesh.Nodes();
-	vector<int> tag; tag.assign(NM, 0);
-
-	// for higher order elements
-	// we need to make sure that we don't process the edge nodes
-	// we assume here that the first NCN nodes of the element
-	// are the corner nodes and that all other nodes are edge or interior nodes
-	int NE = dom.Elements();
-	for (int i=0; i<NE; ++i)
+	// build the node-element list. This will define our patches
+	m_pn.assign(NN + 1, 0);
+	for (int i = 0; i < NE; ++i)
 	{
 		FESolidElement& el = dom.Element(i);
 		int ne = el.Nodes();
-		for (int j=NCN; j<ne; ++j) tag[el.m_node[j]] = 2;
+		for (int j = 0; j < ne; ++j) m_pn[m_lid[el.m_node[j]] + 1]++;
+	}
+	for (int i = 0; i < NN; ++i) m_pn[i + 1] += m_pn[i];
+	m_ne.resize(m_pn[NN]);
+	vector<int> pos(m_pn.begin(), m_pn.end() - 1);
+	for (int i = 0; i < NE; ++i)
+	{
+		FESolidElement& el = dom.Element(i);
+		int ne = el.Nodes();
+		for (int j = 0; j < ne; ++j) m_ne[pos[m_lid[el.m_node[j]]]++] = i;
 	}
 
-	// this array will store the results
-	vector<double> val;
-	val.assign(NM, 0.0);
+	// only corner nodes with enough sampling points in their patch define a patch operator
+	int npatch = 0;
+	m_patch.assign(NN, -1);
+	for (int i = 0; i < NN; ++i)
+	{
+		if (edge[i]) continue;
 
-	// build the node-element-list. This will define our patches
-	FENodeElemList NEL;
-	NEL.Create(dom);
+		int m = 0;
+		for (int j = m_pn[i]; j < m_pn[i + 1]; ++j) m += dom.Element(m_ne[j]).GaussPoints();
 
-	// loop over all nodes
-	for (int i=0; i<NN; ++i)
+		if (m > NDOF + 1) m_patch[i] = npatch++;
+	}
+
+	// setup and invert the A-matrices
+	const int NDOF2 = NDOF*NDOF;
+	m_Ai.assign(npatch*NDOF2, 0.0);
+#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
 	{
-		// get the node
-		FENode& node = dom.Node(i);
-		int in = dom.NodeIndex(i);
+		int ip = m_patch[i];
+		if (ip < 0) continue;
+
+		vec3d rc = dom.Node(i).m_r0;
 
-		// don't loop over edge nodes (edge or interior nodes have a tag > 1)
-		if (tag[in] <= 1)
+		double pk[10];
+		matrix A(NDOF, NDOF); A.zero();
+		for (int j = m_pn[i]; j < m_pn[i + 1]; ++j)
 		{
-			// get the nodal position
-			vec3d rc = node.m_rt;
-
-			// get the element patch
-			int ne = NEL.Valence(in);
-			FEElement** ppe = NEL.ElementList(in);
-			int* pei = NEL.ElementIndexList(in);
-
-			// setup the A-matrix
-			vector<double> pk(NDOF);
-			matrix A(NDOF,NDOF); A.zero();
-			int m = 0;
-			for (int j=0; j<ne; ++j)
+			FESolidElement& el = dom.Element(m_ne[j]);
+			int nint = el.GaussPoints();
+			for (int n = 0; n < nint; ++n)
 			{
-				FEElement& el = *(ppe[j]);
-
-				int nint = el.GaussPoints();
-				for (int n=0; n<nint; ++n, ++m)
-				{
-					FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-//					vec3d r = ep.m_rt - rc;
-					vec3d r = mp.m_r0 - rc;
-					pk[0] = 1.0; pk[1] = r.x; pk[2] = r.y; pk[3] = r.z;
-					if (NDOF >=  7) { pk[4] = r.x*r.y; pk[5] = r.y*r.z; pk[6] = r.x*r.z; }
-					if (NDOF >= 10) { pk[7] = r.x*r.x; pk[8] = r.y*r.y; pk[9] = r.z*r.z; }
-					A += outer_product(pk);
-				}
+				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+				spr_basis(mp.m_r0 - rc, NDOF, pk);
+				for (int k = 0; k < NDOF; ++k)
+					for (int l = 0; l < NDOF; ++l) A[k][l] += pk[k] * pk[l];
 			}
+		}
+
+		matrix Ai = A.inverse();
+		double* ai = &m_Ai[ip*NDOF2];
+		for (int k = 0; k < NDOF; ++k)
+			for (int l = 0; l < NDOF; ++l) ai[k*NDOF + l] = Ai[k][l];
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! Evaluate the nodal values of all components. The polynomial coefficients of all patches are
+//! calculated first. The patch centers take the constant coefficient of their own patch, all 
+//! other nodes (edge, interior, and nodes with insufficient sampling points) take the average
+//! of the values extrapolated from all patches they belong to.
+void FESPRPatchOperator::Apply(FESolidDomain& dom, const vector< vector< vector<double> > >& d, vector< vector<double> >& o) const
+{
+	const int NN = m_nnodes;
+	const int NC = (int) d.size();
+	const int NDOF = m_ndof;
+	const int NDOF2 = NDOF*NDOF;
+
+	o.resize(NC);
+	for (int c = 0; c < NC; ++c) o[c].assign(NN, 0.0);
+	if ((NC == 0) || (NDOF == 0)) return;
+
+	// calculate the polynomial coefficients of all patches
+	int npatch = (int)m_Ai.size() / NDOF2;
+	vector<double> C(npatch*NC*NDOF, 0.0);
+#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
+	{
+		int ip = m_patch[i];
+		if (ip < 0) continue;
 
-			// invert matrix and make sure condition number is good enough
-			matrix Ai = A.inverse();
+		vec3d rc = dom.Node(i).m_r0;
 
-			// make sure we have enough sampling points
-			if (m > NDOF + 1)
+		// setup the right-hand sides (stored in the coefficient array)
+		double* b = &C[ip*NC*NDOF];
+		double pk[10];
+		for (int j = m_pn[i]; j < m_pn[i + 1]; ++j)
+		{
+			int iel = m_ne[j];
+			FESolidElement& el = dom.Element(iel);
+			int nint = el.GaussPoints();
+			for (int n = 0; n < nint; ++n)
 			{
-				vector<double> b; b.assign(NDOF,0.0);
-				for (int j=0; j<ne; ++j)
+				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+				spr_basis(mp.m_r0 - rc, NDOF, pk);
+				for (int c = 0; c < NC; ++c)
 				{
-					FEElement& el = *(ppe[j]);
-					const vector<double>& ed = d[pei[j]];
-
-					assert(ppe[j] == &dom.Element(pei[j]));
-
-					int nint = el.GaussPoints();
-					for (int n=0; n<nint; ++n)
-					{
-						FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-//						FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
-//						vec3d r = ep.m_rt - rc;
-						vec3d r = mp.m_r0 - rc;
-						pk[0] = 1.0; pk[1] = r.x; pk[2] = r.y; pk[3] = r.z;
-						if (NDOF >=  7) { pk[4] = r.x*r.y; pk[5] = r.y*r.z; pk[6] = r.x*r.z; }
-						if (NDOF >= 10) { pk[7] = r.x*r.x; pk[8] = r.y*r.y; pk[9] = r.z*r.z; }
-
-						double s = ed[n];
-						for (int k=0; k<NDOF; k++) b[k] += s*pk[k];
-					}
+					double s = d[c][iel][n];
+					double* bc = b + c*NDOF;
+					for (int k = 0; k < NDOF; ++k) bc[k] += s*pk[k];
 				}
+			}
+		}
 
-				// solve the linear system
-				vector<double> c = Ai*b;
+		// solve the linear systems
+		const double* ai = &m_Ai[ip*NDOF2];
+		for (int c = 0; c < NC; ++c)
+		{
+			double* bc = b + c*NDOF;
+			double tmp[10];
+			for (int k = 0; k < NDOF; ++k) tmp[k] = bc[k];
+			for (int k = 0; k < NDOF; ++k)
+			{
+				double v = 0.0;
+				for (int l = 0; l < NDOF; ++l) v += ai[k*NDOF + l] * tmp[l];
+				bc[k] = v;
+			}
+		}
+	}
 
-				// tag this node as processed
-				tag[in] = 1;
+	// evaluate the nodal values
+#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
+	{
+		int ip = m_patch[i];
+		if (ip >= 0)
+		{
+			for (int c = 0; c < NC; ++c) o[c][i] = C[(ip*NC + c)*NDOF];
+			continue;
+		}
 
-				// store result
-				val[in] = c[0];
+		// visit all patches that contain this node. A patch is visited once
+		// for each of its elements that contains this node.
+		vec3d ri = dom.Node(i).m_r0;
+		double pk[10];
+		int nvisit = 0;
+		for (int j = m_pn[i]; j < m_pn[i + 1]; ++j)
+		{
+			FESolidElement& el = dom.Element(m_ne[j]);
+			int ne = el.Nodes();
+			for (int k = 0; k < ne; ++k)
+			{
+				int l = m_lid[el.m_node[k]];
+				int jp = m_patch[l];
+				if (jp < 0) continue;
 
-				// loop over all unprocessed nodes of this patch
-				for (int j=0; j<ne; ++j)
+				spr_basis(ri - dom.Node(l).m_r0, NDOF, pk);
+				for (int c = 0; c < NC; ++c)
 				{
-					FEElement& el = *(ppe[j]);
-					int en = el.Nodes();
-					for (int k=0; k<en; ++k)
-					{
-						int em = el.m_node[k];
-						if (tag[em] != 1)
-						{
-							vec3d r = mesh.Node(em).m_rt - rc;
-							pk[0] = 1.0; pk[1] = r.x; pk[2] = r.y; pk[3] = r.z;
-							if (NDOF >=  7) { pk[4] = r.x*r.y; pk[5] = r.y*r.z; pk[6] = r.x*r.z; }
-							if (NDOF >= 10) { pk[7] = r.x*r.x; pk[8] = r.y*r.y; pk[9] = r.z*r.z; }
-
-							// calculate the value for this node
-							double v = 0;
-							for (int l=0; l<NDOF; ++l) v += pk[l]*c[l];
-
-							// for edge nodes, we need to keep track of how often we visit this node
-							// Therefore we increment the tag.
-							// (remember that the tag started at 2 for edge/interior nodes)
-							if (tag[em] >= 2)
-							{
-								tag[em]++;
-								val[em] += v;
-							}
-							else val[em] = v;
-						}
-					}
+					const double* cc = &C[(jp*NC + c)*NDOF];
+					double v = 0.0;
+					for (int m = 0; m < NDOF; ++m) v += pk[m] * cc[m];
+					o[c][i] += v;
 				}
+				nvisit++;
 			}
 		}
+
+		if (nvisit > 1)
+		{
+			for (int c = 0; c < NC; ++c) o[c][i] /= (double)nvisit;
+		}
 	}
+}
 
-	// copy results to archive
-	for (int i=0; i<NN; ++i)
+//-------------------------------------------------------------------------------------------------
+//! get the patch operator of this domain. The operator is created the first time it is 
+//! needed and is then stored on the domain.
+FESPRPatchOperator* FESPRProjection::GetPatchOperator(FESolidDomain& dom)
+{
+	FESPRPatchOperator* op = dom.GetSPRPatchOperator();
+	if ((op == nullptr) || (op->IsValid(dom, m_p) == false))
 	{
-		int in = dom.NodeIndex(i);
-		double s = val[in];
-
-		// for edge nodes we need to average
-		// (remember that the tag started at 2 for edge/interior nodes)
-		if (tag[in] >= 2)
+		op = new FESPRPatchOperator;
+		if (op->Create(dom, m_p) == false)
 		{
-//			assert(tag[in] > 2);	// all edges nodes must be visited at least once!
-			int l = tag[in]-2;
-			if (l > 0) s /= (double) (l);
+			delete op;
+			return nullptr;
 		}
-		
-		o[i] = s;
+		dom.SetSPRPatchOperator(op);
 	}
+	return op;
+}
+
+//-------------------------------------------------------------------------------------------------
+//! Projects the integration point data, stored in d, onto the nodes of the domain.
+//! The result is stored in o.
+void FESPRProjection::Project(FESolidDomain& dom, const vector< vector<double> >& d, vector<double>& o)
+{
+	vector< vector< vector<double> > > D(1);
+	D[0] = d;
+	vector< vector<double> > O;
+	Project(dom, D, O);
+	o = O[0];
+}
+
+//-------------------------------------------------------------------------------------------------
+//! Projects several components of integration point data at once. d[c] stores the 
+//! integration point values of component c, and the nodal values are returned in o[c].
+void FESPRProjection::Project(FESolidDomain& dom, const vector< vector< vector<double> > >& d, vector< vector<double> >& o)
+{
+	FESPRPatchOperator* op = GetPatchOperator(dom);
+	if (op == nullptr)
+	{
+		int NN = dom.Nodes();
+		o.resize(d.size());
+		for (size_t c = 0; c < d.size(); ++c) o[c].assign(NN, 0.0);
+		return;
+	}
+
+	op->Apply(dom, d, o);
 }
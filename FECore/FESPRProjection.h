@@ -32,6 +32,39 @@ SOFTWARE.*/
 
 class FESolidDomain;
 
+//-------------------------------------------------------------------------------------------------
+//! This class stores the least-squares operators of the SPR patches of a solid domain. 
+//! The operators only depend on the reference geometry, so they are set up once and 
+//! are cached on the domain (see FESolidDomain::GetSPRPatchOperator).
+class FECORE_API FESPRPatchOperator
+{
+public:
+	FESPRPatchOperator();
+
+	//! setup the patch operators for the given interpolation order
+	bool Create(FESolidDomain& dom, int p);
+
+	//! see if this operator can be used for the domain and interpolation order
+	bool IsValid(FESolidDomain& dom, int p) const;
+
+	//! Evaluate the nodal values of all components. 
+	//! d[c][i][n] is the value of component c at integration point n of element i, 
+	//! o[c][j] will be the value of component c at domain node j.
+	void Apply(FESolidDomain& dom, const std::vector< std::vector< std::vector<double> > >& d, std::vector< std::vector<double> >& o) const;
+
+private:
+	int		m_p;		//!< interpolation order this operator was built for
+	int		m_ndof;		//!< number of degrees of freedom of polynomial
+	int		m_nelem;	//!< number of elements of the domain when the operator was built
+	int		m_nnodes;	//!< number of nodes of the domain when the operator was built
+
+	std::vector<int>		m_patch;	//!< index of node's patch operator (or -1 if node is not a patch center)
+	std::vector<int>		m_lid;		//!< mesh node index to domain node index (or -1)
+	std::vector<double>		m_Ai;		//!< inverted patch matrices (m_ndof x m_ndof for each patch)
+	std::vector<int>		m_pn;		//!< start index into m_ne for each domain node
+	std::vector<int>		m_ne;		//!< elements attached to the domain nodes
+};
+
 //-------------------------------------------------------------------------------------------------
 //! This class implements the super-convergent-patch recovery method which projects integration point
 //! data to the finite element nodes.
@@ -40,10 +73,18 @@ class FECORE_API FESPRProjection
 public:
 	FESPRProjection();
 
+	//! project a single component
 	void Project(FESolidDomain& dom, const std::vector< std::vector<double> >& d, std::vector<double>& o);
 
+	//! project several components in one pass over the patches
+	void Project(FESolidDomain& dom, const std::vector< std::vector< std::vector<double> > >& d, std::vector< std::vector<double> >& o);
+
 	void SetInterpolationOrder(int p);
 
+protected:
+	//! get the (cached) patch operator of the domain
+	FESPRPatchOperator* GetPatchOperator(FESolidDomain& dom);
+
 protected:
 	int		m_p;	//!< interpolation order (set to -1 for default rules)
 };
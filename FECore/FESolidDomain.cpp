@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEMaterial.h"
 #include "tools.h"
 #include "log.h"
+#include "FESPRProjection.h"
 
 //-----------------------------------------------------------------------------
 FESolidDomain::FESolidDomain(FEModel* pfem) : FEDomain(FE_DOMAIN_SOLID, pfem), m_dofU(pfem), m_dofSU(pfem)
@@ -41,6 +42,20 @@ FESolidDomain::FESolidDomain(FEModel* pfem) : FEDomain(FE_DOMAIN_SOLID, pfem), m
     m_dofSU.AddDof(pfem->GetDOFIndex("sx"));
 	m_dofSU.AddDof(pfem->GetDOFIndex("sy"));
 	m_dofSU.AddDof(pfem->GetDOFIndex("sz"));
+	m_spr = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+FESolidDomain::~FESolidDomain()
+{
+	delete m_spr;
+}
+
+//-----------------------------------------------------------------------------
+void FESolidDomain::SetSPRPatchOperator(FESPRPatchOperator* op)
+{
+	if (op != m_spr) delete m_spr;
+	m_spr = op;
 }
 
 //-----------------------------------------------------------------------------
@@ -48,6 +63,7 @@ void FESolidDomain::Create(int nsize, int elemType)
 {
 	// allocate elements
     m_Elem.resize(nsize);
+	SetSPRPatchOperator(nullptr);
 	for (int i = 0; i < nsize; ++i)
 	{
 		FESolidElement& el = m_Elem[i];
@@ -81,6 +97,45 @@ void FESolidDomain::CopyFrom(FEMeshPartition* pd)
     FESolidDomain* psd = dynamic_cast<FESolidDomain*>(pd);
     m_Elem = psd->m_Elem;
 	ForEachElement([=](FEElement& el) { el.SetMeshPartition(this); });
+	SetSPRPatchOperator(nullptr);
+}
+
+//-----------------------------------------------------------------------------
+//! Reorder the elements of this domain. The element IDs are not changed, only the
+//! position of the elements in the domain. This should be called before the domain is
+//! initialized, since any data that is indexed by the local element ID is invalidated.
+void FESolidDomain::Permute(const std::vector<int>& P)
+{
+	int NE = Elements();
+	assert((int)P.size() == NE);
+
+	// apply the permutation by following its cycles
+	vector<bool> done(NE, false);
+	for (int i = 0; i < NE; ++i)
+	{
+		if (done[i]) continue;
+		int j = i;
+		while (P[j] != i)
+		{
+			m_Elem[j].Swap(m_Elem[P[j]]);
+			done[j] = true;
+			j = P[j];
+		}
+		done[j] = true;
+	}
+
+	// update the local IDs and the material points' element pointers
+	for (int i = 0; i < NE; ++i)
+	{
+		FESolidElement& el = m_Elem[i];
+		el.SetLocalID(i);
+		for (int n = 0; n < el.GaussPoints(); ++n)
+		{
+			FEMaterialPoint* mp = el.GetMaterialPoint(n);
+			if (mp) el.SetMaterialPointData(mp, n);
+		}
+	}
+	SetSPRPatchOperator(nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -42,6 +42,8 @@ typedef std::function<void(FEMaterialPoint& mp, int node_a, std::vector<double>&
 
 typedef std::function<void(FEMaterialPoint& mp, int node_a, int node_b, matrix& val)> FEVolumeMatrixIntegrand;
 
+class FESPRPatchOperator;
+
 //-----------------------------------------------------------------------------
 //! abstract base class for 3D volumetric elements
 class FECORE_API FESolidDomain : public FEDomain
@@ -49,6 +51,13 @@ class FECORE_API FESolidDomain : public FEDomain
 public:
     //! constructor
     FESolidDomain(FEModel* pfem);
+
+	//! destructor
+	~FESolidDomain();
+
+	//! the domain owns its SPR patch operator, so it cannot be copied
+	FESolidDomain(const FESolidDomain&) = delete;
+	FESolidDomain& operator = (const FESolidDomain&) = delete;
     
     //! create storage for elements
     void Create(int nsize, int elemType) override;
@@ -65,6 +74,9 @@ public:
     //! copy data from another domain (overridden from FEDomain)
     void CopyFrom(FEMeshPartition* pd) override;
 
+	//! reorder the elements (P[i] is the old index of the element that is moved to position i)
+	void Permute(const std::vector<int>& P);
+
     //! element access
 	FESolidElement& Element(int n);
     FEElement& ElementRef(int n) override { return m_Elem[n]; }
@@ -267,9 +279,18 @@ public:
 		FEVolumeMatrixIntegrand f	// the matrix function to evaluate
 	);
 
+public:
+	//! get the cached SPR patch operator (can be null)
+	FESPRPatchOperator* GetSPRPatchOperator() { return m_spr; }
+
+	//! set the cached SPR patch operator (the domain takes ownership)
+	void SetSPRPatchOperator(FESPRPatchOperator* op);
+
 protected:
     vector<FESolidElement>	m_Elem;		//!< array of elements
 
 	FEDofList	m_dofU;
 	FEDofList	m_dofSU;
+
+	FESPRPatchOperator*	m_spr;	//!< cached SPR patch operator for nodal projections
 };
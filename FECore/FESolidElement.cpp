@@ -66,6 +66,13 @@ FESolidElement& FESolidElement::operator = (const FESolidElement& el)
 	return (*this);
 }
 
+void FESolidElement::Swap(FESolidElement& el)
+{
+	FEElement::Swap(el);
+	m_bitfc.swap(el.m_bitfc);
+	m_J0i.swap(el.m_J0i);
+}
+
 void FESolidElement::SetTraits(FEElementTraits* pt)
 {
 	FEElement::SetTraits(pt);
@@ -41,6 +41,9 @@ public:
 	//! assignment operator
 	FESolidElement& operator = (const FESolidElement& el);
 
+	//! exchange all data with another solid element
+	void Swap(FESolidElement& el);
+
 	//! set the element traits
 	void SetTraits(FEElementTraits* pt) override;
 
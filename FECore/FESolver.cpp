@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FESolver.h"
 #include "FEModel.h"
 #include "FENodeReorder.h"
+#include "FEMeshReorder.h"
 #include "DumpStream.h"
 #include "FEDomain.h"
 #include "FESurfacePairConstraint.h"
@@ -45,6 +46,7 @@ BEGIN_FECORE_CLASS(FESolver, FECoreBase)
 	ADD_PARAMETER(m_eq_scheme, "equation_scheme");
 	ADD_PARAMETER(m_eq_order , "equation_order" );
 	ADD_PARAMETER(m_bwopt    , "optimize_bw");
+	ADD_PARAMETER(m_reorder  , "optimize_locality", 0, "none\0hilbert\0morton\0");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -61,6 +63,7 @@ FESolver::FESolver(FEModel* fem) : FECoreBase(fem)
 	m_neq = 0;
 
 	m_bwopt = 0;
+	m_reorder = FEMeshReorder::REORDER_NONE;
 
 	m_eq_scheme = EQUATION_SCHEME::STAGGERED;
 	m_eq_order = EQUATION_ORDER::NORMAL_ORDER;
@@ -338,6 +341,12 @@ bool FESolver::InitEquations()
 		FENodeReorder mod;
 		mod.Apply(mesh, P);
 	}
+	else if (m_reorder != FEMeshReorder::REORDER_NONE)
+	{
+		// number the nodes along a space-filling curve
+		FEMeshReorder mod(m_reorder);
+		mod.NodeOrder(mesh, P);
+	}
 	else for (int i = 0; i < NN; ++i) P[i] = i;
 
 	for (int i = 0; i < mesh.Nodes(); ++i)
@@ -506,6 +515,12 @@ bool FESolver::InitEquations2()
 		FENodeReorder mod;
 		mod.Apply(mesh, P);
 	}
+	else if (m_reorder != FEMeshReorder::REORDER_NONE)
+	{
+		// number the nodes along a space-filling curve
+		FEMeshReorder mod(m_reorder);
+		mod.NodeOrder(mesh, P);
+	}
 	else for (int i = 0; i < NN; ++i) P[i] = i;
 
 	// reset all equation numbers
@@ -167,6 +167,7 @@ public:
 
 public: //TODO Move these parameters elsewhere
 	int					m_bwopt;	    //!< bandwidth optimization flag
+	int					m_reorder;		//!< locality reordering of nodes and elements (see FEMeshReorder)
 	int					m_msymm;		//!< matrix symmetry flag for linear solver allocation
 	int					m_eq_scheme;	//!< equation number scheme (used in InitEquations)
 	int					m_eq_order;		//!< normal or reverse ordering
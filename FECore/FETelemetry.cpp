@@ -0,0 +1,231 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FETelemetry.h"
+#include "FEModel.h"
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+// names of the model timers (see TimerID)
+static const char* szTimerName[] = {
+	"update",
+	"linear_solve",
+	"reform",
+	"residual",
+	"stiffness",
+	"qn_update"
+};
+
+//-----------------------------------------------------------------------------
+FETelemetry::FETelemetry()
+{
+	m_fp = nullptr;
+	m_bfirst = true;
+}
+
+//-----------------------------------------------------------------------------
+FETelemetry::~FETelemetry()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+bool FETelemetry::Open(const char* szfile)
+{
+	Close();
+	m_fp = fopen(szfile, "wt");
+	if (m_fp == nullptr) return false;
+
+	// use a large buffer so that the solver rarely has to wait for the disk
+	setvbuf(m_fp, nullptr, _IOFBF, 1 << 16);
+
+	m_timers.clear();
+	m_wall.reset();
+	m_wall.start();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::Close()
+{
+	if (m_fp) fclose(m_fp);
+	m_fp = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::Flush()
+{
+	if (m_fp) fflush(m_fp);
+}
+
+//-----------------------------------------------------------------------------
+double FETelemetry::WallTime()
+{
+	return m_wall.peek();
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::BeginRecord(const char* sztype)
+{
+	if (m_fp == nullptr) return;
+	fputc('{', m_fp);
+	m_bfirst = true;
+	Write("type", sztype);
+	Write("wall", WallTime());
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::EndRecord()
+{
+	if (m_fp == nullptr) return;
+	fputs("}\n", m_fp);
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::BeginObject(const char* szkey)
+{
+	if (m_fp == nullptr) return;
+	WriteKey(szkey);
+	fputc('{', m_fp);
+	m_bfirst = true;
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::EndObject()
+{
+	if (m_fp == nullptr) return;
+	fputc('}', m_fp);
+	m_bfirst = false;
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::Write(const char* szkey, int n)
+{
+	if (m_fp == nullptr) return;
+	WriteKey(szkey);
+	fprintf(m_fp, "%d", n);
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::Write(const char* szkey, double v)
+{
+	if (m_fp == nullptr) return;
+	WriteKey(szkey);
+	WriteValue(v);
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::Write(const char* szkey, bool b)
+{
+	if (m_fp == nullptr) return;
+	WriteKey(szkey);
+	fputs((b ? "true" : "false"), m_fp);
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::Write(const char* szkey, const char* sz)
+{
+	if (m_fp == nullptr) return;
+	WriteKey(szkey);
+	WriteString(sz);
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::Write(const char* szkey, const double* v, int n)
+{
+	if (m_fp == nullptr) return;
+	WriteKey(szkey);
+	fputc('[', m_fp);
+	for (int i = 0; i < n; ++i)
+	{
+		if (i > 0) fputc(',', m_fp);
+		WriteValue(v[i]);
+	}
+	fputc(']', m_fp);
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::WriteTimerDeltas(FEModel& fem)
+{
+	if (m_fp == nullptr) return;
+
+	int ntimers = fem.Timers();
+	if ((int)m_timers.size() != ntimers) m_timers.assign(ntimers, 0.0);
+
+	BeginObject("timers");
+	for (int i = 0; i < ntimers; ++i)
+	{
+		double t = fem.GetTimer(i)->peek();
+
+		// the timers are reset at the start of each step
+		double dt = t - m_timers[i];
+		if (dt < 0.0) dt = t;
+		m_timers[i] = t;
+
+		if (i < (int)(sizeof(szTimerName) / sizeof(const char*))) Write(szTimerName[i], dt);
+		else
+		{
+			char szname[32];
+			sprintf(szname, "timer%d", i);
+			Write(szname, dt);
+		}
+	}
+	EndObject();
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::WriteKey(const char* szkey)
+{
+	if (m_bfirst == false) fputc(',', m_fp);
+	m_bfirst = false;
+	WriteString(szkey);
+	fputc(':', m_fp);
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::WriteString(const char* sz)
+{
+	fputc('\"', m_fp);
+	for (const char* c = sz; *c; ++c)
+	{
+		if ((*c == '\"') || (*c == '\\')) { fputc('\\', m_fp); fputc(*c, m_fp); }
+		else if ((unsigned char)(*c) < 0x20) fputc(' ', m_fp);
+		else fputc(*c, m_fp);
+	}
+	fputc('\"', m_fp);
+}
+
+//-----------------------------------------------------------------------------
+void FETelemetry::WriteValue(double v)
+{
+	// JSON has no representation for inf or nan
+	if ((v != v) || (fabs(v) > 1.7976931348623157e308)) fputs("null", m_fp);
+	else fprintf(m_fp, "%.9lg", v);
+}
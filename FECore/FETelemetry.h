@@ -0,0 +1,104 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include "Timer.h"
+#include <stdio.h>
+#include <vector>
+
+class FEModel;
+
+//-----------------------------------------------------------------------------
+//! This class writes a machine-readable stream of convergence data. Each record
+//! is written as a single line of JSON (i.e. the JSON-lines format), so that the 
+//! file can be parsed, or tailed, by monitoring tools while the model is running.
+//! The output is buffered and only flushed at the end of each time step, so the 
+//! overhead on the solver is negligible.
+class FECORE_API FETelemetry
+{
+public:
+	FETelemetry();
+	~FETelemetry();
+
+	//! open the telemetry file
+	bool Open(const char* szfile);
+
+	//! close the telemetry file
+	void Close();
+
+	//! see if the telemetry stream is open
+	bool IsOpen() const { return (m_fp != nullptr); }
+
+	//! flush the stream
+	void Flush();
+
+public:
+	//! start a new record of the given type
+	void BeginRecord(const char* sztype);
+
+	//! end the current record
+	void EndRecord();
+
+	//! start a nested object
+	void BeginObject(const char* szkey);
+
+	//! end a nested object
+	void EndObject();
+
+	//! write a key-value pair
+	void Write(const char* szkey, int n);
+	void Write(const char* szkey, double v);
+	void Write(const char* szkey, bool b);
+	void Write(const char* szkey, const char* sz);
+
+	//! write an array of values
+	void Write(const char* szkey, const double* v, int n);
+
+	//! Write the time spent in each of the model's timers since the last call
+	void WriteTimerDeltas(FEModel& fem);
+
+	//! return the wall time (in seconds) since the stream was opened
+	double WallTime();
+
+private:
+	FETelemetry(const FETelemetry&);
+	void operator = (const FETelemetry&);
+
+	void WriteKey(const char* szkey);
+	void WriteString(const char* sz);
+	void WriteValue(double v);
+
+private:
+	FILE*	m_fp;		//!< the telemetry file
+	bool	m_bfirst;	//!< the next item is the first item of the current object
+	Timer	m_wall;		//!< wall time since the stream was opened
+
+	std::vector<double>	m_timers;	//!< timer values at the last call to WriteTimerDeltas
+};
@@ -0,0 +1,120 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEThreadLocalVector.h"
+#include "FEModel.h"
+#include "sys.h"
+
+//-----------------------------------------------------------------------------
+FEThreadLocalVector::FEThreadLocalVector(FEModel& fem, vector<double>& R, vector<double>& Fr) : FEGlobalVector(fem, R, Fr)
+{
+}
+
+//-----------------------------------------------------------------------------
+void FEThreadLocalVector::Zero()
+{
+	// the number of threads may have changed since the last call
+	int nt = omp_get_max_threads();
+	if ((int)m_Rt.size() != nt)
+	{
+		m_Rt.resize(nt);
+		m_Frt.resize(nt);
+	}
+
+	// each thread clears its own copy
+	int NR = (int)m_R.size();
+	int NF = (int)m_Fr.size();
+#pragma omp parallel num_threads(nt)
+	{
+		int n = omp_get_thread_num();
+		m_Rt[n].assign(NR, 0.0);
+		m_Frt[n].assign(NF, 0.0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEThreadLocalVector::Reduce()
+{
+	const int nt = (int)m_Rt.size();
+	const int NR = (int)m_R.size();
+	const int NF = (int)m_Fr.size();
+
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NR; ++i)
+	{
+		double r = 0.0;
+		for (int n=0; n<nt; ++n) r += m_Rt[n][i];
+		m_R[i] += r;
+	}
+
+#pragma omp parallel for schedule(static)
+	for (int i=0; i<NF; ++i)
+	{
+		double f = 0.0;
+		for (int n=0; n<nt; ++n) f += m_Frt[n][i];
+		m_Fr[i] += f;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEThreadLocalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
+{
+	int n = omp_get_thread_num();
+	vector<double>& R = m_Rt[n];
+	vector<double>& Fr = m_Frt[n];
+
+	int ndof = (int)fe.size();
+	for (int i=0; i<ndof; ++i)
+	{
+		int I = elm[i];
+		if (I >= 0) R[I] += fe[i];
+		else if (-I-2 >= 0) Fr[-I-2] -= fe[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEThreadLocalVector::Assemble(vector<int>& lm, vector<double>& fe)
+{
+	vector<double>& R = m_Rt[omp_get_thread_num()];
+	const int n = (int)lm.size();
+	for (int i=0; i<n; ++i)
+	{
+		int nid = lm[i];
+		if (nid >= 0) R[nid] += fe[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEThreadLocalVector::Assemble(int nodeId, int dof, double f)
+{
+	FENode& node = m_fem.GetMesh().Node(nodeId);
+	int n = node.m_ID[dof];
+	if (n >= 0) m_Rt[omp_get_thread_num()][n] += f;
+}
@@ -0,0 +1,63 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "FEGlobalVector.h"
+
+//-----------------------------------------------------------------------------
+//! A global vector that gives each thread its own copy of the residual and
+//! reaction force arrays. Element vectors can then be assembled from inside
+//! a parallel loop without atomic updates. The thread copies must be cleared
+//! with Zero() before assembly starts and summed into the global arrays with
+//! Reduce() when assembly is done.
+class FECORE_API FEThreadLocalVector : public FEGlobalVector
+{
+public:
+	//! constructor
+	FEThreadLocalVector(FEModel& fem, vector<double>& R, vector<double>& Fr);
+
+	//! clear the thread copies
+	void Zero();
+
+	//! add the thread copies to the global arrays
+	void Reduce();
+
+	//! Assemble the element vector into this global vector
+	void Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom = false) override;
+
+	//! Assemble into this global vector
+	void Assemble(vector<int>& lm, vector<double>& fe) override;
+
+	//! assemble a nodel value
+	void Assemble(int node, int dof, double f) override;
+
+private:
+	vector< vector<double> >	m_Rt;	//!< thread copies of residual
+	vector< vector<double> >	m_Frt;	//!< thread copies of reaction forces
+};
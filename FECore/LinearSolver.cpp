@@ -110,6 +110,23 @@ void LinearSolver::Destroy()
 
 }
 
+//-----------------------------------------------------------------------------
+//! Solve for several right-hand sides by calling BackSolve for each one.
+bool LinearSolver::BackSolve(std::vector<double>& X, std::vector<double>& B, int nrhs)
+{
+	if (nrhs <= 0) return true;
+	size_t neq = B.size() / nrhs;
+	assert(neq*nrhs == B.size());
+	X.resize(B.size());
+	if (neq == 0) return true;
+
+	for (int k = 0; k < nrhs; ++k)
+	{
+		if (BackSolve(&X[k*neq], &B[k*neq]) == false) return false;
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! helper function for when this solver is used as a preconditioner
 bool LinearSolver::mult_vector(double* x, double* y)
@@ -83,6 +83,13 @@ public:
 	//! do a backsolve, i.e. solve for a right-hand side vector y (must be overridden)
 	virtual bool BackSolve(double* x, double* y) = 0;
 
+	//! Do a backsolve for several right-hand sides at once. B stores the nrhs right-hand sides
+	//! one after another (i.e. B[k*neq + i] is row i of right-hand side k) and the solutions 
+	//! are returned in the same layout in X. The default implementation solves for one 
+	//! right-hand side at a time. Direct solvers can override this to reuse the factorization
+	//! for all right-hand sides in one sweep.
+	virtual bool BackSolve(std::vector<double>& X, std::vector<double>& B, int nrhs);
+
 	//! Do any cleanup
 	virtual void Destroy();
 
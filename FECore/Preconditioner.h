@@ -76,6 +76,7 @@ public:
 
 	// apply to vector P x = y
 	bool BackSolve(double* x, double* y) override;
+	using LinearSolver::BackSolve;
 
 private:
 	vector<double>	m_D;
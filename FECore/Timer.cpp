@@ -38,7 +38,7 @@ SOFTWARE.*/
 #ifdef WIN32
 #define TIMER_TYPE clock_t
 #else
-#define TIMER_TYPE	time_t
+#define TIMER_TYPE	timespec
 #endif
 
 //-----------------------------------------------------------------------------
@@ -52,8 +52,8 @@ double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0);
 void sys_get_time(TIMER_TYPE& t) { t = clock(); }
 double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return (double) (t1 - t0) / CLOCKS_PER_SEC; }
 #else
-void sys_get_time(TIMER_TYPE& t) { time(&t); }
-double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return difftime(t1, t0); }
+void sys_get_time(TIMER_TYPE& t) { clock_gettime(CLOCK_MONOTONIC, &t); }
+double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return (double)(t1.tv_sec - t0.tv_sec) + 1e-9*(double)(t1.tv_nsec - t0.tv_nsec); }
 #endif
 
 //-----------------------------------------------------------------------------
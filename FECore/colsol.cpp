@@ -170,6 +170,53 @@ FECORE_API void colsol_solve(int N, double* values, int* pointers, double* R)
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Back substitution for several right hand sides at once. The nrhs vectors in R
+// are interleaved, i.e. R[i*nrhs + k] is row i of right hand side k. This way each 
+// coefficient of the factored matrix is loaded once for all right hand sides, and
+// the inner loops run over contiguous memory. The operations for each right hand 
+// side are the same as in colsol_solve.
+
+FECORE_API void colsol_solve_multi(int N, double* values, int* pointers, double* R, int nrhs)
+{
+	int i, mi, r, k;
+
+	// calculate V = L^(-T)*R vectors
+	for (i=1; i<N; ++i)
+	{
+		mi = i+1 - pointers[i+1] + pointers[i];
+		double* Ri = R + (size_t)i*nrhs;
+		for (r=mi; r<i; ++r)
+		{
+			const double kir = values[ pointers[i] + i - r];
+			const double* Rr = R + (size_t)r*nrhs;
+			for (k=0; k<nrhs; ++k) Ri[k] -= kir*Rr[k];
+		}
+	}
+
+	// calculate Vbar = D^(-1)*V
+	for (i=0; i<N; ++i)
+	{
+		const double di = values[ pointers[i] ];
+		double* Ri = R + (size_t)i*nrhs;
+		for (k=0; k<nrhs; ++k) Ri[k] /= di;
+	}
+
+	// calculate the solutions
+	for (i=N-1; i>0; --i)
+	{
+		mi = i+1 - pointers[i+1] + pointers[i];
+
+		const double* Ri = R + (size_t)i*nrhs;
+		const int pi = pointers[i] + i;
+		for (r=mi; r<i; ++r)
+		{
+			const double kri = values[ pi - r ];
+			double* Rr = R + (size_t)r*nrhs;
+			for (k=0; k<nrhs; ++k) Rr[k] -= kri*Ri[k];
+		}
+	}
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // This LU solver is grabbed from Numerical Recipes in C.
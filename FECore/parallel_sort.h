@@ -0,0 +1,72 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "sys.h"
+
+//-----------------------------------------------------------------------------
+//! Sort a vector in parallel. The vector is split into one block per thread,
+//! the blocks are sorted concurrently and then merged pairwise. Small arrays
+//! are sorted serially. The sort is not stable, so keys should be unique 
+//! (e.g. by packing the item index into the key) if the order of equal items matters.
+template <class T> void parallel_sort(std::vector<T>& v)
+{
+	const int N = (int)v.size();
+	int nt = omp_get_max_threads();
+	if ((nt < 2) || (N < 16384))
+	{
+		std::sort(v.begin(), v.end());
+		return;
+	}
+
+	// block boundaries
+	std::vector<int> start(nt + 1);
+	for (int i = 0; i <= nt; ++i) start[i] = (int)(((long long)N * i) / nt);
+
+	// sort the blocks
+#pragma omp parallel for schedule(static, 1) num_threads(nt)
+	for (int i = 0; i < nt; ++i)
+		std::sort(v.begin() + start[i], v.begin() + start[i + 1]);
+
+	// merge the blocks
+	for (int w = 1; w < nt; w *= 2)
+	{
+		int pairs = (nt + 2*w - 1) / (2*w);
+#pragma omp parallel for schedule(static, 1)
+		for (int i = 0; i < pairs; ++i)
+		{
+			int i0 = 2*w*i;
+			int i1 = std::min(i0 + w, nt);
+			int i2 = std::min(i0 + 2*w, nt);
+			if (i1 < i2) std::inplace_merge(v.begin() + start[i0], v.begin() + start[i1], v.begin() + start[i2]);
+		}
+	}
+}
@@ -49,7 +49,15 @@ SOFTWARE.*/
 #ifdef WIN32
 extern "C" int __cdecl omp_get_num_threads(void);
 extern "C" int __cdecl omp_get_thread_num(void);
+extern "C" int __cdecl omp_get_max_threads(void);
+extern "C" void __cdecl omp_set_num_threads(int);
+extern "C" void __cdecl omp_set_nested(int);
+extern "C" int __cdecl omp_get_nested(void);
 #else
 extern "C" int omp_get_num_threads(void);
 extern "C" int omp_get_thread_num(void);
+extern "C" int omp_get_max_threads(void);
+extern "C" void omp_set_num_threads(int);
+extern "C" void omp_set_nested(int);
+extern "C" int omp_get_nested(void);
 #endif
@@ -0,0 +1,546 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "tens4ds_batch.h"
+#include "FEElement.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+	// component order of mat3ds
+	enum { XX, XY, YY, XZ, YZ, ZZ };
+
+	// number of lanes in a block
+	const int L = tens4ds_batch::LANES;
+}
+
+// Lane accessors used by the kernels below. These access component i of 
+// lane l in the current block.
+#define A(i) pa[(i)*L + l]
+#define B(i) pb[(i)*L + l]
+#define C(i) pc[(i)*L + l]
+#define M(i) pm[(i)*L + l]
+#define S(i) ps[(i)*L + l]
+
+//=============================================================================
+void mat3d_batch::set(int n, const mat3d& a)
+{
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j) (*this)(n, 3*i + j) = a(i, j);
+}
+
+//-----------------------------------------------------------------------------
+mat3d mat3d_batch::get(int n) const
+{
+	const mat3d_batch& m = *this;
+	return mat3d(m(n, 0), m(n, 1), m(n, 2), m(n, 3), m(n, 4), m(n, 5), m(n, 6), m(n, 7), m(n, 8));
+}
+
+//=============================================================================
+void mat3ds_batch::set(int n, const mat3ds& a)
+{
+	mat3ds_batch& m = *this;
+	m(n, XX) = a.xx(); m(n, XY) = a.xy(); m(n, YY) = a.yy();
+	m(n, XZ) = a.xz(); m(n, YZ) = a.yz(); m(n, ZZ) = a.zz();
+}
+
+//-----------------------------------------------------------------------------
+mat3ds mat3ds_batch::get(int n) const
+{
+	const mat3ds_batch& m = *this;
+	return mat3ds(m(n, XX), m(n, YY), m(n, ZZ), m(n, XY), m(n, YZ), m(n, XZ));
+}
+
+//=============================================================================
+void tens4ds_batch::set(int n, const tens4ds& a)
+{
+	for (int i = 0; i < NNZ; ++i) (*this)(n, i) = a.d[i];
+}
+
+//-----------------------------------------------------------------------------
+tens4ds tens4ds_batch::get(int n) const
+{
+	tens4ds a;
+	for (int i = 0; i < NNZ; ++i) a.d[i] = (*this)(n, i);
+	return a;
+}
+
+//=============================================================================
+// (a dyad1s a)_ijkl = a_ij a_kl
+static void dyad1s_block(const double* __restrict pa, double* __restrict pc)
+{
+	for (int l = 0; l < L; ++l)
+	{
+		C( 0) = A(XX)*A(XX);
+		C( 1) = A(XX)*A(YY);
+		C( 2) = A(YY)*A(YY);
+		C( 3) = A(XX)*A(ZZ);
+		C( 4) = A(YY)*A(ZZ);
+		C( 5) = A(ZZ)*A(ZZ);
+		C( 6) = A(XX)*A(XY);
+		C( 7) = A(YY)*A(XY);
+		C( 8) = A(ZZ)*A(XY);
+		C( 9) = A(XY)*A(XY);
+		C(10) = A(XX)*A(YZ);
+		C(11) = A(YY)*A(YZ);
+		C(12) = A(ZZ)*A(YZ);
+		C(13) = A(XY)*A(YZ);
+		C(14) = A(YZ)*A(YZ);
+		C(15) = A(XX)*A(XZ);
+		C(16) = A(YY)*A(XZ);
+		C(17) = A(ZZ)*A(XZ);
+		C(18) = A(XY)*A(XZ);
+		C(19) = A(YZ)*A(XZ);
+		C(20) = A(XZ)*A(XZ);
+	}
+}
+
+void dyad1s(const mat3ds_batch& a, tens4ds_batch& c)
+{
+	const int c_nb = c.blocks();
+	assert(a.blocks() == c_nb);
+	for (int k = 0; k < c_nb; ++k) dyad1s_block(a.block(k), c.block(k));
+}
+
+//-----------------------------------------------------------------------------
+// (a dyad1s b)_ijkl = a_ij b_kl + b_ij a_kl
+static void dyad1s_block(const double* __restrict pa, const double* __restrict pb, double* __restrict pc)
+{
+	for (int l = 0; l < L; ++l)
+	{
+		C( 0) = 2*A(XX)*B(XX);
+		C( 1) = A(XX)*B(YY) + B(XX)*A(YY);
+		C( 2) = 2*A(YY)*B(YY);
+		C( 3) = A(XX)*B(ZZ) + B(XX)*A(ZZ);
+		C( 4) = A(YY)*B(ZZ) + B(YY)*A(ZZ);
+		C( 5) = 2*A(ZZ)*B(ZZ);
+		C( 6) = A(XX)*B(XY) + B(XX)*A(XY);
+		C( 7) = A(YY)*B(XY) + B(YY)*A(XY);
+		C( 8) = A(ZZ)*B(XY) + B(ZZ)*A(XY);
+		C( 9) = 2*A(XY)*B(XY);
+		C(10) = A(XX)*B(YZ) + B(XX)*A(YZ);
+		C(11) = A(YY)*B(YZ) + B(YY)*A(YZ);
+		C(12) = A(ZZ)*B(YZ) + B(ZZ)*A(YZ);
+		C(13) = A(XY)*B(YZ) + B(XY)*A(YZ);
+		C(14) = 2*A(YZ)*B(YZ);
+		C(15) = A(XX)*B(XZ) + B(XX)*A(XZ);
+		C(16) = A(YY)*B(XZ) + B(YY)*A(XZ);
+		C(17) = A(ZZ)*B(XZ) + B(ZZ)*A(XZ);
+		C(18) = A(XY)*B(XZ) + B(XY)*A(XZ);
+		C(19) = A(YZ)*B(XZ) + B(YZ)*A(XZ);
+		C(20) = 2*A(XZ)*B(XZ);
+	}
+}
+
+void dyad1s(const mat3ds_batch& a, const mat3ds_batch& b, tens4ds_batch& c)
+{
+	const int c_nb = c.blocks();
+	assert((a.blocks() == c_nb) && (b.blocks() == c_nb));
+	for (int k = 0; k < c_nb; ++k) dyad1s_block(a.block(k), b.block(k), c.block(k));
+}
+
+//-----------------------------------------------------------------------------
+// (a dyad4s a)_ijkl = (a_ik a_jl + a_il a_jk)/2
+static void dyad4s_block(const double* __restrict pa, double* __restrict pc)
+{
+	for (int l = 0; l < L; ++l)
+	{
+		C( 0) = A(XX)*A(XX);
+		C( 1) = A(XY)*A(XY);
+		C( 2) = A(YY)*A(YY);
+		C( 3) = A(XZ)*A(XZ);
+		C( 4) = A(YZ)*A(YZ);
+		C( 5) = A(ZZ)*A(ZZ);
+		C( 6) = A(XX)*A(XY);
+		C( 7) = A(XY)*A(YY);
+		C( 8) = A(XZ)*A(YZ);
+		C( 9) = 0.5*(A(XX)*A(YY) + A(XY)*A(XY));
+		C(10) = A(XY)*A(XZ);
+		C(11) = A(YY)*A(YZ);
+		C(12) = A(YZ)*A(ZZ);
+		C(13) = 0.5*(A(XY)*A(YZ) + A(XZ)*A(YY));
+		C(14) = 0.5*(A(YY)*A(ZZ) + A(YZ)*A(YZ));
+		C(15) = A(XX)*A(XZ);
+		C(16) = A(XY)*A(YZ);
+		C(17) = A(XZ)*A(ZZ);
+		C(18) = 0.5*(A(XX)*A(YZ) + A(XZ)*A(XY));
+		C(19) = 0.5*(A(XY)*A(ZZ) + A(YZ)*A(XZ));
+		C(20) = 0.5*(A(XX)*A(ZZ) + A(XZ)*A(XZ));
+	}
+}
+
+void dyad4s(const mat3ds_batch& a, tens4ds_batch& c)
+{
+	const int c_nb = c.blocks();
+	assert(a.blocks() == c_nb);
+	for (int k = 0; k < c_nb; ++k) dyad4s_block(a.block(k), c.block(k));
+}
+
+//-----------------------------------------------------------------------------
+// (a dyad4s b)_ijkl = (a_ik b_jl + a_il b_jk)/2 +  (b_ik a_jl + b_il a_jk)/2
+static void dyad4s_block(const double* __restrict pa, const double* __restrict pb, double* __restrict pc)
+{
+	for (int l = 0; l < L; ++l)
+	{
+		C( 0) = 2*A(XX)*B(XX);
+		C( 1) = 2*A(XY)*B(XY);
+		C( 2) = 2*A(YY)*B(YY);
+		C( 3) = 2*A(XZ)*B(XZ);
+		C( 4) = 2*A(YZ)*B(YZ);
+		C( 5) = 2*A(ZZ)*B(ZZ);
+		C( 6) = A(XX)*B(XY) + B(XX)*A(XY);
+		C( 7) = A(XY)*B(YY) + B(XY)*A(YY);
+		C( 8) = A(XZ)*B(YZ) + B(XZ)*A(YZ);
+		C( 9) = 0.5*(A(XX)*B(YY) + A(XY)*B(XY) + B(XX)*A(YY) + B(XY)*A(XY));
+		C(10) = A(XY)*B(XZ) + B(XY)*A(XZ);
+		C(11) = A(YY)*B(YZ) + B(YY)*A(YZ);
+		C(12) = A(YZ)*B(ZZ) + B(YZ)*A(ZZ);
+		C(13) = 0.5*(A(XY)*B(YZ) + A(XZ)*B(YY) + B(XY)*A(YZ) + B(XZ)*A(YY));
+		C(14) = 0.5*(A(YY)*B(ZZ) + A(YZ)*B(YZ) + B(YY)*A(ZZ) + B(YZ)*A(YZ));
+		C(15) = A(XX)*B(XZ) + B(XX)*A(XZ);
+		C(16) = A(XY)*B(YZ) + B(XY)*A(YZ);
+		C(17) = A(XZ)*B(ZZ) + B(XZ)*A(ZZ);
+		C(18) = 0.5*(A(XX)*B(YZ) + A(XZ)*B(XY) + B(XX)*A(YZ) + B(XZ)*A(XY));
+		C(19) = 0.5*(A(XY)*B(ZZ) + A(YZ)*B(XZ) + B(XY)*A(ZZ) + B(YZ)*A(XZ));
+		C(20) = 0.5*(A(XX)*B(ZZ) + A(XZ)*B(XZ) + B(XX)*A(ZZ) + B(XZ)*A(XZ));
+	}
+}
+
+void dyad4s(const mat3ds_batch& a, const mat3ds_batch& b, tens4ds_batch& c)
+{
+	const int c_nb = c.blocks();
+	assert((a.blocks() == c_nb) && (b.blocks() == c_nb));
+	for (int k = 0; k < c_nb; ++k) dyad4s_block(a.block(k), b.block(k), c.block(k));
+}
+
+//-----------------------------------------------------------------------------
+// (a ddots b)_ijkl = a_ijmn b_mnkl + b_ijmn a_mnkl
+static void ddots_block(const double* __restrict pa, const double* __restrict pb, double* __restrict pc)
+{
+	for (int l = 0; l < L; ++l)
+	{
+		C( 0) = 2*A(0)*B(0) + 2*A(1)*B(1) + 2*A(3)*B(3)
+		      + 2*(2*A(6)*B(6) + 2*A(10)*B(10) + 2*A(15)*B(15));
+		C( 1) = A(0)*B(1) + B(0)*A(1) + A(1)*B(2) + B(1)*A(2) + A(3)*B(4) + B(3)*A(4)
+		      + 2*(A(6)*B(7) + B(6)*A(7) + A(10)*B(11) + B(10)*A(11) + A(15)*B(16) + B(15)*A(16));
+		C( 2) = 2*A(1)*B(1) + 2*A(2)*B(2) + 2*A(4)*B(4)
+		      + 2*(2*A(7)*B(7) + 2*A(11)*B(11) + 2*A(16)*B(16));
+		C( 3) = A(0)*B(3) + B(0)*A(3) + A(1)*B(4) + B(1)*A(4) + A(3)*B(5) + B(3)*A(5)
+		      + 2*(A(6)*B(8) + B(6)*A(8) + A(10)*B(12) + B(10)*A(12) + A(15)*B(17) + B(15)*A(17));
+		C( 4) = A(1)*B(3) + B(1)*A(3) + A(2)*B(4) + B(2)*A(4) + A(4)*B(5) + B(4)*A(5)
+		      + 2*(A(7)*B(8) + B(7)*A(8) + A(11)*B(12) + B(11)*A(12) + A(16)*B(17) + B(16)*A(17));
+		C( 5) = 2*A(3)*B(3) + 2*A(4)*B(4) + 2*A(5)*B(5)
+		      + 2*(2*A(8)*B(8) + 2*A(12)*B(12) + 2*A(17)*B(17));
+		C( 6) = A(0)*B(6) + B(0)*A(6) + A(1)*B(7) + B(1)*A(7) + A(3)*B(8) + B(3)*A(8)
+		      + 2*(A(6)*B(9) + B(6)*A(9) + A(10)*B(13) + B(10)*A(13) + A(15)*B(18) + B(15)*A(18));
+		C( 7) = A(1)*B(6) + B(1)*A(6) + A(2)*B(7) + B(2)*A(7) + A(4)*B(8) + B(4)*A(8)
+		      + 2*(A(7)*B(9) + B(7)*A(9) + A(11)*B(13) + B(11)*A(13) + A(16)*B(18) + B(16)*A(18));
+		C( 8) = A(3)*B(6) + B(3)*A(6) + A(4)*B(7) + B(4)*A(7) + A(5)*B(8) + B(5)*A(8)
+		      + 2*(A(8)*B(9) + B(8)*A(9) + A(12)*B(13) + B(12)*A(13) + A(17)*B(18) + B(17)*A(18));
+		C( 9) = 2*A(6)*B(6) + 2*A(7)*B(7) + 2*A(8)*B(8)
+		      + 2*(2*A(9)*B(9) + 2*A(13)*B(13) + 2*A(18)*B(18));
+		C(10) = A(0)*B(10) + B(0)*A(10) + A(1)*B(11) + B(1)*A(11) + A(3)*B(12) + B(3)*A(12)
+		      + 2*(A(6)*B(13) + B(6)*A(13) + A(10)*B(14) + B(10)*A(14) + A(15)*B(19) + B(15)*A(19));
+		C(11) = A(1)*B(10) + B(1)*A(10) + A(2)*B(11) + B(2)*A(11) + A(4)*B(12) + B(4)*A(12)
+		      + 2*(A(7)*B(13) + B(7)*A(13) + A(11)*B(14) + B(11)*A(14) + A(16)*B(19) + B(16)*A(19));
+		C(12) = A(3)*B(10) + B(3)*A(10) + A(4)*B(11) + B(4)*A(11) + A(5)*B(12) + B(5)*A(12)
+		      + 2*(A(8)*B(13) + B(8)*A(13) + A(12)*B(14) + B(12)*A(14) + A(17)*B(19) + B(17)*A(19));
+		C(13) = A(6)*B(10) + B(6)*A(10) + A(7)*B(11) + B(7)*A(11) + A(8)*B(12) + B(8)*A(12)
+		      + 2*(A(9)*B(13) + B(9)*A(13) + A(13)*B(14) + B(13)*A(14) + A(18)*B(19) + B(18)*A(19));
+		C(14) = 2*A(10)*B(10) + 2*A(11)*B(11) + 2*A(12)*B(12)
+		      + 2*(2*A(13)*B(13) + 2*A(14)*B(14) + 2*A(19)*B(19));
+		C(15) = A(0)*B(15) + B(0)*A(15) + A(1)*B(16) + B(1)*A(16) + A(3)*B(17) + B(3)*A(17)
+		      + 2*(A(6)*B(18) + B(6)*A(18) + A(10)*B(19) + B(10)*A(19) + A(15)*B(20) + B(15)*A(20));
+		C(16) = A(1)*B(15) + B(1)*A(15) + A(2)*B(16) + B(2)*A(16) + A(4)*B(17) + B(4)*A(17)
+		      + 2*(A(7)*B(18) + B(7)*A(18) + A(11)*B(19) + B(11)*A(19) + A(16)*B(20) + B(16)*A(20));
+		C(17) = A(3)*B(15) + B(3)*A(15) + A(4)*B(16) + B(4)*A(16) + A(5)*B(17) + B(5)*A(17)
+		      + 2*(A(8)*B(18) + B(8)*A(18) + A(12)*B(19) + B(12)*A(19) + A(17)*B(20) + B(17)*A(20));
+		C(18) = A(6)*B(15) + B(6)*A(15) + A(7)*B(16) + B(7)*A(16) + A(8)*B(17) + B(8)*A(17)
+		      + 2*(A(9)*B(18) + B(9)*A(18) + A(13)*B(19) + B(13)*A(19) + A(18)*B(20) + B(18)*A(20));
+		C(19) = A(10)*B(15) + B(10)*A(15) + A(11)*B(16) + B(11)*A(16) + A(12)*B(17) + B(12)*A(17)
+		      + 2*(A(13)*B(18) + B(13)*A(18) + A(14)*B(19) + B(14)*A(19) + A(19)*B(20) + B(19)*A(20));
+		C(20) = 2*A(15)*B(15) + 2*A(16)*B(16) + 2*A(17)*B(17)
+		      + 2*(2*A(18)*B(18) + 2*A(19)*B(19) + 2*A(20)*B(20));
+	}
+}
+
+void ddots(const tens4ds_batch& a, const tens4ds_batch& b, tens4ds_batch& c)
+{
+	const int c_nb = c.blocks();
+	assert((a.blocks() == c_nb) && (b.blocks() == c_nb));
+	for (int k = 0; k < c_nb; ++k) ddots_block(a.block(k), b.block(k), c.block(k));
+}
+
+//-----------------------------------------------------------------------------
+// s_ij = c_ijkl m_kl
+static void ddot_block(const double* __restrict pc, const double* __restrict pm, double* __restrict ps)
+{
+	for (int l = 0; l < L; ++l)
+	{
+		S(XX) = C( 0)*M(XX) + C( 1)*M(YY) + C( 3)*M(ZZ) + 2*(C( 6)*M(XY) + C(10)*M(YZ) + C(15)*M(XZ));
+		S(YY) = C( 1)*M(XX) + C( 2)*M(YY) + C( 4)*M(ZZ) + 2*(C( 7)*M(XY) + C(11)*M(YZ) + C(16)*M(XZ));
+		S(ZZ) = C( 3)*M(XX) + C( 4)*M(YY) + C( 5)*M(ZZ) + 2*(C( 8)*M(XY) + C(12)*M(YZ) + C(17)*M(XZ));
+		S(XY) = C( 6)*M(XX) + C( 7)*M(YY) + C( 8)*M(ZZ) + 2*(C( 9)*M(XY) + C(13)*M(YZ) + C(18)*M(XZ));
+		S(YZ) = C(10)*M(XX) + C(11)*M(YY) + C(12)*M(ZZ) + 2*(C(13)*M(XY) + C(14)*M(YZ) + C(19)*M(XZ));
+		S(XZ) = C(15)*M(XX) + C(16)*M(YY) + C(17)*M(ZZ) + 2*(C(18)*M(XY) + C(19)*M(YZ) + C(20)*M(XZ));
+	}
+}
+
+void ddot(const tens4ds_batch& c, const mat3ds_batch& m, mat3ds_batch& s)
+{
+	const int c_nb = c.blocks();
+	assert((m.blocks() == c_nb) && (s.blocks() == c_nb));
+	for (int k = 0; k < c_nb; ++k) ddot_block(c.block(k), m.block(k), s.block(k));
+}
+
+//-----------------------------------------------------------------------------
+// In Voigt notation the push-forward is r = Q*c*Q^T, where Q_ab = F_iK F_jL + F_iL F_jK 
+// for a = (ij), b = (KL) and K != L, and Q_ab = F_iK F_jK for K == L.
+static void pp_block(const double* __restrict pc, const double* __restrict pf, double* __restrict pr)
+{
+	// Voigt pairs and the position of the Voigt component (a,b) in tens4ds::d
+	static const int vi[6] = { 0, 1, 2, 0, 1, 0 };
+	static const int vj[6] = { 0, 1, 2, 1, 2, 2 };
+	static const int id[6][6] = {
+		{  0,  1,  3,  6, 10, 15 },
+		{  1,  2,  4,  7, 11, 16 },
+		{  3,  4,  5,  8, 12, 17 },
+		{  6,  7,  8,  9, 13, 18 },
+		{ 10, 11, 12, 13, 14, 19 },
+		{ 15, 16, 17, 18, 19, 20 }};
+
+	double Q[36][L], T[36][L];
+	for (int a = 0; a < 6; ++a)
+		for (int b = 0; b < 6; ++b)
+		{
+			const double* Fi = pf + (3*vi[a])*L;
+			const double* Fj = pf + (3*vj[a])*L;
+			const int K = vi[b], M = vj[b];
+			double* q = Q[6*a + b];
+			if (K == M) for (int l = 0; l < L; ++l) q[l] = Fi[K*L + l]*Fj[K*L + l];
+			else for (int l = 0; l < L; ++l) q[l] = Fi[K*L + l]*Fj[M*L + l] + Fi[M*L + l]*Fj[K*L + l];
+		}
+
+	// T = Q*c
+	for (int a = 0; a < 6; ++a)
+		for (int b = 0; b < 6; ++b)
+		{
+			double* t = T[6*a + b];
+			for (int l = 0; l < L; ++l) t[l] = 0.0;
+			for (int k = 0; k < 6; ++k)
+			{
+				const double* q = Q[6*a + k];
+				const double* c = pc + id[k][b]*L;
+				for (int l = 0; l < L; ++l) t[l] += q[l]*c[l];
+			}
+		}
+
+	// r = T*Q^T (upper triangle only)
+	for (int b = 0; b < 6; ++b)
+		for (int a = 0; a <= b; ++a)
+		{
+			double* r = pr + id[a][b]*L;
+			for (int l = 0; l < L; ++l) r[l] = 0.0;
+			for (int k = 0; k < 6; ++k)
+			{
+				const double* t = T[6*a + k];
+				const double* q = Q[6*b + k];
+				for (int l = 0; l < L; ++l) r[l] += t[l]*q[l];
+			}
+		}
+}
+
+void pp(const tens4ds_batch& c, const mat3d_batch& F, tens4ds_batch& r)
+{
+	const int r_nb = r.blocks();
+	assert((c.blocks() == r_nb) && (F.blocks() == r_nb));
+	for (int k = 0; k < r_nb; ++k) pp_block(c.block(k), F.block(k), r.block(k));
+}
+
+//-----------------------------------------------------------------------------
+// This is the same expression as in FEElasticSolidDomain::ElementMaterialStiffness,
+// but it is vectorized over the nodes instead of the points: for each point, D*BL 
+// is evaluated for all nodes j at once, and then contracted with BL of node i. The
+// result is accumulated in a node-contiguous buffer, which avoids reductions over
+// the lanes and the stride of ke. 
+void add_material_stiffness(const tens4ds_batch& c, const vec3d* G, const double* w, int neln, matrix& ke)
+{
+	const int N = c.size();
+	const int MN = FEElement::MAX_NODES;
+	assert(neln <= MN);
+	assert((ke.rows() >= 3*neln) && (ke.columns() >= 3*neln));
+
+	// K[3*i + a][b][j] accumulates ke[3*i + a][3*j + b]
+	double K[3*MN][3][MN];
+	for (int i = 0; i < 3*neln; ++i)
+		for (int b = 0; b < 3; ++b)
+			for (int j = 0; j < neln; ++j) K[i][b][j] = 0.0;
+
+	// shape function gradients and D*BL of all nodes
+	double Gx[MN], Gy[MN], Gz[MN];
+	double DBL[18][MN];
+
+	for (int n = 0; n < N; ++n)
+	{
+		// tangent at this point
+		const double* pc = c.block(n / L) + n % L;
+		double D[tens4ds::NNZ];
+		for (int m = 0; m < tens4ds::NNZ; ++m) D[m] = pc[m*L];
+
+		const vec3d* Gn = G + n*neln;
+		for (int j = 0; j < neln; ++j) { Gx[j] = Gn[j].x; Gy[j] = Gn[j].y; Gz[j] = Gn[j].z; }
+
+		// D*BL, multiplied by the weight
+		const double wn = w[n];
+		for (int j = 0; j < neln; ++j)
+		{
+			const double gx = Gx[j]*wn, gy = Gy[j]*wn, gz = Gz[j]*wn;
+
+			DBL[ 0][j] = D[ 0]*gx + D[ 6]*gy + D[15]*gz;
+			DBL[ 1][j] = D[ 1]*gy + D[ 6]*gx + D[10]*gz;
+			DBL[ 2][j] = D[ 3]*gz + D[10]*gy + D[15]*gx;
+
+			DBL[ 3][j] = D[ 1]*gx + D[ 7]*gy + D[16]*gz;
+			DBL[ 4][j] = D[ 2]*gy + D[ 7]*gx + D[11]*gz;
+			DBL[ 5][j] = D[ 4]*gz + D[11]*gy + D[16]*gx;
+
+			DBL[ 6][j] = D[ 3]*gx + D[ 8]*gy + D[17]*gz;
+			DBL[ 7][j] = D[ 4]*gy + D[ 8]*gx + D[12]*gz;
+			DBL[ 8][j] = D[ 5]*gz + D[12]*gy + D[17]*gx;
+
+			DBL[ 9][j] = D[ 6]*gx + D[ 9]*gy + D[18]*gz;
+			DBL[10][j] = D[ 7]*gy + D[ 9]*gx + D[13]*gz;
+			DBL[11][j] = D[ 8]*gz + D[13]*gy + D[18]*gx;
+
+			DBL[12][j] = D[10]*gx + D[13]*gy + D[19]*gz;
+			DBL[13][j] = D[11]*gy + D[13]*gx + D[14]*gz;
+			DBL[14][j] = D[12]*gz + D[14]*gy + D[19]*gx;
+
+			DBL[15][j] = D[15]*gx + D[18]*gy + D[20]*gz;
+			DBL[16][j] = D[16]*gy + D[18]*gx + D[19]*gz;
+			DBL[17][j] = D[17]*gz + D[19]*gy + D[20]*gx;
+		}
+
+		// BL^T*D*BL
+		for (int i = 0; i < neln; ++i)
+		{
+			const double gx = Gx[i], gy = Gy[i], gz = Gz[i];
+			for (int b = 0; b < 3; ++b)
+			{
+				double* __restrict k0 = K[3*i    ][b];
+				double* __restrict k1 = K[3*i + 1][b];
+				double* __restrict k2 = K[3*i + 2][b];
+				const double* __restrict d0 = DBL[b];
+				const double* __restrict d1 = DBL[3 + b];
+				const double* __restrict d2 = DBL[6 + b];
+				const double* __restrict d3 = DBL[9 + b];
+				const double* __restrict d4 = DBL[12 + b];
+				const double* __restrict d5 = DBL[15 + b];
+				for (int j = 0; j < neln; ++j)
+				{
+					k0[j] += gx*d0[j] + gy*d3[j] + gz*d5[j];
+					k1[j] += gy*d1[j] + gx*d3[j] + gz*d4[j];
+					k2[j] += gz*d2[j] + gy*d4[j] + gx*d5[j];
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < 3*neln; ++i)
+		for (int j = 0, j3 = 0; j < neln; ++j, j3 += 3)
+		{
+			ke[i][j3    ] += K[i][0][j];
+			ke[i][j3 + 1] += K[i][1][j];
+			ke[i][j3 + 2] += K[i][2][j];
+		}
+}
+
+//-----------------------------------------------------------------------------
+// c += a*s
+void axpy(const tens4ds_batch& a, const double* s, tens4ds_batch& c)
+{
+	const int N = c.size();
+	assert(a.size() == N);
+	for (int k = 0; k < c.blocks(); ++k)
+	{
+		const double* __restrict pa = a.block(k);
+		const double* __restrict ps = s + k*L;
+		double* __restrict pc = c.block(k);
+		const int nl = (N - k*L < L ? N - k*L : L);
+		for (int i = 0; i < tens4ds::NNZ; ++i)
+			for (int l = 0; l < nl; ++l) C(i) += A(i)*ps[l];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// c *= s
+void scale(const double* s, tens4ds_batch& c)
+{
+	const int N = c.size();
+	for (int k = 0; k < c.blocks(); ++k)
+	{
+		const double* __restrict ps = s + k*L;
+		double* __restrict pc = c.block(k);
+		const int nl = (N - k*L < L ? N - k*L : L);
+		for (int i = 0; i < tens4ds::NNZ; ++i)
+			for (int l = 0; l < nl; ++l) C(i) *= ps[l];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// c += lam*(I dyad1s I) + 2*mu*(I dyad4s I)
+void add_isotropic(const double* lam, const double* mu, tens4ds_batch& c)
+{
+	const int N = c.size();
+	for (int k = 0; k < c.blocks(); ++k)
+	{
+		const double* __restrict pl = lam + k*L;
+		const double* __restrict pu = mu + k*L;
+		double* __restrict pc = c.block(k);
+		const int nl = (N - k*L < L ? N - k*L : L);
+		for (int l = 0; l < nl; ++l)
+		{
+			C( 0) += pl[l] + 2.0*pu[l];
+			C( 1) += pl[l];
+			C( 2) += pl[l] + 2.0*pu[l];
+			C( 3) += pl[l];
+			C( 4) += pl[l];
+			C( 5) += pl[l] + 2.0*pu[l];
+			C( 9) += pu[l];
+			C(14) += pu[l];
+			C(20) += pu[l];
+		}
+	}
+}
+
+#undef A
+#undef B
+#undef C
+#undef M
+#undef S
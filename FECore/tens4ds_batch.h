@@ -0,0 +1,205 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "tens4d.h"
+#include "matrix.h"
+#include "fecore_api.h"
+#include <vector>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+// Batched versions of the tensor classes that material models can use to 
+// evaluate many integration points at once. 
+// The tensors are stored in blocks of LANES points. Within a block, component i 
+// of all points is stored contiguously, i.e. component i of point n is found at
+//
+//   d[(n/LANES)*NNZ*LANES + i*LANES + n%LANES]
+//
+// The batch kernels evaluate the same expressions as the mat3ds/tens4ds operators,
+// but for all lanes of a block at once, which the compiler turns into SIMD code.
+// The components are stored in the same order as in mat3d, mat3ds and tens4ds. 
+// The unused lanes of the last block are zero.
+//
+// A batch either owns its storage, or uses a buffer provided by the caller, 
+// which allows materials to keep the batches of an element on the stack.
+
+//-----------------------------------------------------------------------------
+//! Storage of a batch of tensors with NNZ components
+template <int NNZ_> class tensor_batch
+{
+public:
+	enum { NNZ = NNZ_, LANES = 8 };
+
+public:
+	tensor_batch() : m_n(0), m_nb(0), m_pd(nullptr) {}
+
+	//! allocate storage for n tensors (initialized to zero)
+	explicit tensor_batch(int n) : m_n(0), m_nb(0), m_pd(nullptr) { resize(n); }
+
+	//! use the buffer buf for n tensors. The buffer must hold at least 
+	//! buffer_size(n) values and is initialized to zero.
+	tensor_batch(int n, double* buf) : m_n(n), m_nb((n + LANES - 1) / LANES), m_pd(buf) { zero(); }
+
+	tensor_batch(const tensor_batch& a) : m_n(0), m_nb(0), m_pd(nullptr) { *this = a; }
+
+	//! copies the values. A batch that uses an external buffer must have the same size.
+	tensor_batch& operator = (const tensor_batch& a)
+	{
+		if (a.m_n != m_n)
+		{
+			assert(m_buf.empty() == false || m_pd == nullptr);
+			resize(a.m_n);
+		}
+		std::copy(a.m_pd, a.m_pd + buffer_size(m_n), m_pd);
+		return *this;
+	}
+
+	//! number of values needed to store n tensors
+	static int buffer_size(int n) { return ((n + LANES - 1) / LANES)*NNZ*LANES; }
+
+	//! allocate storage for n tensors (initialized to zero)
+	void resize(int n)
+	{
+		m_n = n;
+		m_nb = (n + LANES - 1) / LANES;
+		m_buf.assign(buffer_size(n), 0.0);
+		m_pd = (m_buf.empty() ? nullptr : &m_buf[0]);
+	}
+
+	//! number of tensors in batch
+	int size() const { return m_n; }
+
+	//! number of blocks
+	int blocks() const { return m_nb; }
+
+	//! return pointer to block b
+	double* block(int b) { return m_pd + b*NNZ*LANES; }
+	const double* block(int b) const { return m_pd + b*NNZ*LANES; }
+
+	//! access component i of tensor n
+	double& operator () (int n, int i) { return m_pd[(n / LANES)*NNZ*LANES + i*LANES + n % LANES]; }
+	double operator () (int n, int i) const { return m_pd[(n / LANES)*NNZ*LANES + i*LANES + n % LANES]; }
+
+	//! set all tensors to zero
+	void zero() { std::fill(m_pd, m_pd + buffer_size(m_n), 0.0); }
+
+private:
+	int		m_n;	//!< number of tensors
+	int		m_nb;	//!< number of blocks
+	double*	m_pd;	//!< tensor data (either m_buf or an external buffer)
+	std::vector<double>	m_buf;
+};
+
+//-----------------------------------------------------------------------------
+//! Batch of 2nd order tensors
+class FECORE_API mat3d_batch : public tensor_batch<9>
+{
+public:
+	mat3d_batch() {}
+	explicit mat3d_batch(int n) : tensor_batch<9>(n) {}
+	mat3d_batch(int n, double* buf) : tensor_batch<9>(n, buf) {}
+
+	//! set/get tensor n
+	void set(int n, const mat3d& a);
+	mat3d get(int n) const;
+};
+
+//-----------------------------------------------------------------------------
+//! Batch of symmetric 2nd order tensors
+class FECORE_API mat3ds_batch : public tensor_batch<6>
+{
+public:
+	mat3ds_batch() {}
+	explicit mat3ds_batch(int n) : tensor_batch<6>(n) {}
+	mat3ds_batch(int n, double* buf) : tensor_batch<6>(n, buf) {}
+
+	//! set/get tensor n
+	void set(int n, const mat3ds& a);
+	mat3ds get(int n) const;
+};
+
+//-----------------------------------------------------------------------------
+//! Batch of 4th order tensors with major and minor symmetries
+class FECORE_API tens4ds_batch : public tensor_batch<21>
+{
+public:
+	tens4ds_batch() {}
+	explicit tens4ds_batch(int n) : tensor_batch<21>(n) {}
+	tens4ds_batch(int n, double* buf) : tensor_batch<21>(n, buf) {}
+
+	//! set/get tensor n
+	void set(int n, const tens4ds& a);
+	tens4ds get(int n) const;
+};
+
+//-----------------------------------------------------------------------------
+// Batch kernels. The result is always the last argument and all batches must have
+// the same size. Scalar arrays have one value per tensor.
+
+// c = a dyad1s a
+FECORE_API void dyad1s(const mat3ds_batch& a, tens4ds_batch& c);
+
+// c = a dyad1s b
+FECORE_API void dyad1s(const mat3ds_batch& a, const mat3ds_batch& b, tens4ds_batch& c);
+
+// c = a dyad4s a
+FECORE_API void dyad4s(const mat3ds_batch& a, tens4ds_batch& c);
+
+// c = a dyad4s b
+FECORE_API void dyad4s(const mat3ds_batch& a, const mat3ds_batch& b, tens4ds_batch& c);
+
+// c = a ddots b
+FECORE_API void ddots(const tens4ds_batch& a, const tens4ds_batch& b, tens4ds_batch& c);
+
+// s = c : m
+FECORE_API void ddot(const tens4ds_batch& c, const mat3ds_batch& m, mat3ds_batch& s);
+
+// r = c.pp(F), i.e. r_ijpq = F_ik F_jl c_klmn F_pm F_qn
+FECORE_API void pp(const tens4ds_batch& c, const mat3d_batch& F, tens4ds_batch& r);
+
+// c += a*s
+FECORE_API void axpy(const tens4ds_batch& a, const double* s, tens4ds_batch& c);
+
+// c *= s
+FECORE_API void scale(const double* s, tens4ds_batch& c);
+
+// c += lam*(I dyad1s I) + 2*mu*(I dyad4s I)
+FECORE_API void add_isotropic(const double* lam, const double* mu, tens4ds_batch& c);
+
+// Material stiffness of an element, i.e. the contraction of the tangents c with 
+// the linear strain-displacement matrices of the nodes:
+//
+//   ke[3i+a][3j+b] += sum_n w[n] * (BL_i^T * D_n * BL_j)_ab
+//
+// where D_n is the Voigt matrix of c at point n. G holds the spatial gradients 
+// of the neln shape functions at each point, i.e. G[n*neln + i] is the gradient 
+// of shape function i at point n, and w holds the integration weights (which
+// include the jacobian). Only ke's nodal blocks for i, j < neln are updated.
+FECORE_API void add_material_stiffness(const tens4ds_batch& c, const vec3d* G, const double* w, int neln, matrix& ke);
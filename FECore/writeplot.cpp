@@ -37,7 +37,7 @@ void writeSPRElementValueMat3dd(FESolidDomain& dom, FEDataStream& ar, std::funct
 	int NE = dom.Elements();
 
 	// build the element data array
-	vector< vector<double> > ED[3];
+	vector< vector< vector<double> > > ED(3);
 	ED[0].resize(NE);
 	ED[1].resize(NE);
 	ED[2].resize(NE);
@@ -53,7 +53,7 @@ void writeSPRElementValueMat3dd(FESolidDomain& dom, FEDataStream& ar, std::funct
 	// this array will store the results
 	FESPRProjection map;
 	map.SetInterpolationOrder(interpolOrder);
-	vector<double> val[3];
+	vector< vector<double> > val;
 
 	// fill the ED array
 	for (int i = 0; i < NE; ++i)
@@ -72,9 +72,7 @@ void writeSPRElementValueMat3dd(FESolidDomain& dom, FEDataStream& ar, std::funct
 	}
 
 	// project to nodes
-	map.Project(dom, ED[0], val[0]);
-	map.Project(dom, ED[1], val[1]);
-	map.Project(dom, ED[2], val[2]);
+	map.Project(dom, ED, val);
 
 	// copy results to archive
 	for (int i = 0; i<NN; ++i)
@@ -94,7 +92,7 @@ void writeSPRElementValueMat3ds(FESolidDomain& dom, FEDataStream& ar, std::funct
 	int NE = dom.Elements();
 
 	// build the element data array
-	vector< vector<double> > ED[6];
+	vector< vector< vector<double> > > ED(6);
 	for (int n = 0; n < 6; ++n)
 	{
 		ED[n].resize(NE);
@@ -109,7 +107,7 @@ void writeSPRElementValueMat3ds(FESolidDomain& dom, FEDataStream& ar, std::funct
 	// this array will store the results
 	FESPRProjection map;
 	map.SetInterpolationOrder(interpolOrder);
-	vector<double> val[6];
+	vector< vector<double> > val;
 
 	// fill the ED array
 	for (int i = 0; i<NE; ++i)
@@ -129,12 +127,8 @@ void writeSPRElementValueMat3ds(FESolidDomain& dom, FEDataStream& ar, std::funct
 		}
 	}
 
-	// project to nodes
-	// loop over stress components
-	for (int n = 0; n<6; ++n)
-	{
-		map.Project(dom, ED[n], val[n]);
-	}
+	// project all stress components to nodes
+	map.Project(dom, ED, val);
 
 	// copy results to archive
 	for (int i = 0; i<NN; ++i)
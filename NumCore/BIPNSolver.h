@@ -75,6 +75,7 @@ public:
 
 	//! Calculate the solution of RHS b and store solution in x
 	bool BackSolve(double* x, double* y) override;
+	using LinearSolver::BackSolve;
 
 	//! Return a sparse matrix compatible with this solver
 	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
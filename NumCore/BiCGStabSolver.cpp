@@ -26,6 +26,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "BiCGStabSolver.h"
 #include "CompactUnSymmMatrix.h"
+#include "BlockCSRMatrix.h"
 #include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
@@ -34,6 +35,11 @@ BEGIN_FECORE_CLASS(BiCGStabSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_tol, "tol");
 	ADD_PARAMETER(m_maxiter, "max_iter");
 	ADD_PARAMETER(m_fail_max_iter, "fail_max_iters");
+	ADD_PARAMETER(m_nrecycle, "recycle_vectors");
+	ADD_PARAMETER(m_warmStart, "warm_start");
+	ADD_PARAMETER(m_blockSize, FE_RANGE_GREATER_OR_EQUAL(0), "matrix_block_size");
+	ADD_PARAMETER(m_pcMaxReuse, FE_RANGE_GREATER_OR_EQUAL(0), "pc_max_reuse");
+	ADD_PARAMETER(m_pcIterGrowth, FE_RANGE_GREATER_OR_EQUAL(0.0), "pc_iter_growth");
 	ADD_PROPERTY(m_P, "pc_left");
 END_FECORE_CLASS();
 
@@ -45,6 +51,11 @@ BiCGStabSolver::BiCGStabSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(
 	m_abstol = 0.0;
 	m_print_level = 0;
 	m_fail_max_iter = true;
+	m_nrecycle = 0;
+	m_warmStart = false;
+	m_blockSize = 0;
+	m_pcMaxReuse = 0;
+	m_pcIterGrowth = 2.0;
 }
 
 //-----------------------------------------------------------------------------
@@ -57,6 +68,10 @@ SparseMatrix* BiCGStabSolver::CreateSparseMatrix(Matrix_Type ntype)
 		m_P->SetPartitions(m_part);
 		m_pA = m_P->CreateSparseMatrix(ntype);
 	}
+	else if (m_blockSize > 0)
+	{
+		m_pA = new BlockCSRMatrix(m_blockSize, (ntype == REAL_SYMMETRIC));
+	}
 	else
 	{
 		if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
@@ -93,6 +108,14 @@ bool BiCGStabSolver::HasPreconditioner() const
 //-----------------------------------------------------------------------------
 bool BiCGStabSolver::PreProcess()
 {
+	m_recycle.SetMaxVectors(m_nrecycle);
+	m_recycle.SetWarmStart(m_warmStart);
+
+	// the matrix structure may have changed so the preconditioner must be rebuilt
+	m_pcReuse.SetMaxReuse(m_pcMaxReuse);
+	m_pcReuse.SetIterationGrowth(m_pcIterGrowth);
+	m_pcReuse.SetLogging((m_pcMaxReuse > 0) || (m_print_level > 0));
+	m_pcReuse.Reset(GetFEModel());
 	return true;
 }
 
@@ -102,9 +125,11 @@ bool BiCGStabSolver::Factor()
 	if (m_pA == 0) return false;
 	if (m_P)
 	{
-		if (m_P->PreProcess() == false) return false;
-		if (m_P->Factor() == false) return false;
+		// the preconditioner may be reused from a previous reformation
+		LinearSolver* P = m_P;
+		if (m_pcReuse.Factor(GetFEModel(), [=]() { return (P->PreProcess() && P->Factor()); }) == false) return false;
 	}
+	m_recycle.MatrixChanged();
 	return true;
 }
 
@@ -113,6 +138,27 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 {
 	if (m_pA == nullptr) return false;
 
+	// the reuse policy keeps track of the solve times and iteration counts
+	return m_pcReuse.Solve(this, [=]() { return SolveRecycled(x, b); });
+}
+
+//-----------------------------------------------------------------------------
+bool BiCGStabSolver::SolveRecycled(double* x, double* b)
+{
+	if (m_recycle.IsActive() == false) return SolveSystem(x, b, 1.0);
+
+	// solve for the correction to the initial guess from the recycled subspace
+	SparseMatrix* A = m_pA;
+	return m_recycle.Solve(A->Rows(), x, b,
+		[=](double* u, double* v) { A->mult_vector(u, v); },
+		[=](double* u, double* f, double tolScale) { return SolveSystem(u, f, tolScale); });
+}
+
+//-----------------------------------------------------------------------------
+bool BiCGStabSolver::SolveSystem(double* x, double* b, double tolScale)
+{
+	if (m_pA == nullptr) return false;
+
 	SparseMatrix& A = *m_pA;
 	int neq = A.Rows();
 
@@ -130,7 +176,7 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 	norm0 = sqrt(norm0);
 
 	// if the norm is zero, there is nothing to do
-	if (norm0 == 0.0) return true;
+	if (norm0 == 0.0) { UpdateStats(0); return true; }
 
 //	Choose an arbitrary vector rt such that(rt, r0) != 0, e.g., rt = r0
 	vector<double> rt(r_i);
@@ -192,7 +238,7 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 		normi = sqrt(normi);
 
 		// see if we have converged
-		double tol = norm0*m_tol + m_abstol;
+		double tol = norm0*m_tol*tolScale + m_abstol;
 		if (normi <= tol) converged = true;
 		else
 		{
@@ -217,6 +263,9 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 		feLog("%d:%lg, %lg\n", iter, normi, norm0);
 	}
 
+	// update stats
+	UpdateStats(iter);
+
 	return (m_fail_max_iter ? converged : true);
 }
 
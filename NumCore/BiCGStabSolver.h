@@ -26,6 +26,8 @@ SOFTWARE.*/
 #pragma once
 #include <FECore/LinearSolver.h>
 #include "CompactSymmMatrix.h"
+#include "RecycledSubspace.h"
+#include "PreconditionerReuse.h"
 
 // This class implements an interface to the RCI CG iterative solver from the MKL math library.
 class BiCGStabSolver : public IterativeLinearSolver
@@ -35,6 +37,7 @@ public:
 	bool PreProcess() override;
 	bool Factor() override;
 	bool BackSolve(double* x, double* b) override;
+	using LinearSolver::BackSolve;
 	void Destroy() override;
 
 public:
@@ -51,6 +54,13 @@ public:
 	void SetTolerance(double tol) { m_tol = tol; }
 	void SetPrintLevel(int n) override { m_print_level = n; }
 
+protected:
+	// solve the linear system (the relative tolerance is scaled by tolScale)
+	bool SolveSystem(double* x, double* b, double tolScale);
+
+	// solve the linear system using the recycled subspace (if active)
+	bool SolveRecycled(double* x, double* b);
+
 protected:
 	SparseMatrix*		m_pA;
 	LinearSolver*		m_P;
@@ -60,6 +70,14 @@ protected:
 	double	m_abstol;		// absolute residual tolerance
 	int		m_print_level;	// output level
 	double	m_fail_max_iter;
+	int		m_nrecycle;		// nr of recycled vectors (0 = no recycling)
+	bool	m_warmStart;	// use previous solution as initial guess
+	int		m_blockSize;	// block size of BCSR matrix (0 = use scalar format)
+	int		m_pcMaxReuse;	// max nr of reformations the preconditioner is reused (0 = always refresh)
+	double	m_pcIterGrowth;	// iteration growth factor that triggers a preconditioner refresh
+
+	RecycledSubspace	m_recycle;
+	PreconditionerReuse	m_pcReuse;
 
 	DECLARE_FECORE_CLASS();
 };
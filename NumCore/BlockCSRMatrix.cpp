@@ -0,0 +1,450 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "BlockCSRMatrix.h"
+#include <FECore/FEElement.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Multiply a BCSR matrix with (padded) vector x, i.e. y = A*x.
+// The block size is a template parameter so that the block loops can be unrolled.
+template <int BS> static void bcsr_mult(int nb, const int* rowptr, const int* colind, const double* val, const double* x, double* y)
+{
+#pragma omp parallel for schedule(guided)
+	for (int I = 0; I < nb; ++I)
+	{
+		double yi[BS] = { 0.0 };
+		for (int k = rowptr[I]; k < rowptr[I + 1]; ++k)
+		{
+			const double* B = val + k*BS*BS;
+			const double* xj = x + colind[k]*BS;
+			for (int i = 0; i < BS; ++i)
+				for (int j = 0; j < BS; ++j) yi[i] += B[i*BS + j] * xj[j];
+		}
+		for (int i = 0; i < BS; ++i) y[I*BS + i] = yi[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// same as above, but for arbitrary block sizes
+static void bcsr_mult(int bs, int nb, const int* rowptr, const int* colind, const double* val, const double* x, double* y)
+{
+#pragma omp parallel for schedule(guided)
+	for (int I = 0; I < nb; ++I)
+	{
+		double* yi = y + I*bs;
+		for (int i = 0; i < bs; ++i) yi[i] = 0.0;
+		for (int k = rowptr[I]; k < rowptr[I + 1]; ++k)
+		{
+			const double* B = val + k*bs*bs;
+			const double* xj = x + colind[k]*bs;
+			for (int i = 0; i < bs; ++i)
+				for (int j = 0; j < bs; ++j) yi[i] += B[i*bs + j] * xj[j];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// see if two columns have the same profile
+static bool sameProfile(const SparseMatrixProfile::ColumnProfile& a, const SparseMatrixProfile::ColumnProfile& b)
+{
+	if (a.size() != b.size()) return false;
+	for (int i = 0; i < a.size(); ++i)
+	{
+		if ((a[i].start != b[i].start) || (a[i].end != b[i].end)) return false;
+	}
+	return true;
+}
+
+//=============================================================================
+BlockCSRMatrix::BlockCSRMatrix(int blockSize, bool symmetric)
+{
+	m_bs = (blockSize > 0 ? blockSize : 1);
+	m_bsymm = symmetric;
+	m_nb = 0;
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Zero()
+{
+	std::fill(m_val.begin(), m_val.end(), 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Clear()
+{
+	m_nb = 0;
+	m_beq.clear();
+	m_eqb.clear();
+	m_rowptr.clear();
+	m_colind.clear();
+	m_bdiag.clear();
+	m_val.clear();
+	m_xp.clear();
+	m_yp.clear();
+
+	SparseMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Create(SparseMatrixProfile& mp)
+{
+	int neq = mp.Rows();
+	assert(neq == mp.Columns());
+
+	// group consecutive equations with the same profile into blocks
+	m_eqb.assign(neq, -1);
+	m_beq.clear();
+	for (int i = 0; i < neq; ++i)
+	{
+		bool newBlock = true;
+		if (i > 0)
+		{
+			int n = (int)m_beq.size() - 1;
+			if ((i - m_beq[n] < m_bs) && sameProfile(mp.Column(i - 1), mp.Column(i))) newBlock = false;
+		}
+		if (newBlock) m_beq.push_back(i);
+		m_eqb[i] = (int)m_beq.size() - 1;
+	}
+	m_nb = (int)m_beq.size();
+	m_beq.push_back(neq);
+
+	// build the block profile. Since all the equations of a block have the same
+	// profile, we only need to look at the first equation of each block.
+	// (The block structure is made symmetric, so that we can mirror symmetric matrices.)
+	vector< vector<int> > rows(m_nb);
+	vector<int> tag(m_nb, -1);
+	for (int J = 0; J < m_nb; ++J)
+	{
+		rows[J].push_back(J);
+		tag[J] = J;
+
+		SparseMatrixProfile::ColumnProfile& a = mp.Column(m_beq[J]);
+		for (int n = 0; n < a.size(); ++n)
+		{
+			int I0 = m_eqb[a[n].start];
+			int I1 = m_eqb[a[n].end];
+			for (int I = I0; I <= I1; ++I)
+			{
+				if (tag[I] != J)
+				{
+					tag[I] = J;
+					rows[I].push_back(J);
+					rows[J].push_back(I);
+				}
+			}
+		}
+	}
+
+	// create the row pointers and column indices
+	m_rowptr.assign(m_nb + 1, 0);
+	for (int I = 0; I < m_nb; ++I)
+	{
+		vector<int>& r = rows[I];
+		std::sort(r.begin(), r.end());
+		r.erase(std::unique(r.begin(), r.end()), r.end());
+		m_rowptr[I + 1] = m_rowptr[I] + (int)r.size();
+	}
+
+	int nnzb = m_rowptr[m_nb];
+	m_colind.resize(nnzb);
+	m_bdiag.resize(m_nb);
+	for (int I = 0; I < m_nb; ++I)
+	{
+		vector<int>& r = rows[I];
+		int* pc = &m_colind[m_rowptr[I]];
+		for (int n = 0; n < (int)r.size(); ++n)
+		{
+			pc[n] = r[n];
+			if (r[n] == I) m_bdiag[I] = m_rowptr[I] + n;
+		}
+		vector<int>().swap(r);
+	}
+
+	m_val.assign(nnzb*m_bs*m_bs, 0.0);
+	m_xp.assign(m_nb*m_bs, 0.0);
+	m_yp.assign(m_nb*m_bs, 0.0);
+
+	m_nrow = m_ncol = neq;
+	m_nsize = nnzb*m_bs*m_bs;
+}
+
+//-----------------------------------------------------------------------------
+int BlockCSRMatrix::FindBlock(int I, int J) const
+{
+	const int* pc = &m_colind[0];
+	const int* p = std::lower_bound(pc + m_rowptr[I], pc + m_rowptr[I + 1], J);
+	if ((p != pc + m_rowptr[I + 1]) && (*p == J)) return (int)(p - pc);
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+double* BlockCSRMatrix::Entry(int i, int j)
+{
+	int I = m_eqb[i];
+	int J = m_eqb[j];
+	int k = FindBlock(I, J);
+	if (k < 0) return nullptr;
+	return &m_val[(k*m_bs + (i - m_beq[I]))*m_bs + (j - m_beq[J])];
+}
+
+//-----------------------------------------------------------------------------
+//! The element equations are first mapped to the blocks of the element, so
+//! that the block lookup is only done once for each pair of element blocks.
+//! The work arrays are on the stack, unless the element is larger than 
+//! MAX_EQ equations.
+void BlockCSRMatrix::Assemble(const matrix& ke, const vector<int>& lm)
+{
+	const int N = (int)lm.size();
+	const int bs = m_bs;
+
+	const int MAX_EQ = 3*FEElement::MAX_NODES;
+	int ubs[MAX_EQ], lbs[MAX_EQ], poss[MAX_EQ*MAX_EQ];
+	vector<int> ubv, lbv, posv;
+	int* ub = ubs;
+	int* lb = lbs;
+	if (N > MAX_EQ)
+	{
+		ubv.resize(N); ub = &ubv[0];
+		lbv.resize(N); lb = &lbv[0];
+	}
+
+	// find the blocks of this element
+	int nu = 0;
+	for (int i = 0; i < N; ++i)
+	{
+		lb[i] = -1;
+		if (lm[i] >= 0)
+		{
+			int I = m_eqb[lm[i]];
+			int n = 0;
+			while ((n < nu) && (ub[n] != I)) ++n;
+			if (n == nu) ub[nu++] = I;
+			lb[i] = n;
+		}
+	}
+
+	// find the locations of all the element blocks
+	int* pos = poss;
+	if (nu > MAX_EQ)
+	{
+		posv.resize(nu*nu); pos = &posv[0];
+	}
+	for (int u = 0; u < nu; ++u)
+		for (int v = 0; v < nu; ++v) pos[u*nu + v] = FindBlock(ub[u], ub[v]);
+
+	// assemble element matrix
+	for (int i = 0; i < N; ++i)
+	{
+		if (lb[i] < 0) continue;
+		int I = lm[i];
+		int ri = I - m_beq[ub[lb[i]]];
+		for (int j = 0; j < N; ++j)
+		{
+			if (lb[j] < 0) continue;
+			int J = lm[j];
+
+			// for symmetric matrices, we only assemble the lower triangular part
+			if (m_bsymm && (I < J)) continue;
+
+			int cj = J - m_beq[ub[lb[j]]];
+			int k = pos[lb[i]*nu + lb[j]];
+			assert(k >= 0);
+
+			#pragma omp atomic
+			m_val[(k*bs + ri)*bs + cj] += ke[i][j];
+
+			if (m_bsymm && (I != J))
+			{
+				int kt = pos[lb[j]*nu + lb[i]];
+				#pragma omp atomic
+				m_val[(kt*bs + cj)*bs + ri] += ke[i][j];
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+		for (int j = 0; j < M; ++j)
+		{
+			int J = lmj[j];
+			if (J < 0) continue;
+
+			// for symmetric matrices, we only assemble the lower triangular part
+			if (m_bsymm && (I < J)) continue;
+
+			double* pv = Entry(I, J);
+			if (pv)
+			{
+				#pragma omp atomic
+				(*pv) += ke[i][j];
+			}
+
+			if (m_bsymm && (I != J))
+			{
+				pv = Entry(J, I);
+				if (pv)
+				{
+					#pragma omp atomic
+					(*pv) += ke[i][j];
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool BlockCSRMatrix::check(int i, int j)
+{
+	return (FindBlock(m_eqb[i], m_eqb[j]) >= 0);
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::set(int i, int j, double v)
+{
+	double* pv = Entry(i, j);
+	if (pv)
+	{
+		#pragma omp critical (BCSR_set)
+		{
+			*pv = v;
+			if (m_bsymm) *Entry(j, i) = v;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! For symmetric matrices, only the upper triangular part is added
+//! (see also CompactSymmMatrix::add)
+void BlockCSRMatrix::add(int i, int j, double v)
+{
+	if (m_bsymm && (i > j)) return;
+
+	double* pv = Entry(i, j);
+	if (pv == nullptr) { assert(false); return; }
+
+	#pragma omp atomic
+	(*pv) += v;
+
+	if (m_bsymm && (i != j))
+	{
+		pv = Entry(j, i);
+		#pragma omp atomic
+		(*pv) += v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double BlockCSRMatrix::get(int i, int j)
+{
+	double* pv = Entry(i, j);
+	return (pv ? *pv : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+double BlockCSRMatrix::diag(int i)
+{
+	int I = m_eqb[i];
+	int ri = i - m_beq[I];
+	return m_val[(m_bdiag[I]*m_bs + ri)*m_bs + ri];
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::scale(const vector<double>& L, const vector<double>& R)
+{
+	const int bs = m_bs;
+#pragma omp parallel for
+	for (int I = 0; I < m_nb; ++I)
+	{
+		int ni = m_beq[I + 1] - m_beq[I];
+		const double* Li = &L[m_beq[I]];
+		for (int k = m_rowptr[I]; k < m_rowptr[I + 1]; ++k)
+		{
+			int J = m_colind[k];
+			int nj = m_beq[J + 1] - m_beq[J];
+			const double* Rj = &R[m_beq[J]];
+			double* B = &m_val[k*bs*bs];
+			for (int i = 0; i < ni; ++i)
+				for (int j = 0; j < nj; ++j) B[i*bs + j] *= Li[i] * Rj[j];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool BlockCSRMatrix::mult_vector(double* x, double* r)
+{
+	if (m_nb == 0) return true;
+	const int bs = m_bs;
+
+	// copy x to the padded vector
+#pragma omp parallel for
+	for (int I = 0; I < m_nb; ++I)
+	{
+		int n0 = m_beq[I];
+		int ni = m_beq[I + 1] - n0;
+		double* xi = &m_xp[I*bs];
+		for (int i = 0; i < ni; ++i) xi[i] = x[n0 + i];
+	}
+
+	// do the block multiplication
+	const int* rowptr = &m_rowptr[0];
+	const int* colind = &m_colind[0];
+	const double* val = &m_val[0];
+	switch (bs)
+	{
+	case 1: bcsr_mult<1>(m_nb, rowptr, colind, val, &m_xp[0], &m_yp[0]); break;
+	case 2: bcsr_mult<2>(m_nb, rowptr, colind, val, &m_xp[0], &m_yp[0]); break;
+	case 3: bcsr_mult<3>(m_nb, rowptr, colind, val, &m_xp[0], &m_yp[0]); break;
+	case 4: bcsr_mult<4>(m_nb, rowptr, colind, val, &m_xp[0], &m_yp[0]); break;
+	default:
+		bcsr_mult(bs, m_nb, rowptr, colind, val, &m_xp[0], &m_yp[0]);
+	}
+
+	// copy the result back
+#pragma omp parallel for
+	for (int I = 0; I < m_nb; ++I)
+	{
+		int n0 = m_beq[I];
+		int ni = m_beq[I + 1] - n0;
+		const double* yi = &m_yp[I*bs];
+		for (int i = 0; i < ni; ++i) r[n0 + i] = yi[i];
+	}
+
+	return true;
+}
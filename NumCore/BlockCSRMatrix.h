@@ -0,0 +1,131 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <FECore/SparseMatrix.h>
+
+//=============================================================================
+//! This class stores a sparse matrix in block compressed row storage (BCSR) format.
+
+//! The equations are grouped in blocks of at most BS consecutive equations, which
+//! normally correspond to the degrees of freedom of a node. The block partition is
+//! found from the matrix profile: consecutive equations with identical column
+//! profiles are placed in the same block. Only one column index is stored per
+//! block and the blocks are stored as dense BSxBS (row-major) matrices. Blocks with
+//! less than BS equations (e.g. nodes with fixed dofs) are padded with zeroes.
+//! For symmetric matrices both triangles are stored. As for the other symmetric
+//! formats, only one triangle is assembled and the other one is obtained by symmetry.
+
+class BlockCSRMatrix : public SparseMatrix
+{
+public:
+	//! constructor
+	BlockCSRMatrix(int blockSize = 3, bool symmetric = false);
+
+public: // from SparseMatrix
+
+	//! zero matrix elements
+	void Zero() override;
+
+	//! release memory
+	void Clear() override;
+
+	//! Create the block structure from the SparseMatrixProfile
+	void Create(SparseMatrixProfile& mp) override;
+
+	//! Assemble an element matrix into the global matrix
+	void Assemble(const matrix& ke, const vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj) override;
+
+	//! see if a matrix element is defined
+	bool check(int i, int j) override;
+
+	//! set matrix item
+	void set(int i, int j, double v) override;
+
+	//! add a value to a matrix item
+	void add(int i, int j, double v) override;
+
+	//! get a matrix item
+	double get(int i, int j) override;
+
+	//! return the diagonal value
+	double diag(int i) override;
+
+	//! do row (L) and column (R) scaling
+	void scale(const vector<double>& L, const vector<double>& R) override;
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+public:
+	//! max nr of equations per block
+	int BlockSize() const { return m_bs; }
+
+	//! is the matrix symmetric
+	bool isSymmetric() const { return m_bsymm; }
+
+	//! nr of block rows
+	int Blocks() const { return m_nb; }
+
+	//! nr of nonzero blocks
+	int NonZeroBlocks() const { return (int)m_colind.size(); }
+
+	//! first equation of a block row
+	int BlockStart(int n) const { return m_beq[n]; }
+
+	//! nr of equations in a block row
+	int BlockEquations(int n) const { return m_beq[n + 1] - m_beq[n]; }
+
+	//! values of the diagonal block of a block row
+	double* DiagonalBlock(int n) { return &m_val[m_bdiag[n]*m_bs*m_bs]; }
+
+private:
+	//! find the index of block (I, J), returns -1 if the block is not defined
+	int FindBlock(int I, int J) const;
+
+	//! get a pointer to a matrix item (returns null if not defined)
+	double* Entry(int i, int j);
+
+private:
+	int		m_bs;		//!< max block size
+	bool	m_bsymm;	//!< symmetric flag
+	int		m_nb;		//!< nr of block rows
+
+	vector<int>		m_beq;		//!< first equation of each block (size = nb + 1)
+	vector<int>		m_eqb;		//!< block of each equation
+	vector<int>		m_rowptr;	//!< block row pointers
+	vector<int>		m_colind;	//!< block column indices
+	vector<int>		m_bdiag;	//!< index of the diagonal block of each block row
+	vector<double>	m_val;		//!< block values
+
+	vector<double>	m_xp, m_yp;	//!< padded vectors used by mult_vector
+};
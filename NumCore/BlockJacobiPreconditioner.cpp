@@ -0,0 +1,128 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "BlockJacobiPreconditioner.h"
+#include "BlockCSRMatrix.h"
+
+BEGIN_FECORE_CLASS(BlockJacobiPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_blockSize, FE_RANGE_GREATER(0), "block_size");
+END_FECORE_CLASS();
+
+//=================================================================================================
+
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_blockSize = 3;
+	m_bs = 1;
+}
+
+SparseMatrix* BlockJacobiPreconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	BlockCSRMatrix* A = new BlockCSRMatrix(m_blockSize, (ntype == REAL_SYMMETRIC));
+	SetSparseMatrix(A);
+	return A;
+}
+
+bool BlockJacobiPreconditioner::Factor()
+{
+	SparseMatrix* A = GetSparseMatrix();
+	if (A == nullptr) return false;
+
+	int N = A->Rows();
+	if (A->Columns() != N) return false;
+
+	BlockCSRMatrix* B = dynamic_cast<BlockCSRMatrix*>(A);
+	if (B == nullptr)
+	{
+		// for other formats, we just use the diagonal
+		m_bs = 1;
+		m_beq.resize(N + 1);
+		m_Di.resize(N);
+		for (int i = 0; i < N; ++i)
+		{
+			double dii = A->diag(i);
+			if (dii == 0.0) return false;
+			m_Di[i] = 1.0 / dii;
+			m_beq[i] = i;
+		}
+		m_beq[N] = N;
+		return true;
+	}
+
+	// invert the diagonal blocks
+	int nb = B->Blocks();
+	m_bs = B->BlockSize();
+	m_beq.resize(nb + 1);
+	m_Di.assign(nb*m_bs*m_bs, 0.0);
+	for (int I = 0; I <= nb; ++I) m_beq[I] = (I < nb ? B->BlockStart(I) : N);
+
+	const int bs = m_bs;
+	bool bok = true;
+#pragma omp parallel for reduction(&&:bok)
+	for (int I = 0; I < nb; ++I)
+	{
+		int n = B->BlockEquations(I);
+		const double* D = B->DiagonalBlock(I);
+		matrix Dn(n, n);
+		for (int i = 0; i < n; ++i)
+			for (int j = 0; j < n; ++j) Dn[i][j] = D[i*bs + j];
+
+		for (int i = 0; i < n; ++i) if (Dn[i][i] == 0.0) bok = false;
+
+		matrix Di = Dn.inverse();
+		double* pd = &m_Di[I*bs*bs];
+		for (int i = 0; i < n; ++i)
+			for (int j = 0; j < n; ++j) pd[i*bs + j] = Di[i][j];
+	}
+
+	return bok;
+}
+
+bool BlockJacobiPreconditioner::BackSolve(double* x, double* y)
+{
+	const int nb = (int)m_beq.size() - 1;
+	const int bs = m_bs;
+
+#pragma omp parallel for
+	for (int I = 0; I < nb; ++I)
+	{
+		int n0 = m_beq[I];
+		int n = m_beq[I + 1] - n0;
+		const double* pd = &m_Di[I*bs*bs];
+		for (int i = 0; i < n; ++i)
+		{
+			double xi = 0.0;
+			for (int j = 0; j < n; ++j) xi += pd[i*bs + j] * y[n0 + j];
+			x[n0 + i] = xi;
+		}
+	}
+
+	return true;
+}
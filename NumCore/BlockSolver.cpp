@@ -37,6 +37,8 @@ BEGIN_FECORE_CLASS(BlockIterativeSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_failMaxIter, "fail_max_iter");
 	ADD_PARAMETER(m_method     , "solution_method");
 	ADD_PARAMETER(m_zeroInitGuess, "zero_initial_guess");
+	ADD_PARAMETER(m_nrecycle     , "recycle_vectors");
+	ADD_PARAMETER(m_warmStart    , "warm_start");
 END_FECORE_CLASS()
 
 //-----------------------------------------------------------------------------
@@ -51,6 +53,8 @@ BlockIterativeSolver::BlockIterativeSolver(FEModel* fem) : IterativeLinearSolver
 	m_failMaxIter = true;
 	m_method = JACOBI;
 	m_zeroInitGuess = true;
+	m_nrecycle = 0;
+	m_warmStart = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -159,6 +163,9 @@ bool BlockIterativeSolver::PreProcess()
 
 	m_iter = 0;
 
+	m_recycle.SetMaxVectors(m_nrecycle);
+	m_recycle.SetWarmStart(m_warmStart);
+
 	return true;
 }
 
@@ -170,12 +177,28 @@ bool BlockIterativeSolver::Factor()
 	int N = (int) m_solver.size();
 	for (int i=0; i<N; ++i) m_solver[i]->Factor();
 
+	m_recycle.MatrixChanged();
+
 	return true;
 }
 
 //-----------------------------------------------------------------------------
 //! Backsolve the linear system
 bool BlockIterativeSolver::BackSolve(double* x, double* b)
+{
+	if (m_recycle.IsActive() == false) return SolveSystem(x, b, 1.0);
+
+	// solve for the correction to the initial guess from the recycled subspace.
+	// (The correction is solved with a zero initial guess.)
+	BlockMatrix* A = m_pA;
+	return m_recycle.Solve(A->Rows(), x, b,
+		[=](double* u, double* v) { A->mult_vector(u, v); },
+		[=](double* u, double* f, double tolScale) { return SolveSystem(u, f, tolScale); });
+}
+
+//-----------------------------------------------------------------------------
+//! Solve the linear system with block Jacobi or Gauss-Seidel iterations
+bool BlockIterativeSolver::SolveSystem(double* x, double* b, double tolScale)
 {
 	// get partitions
 	int NP = m_pA->Partitions();
@@ -291,7 +314,7 @@ bool BlockIterativeSolver::BackSolve(double* x, double* b)
 		for (int i=0; i<neq0; ++i) res[i] -= b[i];
 		norm = l2_norm(res);
 		if (m_printLevel == 1) feLog("%d: %lg\n", m_iter, norm);
-		if (norm <= norm0*m_tol)
+		if (norm <= norm0*m_tol*tolScale)
 		{
 			bconv = true;
 			break;	
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include <FECore/LinearSolver.h>
 #include "BlockMatrix.h"
 #include "PardisoSolver.h"
+#include "RecycledSubspace.h"
 
 //-----------------------------------------------------------------------------
 // This class implements an iterative block solution strategy for solving linear 
@@ -58,6 +59,7 @@ public:
 
 	//! Backsolve the linear system
 	bool BackSolve(double* x, double* y) override;
+	using LinearSolver::BackSolve;
 
 	//! Clean up
 	void Destroy() override;
@@ -93,6 +95,10 @@ public:
 	// set the zero-initial-guess flag
 	void SetZeroInitialGuess(bool b);
 
+private:
+	// solve the linear system (the relative tolerance is scaled by tolScale)
+	bool SolveSystem(double* x, double* b, double tolScale);
+
 private:
 	BlockMatrix*			m_pA;		//!< block matrices
 	vector<PardisoSolver*>	m_solver;	//!< solvers for solving diagonal blocks
@@ -105,6 +111,10 @@ private:
 	int		m_printLevel;		//!< set print level
 	bool	m_failMaxIter;		//!< fail on max iterations reached
 	bool	m_zeroInitGuess;	//!< always use zero as the initial guess
+	int		m_nrecycle;			//!< nr of recycled vectors (0 = no recycling)
+	bool	m_warmStart;		//!< use the previous solution as initial guess
+
+	RecycledSubspace	m_recycle;	//!< recycled subspace
 
 	DECLARE_FECORE_CLASS();
 };
@@ -111,6 +111,7 @@ public:
 	bool PreProcess() override;
 	bool Factor() override;
 	bool BackSolve(double* x, double* y) override;
+	using LinearSolver::BackSolve;
 	void Destroy() override;
 
 private:
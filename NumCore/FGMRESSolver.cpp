@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FGMRESSolver.h"
 #include "CompactSymmMatrix.h"
 #include "CompactUnSymmMatrix.h"
+#include "BlockCSRMatrix.h"
 #include <FECore/log.h>
 #include "MatrixTools.h"
 
@@ -52,6 +53,11 @@ BEGIN_FECORE_CLASS(FGMRESSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_reltol        , "tol");
 	ADD_PARAMETER(m_abstol        , "abs_tol");
 	ADD_PARAMETER(m_maxIterFail   , "fail_max_iters");
+	ADD_PARAMETER(m_nrecycle      , "recycle_vectors");
+	ADD_PARAMETER(m_warmStart     , "warm_start");
+	ADD_PARAMETER(m_blockSize     , FE_RANGE_GREATER_OR_EQUAL(0), "matrix_block_size");
+	ADD_PARAMETER(m_pcMaxReuse    , FE_RANGE_GREATER_OR_EQUAL(0), "pc_max_reuse");
+	ADD_PARAMETER(m_pcIterGrowth  , FE_RANGE_GREATER_OR_EQUAL(0.0), "pc_iter_growth");
 
 	ADD_PROPERTY(m_P, "pc_left");
 	ADD_PROPERTY(m_R, "pc_right");
@@ -70,6 +76,11 @@ FGMRESSolver::FGMRESSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0)
 	m_print_cn = false;
 
 	m_do_jacobi = false;
+	m_nrecycle = 0;
+	m_warmStart = false;
+	m_blockSize = 0;
+	m_pcMaxReuse = 0;
+	m_pcIterGrowth = 2.0;
 
 	m_P = 0;	// we don't use a preconditioner for this solver
 	m_R = 0;	// no right preconditioner
@@ -211,7 +222,11 @@ SparseMatrix* FGMRESSolver::CreateSparseMatrix(Matrix_Type ntype)
 	}
 
 	// if the matrix is still zero, let's just allocate one
-	if (m_pA == nullptr)
+	if ((m_pA == nullptr) && (m_blockSize > 0))
+	{
+		m_pA = new BlockCSRMatrix(m_blockSize, (ntype == REAL_SYMMETRIC));
+	}
+	else if (m_pA == nullptr)
 	{
 		// allocate new matrix
 		switch (ntype)
@@ -247,6 +262,12 @@ void FGMRESSolver::Destroy()
 //-----------------------------------------------------------------------------
 bool FGMRESSolver::PreProcess() 
 {
+	// the matrix structure may have changed so the preconditioner must be rebuilt
+	m_pcReuse.SetMaxReuse(m_pcMaxReuse);
+	m_pcReuse.SetIterationGrowth(m_pcIterGrowth);
+	m_pcReuse.SetLogging((m_pcMaxReuse > 0) || (m_print_level > 0));
+	m_pcReuse.Reset(GetFEModel());
+
 #ifdef MKL_ISS
 	// number of equations
 	MKL_INT N = m_pA->Rows();
@@ -263,6 +284,9 @@ bool FGMRESSolver::PreProcess()
 
 	m_W.resize(N, 1.0);
 
+	m_recycle.SetMaxVectors(m_nrecycle);
+	m_recycle.SetWarmStart(m_warmStart);
+
 	return true; 
 #else
 	return false;
@@ -293,7 +317,20 @@ bool FGMRESSolver::Factor()
 		feLog("\tcondition number (est.) ................... : %lg\n\n", c);
 	}
 
-	// call the preconditioner
+	// call the preconditioners (these may be reused from a previous reformation)
+	if (m_P || m_R)
+	{
+		if (m_pcReuse.Factor(GetFEModel(), [=]() { return FactorPreconditioners(); }) == false) return false;
+	}
+
+	m_recycle.MatrixChanged();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FGMRESSolver::FactorPreconditioners()
+{
 	if (m_P)
 	{
 		m_P->SetFEModel(GetFEModel());
@@ -313,6 +350,40 @@ bool FGMRESSolver::Factor()
 
 //-----------------------------------------------------------------------------
 bool FGMRESSolver::BackSolve(double* x, double* b)
+{
+	// make sure we have a matrix
+	if (m_pA == 0) return false;
+
+	// the reuse policy keeps track of the solve times and iteration counts
+	return m_pcReuse.Solve(this, [=]() { return SolveRecycled(x, b); });
+}
+
+//-----------------------------------------------------------------------------
+bool FGMRESSolver::SolveRecycled(double* x, double* b)
+{
+	if (m_recycle.IsActive() == false) return SolveSystem(x, b, 1.0);
+
+	// The subspace is built for the unscaled matrix, so we need to undo the Jacobi scaling
+	// when multiplying with the matrix. 
+	int N = m_pA->Rows();
+	m_Wt.resize(N);
+	auto mult = [=](double* u, double* v) {
+		if (m_do_jacobi)
+		{
+			for (int i = 0; i < N; ++i) m_Wt[i] = u[i] / m_W[i];
+			m_pA->mult_vector(&m_Wt[0], v);
+			for (int i = 0; i < N; ++i) v[i] /= m_W[i];
+		}
+		else m_pA->mult_vector(u, v);
+	};
+
+	// solve for the correction to the initial guess from the recycled subspace
+	return m_recycle.Solve(N, x, b, mult,
+		[=](double* u, double* f, double tolScale) { return SolveSystem(u, f, tolScale); });
+}
+
+//-----------------------------------------------------------------------------
+bool FGMRESSolver::SolveSystem(double* x, double* b, double tolScale)
 {
 #ifdef MKL_ISS
 	// make sure we have a matrix
@@ -353,6 +424,7 @@ bool FGMRESSolver::BackSolve(double* x, double* b)
 	ipar[14] = nrestart;	                    // number of non-restarted iterations
 	if (m_reltol > 0) dpar[0] = m_reltol;		// set the relative tolerance
 	if (m_abstol > 0) dpar[1] = m_abstol;		// set the absolute tolerance
+	dpar[0] *= tolScale;						// scale relative tolerance when solving for a correction
 
 	// Check the correctness and consistency of the newly set parameters
 	dfgmres_check(&ivar, &x[0], &F[0], &RCI_request, ipar, dpar, &m_tmp[0]);
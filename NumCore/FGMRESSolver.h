@@ -26,6 +26,8 @@ SOFTWARE.*/
 #pragma once
 #include <FECore/LinearSolver.h>
 #include <FECore/SparseMatrix.h>
+#include "RecycledSubspace.h"
+#include "PreconditionerReuse.h"
 
 //-----------------------------------------------------------------------------
 //! This class implements an interface to the MKL FGMRES iterative solver for 
@@ -44,6 +46,7 @@ public:
 
 	//! Calculate the solution of RHS b and store solution in x
 	bool BackSolve(double* x, double* b) override;
+	using LinearSolver::BackSolve;
 
 	//! Clean up
 	void Destroy() override;
@@ -105,6 +108,15 @@ public:
 protected:
 	SparseMatrix* GetSparseMatrix() { return m_pA; }
 
+	// solve the linear system (the relative tolerance is scaled by tolScale)
+	bool SolveSystem(double* x, double* b, double tolScale);
+
+	// solve the linear system using the recycled subspace (if active)
+	bool SolveRecycled(double* x, double* b);
+
+	// factor the left and right preconditioners
+	bool FactorPreconditioners();
+
 private:
 	int		m_maxiter;			// max nr of iterations
 	int		m_nrestart;			// max nr of non-restarted iterations
@@ -116,6 +128,11 @@ private:
 	bool	m_maxIterFail;
 	bool	m_print_cn;			// Calculate and print the condition number
 	bool	m_do_jacobi;
+	int		m_nrecycle;			// nr of recycled vectors (0 = no recycling)
+	bool	m_warmStart;		// use the previous solution as initial guess
+	int		m_blockSize;		// block size of BCSR matrix (0 = use scalar format)
+	int		m_pcMaxReuse;		// max nr of reformations the preconditioner is reused (0 = always refresh)
+	double	m_pcIterGrowth;		// iteration growth factor that triggers a preconditioner refresh
 
 private:
 	SparseMatrix*	m_pA;		//!< the sparse matrix format
@@ -124,6 +141,10 @@ private:
 	vector<double>	m_tmp;
 	vector<double>	m_Rv;		//!< used when a right preconditioner is ued
 	vector<double>	m_W;		//!< Jacobi preconditioner
+	vector<double>	m_Wt;		//!< temp vector for multiplying with the unscaled matrix
+
+	RecycledSubspace	m_recycle;	//!< recycled subspace
+	PreconditionerReuse	m_pcReuse;	//!< preconditioner reuse policy
 
 	DECLARE_FECORE_CLASS();
 };
@@ -55,6 +55,7 @@ public:
 
 	//! Calculate the solution of RHS b and store solution in x
 	bool BackSolve(double* x, double* b) override;
+	using LinearSolver::BackSolve;
 
 	//! Return a sparse matrix compatible with this solver
 	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
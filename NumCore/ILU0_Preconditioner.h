@@ -40,6 +40,7 @@ public:
 
 	// apply to vector P x = y
 	bool BackSolve(double* x, double* y) override;
+	using LinearSolver::BackSolve;
 
 	// create sparse matrix
 	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
@@ -41,6 +41,7 @@ public:
 
 	// apply to vector P x = y
 	bool BackSolve(double* x, double* y) override;
+	using LinearSolver::BackSolve;
 
 public:
 	CompactSymmMatrix* getMatrix();
@@ -122,12 +122,12 @@ bool LUSolver::BackSolve(double* x, double* b)
 {
 	DenseMatrix& a = *m_pA;
 
-	x = b;
-
 	int i, ii=0, ip, j;
 	double sum;
 
 	int n = a.Rows();
+	for (i=0; i<n; ++i) x[i] = b[i];
+
 	for (i=0; i<n; ++i)
 	{
 		ip = indx[i];
@@ -147,7 +147,69 @@ bool LUSolver::BackSolve(double* x, double* b)
 		x[i] = sum/a(i,i);
 	}
 
-	return false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool LUSolver::BackSolve(vector<double>& X, vector<double>& B, int nrhs)
+{
+	DenseMatrix& a = *m_pA;
+
+	if (nrhs <= 0) return true;
+	int n = a.Rows();
+	assert((size_t)n*nrhs == B.size());
+	X.resize(B.size());
+
+	// the right-hand sides are interleaved so that the inner loops
+	// run over all right-hand sides at once
+	vector<double> w(n*nrhs);
+	for (int k=0; k<nrhs; ++k)
+		for (int i=0; i<n; ++i) w[i*nrhs + k] = B[k*n + i];
+
+	// forward substitution (with row interchanges)
+	for (int i=0; i<n; ++i)
+	{
+		double* wi = &w[i*nrhs];
+		int ip = indx[i];
+		if (ip != i)
+		{
+			double* wp = &w[ip*nrhs];
+			for (int k=0; k<nrhs; ++k) { double t = wp[k]; wp[k] = wi[k]; wi[k] = t; }
+		}
+
+		for (int j=0; j<i; ++j)
+		{
+			double aij = a(i,j);
+			if (aij != 0.0)
+			{
+				const double* wj = &w[j*nrhs];
+				for (int k=0; k<nrhs; ++k) wi[k] -= aij*wj[k];
+			}
+		}
+	}
+
+	// back substitution
+	for (int i=n-1; i>=0; --i)
+	{
+		double* wi = &w[i*nrhs];
+		for (int j=i+1; j<n; ++j)
+		{
+			double aij = a(i,j);
+			if (aij != 0.0)
+			{
+				const double* wj = &w[j*nrhs];
+				for (int k=0; k<nrhs; ++k) wi[k] -= aij*wj[k];
+			}
+		}
+
+		double aii = a(i,i);
+		for (int k=0; k<nrhs; ++k) wi[k] /= aii;
+	}
+
+	for (int k=0; k<nrhs; ++k)
+		for (int i=0; i<n; ++i) X[k*n + i] = w[i*nrhs + k];
+
+	return true;
 }
 
 //-----------------------------------------------------------------------------
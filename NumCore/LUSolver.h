@@ -54,6 +54,9 @@ public:
 	//! solve using factored matrix
 	bool BackSolve(double* x, double* b) override;
 
+	//! solve for several right-hand sides using factored matrix
+	bool BackSolve(std::vector<double>& X, std::vector<double>& B, int nrhs) override;
+
 	//! Clean-up
 	void Destroy() override;
 
@@ -85,22 +85,27 @@ double NumCore::inverse_infnorm(CompactMatrix* A)
 	if (solver.Factor() == false) return 0.0;
 
 	int N = A->Rows();
-	vector<double> e(N, 0.0), x(N, 0.0);
 	vector<double> s(N, 0.0);
-	for (int i = 0; i < N; ++i)
+
+	// the columns of the inverse matrix are calculated in small blocks, which limits the memory needed
+	const int NB = 8;
+	vector<double> E, X;
+	for (int i0 = 0; i0 < N; i0 += NB)
 	{
-		// get the i-th column of the inverse matrix
-		e[i] = 1.0;
-		solver.BackSolve(&x[0], &e[0]);
+		// get the next block of columns of the inverse matrix
+		int nrhs = (i0 + NB <= N ? NB : N - i0);
+		E.assign((size_t)nrhs*N, 0.0);
+		for (int k = 0; k < nrhs; ++k) E[(size_t)k*N + i0 + k] = 1.0;
+		solver.BackSolve(X, E, nrhs);
 
 		// add to net row sums
-		for (int j = 0; j < N; ++j) s[j] += fabs(x[j]);
-
-		// reset e
-		e[i] = 0.0;
+		for (int k = 0; k < nrhs; ++k)
+		{
+			const double* x = &X[(size_t)k*N];
+			for (int j = 0; j < N; ++j) s[j] += fabs(x[j]);
+		}
 
-		if (i % 100 == 0)
-			fprintf(stderr, "%.2lg%%\r", 100.0 *i / N);
+		fprintf(stderr, "%.2lg%%\r", 100.0 *i0 / N);
 	}
 
 	// get the max row sum
@@ -140,23 +145,28 @@ double NumCore::estimateConditionNumber(SparseMatrix* K)
 	int N = A->Rows();
 	double normAi = 0.0;
 
-	vector<double> b(N, 0), x(N, 0);
+	// the random vectors are solved for in small blocks, which limits the memory needed
+	const int NB = 8;
 	int iters = (N < 50 ? N : 50);
-	for (int i = 0; i < iters; ++i)
+	vector<double> b(N, 0), B, X;
+	for (int i0 = 0; i0 < iters; i0 += NB)
 	{
-		// create a random vector
-		NumCore::randomVector(b, -1.0, 1.0);
-		for (int j = 0; j < N; ++j) b[j] = (b[j] >= 0.0 ? 1.0 : -1.0);
-
-		// calculate solution
-		solver.BackSolve(&x[0], &b[0]);
+		int nrhs = (i0 + NB <= iters ? NB : iters - i0);
+		B.resize((size_t)nrhs*N);
+		for (int k = 0; k < nrhs; ++k)
+		{
+			NumCore::randomVector(b, -1.0, 1.0);
+			double* bk = &B[(size_t)k*N];
+			for (int j = 0; j < N; ++j) bk[j] = (b[j] >= 0.0 ? 1.0 : -1.0);
+		}
 
-		double normb = infNorm(b);
-		double normx = infNorm(x);
-		if (normx > normAi) normAi = normx;
+		solver.BackSolve(X, B, nrhs);
 
-//		int pct = (100 * i) / (iters - 1);
-//		fprintf(stderr, "calculating condition number: %d%%\r", pct);
+		for (int k = 0; k < nrhs; ++k)
+		{
+			const double* xk = &X[(size_t)k*N];
+			for (int j = 0; j < N; ++j) if (fabs(xk[j]) > normAi) normAi = fabs(xk[j]);
+		}
 	}
 
 	return normA*normAi;
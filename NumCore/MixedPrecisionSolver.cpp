@@ -0,0 +1,254 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "MixedPrecisionSolver.h"
+#include <FECore/log.h>
+#include <float.h>
+#include <math.h>
+
+#ifdef PARDISO
+#undef PARDISO
+#include <mkl.h>
+#include <mkl_pardiso.h>
+#define PARDISO
+
+// defined in PardisoSolver.cpp
+void print_err(int nerror);
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(MixedPrecisionSolver, PardisoSolver)
+	ADD_PARAMETER(m_maxRefine , "max_refine");
+	ADD_PARAMETER(m_tol       , "tol");
+	ADD_PARAMETER(m_printLevel, "print_level");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+MixedPrecisionSolver::MixedPrecisionSolver(FEModel* fem) : PardisoSolver(fem)
+{
+	m_maxRefine = 10;
+	m_tol = 1e-12;
+	m_printLevel = 0;
+
+	m_bdouble = false;
+	m_nrefine = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool MixedPrecisionSolver::Factor()
+{
+	// make sure we have work to do
+	if (m_pA->Rows() == 0) return true;
+
+	// once the refinement has stalled we stay with the double precision factorization
+	if (m_bdouble) return FactorDouble();
+
+	if (FactorSingle() == false)
+	{
+		feLogWarning("Single precision factorization failed. Switching to double precision.");
+		m_bdouble = true;
+		return FactorDouble();
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool MixedPrecisionSolver::FactorSingle()
+{
+	// release the previous factorization since it may have a different precision
+	if (m_isFactored) Destroy();
+
+	// make a single precision copy of the matrix
+	int nnz = m_pA->NonZeroes();
+	double* pv = m_pA->Values();
+	m_af.resize(nnz);
+	for (int i = 0; i < nnz; ++i)
+	{
+		// the matrix cannot be represented in single precision
+		if (fabs(pv[i]) > FLT_MAX) return false;
+		m_af[i] = (float)pv[i];
+	}
+
+	m_iparm[27] = 1;	// single precision
+
+	// Reordering and symbolic factorization
+	int phase = 11;
+	int error = 0;
+	pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, &m_af[0], m_pA->Pointers(), m_pA->Indices(),
+		NULL, &m_nrhs, m_iparm, &m_msglvl, NULL, NULL, &error);
+	if (error)
+	{
+		fprintf(stderr, "\nERROR during symbolic factorization: ");
+		print_err(error);
+		m_iparm[27] = 0;
+		return false;
+	}
+
+	// numerical factorization
+	phase = 22;
+	m_iparm[3] = 0;
+	error = 0;
+	pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, &m_af[0], m_pA->Pointers(), m_pA->Indices(),
+		NULL, &m_nrhs, m_iparm, &m_msglvl, NULL, NULL, &error);
+
+	// we need the Pardiso memory to be released, even when the factorization failed
+	m_isFactored = true;
+	if (error)
+	{
+		Destroy();
+		m_iparm[27] = 0;
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool MixedPrecisionSolver::FactorDouble()
+{
+	if (m_isFactored) Destroy();
+
+	// we no longer need the single precision data
+	vector<float>().swap(m_af);
+	vector<float>().swap(m_bf);
+	vector<float>().swap(m_xf);
+
+	m_iparm[27] = 0;
+	return PardisoSolver::Factor();
+}
+
+//-----------------------------------------------------------------------------
+bool MixedPrecisionSolver::SolveSingle(double* x, double* b)
+{
+	m_bf.resize(m_n);
+	m_xf.resize(m_n);
+	for (int i = 0; i < m_n; ++i) m_bf[i] = (float)b[i];
+
+	int phase = 33;
+	m_iparm[7] = 0;	// we do the iterative refinement ourselves
+
+	int error = 0;
+	pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, &m_af[0], m_pA->Pointers(), m_pA->Indices(),
+		NULL, &m_nrhs, m_iparm, &m_msglvl, &m_bf[0], &m_xf[0], &error);
+	if (error)
+	{
+		fprintf(stderr, "\nERROR during solution: ");
+		print_err(error);
+		return false;
+	}
+
+	for (int i = 0; i < m_n; ++i) x[i] = (double)m_xf[i];
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool MixedPrecisionSolver::BackSolve(double* x, double* b)
+{
+	// make sure we have work to do
+	if (m_pA->Rows() == 0) return true;
+
+	if (m_bdouble) return PardisoSolver::BackSolve(x, b);
+
+	int N = m_n;
+	m_r.resize(N);
+	m_Ax.resize(N);
+	vector<double> d(N);
+
+	double normb = 0.0;
+	for (int i = 0; i < N; ++i) normb += b[i] * b[i];
+	normb = sqrt(normb);
+	if (normb == 0.0)
+	{
+		for (int i = 0; i < N; ++i) x[i] = 0.0;
+		UpdateStats(0);
+		return true;
+	}
+
+	// initial solution
+	for (int i = 0; i < N; ++i) { x[i] = 0.0; m_r[i] = b[i]; }
+	double normr = normb;
+
+	// iterative refinement: x += A_s^-1 (b - A x)
+	bool bconv = false;
+	int niter = 0;
+	while (niter < m_maxRefine)
+	{
+		if (SolveSingle(&d[0], &m_r[0]) == false) break;
+		for (int i = 0; i < N; ++i) x[i] += d[i];
+		niter++;
+
+		// calculate the new residual in double precision
+		m_pA->mult_vector(x, &m_Ax[0]);
+		double normr_prev = normr;
+		normr = 0.0;
+		for (int i = 0; i < N; ++i)
+		{
+			m_r[i] = b[i] - m_Ax[i];
+			normr += m_r[i] * m_r[i];
+		}
+		normr = sqrt(normr);
+
+		if (m_printLevel > 0) feLog("%d: %lg\n", niter, normr / normb);
+
+		if (normr <= m_tol*normb) { bconv = true; break; }
+
+		// The refinement should reduce the residual by at least a factor of two. 
+		// If it doesn't, the single precision factorization is not accurate enough.
+		if (normr > 0.5*normr_prev) break;
+	}
+
+	m_nrefine += niter;
+	if (m_printLevel > 0) feLog("\trefinement steps ................... : %d\n", niter);
+
+	if (bconv == false)
+	{
+		feLogWarning("Iterative refinement stalled after %d steps (residual = %lg).\nSwitching to double precision factorization.", niter, normr / normb);
+		m_bdouble = true;
+		if (FactorDouble() == false) return false;
+		return PardisoSolver::BackSolve(x, b);
+	}
+
+	// update stats
+	UpdateStats(niter);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Each right-hand side needs its own refinement, so the single precision solves 
+//! are done one right-hand side at a time. A double precision factorization can 
+//! solve for all right-hand sides at once.
+bool MixedPrecisionSolver::BackSolve(vector<double>& X, vector<double>& B, int nrhs)
+{
+	if (m_bdouble) return PardisoSolver::BackSolve(X, B, nrhs);
+	return LinearSolver::BackSolve(X, B, nrhs);
+}
+
+#endif
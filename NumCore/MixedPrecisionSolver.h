@@ -0,0 +1,77 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "PardisoSolver.h"
+
+//-----------------------------------------------------------------------------
+//! This solver factors the matrix in single precision with Pardiso, which halves 
+//! the memory needed for the factorization. Double precision accuracy is recovered
+//! with iterative refinement against the double precision matrix. When the refinement
+//! stalls, the solver switches to a double precision factorization.
+class MixedPrecisionSolver : public PardisoSolver
+{
+public:
+	MixedPrecisionSolver(FEModel* fem);
+
+	bool Factor() override;
+	bool BackSolve(double* x, double* y) override;
+	bool BackSolve(vector<double>& X, vector<double>& B, int nrhs) override;
+
+	void SetPrintLevel(int n) override { m_printLevel = n; }
+
+	//! total number of refinement steps
+	int RefinementSteps() const { return m_nrefine; }
+
+protected:
+	//! do the factorization in single precision
+	bool FactorSingle();
+
+	//! switch to a double precision factorization
+	bool FactorDouble();
+
+	//! solve with the single precision factorization
+	bool SolveSingle(double* x, double* b);
+
+protected:
+	int		m_maxRefine;	//!< max number of refinement steps
+	double	m_tol;			//!< relative residual tolerance
+	int		m_printLevel;	//!< print level
+
+	bool	m_bdouble;		//!< use double precision factorization
+	int		m_nrefine;		//!< total number of refinement steps
+
+	vector<float>	m_af;	//!< single precision copy of matrix values
+	vector<float>	m_bf;	//!< single precision right-hand side
+	vector<float>	m_xf;	//!< single precision solution
+	vector<double>	m_r;	//!< residual
+	vector<double>	m_Ax;	//!< matrix-vector product
+
+	DECLARE_FECORE_CLASS();
+};
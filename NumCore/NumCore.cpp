@@ -31,10 +31,12 @@ SOFTWARE.*/
 #include "SkylineSolver.h"
 #include "LUSolver.h"
 #include "PardisoSolver.h"
+#include "MixedPrecisionSolver.h"
 #include "RCICGSolver.h"
 #include "FGMRESSolver.h"
 #include "ILU0_Preconditioner.h"
 #include "ILUT_Preconditioner.h"
+#include "BlockJacobiPreconditioner.h"
 #include "BIPNSolver.h"
 #include "HypreGMRESsolver.h"
 #include "Hypre_PCG_AMG.h"
@@ -54,6 +56,7 @@ void NumCore::InitModule()
 {
 	// register linear solvers
 	REGISTER_FECORE_CLASS(PardisoSolver  , "pardiso");
+	REGISTER_FECORE_CLASS(MixedPrecisionSolver, "mixed_precision");
 	REGISTER_FECORE_CLASS(SkylineSolver  , "skyline");
 	REGISTER_FECORE_CLASS(LUSolver       , "LU"     );
 	REGISTER_FECORE_CLASS(FGMRESSolver        , "fgmres"   );
@@ -71,6 +74,7 @@ void NumCore::InitModule()
 	REGISTER_FECORE_CLASS(ILU0_Preconditioner, "ilu0");
 	REGISTER_FECORE_CLASS(ILUT_Preconditioner, "ilut");
 	REGISTER_FECORE_CLASS(IncompleteCholesky , "ichol");
+	REGISTER_FECORE_CLASS(BlockJacobiPreconditioner, "block_jacobi");
 
 	// set default linear solver
 	// (Set this before the configuration is read in because
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include "PardisoSolver.h"
 #include "MatrixTools.h"
 #include <FECore/log.h>
@@ -261,6 +262,38 @@ bool PardisoSolver::BackSolve(double* x, double* b)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// Solve for several right-hand sides. Pardiso handles all right-hand sides in 
+// a single solution phase.
+bool PardisoSolver::BackSolve(vector<double>& X, vector<double>& B, int nrhs)
+{
+	// make sure we have work to do
+	if (nrhs <= 0) return true;
+	assert((size_t)m_n*nrhs == B.size());
+	X.resize(B.size());
+	if (m_pA->Rows() == 0) return true;
+
+	int phase = 33;
+
+	m_iparm[7] = 1;	/* Maximum number of iterative refinement steps */
+
+	int error = 0;
+	pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, m_pA->Values(), m_pA->Pointers(), m_pA->Indices(),
+		 NULL, &nrhs, m_iparm, &m_msglvl, &B[0], &X[0], &error);
+
+	if (error)
+	{
+		fprintf(stderr, "\nERROR during solution: ");
+		print_err(error);
+		exit(3);
+	}
+
+	// update stats
+	for (int k = 0; k < nrhs; ++k) UpdateStats(1);
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // This algorithm (naively) estimates the condition number. It is based on the observation that
 // for a linear system of equations A.x = b, the following holds
@@ -283,22 +316,28 @@ double PardisoSolver::condition_number()
 	// choose max iterations
 	int iters = (N < 50 ? N : 50);
 
-	vector<double> b(N, 0), x(N, 0);
-	for (int i = 0; i < iters; ++i)
+	// the random vectors are solved for in small blocks, which limits the memory needed
+	const int NB = 8;
+	vector<double> b(N, 0), B, X;
+	fprintf(stderr, "calculating condition number ...\r");
+	for (int i0 = 0; i0 < iters; i0 += NB)
 	{
-		// create a random vector
-		NumCore::randomVector(b, -1.0, 1.0);
-		for (int j = 0; j < N; ++j) b[j] = (b[j] >= 0.0 ? 1.0 : -1.0);
-
-		// calculate solution
-		BackSolve(&x[0], &b[0]);
-
-		double normb = NumCore::infNorm(b);
-		double normx = NumCore::infNorm(x);
-		if (normx > normAi) normAi = normx;
-
-		int pct = (100 * i) / (iters - 1);
-		fprintf(stderr, "calculating condition number: %d%%\r", pct);
+		int nrhs = (i0 + NB <= iters ? NB : iters - i0);
+		B.resize((size_t)nrhs*N);
+		for (int k = 0; k < nrhs; ++k)
+		{
+			NumCore::randomVector(b, -1.0, 1.0);
+			double* bk = &B[(size_t)k*N];
+			for (int j = 0; j < N; ++j) bk[j] = (b[j] >= 0.0 ? 1.0 : -1.0);
+		}
+
+		BackSolve(X, B, nrhs);
+
+		for (int k = 0; k < nrhs; ++k)
+		{
+			const double* xk = &X[(size_t)k*N];
+			for (int j = 0; j < N; ++j) if (fabs(xk[j]) > normAi) normAi = fabs(xk[j]);
+		}
 	}
 
 	double c = normA*normAi;
@@ -44,6 +44,7 @@ public:
 	bool PreProcess() override;
 	bool Factor() override;
 	bool BackSolve(double* x, double* y) override;
+	bool BackSolve(std::vector<double>& X, std::vector<double>& B, int nrhs) override;
 	void Destroy() override;
 
 	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
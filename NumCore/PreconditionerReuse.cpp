@@ -0,0 +1,173 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "PreconditionerReuse.h"
+#include <FECore/LinearSolver.h>
+#include <FECore/FEModel.h>
+#include <FECore/log.h>
+
+//-----------------------------------------------------------------------------
+PreconditionerReuse::PreconditionerReuse()
+{
+	m_maxReuse = 0;
+	m_iterGrowth = 2.0;
+	m_blog = false;
+
+	m_bvalid = false;
+	m_bstale = false;
+	m_nreused = 0;
+	m_refIters = 0.0;
+
+	m_brefreshed = false;
+	m_nsolves = 0;
+	m_niters = 0;
+}
+
+//-----------------------------------------------------------------------------
+void PreconditionerReuse::SetMaxReuse(int n)
+{
+	m_maxReuse = (n > 0 ? n : 0);
+}
+
+//-----------------------------------------------------------------------------
+void PreconditionerReuse::SetIterationGrowth(double g)
+{
+	m_iterGrowth = (g > 0.0 ? g : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void PreconditionerReuse::SetLogging(bool b)
+{
+	m_blog = b;
+}
+
+//-----------------------------------------------------------------------------
+bool PreconditionerReuse::IsActive() const
+{
+	return (m_maxReuse > 0);
+}
+
+//-----------------------------------------------------------------------------
+void PreconditionerReuse::Reset(FEModel* fem)
+{
+	Report(fem);
+	m_bvalid = false;
+	m_bstale = false;
+	m_nreused = 0;
+	m_refIters = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+bool PreconditionerReuse::NeedsRefresh() const
+{
+	if ((m_bvalid == false) || m_bstale) return true;
+	if (IsActive() == false) return true;
+	return (m_nreused >= m_maxReuse);
+}
+
+//-----------------------------------------------------------------------------
+bool PreconditionerReuse::Factor(FEModel* fem, FactorFunction factor)
+{
+	// report the stats of the previous reformation
+	Report(fem);
+
+	m_setupTime.reset();
+	m_solveTime.reset();
+
+	m_brefreshed = NeedsRefresh();
+	if (m_brefreshed == false)
+	{
+		m_nreused++;
+		return true;
+	}
+
+	m_setupTime.start();
+	bool bret = factor();
+	m_setupTime.stop();
+
+	m_bvalid = bret;
+	m_bstale = false;
+	m_nreused = 0;
+	m_refIters = 0.0;
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+bool PreconditionerReuse::Solve(const LinearSolver* solver, SolveFunction solve)
+{
+	int iter0 = solver->GetStats().iterations;
+
+	m_solveTime.start();
+	bool bret = solve();
+	m_solveTime.stop();
+
+	m_nsolves++;
+	m_niters += solver->GetStats().iterations - iter0;
+
+	// a failed solve may be caused by an outdated preconditioner
+	if (bret == false)
+	{
+		m_bstale = true;
+		return false;
+	}
+
+	if (IsActive())
+	{
+		double avgIters = (double)m_niters / (double)m_nsolves;
+		if (m_brefreshed)
+		{
+			// the reference iteration count is taken from the reformation that built the preconditioner
+			m_refIters = (avgIters > 1.0 ? avgIters : 1.0);
+		}
+		else if ((m_iterGrowth > 0.0) && (m_refIters > 0.0) && (avgIters > m_iterGrowth*m_refIters))
+		{
+			// The preconditioner no longer matches the matrix well enough. It is rebuilt 
+			// on the next reformation, since the factorization requires the new matrix.
+			m_bstale = true;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void PreconditionerReuse::Report(FEModel* fem)
+{
+	if (m_blog && fem && (m_nsolves > 0))
+	{
+		if (m_brefreshed)
+			feLogEx(fem, "\tpreconditioner refreshed: setup = %lg s, solve = %lg s (%d solves, %d iterations)\n", m_setupTime.GetTime(), m_solveTime.GetTime(), m_nsolves, m_niters);
+		else
+			feLogEx(fem, "\tpreconditioner reused (%d/%d): setup = 0 s, solve = %lg s (%d solves, %d iterations)\n", m_nreused, m_maxReuse, m_solveTime.GetTime(), m_nsolves, m_niters);
+	}
+	m_nsolves = 0;
+	m_niters = 0;
+}
@@ -0,0 +1,106 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <FECore/Timer.h>
+#include <functional>
+
+class FEModel;
+class LinearSolver;
+
+//-----------------------------------------------------------------------------
+//! This class implements a policy for reusing a preconditioner across stiffness 
+//! reformations. The incomplete factorizations (ILU0, ILUT, incomplete Cholesky)
+//! are rebuilt every time the iterative solver is factored, even though the 
+//! stiffness matrix often changes little between reformations. With this policy
+//! the previous preconditioner is kept until either the average Krylov iteration 
+//! count per solve grows past a multiple of the count observed right after the 
+//! last refresh, or a maximum number of reformations has passed. 
+//! The preconditioner is also refreshed when a solve fails or when the matrix
+//! structure changes. 
+//! The setup and solve times are accumulated per reformation and reported at 
+//! the start of the next one.
+class PreconditionerReuse
+{
+public:
+	//! function that (re)builds the preconditioner
+	typedef std::function<bool()> FactorFunction;
+
+	//! function that solves the linear system
+	typedef std::function<bool()> SolveFunction;
+
+public:
+	PreconditionerReuse();
+
+	//! set the max nr of reformations the preconditioner is reused (0 = refresh on every reformation)
+	void SetMaxReuse(int n);
+
+	//! set the iteration growth factor that triggers a refresh (0 = don't check iterations)
+	void SetIterationGrowth(double g);
+
+	//! turn logging of the setup and solve times on or off
+	void SetLogging(bool b);
+
+	//! see if the preconditioner can be reused
+	bool IsActive() const;
+
+	//! Force a refresh on the next reformation (e.g. because the matrix structure changed).
+	//! This also reports the stats of the current reformation.
+	void Reset(FEModel* fem);
+
+	//! Call this on each reformation. Calls factor when the preconditioner needs to be refreshed.
+	bool Factor(FEModel* fem, FactorFunction factor);
+
+	//! Call this for each solve. The solver's stats are used to track the iteration count.
+	bool Solve(const LinearSolver* solver, SolveFunction solve);
+
+private:
+	// see if the preconditioner has to be refreshed
+	bool NeedsRefresh() const;
+
+	// log the stats of the current reformation
+	void Report(FEModel* fem);
+
+private:
+	int		m_maxReuse;		//!< max nr of reformations the preconditioner is reused
+	double	m_iterGrowth;	//!< iteration growth factor that triggers a refresh
+	bool	m_blog;			//!< log setup and solve times
+
+	bool	m_bvalid;		//!< the preconditioner was built at least once (since the last reset)
+	bool	m_bstale;		//!< the preconditioner must be refreshed on the next reformation
+	int		m_nreused;		//!< nr of reformations since the last refresh
+	double	m_refIters;		//!< average iterations per solve after the last refresh (0 = not set)
+
+	// stats of the current reformation
+	bool	m_brefreshed;	//!< the preconditioner was refreshed on this reformation
+	int		m_nsolves;		//!< nr of solves
+	int		m_niters;		//!< nr of iterations
+	Timer	m_setupTime;	//!< time to build the preconditioner
+	Timer	m_solveTime;	//!< time spent in the solver
+};
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "RCICGSolver.h"
 #include "IncompleteCholesky.h"
+#include "BlockCSRMatrix.h"
 
 //-----------------------------------------------------------------------------
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
@@ -47,6 +48,7 @@ BEGIN_FECORE_CLASS(RCICGSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_tol, "tol");
 	ADD_PARAMETER(m_maxiter, "max_iter");
 	ADD_PARAMETER(m_fail_max_iters, "fail_max_iters");
+	ADD_PARAMETER(m_blockSize, FE_RANGE_GREATER_OR_EQUAL(0), "matrix_block_size");
 	ADD_PROPERTY(m_P, "pc_left");
 END_FECORE_CLASS();
 
@@ -57,6 +59,7 @@ RCICGSolver::RCICGSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0), m_
 	m_tol = 1e-5;
 	m_print_level = 0;
 	m_fail_max_iters = true;
+	m_blockSize = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -64,7 +67,8 @@ SparseMatrix* RCICGSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
 #ifdef MKL_ISS
 	if (ntype != REAL_SYMMETRIC) return 0;
-	m_pA = new CompactSymmMatrix(1);
+	if (m_blockSize > 0) m_pA = new BlockCSRMatrix(m_blockSize, true);
+	else m_pA = new CompactSymmMatrix(1);
 	return m_pA;
 #else
 	return 0;
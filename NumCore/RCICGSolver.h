@@ -35,6 +35,7 @@ public:
 	bool PreProcess() override;
 	bool Factor() override;
 	bool BackSolve(double* x, double* b) override;
+	using LinearSolver::BackSolve;
 	void Destroy() override;
 
 public:
@@ -59,6 +60,7 @@ protected:
 	double	m_tol;			// residual relative tolerance
 	int		m_print_level;	// output level
 	bool	m_fail_max_iters;
+	int		m_blockSize;	// block size of BCSR matrix (0 = use scalar format)
 
 	DECLARE_FECORE_CLASS();
 };
@@ -0,0 +1,235 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "RecycledSubspace.h"
+#include <math.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+static double dot(const vector<double>& a, const double* b)
+{
+	double s = 0.0;
+	const int n = (int)a.size();
+	for (int i = 0; i < n; ++i) s += a[i] * b[i];
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+RecycledSubspace::RecycledSubspace()
+{
+	m_maxVectors = 0;
+	m_warmStart = false;
+	m_bupdate = false;
+	m_neq = 0;
+}
+
+//-----------------------------------------------------------------------------
+void RecycledSubspace::SetMaxVectors(int n)
+{
+	m_maxVectors = (n > 0 ? n : 0);
+	while ((int)m_U.size() > m_maxVectors)
+	{
+		m_U.erase(m_U.begin());
+		m_C.erase(m_C.begin());
+	}
+}
+
+//-----------------------------------------------------------------------------
+void RecycledSubspace::SetWarmStart(bool b)
+{
+	m_warmStart = b;
+	if (b == false) m_xp.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool RecycledSubspace::IsActive() const
+{
+	return ((m_maxVectors > 0) || m_warmStart);
+}
+
+//-----------------------------------------------------------------------------
+void RecycledSubspace::Clear()
+{
+	m_U.clear();
+	m_C.clear();
+	m_xp.clear();
+	m_bupdate = false;
+}
+
+//-----------------------------------------------------------------------------
+void RecycledSubspace::MatrixChanged()
+{
+	m_bupdate = true;
+}
+
+//-----------------------------------------------------------------------------
+int RecycledSubspace::Vectors() const
+{
+	return (int)m_U.size();
+}
+
+//-----------------------------------------------------------------------------
+// Recalculate C = A*U for the new matrix, and orthonormalize C with modified 
+// Gram-Schmidt. The same operations are applied to U so that C = A*U still holds.
+// Vectors that became linearly dependent are removed.
+void RecycledSubspace::Update(MultFunction A)
+{
+	const int neq = m_neq;
+	vector< vector<double> > U, C;
+	for (size_t k = 0; k < m_U.size(); ++k)
+	{
+		vector<double>& u = m_U[k];
+		vector<double> c(neq);
+		A(&u[0], &c[0]);
+		double norm0 = sqrt(dot(c, &c[0]));
+
+		for (size_t i = 0; i < C.size(); ++i)
+		{
+			double a = dot(C[i], &c[0]);
+			for (int j = 0; j < neq; ++j) { c[j] -= a*C[i][j]; u[j] -= a*U[i][j]; }
+		}
+
+		double norm = sqrt(dot(c, &c[0]));
+		if (norm > 1e-12*norm0)
+		{
+			for (int j = 0; j < neq; ++j) { c[j] /= norm; u[j] /= norm; }
+			U.push_back(u);
+			C.push_back(c);
+		}
+	}
+	m_U.swap(U);
+	m_C.swap(C);
+}
+
+//-----------------------------------------------------------------------------
+// Add a new vector to the subspace. The oldest vector is dropped when the 
+// subspace is full.
+void RecycledSubspace::AddVector(const vector<double>& u0, MultFunction A)
+{
+	const int neq = m_neq;
+	vector<double> u(u0), c(neq);
+	A(&u[0], &c[0]);
+	double norm0 = sqrt(dot(c, &c[0]));
+	if (norm0 == 0.0) return;
+
+	for (size_t i = 0; i < m_C.size(); ++i)
+	{
+		double a = dot(m_C[i], &c[0]);
+		for (int j = 0; j < neq; ++j) { c[j] -= a*m_C[i][j]; u[j] -= a*m_U[i][j]; }
+	}
+
+	double norm = sqrt(dot(c, &c[0]));
+	if (norm <= 1e-12*norm0) return;
+	for (int j = 0; j < neq; ++j) { c[j] /= norm; u[j] /= norm; }
+
+	if ((int)m_U.size() >= m_maxVectors)
+	{
+		m_U.erase(m_U.begin());
+		m_C.erase(m_C.begin());
+	}
+	m_U.push_back(u);
+	m_C.push_back(c);
+}
+
+//-----------------------------------------------------------------------------
+//! Solve A*x = b. The initial guess x0 is the warm start (if requested) plus the 
+//! projection of the remaining residual onto the recycled subspace. Since C = A*U 
+//! is orthonormal, x0 = U*C^T*r minimizes the residual over the subspace.
+//! The solver is then called for the correction with the tolerance scaled so that
+//! the convergence is still measured relative to the original right-hand side.
+bool RecycledSubspace::Solve(int neq, double* x, double* b, MultFunction A, SolveFunction solve)
+{
+	// start over when the nr of equations changed
+	if (neq != m_neq)
+	{
+		Clear();
+		m_neq = neq;
+	}
+	if (neq == 0) return true;
+
+	// update the subspace for the new matrix
+	if (m_bupdate)
+	{
+		Update(A);
+		m_bupdate = false;
+	}
+
+	// a zero right-hand side has a zero solution
+	double normb = 0.0;
+	for (int i = 0; i < neq; ++i) normb += b[i] * b[i];
+	normb = sqrt(normb);
+	if (normb == 0.0)
+	{
+		for (int i = 0; i < neq; ++i) x[i] = 0.0;
+		return true;
+	}
+
+	// residual of the initial guess
+	m_r.assign(b, b + neq);
+	if (m_warmStart && ((int)m_xp.size() == neq))
+	{
+		m_x0 = m_xp;
+		m_t.resize(neq);
+		A(&m_x0[0], &m_t[0]);
+		for (int i = 0; i < neq; ++i) m_r[i] -= m_t[i];
+	}
+	else m_x0.assign(neq, 0.0);
+
+	// project residual onto the recycled subspace
+	for (size_t k = 0; k < m_U.size(); ++k)
+	{
+		const vector<double>& u = m_U[k];
+		const vector<double>& c = m_C[k];
+		double a = dot(c, &m_r[0]);
+		for (int i = 0; i < neq; ++i)
+		{
+			m_x0[i] += a*u[i];
+			m_r[i] -= a*c[i];
+		}
+	}
+
+	// solve for the correction
+	bool bconv = true;
+	double normr = sqrt(dot(m_r, &m_r[0]));
+	m_d.assign(neq, 0.0);
+	if (normr > 0.0)
+	{
+		bconv = solve(&m_d[0], &m_r[0], normb / normr);
+	}
+	for (int i = 0; i < neq; ++i) x[i] = m_x0[i] + m_d[i];
+
+	// store the correction
+	if ((m_maxVectors > 0) && (normr > 0.0)) AddVector(m_d, A);
+
+	// store the solution for the next warm start
+	if (m_warmStart) m_xp.assign(x, x + neq);
+
+	return bconv;
+}
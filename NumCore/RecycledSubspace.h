@@ -0,0 +1,97 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <vector>
+#include <functional>
+
+//-----------------------------------------------------------------------------
+//! This class manages a subspace of previous solutions that iterative solvers 
+//! can recycle between solves. Consecutive linear systems in a nonlinear analysis 
+//! differ very little, so the solution of the next system lies largely in the 
+//! span of the previous corrections. 
+//! Before a solve, the initial guess is obtained from a minimal residual projection
+//! of the right-hand side onto the recycled subspace (as in GCRO-type methods), and
+//! the iterative solver only needs to solve for the remaining correction. The 
+//! correction is then added to the subspace. Optionally, the previous solution is
+//! used as a warm start.
+class RecycledSubspace
+{
+public:
+	//! function that calculates y = A*x
+	typedef std::function<void(double* x, double* y)> MultFunction;
+
+	//! function that solves A*x = b. The solver's relative tolerance must be multiplied by tolScale.
+	typedef std::function<bool(double* x, double* b, double tolScale)> SolveFunction;
+
+public:
+	RecycledSubspace();
+
+	//! set the max nr of vectors to keep (0 = no recycling)
+	void SetMaxVectors(int n);
+
+	//! use the previous solution as initial guess
+	void SetWarmStart(bool b);
+
+	//! see if recycling or warm start is active
+	bool IsActive() const;
+
+	//! remove all vectors
+	void Clear();
+
+	//! Call this when the matrix has changed. The subspace is updated before the next solve.
+	void MatrixChanged();
+
+	//! nr of vectors in the subspace
+	int Vectors() const;
+
+	//! Solve A*x = b using the recycled subspace
+	bool Solve(int neq, double* x, double* b, MultFunction A, SolveFunction solve);
+
+private:
+	// recalculate C = A*U and orthonormalize
+	void Update(MultFunction A);
+
+	// add a new vector to the subspace
+	void AddVector(const std::vector<double>& u, MultFunction A);
+
+private:
+	int		m_maxVectors;	//!< max nr of vectors
+	bool	m_warmStart;	//!< use previous solution as initial guess
+	bool	m_bupdate;		//!< the matrix has changed
+	int		m_neq;			//!< nr of equations
+
+	std::vector< std::vector<double> >	m_U;	//!< recycled vectors
+	std::vector< std::vector<double> >	m_C;	//!< m_C = A*m_U (orthonormal)
+	std::vector<double>	m_xp;	//!< previous solution
+	std::vector<double>	m_x0;	//!< initial guess
+	std::vector<double>	m_r;	//!< residual of initial guess
+	std::vector<double>	m_d;	//!< correction
+	std::vector<double>	m_t;	//!< temp vector
+};
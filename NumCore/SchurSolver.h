@@ -59,6 +59,7 @@ public:
 
 	//! Backsolve the linear system
 	bool BackSolve(double* x, double* b) override;
+	using LinearSolver::BackSolve;
 
 	//! Clean up
 	void Destroy() override;
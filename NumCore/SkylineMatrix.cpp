@@ -204,3 +204,28 @@ double SkylineMatrix::diag(int i)
 {
 	return m_pd[ m_ppointers[i] ];
 }
+
+bool SkylineMatrix::mult_vector(double* x, double* r)
+{
+	int neq = Rows();
+	for (int i = 0; i < neq; ++i) r[i] = 0.0;
+
+	// loop over all columns
+	for (int j = 0; j < neq; ++j)
+	{
+		// the column values are stored from the diagonal upwards
+		double* pv = m_pd + m_ppointers[j];
+		int l = m_ppointers[j + 1] - m_ppointers[j];
+
+		double rj = pv[0] * x[j];
+		for (int k = 1; k < l; ++k)
+		{
+			int i = j - k;
+			rj += pv[k] * x[i];
+			r[i] += pv[k] * x[j];
+		}
+		r[j] += rj;
+	}
+
+	return true;
+}
@@ -65,6 +65,10 @@ public: // from SparseMatrix
 
 	double diag(int i) override;
 
+	//! multiply with vector
+	//! (Note that the values are overwritten when the matrix is factored)
+	bool mult_vector(double* x, double* r) override;
+
 	double* values() { return m_pd; }
 	int* pointers() { return m_ppointers; }
 
@@ -32,6 +32,7 @@ SOFTWARE.*/
 //-----------------------------------------------------------------------------
 void colsol_factor(int N, double* values, int* pointers);
 void colsol_solve(int N, double* values, int* pointers, double* R);
+void colsol_solve_multi(int N, double* values, int* pointers, double* R, int nrhs);
 
 //-----------------------------------------------------------------------------
 SkylineSolver::SkylineSolver(FEModel* fem) : LinearSolver(fem), m_pA(0)
@@ -71,6 +72,27 @@ bool SkylineSolver::BackSolve(double* x, double* b)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+bool SkylineSolver::BackSolve(vector<double>& X, vector<double>& B, int nrhs)
+{
+	if (nrhs <= 0) return true;
+	int neq = m_pA->Rows();
+	assert((size_t)neq*nrhs == B.size());
+	X.resize(B.size());
+
+	// colsol_solve_multi expects the right hand sides to be interleaved
+	vector<double> R(B.size());
+	for (size_t k=0; k<(size_t)nrhs; ++k)
+		for (size_t i=0; i<(size_t)neq; ++i) R[i*nrhs + k] = B[k*neq + i];
+
+	colsol_solve_multi(neq, m_pA->values(), m_pA->pointers(), &R[0], nrhs);
+
+	for (size_t k=0; k<(size_t)nrhs; ++k)
+		for (size_t i=0; i<(size_t)neq; ++i) X[k*neq + i] = R[i*nrhs + k];
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 void SkylineSolver::Destroy()
 {
@@ -49,6 +49,9 @@ public:
 	//! Backsolve the linear system
 	bool BackSolve(double* x, double* b) override;
 
+	//! Backsolve the linear system for several right-hand sides
+	bool BackSolve(std::vector<double>& X, std::vector<double>& B, int nrhs) override;
+
 	//! Clean up
 	void Destroy() override;
 